@@ -25,15 +25,29 @@ ReenableWarnings();
 //~ Actual Api
 enum
 {
-	E_Limits_MaxThreadWorkCount = 1024,
+	E_Limits_MaxThreadWorkCount = 1024, // NOTE(ljre): Per thread. Must be a power of 2.
+	E_Limits_MaxThreadFibers = 128,
 	E_Limits_MaxLoadedSounds = 128,
-	E_Limits_MaxPlayingSounds = 16,
+	E_Limits_MaxPlayingSounds = 4096,
+	E_Limits_MaxMixedSounds = 32, // NOTE(ljre): The rest of the playing sounds go silent, but keep playing.
+	E_Limits_MaxSoundStreams = 16,
+	E_Limits_SoundStreamRingFrames = 1 << 16, // NOTE(ljre): Must be a power of 2.
+	E_Limits_MaxPredecodedSoundFrames = 48000 * 10, // NOTE(ljre): Longer sounds are streamed.
+	E_Limits_MaxAudioCommands = 1024, // NOTE(ljre): Must be a power of 2.
+	E_Limits_AudioBlockFrames = 512, // NOTE(ljre): The mixer and its effects work on blocks of at most this many frames.
+	E_Limits_OfflineAudioSampleRate = 48000,
+	E_Limits_OfflineAudioChannels = 2,
+	E_Limits_MaxAssetStreamRequests = 256,
+	E_Limits_MaxAssetStreamInFlight = 32,
+	E_Limits_MaxAssetStreamPath = 256,
+	E_Limits_RectBatchMaxTextures = 16, // NOTE(ljre): Must be a power of 2.
 };
 
 struct G_GlobalData typedef G_GlobalData;
 struct E_GlobalData typedef E_GlobalData;
 
 struct E_AudioState typedef E_AudioState;
+struct E_AssetStream typedef E_AssetStream;
 struct E_ThreadWorkQueue typedef E_ThreadWorkQueue;
 
 struct E_ThreadCtx
@@ -67,13 +81,22 @@ struct E_GlobalData
 	bool running : 1;
 	bool enable_vsync : 1;
 	
+	int32 argc;
+	const char* const* argv;
+	
 	// NOTE(ljre): Convenience lock for mutating global engine data. Should only be used if the main thread is
 	//             currently waiting and individual worker threads needs to access global resources.
 	OS_RWLock mt_lock;
 	
+	// NOTE(ljre): How many bytes of decoded pixels the asset stream may upload per frame. At least one texture is
+	//             always uploaded per frame, even if it's bigger than this.
+	uintsize asset_stream_upload_budget;
+	E_AssetStream* asset_stream;
+	
+	// NOTE(ljre): 'worker_threads[i].id' is i+1. Their scratch arenas are only made once they run their first work.
 	intsize worker_thread_count;
 	E_ThreadWorkQueue* thread_work_queue;
-	E_ThreadCtx worker_threads[OS_Limits_MaxWorkerThreadCount];
+	E_ThreadCtx* worker_threads;
 };
 
 API void G_Main(E_GlobalData* data);
@@ -193,17 +216,30 @@ typedef E_RectBatchElem;
 struct E_RectBatch
 {
 	Arena* arena;
-	E_Tex2d textures[RB_Limits_DrawMaxTextures];
+	E_Tex2d textures[E_Limits_RectBatchMaxTextures];
+	
+	// NOTE(ljre): If set, pushes convert the rects to the vertex format the GPU reads right away, and a single
+	//             packed batch is uploaded as it is. 'packed_elements' is opaque, so rects can't be edited by hand.
+	bool flag_packed : 1;
 	
 	uint32 count;
-	E_RectBatchElem* elements;
+	union
+	{
+		E_RectBatchElem* elements;
+		struct E_QuadVertex_* packed_elements;
+	};
 }
 typedef E_RectBatch;
 
 API E_Tex2d E_WhiteTexture(void);
+// NOTE(ljre): Uses the font's slot in the batch, or the first null one. Fails only if there's neither.
 API bool E_PushText(E_RectBatch* batch, E_Font* font, String text, vec2 pos, vec2 scale, vec4 color);
 API void E_PushRect(E_RectBatch* batch, const E_RectBatchElem* rect);
 API void E_DrawRectBatch(const E_RectBatch* batch, const E_Camera2D* cam);
+// NOTE(ljre): Draws 'batches' in order. Each of them can be filled by a different thread as long as it has an arena
+//             of its own. Their texture slots are merged into as few draws as possible: a draw samples 4 textures,
+//             so a new one starts where the rects need a 5th. Null slots draw as the white texture.
+API void E_DrawRectBatches(const E_RectBatch* batches, intsize batch_count, const E_Camera2D* cam);
 
 API bool E_DecodeImage(Arena* output_arena, Buffer image, void** out_pixels, int32* out_width, int32* out_height);
 API void E_CalcTextSize(E_Font* font, String text, vec2 scale, vec2* out_size);
@@ -211,31 +247,96 @@ API void E_CalcTextSize(E_Font* font, String text, vec2 scale, vec2* out_size);
 //- Worker Thread API
 void typedef E_ThreadWorkProc(E_ThreadCtx* ctx, void* data);
 
+// NOTE(ljre): Caller-owned fence. Zero-initialize it, point works at it through 'E_ThreadWork.counter', and
+//             then wait on it. It reaches zero when all of those works are done.
+struct E_ThreadCounter
+{
+	volatile int32 count;
+	int32 first_waiting; // NOTE(ljre): Internal. 1-based index of works waiting for this counter.
+}
+typedef E_ThreadCounter;
+
 struct E_ThreadWork
 {
 	E_ThreadWorkProc* callback;
 	void* data;
+	
+	// NOTE(ljre): Both optional. 'counter' is incremented when the work is queued and decremented when it's done.
+	//             If 'dependency' is set, the work will only start after 'dependency' reaches zero.
+	E_ThreadCounter* counter;
+	E_ThreadCounter* dependency;
 }
 typedef E_ThreadWork;
 
+struct E_ThreadWaitingWork_
+{
+	E_ThreadWork work;
+	int32 next; // 1-based
+}
+typedef E_ThreadWaitingWork_;
+
+// NOTE(ljre): Chase-Lev work-stealing deque. The owner thread pushes and pops at 'bottom', while other
+//             threads steal from 'top'. Both indices only grow; they're compared with wrap-around in mind.
+struct E_ThreadWorkDeque
+{
+	alignas(64) volatile int32 top;
+	alignas(64) volatile int32 bottom;
+	alignas(64) E_ThreadWork works[E_Limits_MaxThreadWorkCount];
+}
+typedef E_ThreadWorkDeque;
+
 struct E_ThreadWorkQueue
 {
 	OS_Semaphore semaphore;
-	OS_EventSignal reached_zero_doing_work_sig;
+	OS_Semaphore park_semaphore;
+	OS_Semaphore counter_semaphore;
+	
+	E_ThreadCounter pending;
+	volatile int32 sleeping_count;
+	volatile int32 counter_waiter_count;
+	volatile int32 active_worker_count;
+	int32 deque_count;
 	
-	volatile int32 remaining_head;
-	volatile int32 doing_head;
-	volatile int32 doing_count;
-	E_ThreadWork works[E_Limits_MaxThreadWorkCount];
+	// NOTE(ljre): Threads that don't own a deque (e.g. the audio thread) submit work through this ring.
+	OS_RWLock inject_lock;
+	volatile int32 inject_count;
+	int32 inject_head;
+	E_ThreadWork inject_works[E_Limits_MaxThreadWorkCount];
+	
+	// NOTE(ljre): Works whose dependency hasn't reached zero yet. Protected by 'waiting_lock'.
+	OS_RWLock waiting_lock;
+	int32 first_free_waiting;
+	int32 waiting_pool_count;
+	E_ThreadWaitingWork_ waiting_pool[E_Limits_MaxThreadWorkCount];
+	
+	// NOTE(ljre): Fiber mode. Each work runs on a fiber of its own, so waiting on a counter from inside of a
+	//             work suspends it and lets the thread pick up something else.
+	bool fibers_enabled;
+	OS_RWLock fiber_lock;
+	int32 fiber_count;
+	struct E_ThreadFiber_* first_free_fiber;
+	struct E_ThreadFiber_* fibers;
+	OS_Fiber* thread_fibers;
+	
+	// NOTE(ljre): 'deque_count' of them. Index 0 is the main thread; worker threads use their 'E_ThreadCtx.id'.
+	E_ThreadWorkDeque* deques;
 };
 
 // Returns true if any work has been done.
-// ctx and queue should be NULL if it's being called by the main thread
+// ctx and queue can be NULL, in which case the calling thread's context and the global queue are used.
+// In fiber mode, this always returns false when called from inside of a work.
 API bool E_RunThreadWork(E_ThreadCtx* ctx, E_ThreadWorkQueue* queue);
 
-// NOTE(ljre): these should only be called by main thread!
-API void E_WaitRemainingThreadWork(void);
+// NOTE(ljre): E_QueueThreadWork can be called from any thread, including from inside of a running work.
+//             If the calling thread's deque is full, the work is executed right away.
 API void E_QueueThreadWork(const E_ThreadWork* work);
+// NOTE(ljre): Both of these help run work while waiting. Prefer waiting on the counter you actually need,
+//             E_WaitRemainingThreadWork waits for every single work in the queue. In fiber mode, waiting from
+//             inside of a work suspends it instead.
+API void E_WaitThreadCounter(E_ThreadCounter* counter);
+API void E_WaitRemainingThreadWork(void);
+// NOTE(ljre): Parks worker threads whose id is greater than 'count'. Mostly useful for benchmarking.
+API void E_SetActiveWorkerCount(int32 count);
 
 //- Audio API
 struct E_SoundHandle
@@ -255,6 +356,8 @@ struct E_SoundInfo
 }
 typedef E_SoundInfo;
 
+// NOTE(ljre): Short sounds are decoded whole right away. Longer ones are decoded as they play, so 'ogg' has to
+//             outlive the sound.
 API bool E_LoadSound(Buffer ogg, E_SoundHandle* out_sound, E_SoundInfo* out_info);
 API void E_UnloadSound(E_SoundHandle sound);
 API bool E_IsValidSoundHandle(E_SoundHandle sound);
@@ -277,19 +380,131 @@ struct E_PlayingSoundInfo
 }
 typedef E_PlayingSoundInfo;
 
+enum E_ResampleQuality
+{
+	E_ResampleQuality_Default = 0, // NOTE(ljre): Same as E_ResampleQuality_Sinc32.
+	E_ResampleQuality_Linear,
+	E_ResampleQuality_Sinc8,
+	E_ResampleQuality_Sinc32,
+}
+typedef E_ResampleQuality;
+
+// NOTE(ljre): Every sound plays into a bus, and every bus then goes into E_AudioBus_Master.
+enum E_AudioBus
+{
+	E_AudioBus_Sfx = 0,
+	E_AudioBus_Music,
+	E_AudioBus_Ui,
+	E_AudioBus_Master,
+	
+	E_AudioBus_Count,
+}
+typedef E_AudioBus;
+
 struct E_PlaySoundOptions
 {
 	float32 volume;
 	float32 speed;
+	E_AudioBus bus;
+	E_ResampleQuality quality; // NOTE(ljre): Only matters if the sound isn't at the device's sample rate, or 'speed' isn't 1.
+	
+	// NOTE(ljre): When more than E_Limits_MaxMixedSounds are playing, only the ones with the highest priority, and
+	//             then the loudest, are heard.
+	int32 priority;
+	
+	// NOTE(ljre): A frame of the mixer clock, see E_QueryAudioClock. The sound starts exactly there, or right away if
+	//             the mixer is already past it (0 included).
+	uint64 start_frame;
+	float32 fade_in; // seconds
 }
 typedef E_PlaySoundOptions;
 
 API bool E_PlaySound(E_SoundHandle sound, const E_PlaySoundOptions* options, E_PlayingSoundHandle* out_playing);
+// NOTE(ljre): The handle is freed right away, but the sound still takes a few milliseconds to fade out.
 API bool E_StopSound(E_PlayingSoundHandle playing_sound);
+// NOTE(ljre): Starts fading out at 'frame' of the mixer clock, or right away if the mixer is already past it. The
+//             handle stays valid until the sound is silent.
+API bool E_StopSoundAt(E_PlayingSoundHandle playing_sound, uint64 frame, float32 fade_out);
 API bool E_QueryPlayingSoundInfo(E_PlayingSoundHandle playing_sound, E_PlayingSoundInfo* out_info);
 API void E_StopAllSounds(E_SoundHandle* specific);
 API bool E_IsValidPlayingSoundHandle(E_PlayingSoundHandle playing_sound);
 
+struct E_AudioStats
+{
+	uint32 mix_count;
+	int32 playing_count;
+	int32 mixed_count; // NOTE(ljre): How many of the playing sounds were actually heard in the last mix.
+	int32 stream_underrun_count; // NOTE(ljre): Times a streamed sound wasn't decoded in time.
+	int32 late_mix_count; // NOTE(ljre): Times the mixer took longer than the audio it produced.
+	int32 dropped_play_count; // NOTE(ljre): Times E_PlaySound failed because the mixer fell behind.
+	
+	float32 last_mix_time; // seconds
+	float32 worst_mix_time; // seconds
+	float32 last_mix_length; // seconds of audio produced by the last mix
+	float64 total_mix_time; // seconds, of every mix so far
+	float64 total_mix_length; // seconds of audio produced by every mix so far
+}
+typedef E_AudioStats;
+
+API bool E_QueryAudioStats(E_AudioStats* out_stats);
+
+// NOTE(ljre): How many frames the mixer has produced so far, at 'out_sample_rate'. The device plays them a bit later,
+//             so schedule things at least a buffer or two ahead of this.
+API bool E_QueryAudioClock(uint64* out_frame, int32* out_sample_rate);
+
+enum E_AudioFilterKind
+{
+	E_AudioFilterKind_None = 0,
+	E_AudioFilterKind_LowPass,
+	E_AudioFilterKind_HighPass,
+	E_AudioFilterKind_BandPass,
+	E_AudioFilterKind_Peaking,
+}
+typedef E_AudioFilterKind;
+
+// NOTE(ljre): Applied in this order: filter, reverb, compressor. Zero means off for each of them.
+struct E_AudioBusEffects
+{
+	E_AudioFilterKind filter;
+	float32 filter_frequency; // Hz
+	float32 filter_q; // NOTE(ljre): 0 means 0.707.
+	float32 filter_gain; // dB, only for E_AudioFilterKind_Peaking
+	
+	float32 reverb_mix; // 0 to 1
+	float32 reverb_room_size; // 0 to 1
+	float32 reverb_damping; // 0 to 1
+	
+	float32 compressor_ratio; // NOTE(ljre): Off if 1 or less. INFINITY and no attack makes it a limiter.
+	float32 compressor_threshold; // dB
+	float32 compressor_attack; // seconds
+	float32 compressor_release; // seconds
+	float32 compressor_makeup; // dB
+}
+typedef E_AudioBusEffects;
+
+// NOTE(ljre): Changes to the gain are smoothed over a few milliseconds. E_AudioBus_Master starts at 0.25 to leave some
+//             headroom, every other bus starts at 1.
+API bool E_SetAudioBusGain(E_AudioBus bus, float32 gain);
+API bool E_SetAudioBusEffects(E_AudioBus bus, const E_AudioBusEffects* effects);
+
+// NOTE(ljre): Only when the engine was started with -offline-audio. Then the audio device, if there's one at all, only
+//             gets silence, and the mixer runs when these are called, as fast as it can. The output is
+//             E_Limits_OfflineAudioChannels interleaved channels at E_Limits_OfflineAudioSampleRate.
+//
+//             Streamed sounds are waited on instead of running late, so the same calls always render the same
+//             samples.
+API bool E_RenderAudio(int16* out_samples, int32 frame_count);
+API bool E_RenderAudioToWav(Arena* output_arena, int32 frame_count, Buffer* out_wav);
+
+//- Asset Packs
+struct E_AssetPack typedef E_AssetPack;
+
+// NOTE(ljre): A pack is mapped once and its assets are read in place. See util_assetpack.h and the asset_packer
+//             tool. Returns NULL if the file can't be mapped or isn't a valid pack.
+API E_AssetPack* E_OpenAssetPack(Arena* arena, String path);
+API void E_CloseAssetPack(E_AssetPack* pack);
+API bool E_FindAssetInPack(E_AssetPack* pack, String name, Buffer* out_data);
+
 //- Asset Group
 struct E_AssetInfo
 {
@@ -305,9 +520,14 @@ struct E_AssetGroup
 	uint32 tex2d_count;
 	const E_AssetInfo* sounds_info;
 	const E_AssetInfo* tex2ds_info;
+	E_AssetPack* pack; // NOTE(ljre): Optional. If set, assets are looked up by their 'filepath' in it.
 	
 	// Runtime
 	uint64 load_time;
+	uint64 decode_ticks; // NOTE(ljre): Wall-clock time of the last E_LoadAssets, split by stage.
+	uint64 upload_ticks;
+	uint64 decoded_bytes;
+	int32 streaming_count; // NOTE(ljre): Textures requested by E_StreamAssets that didn't arrive yet.
 	E_Tex2d* tex2ds;
 	E_SoundHandle* sounds;
 }
@@ -316,4 +536,51 @@ typedef E_AssetGroup;
 API void E_LoadAssets(E_AssetGroup* asset_group, Arena* scratch_arena);
 API void E_UnloadAssets(E_AssetGroup* asset_group);
 
+//- Asset Streaming
+// NOTE(ljre): Requests are decoded on worker threads and uploaded from E_FinishFrame, within the budget set by
+//             'asset_stream_upload_budget'. Higher priorities are dispatched first. This API is main-thread only.
+enum E_AssetStreamState
+{
+	E_AssetStreamState_Null = 0, // NOTE(ljre): Invalid or released handle.
+	E_AssetStreamState_Queued,
+	E_AssetStreamState_Decoding,
+	E_AssetStreamState_Done,
+	E_AssetStreamState_Failed,
+}
+typedef E_AssetStreamState;
+
+struct E_AssetStreamHandle
+{
+	uint16 generation;
+	uint16 index;
+}
+typedef E_AssetStreamHandle;
+
+typedef void E_AssetStreamCallback(void* user_data, const E_Tex2d* tex, bool success);
+
+struct E_AssetStreamDesc
+{
+	String filepath;
+	int32 priority;
+	
+	// NOTE(ljre): Optional. '*out_tex' is set to E_WhiteTexture() right away and to the real texture once it's
+	//             uploaded, so it can be drawn with in the meantime. It must stay alive until the request finishes.
+	E_Tex2d* out_tex;
+	E_AssetPack* pack; // NOTE(ljre): Optional. Must stay open until the request finishes.
+	E_AssetStreamCallback* callback;
+	void* user_data;
+}
+typedef E_AssetStreamDesc;
+
+// NOTE(ljre): If 'out_handle' is NULL, the request is released by itself after it finishes. Otherwise, it must be
+//             released with E_ReleaseAssetStream, which also cancels it if it didn't finish yet. The uploaded
+//             texture belongs to the caller either way.
+API bool E_StreamTex2d(const E_AssetStreamDesc* desc, E_AssetStreamHandle* out_handle);
+API E_AssetStreamState E_QueryAssetStream(E_AssetStreamHandle handle, E_Tex2d* out_tex);
+API void E_ReleaseAssetStream(E_AssetStreamHandle handle);
+API int32 E_PendingAssetStreamCount(void);
+
+// NOTE(ljre): Streams every texture of the group that isn't loaded yet. E_UnloadAssets cancels what's left.
+API void E_StreamAssets(E_AssetGroup* asset_group, int32 priority);
+
 #endif //API_ENGINE_H
@@ -30,7 +30,7 @@ enum
 	OS_Limits_MaxWindowTitleLength = 64,
 	OS_Limits_MaxBufferedInput = 256,
 	OS_Limits_MaxCodepointsPerFrame = 64,
-	OS_Limits_MaxWorkerThreadCount = 4,
+	OS_Limits_MaxWorkerThreadCount = 64, // NOTE(ljre): Counting the main thread.
 };
 
 //~ Graphics Context
@@ -40,6 +40,7 @@ enum OS_WindowGraphicsApi
 	
 	OS_WindowGraphicsApi_OpenGL,
 	OS_WindowGraphicsApi_Direct3D11,
+	OS_WindowGraphicsApi_Software, // NOTE(ljre): Nothing to present, the render backend draws on the CPU.
 }
 typedef OS_WindowGraphicsApi;
 
@@ -424,5 +425,20 @@ API int64 OS_InterlockedCompareExchange64(volatile int64* ptr, int64 new_value,
 API void* OS_InterlockedCompareExchangePtr(void* volatile* ptr, void* new_value, void* expected);
 API int32 OS_InterlockedIncrement32(volatile int32* ptr);
 API int32 OS_InterlockedDecrement32(volatile int32* ptr);
+API int32 OS_InterlockedExchange32(volatile int32* ptr, int32 new_value);
+API int32 OS_InterlockedAdd32(volatile int32* ptr, int32 value); // NOTE(ljre): Returns the new value.
+API void OS_MemoryBarrier(void);
+
+// NOTE(ljre): A thread needs to convert itself into a fiber before switching to any other fiber. A fiber's
+//             proc should never return. Where there are no fibers (Android), OS_ConvertThreadToFiber returns a null
+//             fiber and none of the others may be called.
+struct OS_Fiber
+{ void* ptr; }
+typedef OS_Fiber;
+void typedef OS_FiberProc(void* user_data);
+API OS_Fiber OS_ConvertThreadToFiber(void);
+API OS_Fiber OS_CreateFiber(OS_FiberProc* proc, void* user_data, uintsize stack_size);
+API void OS_SwitchToFiber(OS_Fiber fiber);
+API void OS_DeleteFiber(OS_Fiber fiber);
 
 #endif //API_OS_H
@@ -24,6 +24,9 @@ enum
 	RB_Limits_DrawMaxVertexBuffers = 8,
 	RB_Limits_PipelineMaxVertexInputs = 16,
 	RB_Limits_RenderTargetMaxColorAttachments = 4,
+	RB_Limits_Tex2dMaxMips = 16,
+	RB_Limits_RingFramesInFlight = 3,
+	RB_Limits_SoftwareMaxVaryings = 32,
 };
 
 struct RB_Ctx typedef RB_Ctx;
@@ -46,6 +49,7 @@ enum RB_ShaderType
 	RB_ShaderType_Hlsl40Level93,  // vs_4_0_level_9_3 & ps_4_0_level_9_3 object code
 	RB_ShaderType_Hlsl40,         // vs_4_0 & ps_4_0 object code
 	RB_ShaderType_Glsl,           // GLSL (vertex & fragment) source code for both GL3.3 and GLES3.0
+	RB_ShaderType_Software,       // C kernels, see RB_ShaderDesc.software
 }
 typedef RB_ShaderType;
 
@@ -91,7 +95,13 @@ struct RB_Capabilities
 typedef RB_Capabilities;
 
 API RB_Ctx* RB_MakeContext(Arena* arena, const OS_WindowGraphicsContext* graphics_context);
-API RB_Ctx* RB_MakeDeferredContext(RB_Ctx* parent, Arena* );
+// NOTE(ljre): A deferred context records RB_Cmd* and RB_Update* calls into 'arena', which can't be used for anything
+//             else meanwhile, so each thread can fill one of its own. RB_SubmitDeferredContext runs them on the parent,
+//             between its RB_BeginCmd and RB_EndCmd, and empties it. Making, freeing and appending have to be called on
+//             the parent itself (a deferred context asserts on them), and nothing should be made or freed there while
+//             deferred contexts are being filled.
+API RB_Ctx* RB_MakeDeferredContext(RB_Ctx* parent, Arena* arena);
+API void RB_SubmitDeferredContext(RB_Ctx* ctx, RB_Ctx* deferred);
 API void RB_FreeContext(RB_Ctx* ctx);
 API void RB_Present(RB_Ctx* ctx);
 #define RB_IsNull(handle) (!(handle).id)
@@ -187,6 +197,9 @@ struct RB_Tex2dDesc
 	const void* pixels;
 	int32 width, height;
 	RB_TexFormat format;
+	// NOTE(ljre): 0 or 1 means no mips. Otherwise 'pixels' holds the whole chain, largest level first and tightly
+	//             packed. Each level is half of the previous one, rounded down, and at least 1. Can't be dynamic.
+	int32 mip_count;
 	
 	bool flag_dynamic : 1;
 	// NOTE(ljre): Maybe move to RB_DrawDesc or something?
@@ -197,6 +210,31 @@ struct RB_Tex2dDesc
 }
 typedef RB_Tex2dDesc;
 
+// NOTE(ljre): The shaders of the software backend. They work the same as the GLSL ones: every input location is a
+//             vec4 (a matrix takes one per column) and 'uniforms' is the contents of RB_DrawDesc.ubuffer.
+struct RB_SoftwareVertex
+{
+	float32 inputs[RB_Limits_PipelineMaxVertexInputs][4];
+	uint32 vertex_id; // the index from the index buffer
+	uint32 instance_id;
+	const void* uniforms;
+}
+typedef RB_SoftwareVertex;
+
+struct RB_SoftwareFragment
+{
+	const float32* varyings;
+	const float32* ddx; // of the first 'derivative_count' varyings, between this pixel and the one to the right.
+	const float32* ddy; // same, but to the one below.
+	float32 frag_coord[4]; // y goes down and w is 1/w, as in gl_FragCoord.
+	const void* uniforms;
+	const void* const* textures; // of RB_DrawDesc.textures, for RB_SoftwareSample.
+}
+typedef RB_SoftwareFragment;
+
+void typedef RB_SoftwareVertexProc(const RB_SoftwareVertex* vertex, float32 out_position[4], float32* out_varyings);
+void typedef RB_SoftwareFragmentProc(const RB_SoftwareFragment* fragment, float32 out_color[4]);
+
 struct RB_ShaderDesc
 {
 	struct
@@ -211,6 +249,17 @@ struct RB_ShaderDesc
 		Buffer ps;
 	}
 	hlsl40, hlsl40_93, hlsl40_91;
+	struct
+	{
+		RB_SoftwareVertexProc* vs;
+		RB_SoftwareFragmentProc* fs;
+		int32 varying_count;
+		// NOTE(ljre): The last ones of the varyings, taken from the last vertex of the triangle like GLSL's 'flat'.
+		int32 flat_varying_count;
+		// NOTE(ljre): The first ones of the varyings. Needed for fwidth() and to pick the mip level when sampling.
+		int32 derivative_count;
+	}
+	software;
 }
 typedef RB_ShaderDesc;
 
@@ -239,6 +288,9 @@ typedef RB_PipelineDesc;
 struct RB_VBufferDesc
 {
 	bool flag_dynamic : 1;
+	// NOTE(ljre): Implies 'flag_dynamic'. The buffer is only written with RB_AppendVertexBuffer and 'size' is just
+	//             where it starts, it grows as needed.
+	bool flag_ring : 1;
 	
 	uintsize size;
 	const void* initial_data;
@@ -320,6 +372,13 @@ API void RB_UpdateUniformBuffer(RB_Ctx* ctx, RB_UBuffer res, Buffer new_data);
 API void RB_UpdateStructuredBuffer(RB_Ctx* ctx, RB_SBuffer res, Buffer new_data);
 API void RB_UpdateTexture2D(RB_Ctx* ctx, RB_Tex2d res, Buffer new_data);
 
+// NOTE(ljre): Writes 'data' after whatever was appended before, without waiting on the GPU, and returns its offset
+//             to be used in RB_DrawDesc.offsets. The buffer grows so RB_Limits_RingFramesInFlight frames fit before
+//             it wraps around, and wrapping discards it, so draws already made keep reading their data.
+API uint32 RB_AppendVertexBuffer(RB_Ctx* ctx, RB_VBuffer res, Buffer data);
+
+API uintsize RB_CalcTexture2DSize(RB_TexFormat format, int32 width, int32 height, int32 mip_count);
+
 //~
 struct RB_BeginDesc
 {
@@ -376,4 +435,107 @@ API void RB_CmdDraw(RB_Ctx* ctx, const RB_DrawDesc* desc);
 API void RB_CmdDispatch(RB_Ctx* ctx, const RB_DispatchDesc* desc);
 API void RB_EndCmd(RB_Ctx* ctx);
 
+//~
+// NOTE(ljre): The null backend is what a context gets when the graphics API is OS_WindowGraphicsApi_Null. It doesn't
+//             draw anything, but it SafeAsserts every call is valid the way the other backends would need it to be,
+//             and counts them. Other backends return zeroed stats.
+enum RB_NullCallKind
+{
+	RB_NullCallKind_Null = 0,
+	
+	RB_NullCallKind_Make,
+	RB_NullCallKind_Update,
+	RB_NullCallKind_Append,
+	RB_NullCallKind_Free,
+	
+	RB_NullCallKind_Begin,
+	RB_NullCallKind_ApplyPipeline,
+	RB_NullCallKind_ApplyRenderTarget,
+	RB_NullCallKind_Clear,
+	RB_NullCallKind_Draw,
+	RB_NullCallKind_Dispatch,
+	RB_NullCallKind_End,
+}
+typedef RB_NullCallKind;
+
+enum RB_NullResourceKind
+{
+	RB_NullResourceKind_Null = 0,
+	
+	RB_NullResourceKind_Texture2D,
+	RB_NullResourceKind_VertexBuffer,
+	RB_NullResourceKind_IndexBuffer,
+	RB_NullResourceKind_UniformBuffer,
+	RB_NullResourceKind_StructuredBuffer,
+	RB_NullResourceKind_Shader,
+	RB_NullResourceKind_RenderTarget,
+	RB_NullResourceKind_Pipeline,
+	RB_NullResourceKind_ComputeShader,
+}
+typedef RB_NullResourceKind;
+
+struct RB_NullCall
+{
+	RB_NullCallKind kind;
+	RB_NullResourceKind resource; // Make, Update, Append and Free only.
+	uint32 handle; // the resource, or what was applied.
+	uint64 frame_index;
+	uintsize size; // bytes uploaded.
+	
+	union
+	{
+		RB_BeginDesc begin;
+		RB_ClearDesc clear;
+		RB_DrawDesc draw;
+		RB_DispatchDesc dispatch;
+	};
+}
+typedef RB_NullCall;
+
+struct RB_NullStats
+{
+	uint64 make_count;
+	uint64 update_count;
+	uint64 append_count;
+	uint64 free_count;
+	uint64 uploaded_bytes;
+	uint64 ring_discard_count;
+	
+	uint64 begin_count;
+	uint64 pipeline_count;
+	uint64 clear_count;
+	uint64 draw_count;
+	uint64 instanced_draw_count;
+	uint64 index_count; // times the instance count, if instanced.
+	uint64 instance_count;
+	uint64 dispatch_count;
+	
+	int32 live_resource_count;
+	
+	// NOTE(ljre): Every call since recording started, if it did.
+	const RB_NullCall* calls;
+	intsize call_count;
+}
+typedef RB_NullStats;
+
+API RB_NullStats RB_QueryNullStats(RB_Ctx* ctx);
+API void RB_ResetNullStats(RB_Ctx* ctx);
+// NOTE(ljre): Copies every call made from now on into 'arena', which can't be used for anything else meanwhile, and
+//             drops what was recorded before. NULL stops recording, but keeps what was recorded.
+API void RB_RecordNullCalls(RB_Ctx* ctx, Arena* arena);
+
+//~
+// NOTE(ljre): Where the software backend runs its jobs. It has to call 'proc' once for every index in [0, count),
+//             from any thread, and only return after they are all done. Without one, everything runs in the calling
+//             thread. Other backends ignore it.
+void typedef RB_SoftwareJobProc(void* data, intsize index);
+void typedef RB_SoftwareDispatchProc(void* user_data, intsize count, RB_SoftwareJobProc* proc, void* data);
+
+API void RB_SetSoftwareDispatch(RB_Ctx* ctx, RB_SoftwareDispatchProc* dispatch, void* user_data);
+// NOTE(ljre): What was drawn since the last RB_BeginCmd, as RGBA8 from the top row down. Other backends return false.
+API bool RB_ReadSoftwareFramebuffer(RB_Ctx* ctx, Arena* arena, int32* out_width, int32* out_height, Buffer* out_pixels);
+// NOTE(ljre): Same as GLSL's texture(), for RB_SoftwareFragmentProc. 'uv_ddx' and 'uv_ddy' pick the mip level, or the
+//             first one if NULL. Texture coordinates repeat.
+API void RB_SoftwareSample(const RB_SoftwareFragment* fragment, int32 slot, const float32 uv[2], const float32 uv_ddx[2], const float32 uv_ddy[2], float32 out_color[4]);
+
 #endif //API_RENDERBACKEND_H
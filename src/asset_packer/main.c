@@ -0,0 +1,246 @@
+#include "config.h"
+#include "common.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+DisableWarnings();
+#define STB_IMAGE_STATIC
+#define STBI_ONLY_PNG
+#define STBI_NO_STDIO
+#define STB_IMAGE_IMPLEMENTATION
+#include <ext/stb_image.h>
+ReenableWarnings();
+
+#include "util_qoi.h"
+#include "util_assetpack.h"
+
+static void
+PrintHelp(const char* self)
+{
+	fprintf(stderr,
+		"usage: %s [-cook] [-mips] [-qoi] path/to/output.pak path/to/asset...\n"
+		"       %s -ctex [-mips] path/to/asset...\n"
+		"    -cook    store PNG and QOI images as decoded RGBA8 pixels, ready to be uploaded.\n"
+		"    -mips    also store a full mip chain for cooked images. Implies -cook.\n"
+		"    -ctex    instead of a pack, write each image cooked next to it, as \"path/to/asset.ctex\".\n"
+		"    -qoi     store PNG images re-encoded as QOI, with a band table so they can be decoded by many\n"
+		"             threads. Much smaller than -cook, still much faster than PNG to decode.\n"
+		"\n"
+		"assets are named by their path exactly as it was given, e.g. \"assets/pexe.png\".\n",
+		self, self);
+}
+
+static bool
+ReadWholeFile(Arena* arena, const char* fname, Buffer* out_data)
+{
+	FILE* file = fopen(fname, "rb");
+	if (!file)
+		return false;
+	
+	fseek(file, 0, SEEK_END);
+	uintsize size = ftell(file);
+	rewind(file);
+	
+	uint8* buf = ArenaPushDirtyAligned(arena, size, UPak_BlobAlignment);
+	bool ok = (fread(buf, 1, size, file) == size);
+	
+	fclose(file);
+	*out_data = BufMake(size, buf);
+	return ok;
+}
+
+static bool
+WriteWholeFile(const char* fname, const void* data, uintsize size)
+{
+	FILE* file = fopen(fname, "wb");
+	if (!file)
+		return false;
+	
+	bool ok = (fwrite(data, 1, size, file) == size);
+	fclose(file);
+	
+	return ok;
+}
+
+// NOTE(ljre): Decodes 'data' into RGBA8 pixels if it's an image we know about, optionally followed by its mip
+//             chain. Returns false otherwise.
+static bool
+Cook(Arena* arena, UPak_WriteEntry* entry, bool with_mips)
+{
+	Buffer data = entry->data;
+	int32 width, height;
+	void* decoded = NULL;
+	
+	// NOTE(ljre): QOI is decoded straight into the chain, everything else goes through stb_image.
+	if (!UQoi_ParseHeader(data.data, data.size, &width, &height))
+	{
+		if (data.size > INT32_MAX)
+			return false;
+		
+		decoded = stbi_load_from_memory(data.data, (int32)data.size, &width, &height, &(int32){0}, 4);
+		if (!decoded)
+			return false;
+	}
+	
+	int32 mip_count = with_mips ? UPak_CalcFullMipCount(width, height) : 1;
+	uintsize size = UPak_CalcMipChainSize(width, height, mip_count);
+	uint32* chain = ArenaPushDirtyAligned(arena, size, UPak_BlobAlignment);
+	
+	if (decoded)
+	{
+		MemoryCopy(chain, decoded, (uintsize)width * height * 4);
+		stbi_image_free(decoded);
+	}
+	else if (!UQoi_DecodeToBuffer(data.data, data.size, chain, width, height))
+		return false;
+	
+	UPak_GenerateMips(chain, width, height, mip_count);
+	
+	entry->data = BufMake(size, chain);
+	entry->kind = UPak_Kind_Tex2dRGBA8;
+	entry->width = width;
+	entry->height = height;
+	entry->mip_count = mip_count;
+	
+	return true;
+}
+
+// NOTE(ljre): Re-encodes PNG images as QOI with a band table. QOI images are kept as they are.
+static bool
+EncodeQoi(Arena* arena, UPak_WriteEntry* entry)
+{
+	Buffer data = entry->data;
+	int32 width, height;
+	
+	if (UQoi_ParseHeader(data.data, data.size, &width, &height) || data.size > INT32_MAX)
+		return false;
+	
+	uint32* pixels = (uint32*)stbi_load_from_memory(data.data, (int32)data.size, &width, &height, &(int32){0}, 4);
+	if (!pixels)
+		return false;
+	
+	int32 rows_per_band = UQoi_CalcBandRows(width, height);
+	uintsize max_size = UQoi_CalcMaxEncodedSize(width, height, rows_per_band);
+	uint8* encoded = ArenaPushDirtyAligned(arena, max_size, UPak_BlobAlignment);
+	uintsize size = UQoi_EncodeToBuffer(pixels, width, height, rows_per_band, encoded, max_size);
+	
+	stbi_image_free(pixels);
+	entry->data = BufMake(size, encoded);
+	
+	return true;
+}
+
+int
+main(int argc, char* argv[])
+{
+	bool cook = false;
+	bool mips = false;
+	bool ctex = false;
+	bool qoi = false;
+	int32 first_arg = 1;
+	
+	for (; first_arg < argc && argv[first_arg][0] == '-'; ++first_arg)
+	{
+		String arg = StrMake(MemoryStrlen(argv[first_arg]), argv[first_arg]);
+		
+		if (StringEquals(arg, Str("-cook")))
+			cook = true;
+		else if (StringEquals(arg, Str("-mips")))
+			cook = mips = true;
+		else if (StringEquals(arg, Str("-ctex")))
+			cook = ctex = true;
+		else if (StringEquals(arg, Str("-qoi")))
+			qoi = true;
+		else
+		{
+			PrintHelp(argv[0]);
+			return 1;
+		}
+	}
+	
+	if (argc - first_arg < (ctex ? 1 : 2) || (qoi && cook))
+	{
+		PrintHelp(argv[0]);
+		return 1;
+	}
+	
+	const char* output_fname = ctex ? NULL : argv[first_arg++];
+	int32 entry_count = argc - first_arg;
+	
+	Arena* arena = ArenaCreate(4ull << 30, 8 << 20);
+	UPak_WriteEntry* entries = ArenaPushArray(arena, UPak_WriteEntry, entry_count);
+	
+	// NOTE(ljre): Read every input.
+	for (int32 i = 0; i < entry_count; ++i)
+	{
+		const char* fname = argv[first_arg + i];
+		UPak_WriteEntry* entry = &entries[i];
+		
+		entry->name = StrMake(MemoryStrlen(fname), fname);
+		entry->kind = UPak_Kind_Raw;
+		
+		if (!ReadWholeFile(arena, fname, &entry->data))
+		{
+			fprintf(stderr, "could not read input file \"%s\".\n", fname);
+			return 1;
+		}
+		
+		if (qoi && EncodeQoi(arena, entry))
+			fprintf(stderr, "encoded \"%s\" as QOI (%zu bytes).\n", fname, (size_t)entry->data.size);
+		else if (cook && Cook(arena, entry, mips))
+			fprintf(stderr, "cooked \"%s\" (%ix%i, %i mips).\n", fname, entry->width, entry->height, entry->mip_count);
+		else if (ctex)
+		{
+			fprintf(stderr, "could not cook \"%s\".\n", fname);
+			return 1;
+		}
+	}
+	
+	// NOTE(ljre): Standalone cooked textures.
+	if (ctex)
+	{
+		for (int32 i = 0; i < entry_count; ++i)
+		{
+			UPak_WriteEntry* entry = &entries[i];
+			UPak_CookedTexHeader header = UPak_MakeCookedTexHeader(entry->width, entry->height, entry->mip_count);
+			uintsize size = sizeof(header) + entry->data.size;
+			uint8* data = ArenaPushDirtyAligned(arena, size, 16);
+			uintsize fname_size = entry->name.size + sizeof(".ctex");
+			char* fname = ArenaPushDirtyAligned(arena, fname_size, 1);
+			
+			snprintf(fname, fname_size, "%.*s.ctex", (int)entry->name.size, entry->name.data);
+			
+			MemoryCopy(data, &header, sizeof(header));
+			MemoryCopy(data + sizeof(header), entry->data.data, entry->data.size);
+			
+			if (!WriteWholeFile(fname, data, size))
+			{
+				fprintf(stderr, "could not write output file \"%s\".\n", fname);
+				return 1;
+			}
+		}
+		
+		fprintf(stderr, "wrote %i cooked textures.\n", entry_count);
+		return 0;
+	}
+	
+	// NOTE(ljre): Build the whole pack in memory and write it out in one go.
+	uintsize max_size = UPak_CalcMaxSize(entries, entry_count);
+	uint8* data = ArenaPushDirtyAligned(arena, max_size, UPak_BlobAlignment);
+	uintsize size = UPak_Write(entries, entry_count, data, max_size);
+	
+	if (!size)
+	{
+		fprintf(stderr, "the same asset was given more than once.\n");
+		return 1;
+	}
+	
+	if (!WriteWholeFile(output_fname, data, size))
+	{
+		fprintf(stderr, "could not write output file \"%s\".\n", output_fname);
+		return 1;
+	}
+	
+	fprintf(stderr, "wrote %i assets, %zu bytes, to \"%s\".\n", entry_count, (size_t)size, output_fname);
+	return 0;
+}
@@ -0,0 +1,110 @@
+#include "api_engine.h"
+#include "util_qoi.h"
+#include "util_assetpack.h"
+#include "util_audiomix.h"
+#include "util_audiodsp.h"
+
+static E_GlobalData* engine;
+
+static Arena* g_report_arena;
+
+static void
+B_Printf(const char* fmt, ...)
+{
+	if (!g_report_arena)
+		g_report_arena = ArenaCreate(16ull << 20, 64ull << 10);
+	
+	va_list args;
+	va_start(args, fmt);
+	String str = ArenaVPrintf(g_report_arena, fmt, args);
+	va_end(args);
+	
+	// NOTE(ljre): Drop the null terminator so the whole arena is one contiguous report.
+	ArenaPop(g_report_arena, (void*)(str.data + str.size));
+	OS_DebugLog("%S", str);
+}
+
+static float64
+B_TicksToSeconds(uint64 ticks)
+{
+	uint64 frequency;
+	OS_CurrentTick(&frequency);
+	
+	return (float64)ticks / (float64)frequency;
+}
+
+#include "bench_jobs.c"
+#include "bench_assets.c"
+#include "bench_pack.c"
+#include "bench_qoi.c"
+#include "bench_audio.c"
+#include "bench_mix.c"
+#include "bench_dsp.c"
+#include "bench_mixer.c"
+#include "bench_rects.c"
+#include "bench_raster.c"
+#include "bench_deferred.c"
+
+struct B_Mode
+{
+	String name;
+	void (*proc)(void);
+}
+typedef B_Mode;
+
+static const B_Mode g_bench_modes[] = {
+	{ StrInit("jobs"), B_RunJobs },
+	{ StrInit("assets"), B_RunAssets },
+	{ StrInit("pack"), B_RunPack },
+	{ StrInit("qoi"), B_RunQoi },
+	{ StrInit("audio"), B_RunAudio },
+	{ StrInit("mix"), B_RunMix },
+	{ StrInit("dsp"), B_RunDsp },
+	{ StrInit("mixer"), B_RunMixer },
+	{ StrInit("rects"), B_RunRects },
+	{ StrInit("raster"), B_RunRaster },
+	{ StrInit("deferred"), B_RunDeferred },
+};
+
+//~ NOTE(ljre): Entry point
+API void
+G_Main(E_GlobalData* data)
+{
+	Trace();
+	
+	engine = data;
+	
+	// NOTE(ljre): Every non-flag argument selects a benchmark to run. No arguments means run all of them.
+	bool ran_any = false;
+	
+	for (int32 i = 1; i < engine->argc; ++i)
+	{
+		String arg = StrMake(MemoryStrlen(engine->argv[i]), engine->argv[i]);
+		
+		if (arg.size > 0 && arg.data[0] == '-')
+			continue;
+		
+		for (intsize j = 0; j < ArrayLength(g_bench_modes); ++j)
+		{
+			if (StringEquals(arg, g_bench_modes[j].name))
+			{
+				B_Printf("==== %S ====\n", g_bench_modes[j].name);
+				g_bench_modes[j].proc();
+				ran_any = true;
+			}
+		}
+	}
+	
+	if (!ran_any)
+	{
+		for (intsize j = 0; j < ArrayLength(g_bench_modes); ++j)
+		{
+			B_Printf("==== %S ====\n", g_bench_modes[j].name);
+			g_bench_modes[j].proc();
+		}
+	}
+	
+	if (g_report_arena)
+		OS_WriteEntireFile(Str("bench_results.txt"), g_report_arena->memory, g_report_arena->offset);
+	engine->running = false;
+}
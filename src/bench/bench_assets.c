@@ -0,0 +1,57 @@
+enum
+{
+	B_AssetsTextureCount = 500,
+};
+
+static const String g_assets_textures[] = {
+	StrInit("assets/base_texture.png"),
+	StrInit("assets/pexe.png"),
+};
+
+static void
+B_RunAssets(void)
+{
+	Trace();
+	
+	const int32 max_workers = (int32)engine->worker_thread_count;
+	B_Printf("texture group: %i textures\n", (int32)B_AssetsTextureCount);
+	
+	for (int32 workers = 0; workers <= max_workers; ++workers)
+	{
+		E_SetActiveWorkerCount(workers);
+		
+		for ArenaTempScope(engine->persistent_arena)
+		{
+			E_AssetInfo* infos = ArenaPushArray(engine->persistent_arena, E_AssetInfo, B_AssetsTextureCount);
+			
+			for (int32 i = 0; i < B_AssetsTextureCount; ++i)
+			{
+				infos[i].filepath = g_assets_textures[i % ArrayLength(g_assets_textures)];
+				infos[i].name = infos[i].filepath;
+			}
+			
+			E_AssetGroup group = {
+				.arena = engine->persistent_arena,
+				.tex2d_count = B_AssetsTextureCount,
+				.tex2ds_info = infos,
+			};
+			
+			E_LoadAssets(&group, engine->scratch_arena);
+			
+			float64 decode_seconds = B_TicksToSeconds(group.decode_ticks);
+			float64 upload_seconds = B_TicksToSeconds(group.upload_ticks);
+			float64 megabytes = (float64)group.decoded_bytes / (1024.0 * 1024.0);
+			
+			B_Printf("threads: %i | decode: %.3fs (%.1f MiB/s, %.1f MiB/s per thread) | upload: %.3fs\n",
+				workers + 1,
+				decode_seconds,
+				megabytes / decode_seconds,
+				megabytes / decode_seconds / (workers + 1),
+				upload_seconds);
+			
+			E_UnloadAssets(&group);
+		}
+	}
+	
+	E_SetActiveWorkerCount(max_workers);
+}
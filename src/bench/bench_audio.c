@@ -0,0 +1,116 @@
+enum
+{
+	B_AudioFrameCount = 300,
+	B_AudioCallsPerFrame = 200, // NOTE(ljre): Each call is a stop, a play and a query.
+	B_AudioVoiceCount = 1024, // NOTE(ljre): Way past E_Limits_MaxMixedSounds, most of them are virtual.
+	B_AudioFrameLength = E_Limits_OfflineAudioSampleRate / 60, // NOTE(ljre): In frames of audio, for -offline-audio.
+};
+
+static void
+B_RunAudio(void)
+{
+	Trace();
+	
+	Buffer music_ogg, luigi_ogg;
+	E_SoundHandle music, luigi;
+	
+	if (!OS_MapFile(Str("assets/music.ogg"), NULL, &music_ogg) || !OS_MapFile(Str("assets/luigi.ogg"), NULL, &luigi_ogg))
+	{
+		B_Printf("could not map the sounds in assets/, skipping.\n");
+		return;
+	}
+	
+	if (!E_LoadSound(music_ogg, &music, NULL) || !E_LoadSound(luigi_ogg, &luigi, NULL))
+	{
+		B_Printf("no audio device, skipping.\n");
+		return;
+	}
+	
+	E_AudioStats before;
+	E_QueryAudioStats(&before);
+	
+	E_PlayingSoundHandle music_playing;
+	E_PlayingSoundHandle voices[B_AudioVoiceCount] = { 0 };
+	int32 next_voice = 0;
+	int32 play_count = 0;
+	int32 failed_play_count = 0;
+	uint64 calls_ticks = 0;
+	uint64 worst_calls_ticks = 0;
+	int16 offline_chunk[B_AudioFrameLength * E_Limits_OfflineAudioChannels];
+	
+	E_PlaySound(music, &(E_PlaySoundOptions) { .volume = 0.1f, .priority = 4 }, &music_playing);
+	
+	uint64 begin = OS_CurrentTick(NULL);
+	for (int32 frame = 0; frame < B_AudioFrameCount; ++frame)
+	{
+		E_AudioStats frame_stats;
+		E_QueryAudioStats(&frame_stats);
+		
+		uint64 calls_begin = OS_CurrentTick(NULL);
+		
+		for (int32 i = 0; i < B_AudioCallsPerFrame; ++i)
+		{
+			E_PlayingSoundHandle* voice = &voices[next_voice];
+			E_PlayingSoundInfo info;
+			E_PlaySoundOptions options = {
+				.volume = 0.001f + 0.0001f * (float32)(next_voice % 64),
+				.priority = next_voice % 4,
+			};
+			
+			next_voice = (next_voice + 1) % B_AudioVoiceCount;
+			E_StopSound(*voice);
+			
+			if (E_PlaySound(luigi, &options, voice))
+				++play_count;
+			else
+				++failed_play_count;
+			
+			E_QueryPlayingSoundInfo(music_playing, &info);
+		}
+		
+		uint64 calls_end = OS_CurrentTick(NULL);
+		calls_ticks += calls_end - calls_begin;
+		worst_calls_ticks = Max(worst_calls_ticks, calls_end - calls_begin);
+		
+		E_FinishFrame();
+		
+		// NOTE(ljre): Without vsync the frames would outrun the mixer and fill its command ring, so every frame
+		//             waits for a mix to take its commands in. With -offline-audio, that mix is rendered here.
+		if (!E_RenderAudio(offline_chunk, B_AudioFrameLength))
+		{
+			uint32 mix_count = frame_stats.mix_count;
+			
+			while (E_QueryAudioStats(&frame_stats) && frame_stats.mix_count == mix_count)
+				E_RunThreadWork(NULL, engine->thread_work_queue);
+		}
+	}
+	uint64 end = OS_CurrentTick(NULL);
+	
+	E_AudioStats after;
+	E_QueryAudioStats(&after);
+	
+	B_Printf("%i frames, %i plays (%i failed) | %.3fs | calls per frame: avg %.3fms, worst %.3fms\n",
+		(int32)B_AudioFrameCount,
+		play_count,
+		failed_play_count,
+		B_TicksToSeconds(end - begin),
+		B_TicksToSeconds(calls_ticks) * 1000.0 / B_AudioFrameCount,
+		B_TicksToSeconds(worst_calls_ticks) * 1000.0);
+	B_Printf("voices: %i playing, %i mixed\n", after.playing_count, after.mixed_count);
+	B_Printf("mixes: %u | worst mix: %.3fms for %.3fms of audio | late mixes: %i | stream underruns: %i | dropped plays: %i\n",
+		after.mix_count - before.mix_count,
+		after.worst_mix_time * 1000.0f,
+		after.last_mix_length * 1000.0f,
+		after.late_mix_count - before.late_mix_count,
+		after.stream_underrun_count - before.stream_underrun_count,
+		after.dropped_play_count - before.dropped_play_count);
+	
+	if (after.late_mix_count != before.late_mix_count || after.stream_underrun_count != before.stream_underrun_count)
+		B_Printf("  AUDIO UNDERRUNS!\n");
+	if (after.dropped_play_count != before.dropped_play_count)
+		B_Printf("  PLAYS DROPPED BY A FULL COMMAND RING!\n");
+	
+	E_StopAllSounds(NULL);
+	E_UnloadSound(luigi);
+	E_UnloadSound(music);
+}
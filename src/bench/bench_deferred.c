@@ -0,0 +1,262 @@
+enum
+{
+	B_DeferredPassCount = 8,
+	B_DeferredObjectsPerPass = 4096,
+	B_DeferredIterations = 10,
+};
+
+struct B_DeferredUniforms_
+{
+	mat4 mvp;
+	vec4 color;
+}
+typedef B_DeferredUniforms_;
+
+struct B_DeferredScene_
+{
+	RB_Shader shader;
+	RB_Pipeline pipeline;
+	RB_VBuffer vbuffer;
+	RB_IBuffer ibuffer;
+	RB_UBuffer ubuffers[B_DeferredPassCount];
+}
+typedef B_DeferredScene_;
+
+struct B_DeferredJob_
+{
+	const B_DeferredScene_* scene;
+	RB_Ctx* ctx;
+	int32 pass;
+}
+typedef B_DeferredJob_;
+
+// NOTE(ljre): Stands in for traversing a scene: every object gets a transform, its uniforms and a draw of its own.
+static void
+B_DeferredRecordPass_(RB_Ctx* ctx, const B_DeferredScene_* scene, int32 pass)
+{
+	mat4 view;
+	glm_perspective(glm_rad(60.0f), 16.0f / 9.0f, 0.1f, 100.0f, view);
+	
+	RB_CmdApplyPipeline(ctx, scene->pipeline);
+	
+	for (int32 i = 0; i < B_DeferredObjectsPerPass; ++i)
+	{
+		uint64 random = HashInt64((uint64)pass << 32 | (uint64)i);
+		B_DeferredUniforms_ uniforms;
+		mat4 model;
+		
+		glm_translate_make(model, (vec3) { (random & 1023) / 64.0f - 8.0f, (random>>10 & 1023) / 64.0f - 8.0f, -(float32)(random>>20 & 63) - 1.0f });
+		glm_rotate(model, (random>>26 & 511) / 512.0f * (float32)Math_PI*2, (vec3) { 0.0f, 0.0f, 1.0f });
+		glm_mat4_mul(view, model, uniforms.mvp);
+		glm_vec4_copy((vec4) { (random>>35 & 255) / 255.0f, (random>>43 & 255) / 255.0f, (random>>51 & 255) / 255.0f, 1.0f }, uniforms.color);
+		
+		RB_UpdateUniformBuffer(ctx, scene->ubuffers[pass], BufMake(sizeof(uniforms), &uniforms));
+		RB_CmdDraw(ctx, &(RB_DrawDesc) {
+			.ibuffer = scene->ibuffer,
+			.ubuffer = scene->ubuffers[pass],
+			.vbuffers[0] = scene->vbuffer,
+			.strides[0] = sizeof(vec2),
+			.index_count = 6,
+		});
+	}
+}
+
+static void
+B_DeferredRecordPassAsync_(E_ThreadCtx* ctx, void* data)
+{
+	B_DeferredJob_* job = data;
+	B_DeferredRecordPass_(job->ctx, job->scene, job->pass);
+}
+
+static bool
+B_DeferredSameCalls_(RB_NullStats a, RB_NullStats b)
+{
+	if (a.call_count != b.call_count)
+		return false;
+	
+	// NOTE(ljre): 'frame_index' is different, and only draws have a desc worth comparing here.
+	for (intsize i = 0; i < a.call_count; ++i)
+	{
+		const RB_NullCall* left = &a.calls[i];
+		const RB_NullCall* right = &b.calls[i];
+		
+		if (left->kind != right->kind || left->resource != right->resource || left->handle != right->handle || left->size != right->size)
+			return false;
+		if (left->kind == RB_NullCallKind_Draw && MemoryCompare(&left->draw, &right->draw, sizeof(RB_DrawDesc)) != 0)
+			return false;
+	}
+	
+	return true;
+}
+
+static void
+B_RunDeferred(void)
+{
+	Trace();
+	
+	RB_Ctx* rb = engine->renderbackend;
+	
+	// NOTE(ljre): The shaders below only mean something to the null backend, and so does comparing the calls.
+	if (!StringEquals(RB_QueryCapabilities(rb).backend_api, Str("Null")))
+	{
+		B_Printf("only works with the null render backend, skipping.\n");
+		return;
+	}
+	
+	//- Scene
+	static const vec2 vertices[] = { { -0.5f, -0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f }, { -0.5f, 0.5f } };
+	static const uint16 indices[] = { 0, 1, 2, 2, 3, 0 };
+	B_DeferredScene_ scene = { 0 };
+	
+	scene.shader = RB_MakeShader(rb, &(RB_ShaderDesc) {
+		.glsl = {
+			.vs = StrInit("void main() {}"),
+			.fs = StrInit("void main() {}"),
+		},
+	});
+	scene.pipeline = RB_MakePipeline(rb, &(RB_PipelineDesc) {
+		.flag_depth_test = true,
+		.cull_mode = RB_CullMode_Back,
+		
+		.shader = scene.shader,
+		.input_layout[0] = {
+			.format = RB_VertexFormat_Vec2,
+		},
+	});
+	scene.vbuffer = RB_MakeVertexBuffer(rb, &(RB_VBufferDesc) {
+		.initial_data = vertices,
+		.size = sizeof(vertices),
+	});
+	scene.ibuffer = RB_MakeIndexBuffer(rb, &(RB_IBufferDesc) {
+		.initial_data = indices,
+		.size = sizeof(indices),
+		.index_type = RB_IndexType_Uint16,
+	});
+	
+	for (int32 i = 0; i < B_DeferredPassCount; ++i)
+	{
+		scene.ubuffers[i] = RB_MakeUniformBuffer(rb, &(RB_UBufferDesc) {
+			.size = sizeof(B_DeferredUniforms_),
+		});
+	}
+	
+	//- Contexts
+	Arena* deferred_arenas[B_DeferredPassCount];
+	RB_Ctx* deferred[B_DeferredPassCount];
+	B_DeferredJob_ jobs[B_DeferredPassCount];
+	
+	for (int32 i = 0; i < B_DeferredPassCount; ++i)
+	{
+		deferred_arenas[i] = ArenaCreate(256 << 20, 1 << 20);
+		deferred[i] = RB_MakeDeferredContext(rb, deferred_arenas[i]);
+		jobs[i] = (B_DeferredJob_) {
+			.scene = &scene,
+			.ctx = deferred[i],
+			.pass = i,
+		};
+	}
+	
+	Arena* direct_calls = ArenaCreate(1ull << 30, 1 << 20);
+	Arena* deferred_calls = ArenaCreate(1ull << 30, 1 << 20);
+	const int32 max_workers = (int32)engine->worker_thread_count;
+	
+	B_Printf("%i passes, %i objects per pass, %i iterations\n", (int32)B_DeferredPassCount, (int32)B_DeferredObjectsPerPass, (int32)B_DeferredIterations);
+	
+	for (int32 workers = 0; workers <= max_workers; ++workers)
+	{
+		E_SetActiveWorkerCount(workers);
+		
+		uint64 direct = 0, record = 0, submit = 0;
+		bool same = true;
+		
+		for (int32 it = 0; it < B_DeferredIterations; ++it)
+		{
+			//- Every pass recorded by the main thread, straight into the backend
+			ArenaClear(direct_calls);
+			RB_RecordNullCalls(rb, direct_calls);
+			RB_BeginCmd(rb, &(RB_BeginDesc) {
+				.viewport_width = engine->os->window.width,
+				.viewport_height = engine->os->window.height,
+			});
+			
+			uint64 begin = OS_CurrentTick(NULL);
+			for (int32 i = 0; i < B_DeferredPassCount; ++i)
+				B_DeferredRecordPass_(rb, &scene, i);
+			uint64 end = OS_CurrentTick(NULL);
+			
+			RB_EndCmd(rb);
+			RB_RecordNullCalls(rb, NULL);
+			RB_NullStats direct_stats = RB_QueryNullStats(rb);
+			RB_Present(rb);
+			
+			direct += end - begin;
+			
+			//- Every pass recorded by a job into its deferred context, then submitted in order
+			ArenaClear(deferred_calls);
+			RB_RecordNullCalls(rb, deferred_calls);
+			RB_BeginCmd(rb, &(RB_BeginDesc) {
+				.viewport_width = engine->os->window.width,
+				.viewport_height = engine->os->window.height,
+			});
+			
+			E_ThreadCounter counter = { 0 };
+			begin = OS_CurrentTick(NULL);
+			
+			for (int32 i = 0; i < B_DeferredPassCount; ++i)
+			{
+				E_QueueThreadWork(&(E_ThreadWork) {
+					.callback = B_DeferredRecordPassAsync_,
+					.data = &jobs[i],
+					.counter = &counter,
+				});
+			}
+			
+			E_WaitThreadCounter(&counter);
+			uint64 recorded = OS_CurrentTick(NULL);
+			
+			for (int32 i = 0; i < B_DeferredPassCount; ++i)
+				RB_SubmitDeferredContext(rb, deferred[i]);
+			end = OS_CurrentTick(NULL);
+			
+			RB_EndCmd(rb);
+			RB_RecordNullCalls(rb, NULL);
+			RB_NullStats deferred_stats = RB_QueryNullStats(rb);
+			RB_Present(rb);
+			
+			record += recorded - begin;
+			submit += end - recorded;
+			same &= B_DeferredSameCalls_(direct_stats, deferred_stats);
+		}
+		
+		float64 direct_ms = B_TicksToSeconds(direct) * 1000.0 / B_DeferredIterations;
+		float64 record_ms = B_TicksToSeconds(record) * 1000.0 / B_DeferredIterations;
+		float64 submit_ms = B_TicksToSeconds(submit) * 1000.0 / B_DeferredIterations;
+		
+		B_Printf("threads: %i | direct: %.3fms | deferred: record %.3fms, submit %.3fms (%.2fx)\n",
+			workers + 1,
+			direct_ms,
+			record_ms,
+			submit_ms,
+			direct_ms / (record_ms + submit_ms));
+		
+		if (!same)
+			B_Printf("           | DEFERRED CALLS DIFFER FROM THE DIRECT ONES!\n");
+	}
+	
+	E_SetActiveWorkerCount(max_workers);
+	
+	ArenaDestroy(deferred_calls);
+	ArenaDestroy(direct_calls);
+	
+	for (int32 i = 0; i < B_DeferredPassCount; ++i)
+	{
+		RB_FreeContext(deferred[i]);
+		ArenaDestroy(deferred_arenas[i]);
+		RB_FreeUniformBuffer(rb, scene.ubuffers[i]);
+	}
+	
+	RB_FreeIndexBuffer(rb, scene.ibuffer);
+	RB_FreeVertexBuffer(rb, scene.vbuffer);
+	RB_FreePipeline(rb, scene.pipeline);
+	RB_FreeShader(rb, scene.shader);
+}
@@ -0,0 +1,249 @@
+enum
+{
+	B_DspSampleRate = 48000,
+	B_DspFrameCount = 48000, // NOTE(ljre): One second per test signal.
+	B_DspIterations = 50,
+};
+
+static bool g_dsp_failed;
+
+static void
+B_DspCheck_(bool ok, const char* fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	String str = ArenaVPrintf(engine->scratch_arena, fmt, args);
+	va_end(args);
+	
+	B_Printf("  %s %S\n", ok ? "ok  " : "FAIL", str);
+	g_dsp_failed |= !ok;
+}
+
+static void
+B_DspSine_(float32* out, int32 channels, int32 frame_count, float32 frequency, float32 amplitude)
+{
+	for (int32 i = 0; i < frame_count; ++i)
+	{
+		float32 value = amplitude * (float32)sin(2.0 * Math_PI_64 * frequency * i / B_DspSampleRate);
+		
+		for (int32 ch = 0; ch < channels; ++ch)
+			out[i*channels + ch] = value;
+	}
+}
+
+// NOTE(ljre): Peak of the second half of a mono signal, after the filters settled.
+static float32
+B_DspTailPeak_(const float32* samples, int32 frame_count)
+{
+	float32 peak = 0.0f;
+	
+	for (int32 i = frame_count / 2; i < frame_count; ++i)
+		peak = Max(peak, fabsf(samples[i]));
+	
+	return peak;
+}
+
+static void
+B_RunDsp(void)
+{
+	Trace();
+	
+	g_dsp_failed = false;
+	
+	for ArenaTempScope(engine->scratch_arena)
+	{
+		Arena* arena = engine->scratch_arena;
+		float32* mono = ArenaPushAligned(arena, sizeof(float32) * B_DspFrameCount, 64);
+		float32* stereo = ArenaPushAligned(arena, sizeof(float32) * B_DspFrameCount * 2, 64);
+		float32* other = ArenaPushAligned(arena, sizeof(float32) * B_DspFrameCount * 2, 64);
+		
+		//- Biquad
+		{
+			UDsp_Biquad biquad = { 0 };
+			UDsp_SetBiquad(&biquad, UDsp_BiquadKind_LowPass, B_DspSampleRate, 1000.0f, 0.0f, 0.0f);
+			
+			B_DspSine_(mono, 1, B_DspFrameCount, 100.0f, 1.0f);
+			UDsp_ProcessBiquad(&biquad, mono, 1, B_DspFrameCount);
+			float32 pass = B_DspTailPeak_(mono, B_DspFrameCount);
+			
+			biquad = (UDsp_Biquad) { 0 };
+			UDsp_SetBiquad(&biquad, UDsp_BiquadKind_LowPass, B_DspSampleRate, 1000.0f, 0.0f, 0.0f);
+			B_DspSine_(mono, 1, B_DspFrameCount, 10000.0f, 1.0f);
+			UDsp_ProcessBiquad(&biquad, mono, 1, B_DspFrameCount);
+			float32 stop = B_DspTailPeak_(mono, B_DspFrameCount);
+			
+			B_DspCheck_(fabsf(pass - 1.0f) < 0.01f, "lowpass 1kHz: 100Hz comes out at %.4f", pass);
+			B_DspCheck_(stop < 0.02f, "lowpass 1kHz: 10kHz comes out at %.4f (%.1fdB)", stop, 20.0 * log10(stop));
+		}
+		
+		//- Gain smoothing
+		{
+			// NOTE(ljre): A constant signal with the gain going from 1 to 0 and back, changed every block the way a bus
+			//             does. A step change would jump by the whole signal in one sample.
+			float32 gain = 1.0f;
+			float32 worst_jump = 0.0f;
+			float32 last = 1.0f;
+			
+			for (int32 frame = 0; frame < B_DspFrameCount; frame += E_Limits_AudioBlockFrames)
+			{
+				int32 count = Min(E_Limits_AudioBlockFrames, B_DspFrameCount - frame);
+				float32 target = (frame < B_DspFrameCount / 2) ? 0.0f : 1.0f;
+				float32 next = UDsp_SmoothGain(gain, target, count, B_DspSampleRate, 0.01f);
+				
+				for (int32 i = 0; i < count; ++i)
+					mono[frame + i] = 1.0f;
+				
+				UDsp_ApplyGainRamp(mono + frame, 1, count, gain, next);
+				gain = next;
+				
+				for (int32 i = 0; i < count; ++i)
+				{
+					worst_jump = Max(worst_jump, fabsf(mono[frame + i] - last));
+					last = mono[frame + i];
+				}
+			}
+			
+			B_DspCheck_(worst_jump < 0.01f && gain == 1.0f, "gain smoothing: worst step between samples is %.5f", worst_jump);
+		}
+		
+		//- Limiter
+		{
+			UDsp_Compressor limiter = { 0 };
+			UDsp_SetCompressor(&limiter, B_DspSampleRate, -6.0f, INFINITY, 0.0f, 0.05f, 0.0f);
+			
+			B_DspSine_(stereo, 2, B_DspFrameCount, 440.0f, 2.0f);
+			UDsp_ProcessCompressor(&limiter, stereo, 2, B_DspFrameCount);
+			
+			float32 peak = 0.0f;
+			for (int32 i = 0; i < B_DspFrameCount * 2; ++i)
+				peak = Max(peak, fabsf(stereo[i]));
+			
+			B_DspCheck_(peak <= powf(10.0f, -6.0f / 20.0f) + 1e-5f, "limiter at -6dB: peak is %.4f (%.2fdB)", peak, 20.0 * log10(peak));
+		}
+		
+		//- Compressor
+		{
+			// NOTE(ljre): 0dB into 4:1 above -20dB should settle at -20 + 20/4 = -15dB.
+			UDsp_Compressor comp = { 0 };
+			UDsp_SetCompressor(&comp, B_DspSampleRate, -20.0f, 4.0f, 0.005f, 0.2f, 0.0f);
+			
+			B_DspSine_(mono, 1, B_DspFrameCount, 440.0f, 1.0f);
+			UDsp_ProcessCompressor(&comp, mono, 1, B_DspFrameCount);
+			
+			float32 db = 20.0f * log10f(B_DspTailPeak_(mono, B_DspFrameCount));
+			B_DspCheck_(fabsf(db + 15.0f) < 1.0f, "compressor 4:1 at -20dB: 0dB settles at %.2fdB", db);
+		}
+		
+		//- Reverb
+		{
+			UDsp_Reverb reverb;
+			UDsp_InitReverb(&reverb, arena, 2, B_DspSampleRate);
+			UDsp_SetReverb(&reverb, 0.5f, 0.5f, 1.0f);
+			
+			MemoryZero(stereo, sizeof(float32) * B_DspFrameCount * 2);
+			stereo[0] = stereo[1] = 1.0f;
+			UDsp_ProcessReverb(&reverb, stereo, 2, B_DspFrameCount);
+			
+			float64 quarters[4] = { 0 };
+			bool finite = true;
+			
+			for (int32 i = 0; i < B_DspFrameCount * 2; ++i)
+			{
+				finite &= isfinite(stereo[i]);
+				quarters[i * 4 / (B_DspFrameCount * 2)] += stereo[i] * stereo[i];
+			}
+			
+			bool decays = quarters[0] > 0.0 && quarters[1] < quarters[0] && quarters[2] < quarters[1] && quarters[3] < quarters[2];
+			B_DspCheck_(finite && decays, "reverb impulse: energy per quarter second %.1fdB %.1fdB %.1fdB %.1fdB",
+				10.0 * log10(quarters[0]), 10.0 * log10(quarters[1]), 10.0 * log10(quarters[2]), 10.0 * log10(quarters[3]));
+		}
+		
+		//- Block size independence
+		{
+			// NOTE(ljre): The whole chain over one block must match the same chain over blocks of random sizes.
+			UDsp_Biquad biquads[2] = { 0 };
+			UDsp_Reverb reverbs[2];
+			UDsp_Compressor comps[2] = { 0 };
+			uint32 seed = 1;
+			
+			for (int32 i = 0; i < B_DspFrameCount * 2; ++i)
+			{
+				seed = seed * 1664525u + 1013904223u;
+				stereo[i] = (float32)(seed >> 8) / 8388608.0f - 1.0f;
+			}
+			
+			MemoryCopy(other, stereo, sizeof(float32) * B_DspFrameCount * 2);
+			
+			for (int32 i = 0; i < 2; ++i)
+			{
+				UDsp_SetBiquad(&biquads[i], UDsp_BiquadKind_Peaking, B_DspSampleRate, 2000.0f, 2.0f, 6.0f);
+				UDsp_InitReverb(&reverbs[i], arena, 2, B_DspSampleRate);
+				UDsp_SetReverb(&reverbs[i], 0.8f, 0.2f, 0.3f);
+				UDsp_SetCompressor(&comps[i], B_DspSampleRate, -12.0f, 8.0f, 0.001f, 0.1f, 3.0f);
+			}
+			
+			UDsp_ProcessBiquad(&biquads[0], stereo, 2, B_DspFrameCount);
+			UDsp_ProcessReverb(&reverbs[0], stereo, 2, B_DspFrameCount);
+			UDsp_ProcessCompressor(&comps[0], stereo, 2, B_DspFrameCount);
+			
+			for (int32 frame = 0; frame < B_DspFrameCount;)
+			{
+				seed = seed * 1664525u + 1013904223u;
+				int32 count = Min((int32)(seed >> 16) % E_Limits_AudioBlockFrames + 1, B_DspFrameCount - frame);
+				float32* block = other + frame*2;
+				
+				UDsp_ProcessBiquad(&biquads[1], block, 2, count);
+				UDsp_ProcessReverb(&reverbs[1], block, 2, count);
+				UDsp_ProcessCompressor(&comps[1], block, 2, count);
+				frame += count;
+			}
+			
+			B_DspCheck_(MemoryCompare(stereo, other, sizeof(float32) * B_DspFrameCount * 2) == 0, "block size independence: filter -> reverb -> compressor");
+		}
+		
+		//- Timings
+		{
+			UDsp_Biquad biquad = { 0 };
+			UDsp_Reverb reverb;
+			UDsp_Compressor comp = { 0 };
+			
+			UDsp_SetBiquad(&biquad, UDsp_BiquadKind_LowPass, B_DspSampleRate, 5000.0f, 0.0f, 0.0f);
+			UDsp_InitReverb(&reverb, arena, 2, B_DspSampleRate);
+			UDsp_SetReverb(&reverb, 0.5f, 0.5f, 0.3f);
+			UDsp_SetCompressor(&comp, B_DspSampleRate, -12.0f, 4.0f, 0.005f, 0.1f, 0.0f);
+			
+			uint64 ticks[3] = { 0 };
+			
+			for (int32 it = 0; it < B_DspIterations; ++it)
+			{
+				for (int32 frame = 0; frame < B_DspFrameCount; frame += E_Limits_AudioBlockFrames)
+				{
+					int32 count = Min(E_Limits_AudioBlockFrames, B_DspFrameCount - frame);
+					float32* block = stereo + frame*2;
+					uint64 t0 = OS_CurrentTick(NULL);
+					UDsp_ProcessBiquad(&biquad, block, 2, count);
+					uint64 t1 = OS_CurrentTick(NULL);
+					UDsp_ProcessReverb(&reverb, block, 2, count);
+					uint64 t2 = OS_CurrentTick(NULL);
+					UDsp_ProcessCompressor(&comp, block, 2, count);
+					uint64 t3 = OS_CurrentTick(NULL);
+					
+					ticks[0] += t1 - t0;
+					ticks[1] += t2 - t1;
+					ticks[2] += t3 - t2;
+				}
+			}
+			
+			static const String names[] = { StrInit("biquad    "), StrInit("reverb    "), StrInit("compressor") };
+			
+			for (intsize i = 0; i < ArrayLength(names); ++i)
+			{
+				float64 ms = B_TicksToSeconds(ticks[i]) * 1000.0 / B_DspIterations;
+				B_Printf("  %S | %.3fms per second of stereo audio in blocks of %i\n", names[i], ms, (int32)E_Limits_AudioBlockFrames);
+			}
+		}
+	}
+	
+	if (g_dsp_failed)
+		B_Printf("  DSP CHECKS FAILED!\n");
+}
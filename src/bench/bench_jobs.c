@@ -0,0 +1,140 @@
+enum
+{
+	B_JobsLeafIterations = 64,
+	B_JobsFlatBatchSize = 1000,
+	B_JobsFlatBatchCount = 200,
+	B_JobsSpawnerCount = 64,
+	B_JobsSpawnedPerSpawner = 512,
+	B_JobsSpawnRounds = 8,
+};
+
+static volatile uint64 g_jobs_sink[64];
+static E_ThreadCounter g_jobs_counter;
+
+static void
+B_JobsLeaf_(E_ThreadCtx* ctx, void* data)
+{
+	uint64 x = (uint64)(uintptr)data;
+	
+	for (int32 i = 0; i < B_JobsLeafIterations; ++i)
+		x = HashInt64(x);
+	
+	g_jobs_sink[ctx->id % ArrayLength(g_jobs_sink)] += x;
+}
+
+static void
+B_JobsSpawner_(E_ThreadCtx* ctx, void* data)
+{
+	uintptr base = (uintptr)data * B_JobsSpawnedPerSpawner;
+	
+	for (int32 i = 0; i < B_JobsSpawnedPerSpawner; ++i)
+	{
+		E_QueueThreadWork(&(E_ThreadWork) {
+			.callback = B_JobsLeaf_,
+			.data = (void*)(base + i),
+			.counter = &g_jobs_counter,
+		});
+	}
+}
+
+// NOTE(ljre): Same as B_JobsSpawner_, but waits for its children before finishing. In fiber mode, this suspends.
+static void
+B_JobsNestedSpawner_(E_ThreadCtx* ctx, void* data)
+{
+	uintptr base = (uintptr)data * B_JobsSpawnedPerSpawner;
+	E_ThreadCounter children = { 0 };
+	
+	for (int32 i = 0; i < B_JobsSpawnedPerSpawner; ++i)
+	{
+		E_QueueThreadWork(&(E_ThreadWork) {
+			.callback = B_JobsLeaf_,
+			.data = (void*)(base + i),
+			.counter = &children,
+		});
+	}
+	
+	E_WaitThreadCounter(&children);
+}
+
+static void
+B_RunJobs(void)
+{
+	Trace();
+	
+	const int32 max_workers = (int32)engine->worker_thread_count;
+	B_Printf("worker threads available: %i (+ main thread)\n", max_workers);
+	B_Printf("fiber mode: %s\n", engine->thread_work_queue->fibers_enabled ? "on" : "off (pass -job-fibers)");
+	
+	for (int32 workers = 0; workers <= max_workers; ++workers)
+	{
+		E_SetActiveWorkerCount(workers);
+		
+		//- Flat: main thread submits batches and waits for each of them
+		uint64 begin = OS_CurrentTick(NULL);
+		
+		for (int32 batch = 0; batch < B_JobsFlatBatchCount; ++batch)
+		{
+			for (int32 i = 0; i < B_JobsFlatBatchSize; ++i)
+			{
+				E_QueueThreadWork(&(E_ThreadWork) {
+					.callback = B_JobsLeaf_,
+					.data = (void*)(uintptr)(batch * B_JobsFlatBatchSize + i),
+					.counter = &g_jobs_counter,
+				});
+			}
+			
+			E_WaitThreadCounter(&g_jobs_counter);
+		}
+		
+		float64 flat_seconds = B_TicksToSeconds(OS_CurrentTick(NULL) - begin);
+		float64 flat_jobs = (float64)B_JobsFlatBatchCount * B_JobsFlatBatchSize;
+		
+		//- Spawn: jobs submit other jobs from whatever thread they're running on
+		begin = OS_CurrentTick(NULL);
+		
+		for (int32 round = 0; round < B_JobsSpawnRounds; ++round)
+		{
+			for (int32 i = 0; i < B_JobsSpawnerCount; ++i)
+			{
+				E_QueueThreadWork(&(E_ThreadWork) {
+					.callback = B_JobsSpawner_,
+					.data = (void*)(uintptr)(round * B_JobsSpawnerCount + i),
+					.counter = &g_jobs_counter,
+				});
+			}
+			
+			E_WaitThreadCounter(&g_jobs_counter);
+		}
+		
+		float64 spawn_seconds = B_TicksToSeconds(OS_CurrentTick(NULL) - begin);
+		float64 spawn_jobs = (float64)B_JobsSpawnRounds * B_JobsSpawnerCount * (1 + B_JobsSpawnedPerSpawner);
+		
+		//- Nested: same as spawn, but every spawner waits on its own children
+		begin = OS_CurrentTick(NULL);
+		
+		for (int32 round = 0; round < B_JobsSpawnRounds; ++round)
+		{
+			for (int32 i = 0; i < B_JobsSpawnerCount; ++i)
+			{
+				E_QueueThreadWork(&(E_ThreadWork) {
+					.callback = B_JobsNestedSpawner_,
+					.data = (void*)(uintptr)(round * B_JobsSpawnerCount + i),
+					.counter = &g_jobs_counter,
+				});
+			}
+			
+			E_WaitThreadCounter(&g_jobs_counter);
+		}
+		
+		float64 nested_seconds = B_TicksToSeconds(OS_CurrentTick(NULL) - begin);
+		
+		B_Printf("threads: %i | flat: %.0f jobs/s | spawn: %.0f jobs/s (%.0f per thread) | nested: %.0f jobs/s\n",
+			workers + 1,
+			flat_jobs / flat_seconds,
+			spawn_jobs / spawn_seconds,
+			spawn_jobs / spawn_seconds / (workers + 1),
+			spawn_jobs / nested_seconds);
+	}
+	
+	E_SetActiveWorkerCount(max_workers);
+}
@@ -0,0 +1,94 @@
+enum
+{
+	B_MixFrameCount = 1024, // NOTE(ljre): Output frames per voice, about what a device asks for per callback.
+	B_MixVoiceCount = 64,
+	B_MixIterations = 500,
+	B_MixSourceFrames = 48000,
+};
+
+static void
+B_BenchMixKernel_(String label, float32* out, const float32* source, int32 channels, float64 ratio, UMix_Quality quality, bool generic)
+{
+	uint64 step = UMix_MakeStep(ratio);
+	uint64 begin = OS_CurrentTick(NULL);
+	
+	for (int32 i = 0; i < B_MixIterations; ++i)
+	{
+		MemorySet(out, 0, sizeof(float32) * B_MixFrameCount * 2);
+		
+		for (int32 j = 0; j < B_MixVoiceCount; ++j)
+		{
+			// NOTE(ljre): Spread the voices over the source so they don't all hit the same cache lines.
+			UMix_Voice voice = {
+				.samples = source + (intsize)(j * 601) * channels,
+				.channels = channels,
+				.frame_count = B_MixFrameCount,
+				.phase = 0,
+				.step = step,
+				.volume = 1.0f / B_MixVoiceCount,
+				.quality = quality,
+			};
+			
+			if (generic)
+				UMix_MixVoiceGeneric(out, 2, &voice);
+			else
+				UMix_MixVoice(out, 2, &voice);
+		}
+	}
+	
+	uint64 end = OS_CurrentTick(NULL);
+	float64 ms = B_TicksToSeconds(end - begin) * 1000.0;
+	
+	B_Printf("  %S | %.3fms | %.1f voices/ms\n", label, ms, (float64)B_MixVoiceCount * B_MixIterations / ms);
+}
+
+static void
+B_RunMix(void)
+{
+	Trace();
+	
+	B_Printf("%i voices of %i frames into stereo, %i iterations\n", (int32)B_MixVoiceCount, (int32)B_MixFrameCount, (int32)B_MixIterations);
+	UMix_InitTables();
+	
+	for ArenaTempScope(engine->scratch_arena)
+	{
+		Arena* arena = engine->scratch_arena;
+		float32* out = ArenaPushAligned(arena, sizeof(float32) * B_MixFrameCount * 2, 64);
+		float32* source = ArenaPushAligned(arena, sizeof(float32) * (B_MixSourceFrames + UMix_PadFrames*2) * 2, 64);
+		uint32 seed = 1;
+		
+		for (int32 i = 0; i < (B_MixSourceFrames + UMix_PadFrames*2) * 2; ++i)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			source[i] = (float32)(seed >> 8) / 8388608.0f - 1.0f;
+		}
+		
+		// NOTE(ljre): The filters read a few frames before the first one.
+		source += UMix_PadFrames * 2;
+		
+		static const struct
+		{
+			String name;
+			int32 channels;
+			float64 ratio;
+			UMix_Quality quality;
+		}
+		cases[] = {
+			{ StrInit("mono -> stereo, same rate            "), 1, 1.0, UMix_Quality_Linear },
+			{ StrInit("mono -> stereo, 44.1k -> 48k, linear "), 1, 44100.0 / 48000.0, UMix_Quality_Linear },
+			{ StrInit("mono -> stereo, 44.1k -> 48k, sinc8  "), 1, 44100.0 / 48000.0, UMix_Quality_Sinc8 },
+			{ StrInit("mono -> stereo, 44.1k -> 48k, sinc32 "), 1, 44100.0 / 48000.0, UMix_Quality_Sinc32 },
+			{ StrInit("stereo -> stereo, same rate          "), 2, 1.0, UMix_Quality_Linear },
+			{ StrInit("stereo -> stereo, 44.1k->48k, linear "), 2, 44100.0 / 48000.0, UMix_Quality_Linear },
+			{ StrInit("stereo -> stereo, 44.1k->48k, sinc8  "), 2, 44100.0 / 48000.0, UMix_Quality_Sinc8 },
+			{ StrInit("stereo -> stereo, 44.1k->48k, sinc32 "), 2, 44100.0 / 48000.0, UMix_Quality_Sinc32 },
+		};
+		
+		for (intsize i = 0; i < ArrayLength(cases); ++i)
+		{
+			B_Printf("%S\n", cases[i].name);
+			B_BenchMixKernel_(Str("scalar"), out, source, cases[i].channels, cases[i].ratio, cases[i].quality, true);
+			B_BenchMixKernel_(Str("simd  "), out, source, cases[i].channels, cases[i].ratio, cases[i].quality, false);
+		}
+	}
+}
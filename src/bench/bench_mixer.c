@@ -0,0 +1,183 @@
+enum
+{
+	B_MixerSeconds = 10, // NOTE(ljre): Of audio rendered per case.
+	B_MixerChunkFrames = E_Limits_OfflineAudioSampleRate / 10, // NOTE(ljre): Finished voices are restarted between chunks.
+	B_MixerMaxVoices = 512,
+	B_MixerWavSeconds = 5,
+	B_MixerScheduleFrames = E_Limits_OfflineAudioSampleRate * 2,
+	B_MixerScheduleDelay = 1234, // NOTE(ljre): Odd on purpose, so it falls in the middle of a callback.
+};
+
+// NOTE(ljre): Keeps 'music_count' + 'luigi_count' voices playing for B_MixerSeconds and returns how many were started.
+static int32
+B_MixerRenderVoices_(int16* chunk, E_SoundHandle music, int32 music_count, E_SoundHandle luigi, int32 luigi_count)
+{
+	E_PlayingSoundHandle voices[B_MixerMaxVoices] = { 0 };
+	int32 voice_count = Min(music_count + luigi_count, B_MixerMaxVoices);
+	int32 play_count = 0;
+	
+	for (int32 i = 0; i < B_MixerSeconds * E_Limits_OfflineAudioSampleRate / B_MixerChunkFrames; ++i)
+	{
+		for (int32 j = 0; j < voice_count; ++j)
+		{
+			if (E_IsValidPlayingSoundHandle(voices[j]))
+				continue;
+			
+			bool is_music = (j < music_count);
+			E_PlaySoundOptions options = {
+				.volume = is_music ? 0.5f : 0.2f,
+				.speed = is_music ? 1.0f : 0.75f + 0.0625f * (float32)(j % 8), // NOTE(ljre): Most voices get resampled.
+				.bus = is_music ? E_AudioBus_Music : E_AudioBus_Sfx,
+				.priority = is_music ? 1 : 0,
+			};
+			
+			if (E_PlaySound(is_music ? music : luigi, &options, &voices[j]))
+				++play_count;
+		}
+		
+		E_RenderAudio(chunk, B_MixerChunkFrames);
+	}
+	
+	E_StopAllSounds(NULL);
+	E_RenderAudio(chunk, B_MixerChunkFrames);
+	
+	return play_count;
+}
+
+// NOTE(ljre): Renders 'sound' played right away, then scheduled B_MixerScheduleDelay frames ahead and rendered in
+//             callbacks of another size. Both must come out the same, just shifted.
+static bool
+B_MixerCheckSchedule_(Arena* arena, E_SoundHandle sound)
+{
+	const int32 channels = E_Limits_OfflineAudioChannels;
+	int16* reference = ArenaPushArray(arena, int16, B_MixerScheduleFrames * channels);
+	int16* scheduled = ArenaPushArray(arena, int16, (B_MixerScheduleFrames + B_MixerScheduleDelay) * channels);
+	int16 discard[1024 * E_Limits_OfflineAudioChannels];
+	uint64 clock_frame;
+	
+	E_PlaySound(sound, &(E_PlaySoundOptions) { .speed = 0.9f }, NULL);
+	E_RenderAudio(reference, B_MixerScheduleFrames);
+	E_StopAllSounds(NULL);
+	E_RenderAudio(discard, ArrayLength(discard) / channels);
+	
+	E_QueryAudioClock(&clock_frame, NULL);
+	E_PlaySound(sound, &(E_PlaySoundOptions) { .speed = 0.9f, .start_frame = clock_frame + B_MixerScheduleDelay }, NULL);
+	
+	for (int32 frame = 0; frame < B_MixerScheduleFrames + B_MixerScheduleDelay; frame += 700)
+		E_RenderAudio(scheduled + frame * channels, Min(700, B_MixerScheduleFrames + B_MixerScheduleDelay - frame));
+	
+	E_StopAllSounds(NULL);
+	E_RenderAudio(discard, ArrayLength(discard) / channels);
+	
+	bool ok = true;
+	for (int32 i = 0; i < B_MixerScheduleDelay * channels; ++i)
+		ok &= (scheduled[i] == 0);
+	
+	// NOTE(ljre): The SIMD kernels round differently than their scalar tails, and the callbacks don't split the voice
+	//             at the same frames, so allow 1 LSB.
+	for (int32 i = 0; i < B_MixerScheduleFrames * channels; ++i)
+	{
+		int32 diff = scheduled[B_MixerScheduleDelay * channels + i] - reference[i];
+		ok &= (diff >= -1 && diff <= 1);
+	}
+	
+	return ok;
+}
+
+static void
+B_RunMixer(void)
+{
+	Trace();
+	
+	Buffer music_ogg, luigi_ogg;
+	E_SoundHandle music, luigi;
+	
+	if (!OS_MapFile(Str("assets/music.ogg"), NULL, &music_ogg) || !OS_MapFile(Str("assets/luigi.ogg"), NULL, &luigi_ogg))
+	{
+		B_Printf("could not map the sounds in assets/, skipping.\n");
+		return;
+	}
+	
+	// NOTE(ljre): Nothing to render, this only tells if we're offline.
+	if (!E_RenderAudio(NULL, 0))
+	{
+		B_Printf("only works with -offline-audio, skipping.\n");
+		return;
+	}
+	
+	if (!E_LoadSound(music_ogg, &music, NULL) || !E_LoadSound(luigi_ogg, &luigi, NULL))
+	{
+		B_Printf("could not load the sounds, skipping.\n");
+		return;
+	}
+	
+	for ArenaTempScope(engine->scratch_arena)
+	{
+		Arena* arena = engine->scratch_arena;
+		int16* chunk = ArenaPushArray(arena, int16, B_MixerChunkFrames * E_Limits_OfflineAudioChannels);
+		
+		B_Printf("%is of audio per case, %iHz, %i channels\n", (int32)B_MixerSeconds, (int32)E_Limits_OfflineAudioSampleRate, (int32)E_Limits_OfflineAudioChannels);
+		
+		static const struct
+		{
+			String name;
+			int32 music_count;
+			int32 luigi_count;
+		}
+		cases[] = {
+			{ StrInit("1 music                  "), 1, 0 },
+			{ StrInit("32 luigi                 "), 0, 32 },
+			{ StrInit("1 music + 31 luigi       "), 1, 31 },
+			{ StrInit("4 music + 124 luigi      "), 4, 124 },
+			{ StrInit("16 music + 496 luigi     "), 16, 496 },
+		};
+		
+		for (intsize i = 0; i < ArrayLength(cases); ++i)
+		{
+			E_AudioStats before, after;
+			E_QueryAudioStats(&before);
+			
+			uint64 begin = OS_CurrentTick(NULL);
+			int32 play_count = B_MixerRenderVoices_(chunk, music, cases[i].music_count, luigi, cases[i].luigi_count);
+			uint64 end = OS_CurrentTick(NULL);
+			
+			E_QueryAudioStats(&after);
+			
+			// NOTE(ljre): 'total' includes decoding the streams, 'mixer' is only E_AudioThreadProc_.
+			float64 length = after.total_mix_length - before.total_mix_length;
+			float64 total_ms = B_TicksToSeconds(end - begin) * 1000.0 / length;
+			float64 mixer_ms = (after.total_mix_time - before.total_mix_time) * 1000.0 / length;
+			
+			B_Printf("  %S | total %.3fms, mixer %.3fms per second of audio | %.1fx realtime | %i plays, %i underruns\n",
+				cases[i].name,
+				total_ms,
+				mixer_ms,
+				1000.0 / total_ms,
+				play_count,
+				after.stream_underrun_count - before.stream_underrun_count);
+			
+			if (after.stream_underrun_count != before.stream_underrun_count)
+				B_Printf("  OFFLINE STREAM UNDERRUNS!\n");
+		}
+		
+		if (!B_MixerCheckSchedule_(arena, luigi) || !B_MixerCheckSchedule_(arena, music))
+			B_Printf("  SCHEDULED START IS NOT SAMPLE EXACT!\n");
+		
+		// NOTE(ljre): Something to listen to when the numbers look off.
+		E_PlaySound(music, &(E_PlaySoundOptions) { .volume = 0.5f, .bus = E_AudioBus_Music }, NULL);
+		E_PlaySound(luigi, &(E_PlaySoundOptions) { .volume = 0.5f }, NULL);
+		
+		Buffer wav;
+		if (E_RenderAudioToWav(arena, B_MixerWavSeconds * E_Limits_OfflineAudioSampleRate, &wav))
+		{
+			OS_WriteEntireFile(Str("bench_mixer.wav"), wav.data, wav.size);
+			B_Printf("wrote %is to bench_mixer.wav\n", (int32)B_MixerWavSeconds);
+		}
+		
+		E_StopAllSounds(NULL);
+		E_RenderAudio(chunk, B_MixerChunkFrames);
+	}
+	
+	E_UnloadSound(luigi);
+	E_UnloadSound(music);
+}
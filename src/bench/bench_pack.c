@@ -0,0 +1,130 @@
+enum
+{
+	B_PackTextureCount = 500,
+};
+
+static const String g_pack_raw_path = StrInit("bench_raw.pak");
+static const String g_pack_cooked_path = StrInit("bench_cooked.pak");
+
+// NOTE(ljre): The raw pack holds the source files as-is, the cooked one holds decoded RGBA8 pixels with their full
+//             mip chains, same as 'asset_packer -mips' would.
+static bool
+B_BuildPack_(Arena* arena, String path, bool cooked)
+{
+	UPak_WriteEntry entries[ArrayLength(g_assets_textures)];
+	
+	for (intsize i = 0; i < ArrayLength(g_assets_textures); ++i)
+	{
+		void* data;
+		uintsize size;
+		
+		if (!OS_ReadEntireFile(g_assets_textures[i], arena, &data, &size))
+			return false;
+		
+		entries[i] = (UPak_WriteEntry) {
+			.name = g_assets_textures[i],
+			.kind = UPak_Kind_Raw,
+			.data = BufMake(size, data),
+		};
+		
+		if (cooked)
+		{
+			void* pixels;
+			int32 width, height;
+			
+			if (!E_DecodeImage(arena, entries[i].data, &pixels, &width, &height))
+				return false;
+			
+			int32 mip_count = UPak_CalcFullMipCount(width, height);
+			uintsize chain_size = UPak_CalcMipChainSize(width, height, mip_count);
+			uint32* chain = ArenaPushDirtyAligned(arena, chain_size, UPak_BlobAlignment);
+			
+			MemoryCopy(chain, pixels, (uintsize)width * height * 4);
+			UPak_GenerateMips(chain, width, height, mip_count);
+			
+			entries[i].kind = UPak_Kind_Tex2dRGBA8;
+			entries[i].width = width;
+			entries[i].height = height;
+			entries[i].mip_count = mip_count;
+			entries[i].data = BufMake(chain_size, chain);
+		}
+	}
+	
+	uintsize max_size = UPak_CalcMaxSize(entries, ArrayLength(entries));
+	uint8* pack_data = ArenaPushDirtyAligned(arena, max_size, UPak_BlobAlignment);
+	uintsize size = UPak_Write(entries, ArrayLength(entries), pack_data, max_size);
+	
+	return size && OS_WriteEntireFile(path, pack_data, size);
+}
+
+static void
+B_LoadGroup_(String label, E_AssetPack* pack)
+{
+	for ArenaTempScope(engine->persistent_arena)
+	{
+		E_AssetInfo* infos = ArenaPushArray(engine->persistent_arena, E_AssetInfo, B_PackTextureCount);
+		
+		for (int32 i = 0; i < B_PackTextureCount; ++i)
+		{
+			infos[i].filepath = g_assets_textures[i % ArrayLength(g_assets_textures)];
+			infos[i].name = infos[i].filepath;
+		}
+		
+		E_AssetGroup group = {
+			.arena = engine->persistent_arena,
+			.tex2d_count = B_PackTextureCount,
+			.tex2ds_info = infos,
+			.pack = pack,
+		};
+		
+		uint64 begin = OS_CurrentTick(NULL);
+		E_LoadAssets(&group, engine->scratch_arena);
+		uint64 end = OS_CurrentTick(NULL);
+		
+		B_Printf("%S | total: %.3fs | open+decode: %.3fs | upload: %.3fs\n",
+			label,
+			B_TicksToSeconds(end - begin),
+			B_TicksToSeconds(group.decode_ticks),
+			B_TicksToSeconds(group.upload_ticks));
+		
+		E_UnloadAssets(&group);
+	}
+}
+
+static void
+B_RunPack(void)
+{
+	Trace();
+	
+	B_Printf("texture group: %i textures, %i threads\n", (int32)B_PackTextureCount, (int32)engine->worker_thread_count + 1);
+	
+	bool built = false;
+	for ArenaTempScope(engine->scratch_arena)
+		built = B_BuildPack_(engine->scratch_arena, g_pack_raw_path, false) && B_BuildPack_(engine->scratch_arena, g_pack_cooked_path, true);
+	
+	if (!built)
+	{
+		B_Printf("could not build %S and %S, skipping.\n", g_pack_raw_path, g_pack_cooked_path);
+		return;
+	}
+	
+	B_LoadGroup_(Str("loose files "), NULL);
+	
+	for ArenaTempScope(engine->persistent_arena)
+	{
+		E_AssetPack* raw_pack = E_OpenAssetPack(engine->persistent_arena, g_pack_raw_path);
+		E_AssetPack* cooked_pack = E_OpenAssetPack(engine->persistent_arena, g_pack_cooked_path);
+		
+		if (raw_pack)
+		{
+			B_LoadGroup_(Str("raw pack    "), raw_pack);
+			E_CloseAssetPack(raw_pack);
+		}
+		
+		if (cooked_pack)
+		{
+			B_LoadGroup_(Str("cooked pack "), cooked_pack);
+			E_CloseAssetPack(cooked_pack);
+		}
+	}
+}
@@ -0,0 +1,175 @@
+enum
+{
+	B_QoiIterations = 200,
+	B_QoiBigSize = 2048, // NOTE(ljre): Side of the tiled image used to measure banded decoding.
+};
+
+struct B_QoiBandJob_
+{
+	const uint8* data;
+	uintsize size;
+	const UQoi_Bands* bands;
+	int32 band;
+	uint32* pixels;
+	int32 width, height;
+}
+typedef B_QoiBandJob_;
+
+static void
+B_QoiBandProc_(E_ThreadCtx* ctx, void* user_data)
+{
+	B_QoiBandJob_* job = user_data;
+	
+	UQoi_DecodeBand(job->data, job->size, job->bands, job->band, job->pixels, job->width, job->height);
+}
+
+static void
+B_PrintThroughput_(String label, int32 width, int32 height, int32 iterations, uint64 ticks)
+{
+	float64 seconds = B_TicksToSeconds(ticks);
+	float64 mpixels = (float64)width * height * iterations / 1000000.0;
+	
+	B_Printf("  %S | %.3fs | %.1f Mpx/s\n", label, seconds, mpixels / seconds);
+}
+
+static void
+B_BenchQoiImage_(Arena* arena, String name, Buffer png, const uint32* pixels, int32 width, int32 height, int32 iterations)
+{
+	int32 rows_per_band = UQoi_CalcBandRows(width, height);
+	uintsize max_size = UQoi_CalcMaxEncodedSize(width, height, rows_per_band);
+	uint8* encoded = ArenaPushDirtyAligned(arena, max_size, 64);
+	uint32* decoded = ArenaPushDirtyAligned(arena, (uintsize)width * height * 4, 64);
+	uintsize size = 0;
+	uint64 begin, end;
+	
+	//- Encode
+	begin = OS_CurrentTick(NULL);
+	for (int32 i = 0; i < iterations; ++i)
+		size = UQoi_EncodeToBuffer(pixels, width, height, rows_per_band, encoded, max_size);
+	end = OS_CurrentTick(NULL);
+	
+	B_Printf("%S (%ix%i) | png: %z bytes | qoi: %z bytes, %i bands\n", name, width, height, png.size, size, (int32)((height + rows_per_band-1) / rows_per_band));
+	B_PrintThroughput_(Str("qoi encode         "), width, height, iterations, end - begin);
+	
+	//- stb_image, as E_DecodeImage does it
+	if (png.size)
+	{
+		begin = OS_CurrentTick(NULL);
+		for (int32 i = 0; i < iterations; ++i)
+		{
+			for ArenaTempScope(arena)
+			{
+				void* png_pixels;
+				int32 png_width, png_height;
+				
+				E_DecodeImage(arena, png, &png_pixels, &png_width, &png_height);
+			}
+		}
+		end = OS_CurrentTick(NULL);
+		
+		B_PrintThroughput_(Str("png decode (stbi)  "), width, height, iterations, end - begin);
+	}
+	
+	//- QOI, single thread
+	bool ok = true;
+	
+	begin = OS_CurrentTick(NULL);
+	for (int32 i = 0; i < iterations; ++i)
+		ok &= UQoi_DecodeToBuffer(encoded, size, decoded, width, height);
+	end = OS_CurrentTick(NULL);
+	
+	ok &= (MemoryCompare(decoded, pixels, (uintsize)width * height * 4) == 0);
+	B_PrintThroughput_(Str("qoi decode         "), width, height, iterations, end - begin);
+	
+	//- QOI, one job per band
+	UQoi_Bands bands;
+	
+	if (UQoi_ParseBands(encoded, size, width, height, &bands))
+	{
+		B_QoiBandJob_* jobs = ArenaPushArray(arena, B_QoiBandJob_, bands.band_count);
+		
+		for (int32 i = 0; i < bands.band_count; ++i)
+		{
+			jobs[i] = (B_QoiBandJob_) {
+				.data = encoded,
+				.size = size,
+				.bands = &bands,
+				.band = i,
+				.pixels = decoded,
+				.width = width,
+				.height = height,
+			};
+		}
+		
+		MemorySet(decoded, 0, (uintsize)width * height * 4);
+		begin = OS_CurrentTick(NULL);
+		for (int32 i = 0; i < iterations; ++i)
+		{
+			E_ThreadCounter counter = { 0 };
+			
+			for (int32 j = 0; j < bands.band_count; ++j)
+			{
+				E_QueueThreadWork(&(E_ThreadWork) {
+					.callback = B_QoiBandProc_,
+					.data = &jobs[j],
+					.counter = &counter,
+				});
+			}
+			
+			E_WaitThreadCounter(&counter);
+		}
+		end = OS_CurrentTick(NULL);
+		
+		ok &= (MemoryCompare(decoded, pixels, (uintsize)width * height * 4) == 0);
+		B_PrintThroughput_(Str("qoi decode (bands) "), width, height, iterations, end - begin);
+	}
+	
+	if (!ok)
+		B_Printf("  QOI ROUND-TRIP MISMATCH!\n");
+}
+
+static void
+B_RunQoi(void)
+{
+	Trace();
+	
+	B_Printf("%i iterations per image, %i threads\n", (int32)B_QoiIterations, (int32)engine->worker_thread_count + 1);
+	
+	for (intsize i = 0; i < ArrayLength(g_assets_textures); ++i)
+	{
+		for ArenaTempScope(engine->scratch_arena)
+		{
+			Arena* arena = engine->scratch_arena;
+			void* data;
+			uintsize size;
+			void* pixels;
+			int32 width, height;
+			
+			if (!OS_ReadEntireFile(g_assets_textures[i], arena, &data, &size))
+				continue;
+			if (!E_DecodeImage(arena, BufMake(size, data), &pixels, &width, &height))
+				continue;
+			
+			B_BenchQoiImage_(arena, g_assets_textures[i], BufMake(size, data), pixels, width, height, B_QoiIterations);
+			
+			// NOTE(ljre): The assets are tiny, so also tile the last one into a big image to give the bands some
+			//             work to split. The image, its encoding and the decoded copy don't fit in the scratch
+			//             arena, so they get an arena of their own.
+			if (i+1 == ArrayLength(g_assets_textures))
+			{
+				uintsize big_size = (uintsize)B_QoiBigSize * B_QoiBigSize * 4;
+				Arena* big_arena = ArenaCreate(big_size*3 + (16 << 20), 1 << 20);
+				uint32* big = ArenaPushDirtyAligned(big_arena, big_size, 64);
+				
+				for (int32 y = 0; y < B_QoiBigSize; ++y)
+				{
+					for (int32 x = 0; x < B_QoiBigSize; ++x)
+						big[y*B_QoiBigSize + x] = ((uint32*)pixels)[(y % height)*width + (x % width)];
+				}
+				
+				B_BenchQoiImage_(big_arena, Str("tiled"), (Buffer) { 0 }, big, B_QoiBigSize, B_QoiBigSize, B_QoiIterations / 20);
+				ArenaDestroy(big_arena);
+			}
+		}
+	}
+}
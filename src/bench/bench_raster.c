@@ -0,0 +1,285 @@
+enum
+{
+	B_RasterWidth = 1280,
+	B_RasterHeight = 720,
+	B_RasterRectCount = 4096,
+	B_RasterFrames = 10,
+	B_RasterMaxChannelError = 2, // NOTE(ljre): Against the reference image, for rounding and libm differences.
+	B_RasterMaxWrongPixels = B_RasterWidth * B_RasterHeight / 1000,
+};
+
+struct B_RasterVertex_
+{
+	float32 position[3];
+	uint8 color[4];
+}
+typedef B_RasterVertex_;
+
+// NOTE(ljre): The depth scene is already in NDC. It still gets a w that isn't 1, so it goes through the perspective
+//             correct path of the rasterizer.
+static void
+B_RasterDepthVs_(const RB_SoftwareVertex* vertex, float32 out_position[4], float32* out_varyings)
+{
+	float32 w = 1.0f + vertex->inputs[0][0];
+	
+	out_position[0] = vertex->inputs[0][0] * w;
+	out_position[1] = vertex->inputs[0][1] * w;
+	out_position[2] = vertex->inputs[0][2] * w;
+	out_position[3] = w;
+	
+	for (int32 i = 0; i < 4; ++i)
+		out_varyings[i] = vertex->inputs[1][i];
+}
+
+static void
+B_RasterDepthFs_(const RB_SoftwareFragment* fragment, float32 out_color[4])
+{
+	for (int32 i = 0; i < 4; ++i)
+		out_color[i] = fragment->varyings[i];
+}
+
+static void
+B_RasterFillRects_(E_RectBatch* batch)
+{
+	for (int32 i = 0; i < B_RasterRectCount; ++i)
+	{
+		uint64 random = HashInt64(i);
+		
+		float32 angle = (random>>18 & 511) / 512.0f * (float32)Math_PI*2;
+		float32 size = 16.0f + (random>>51 & 63);
+		
+		E_PushRect(batch, &(E_RectBatchElem) {
+			.pos = { (random & 1023) + 64.0f, (random>>9 & 511) + 64.0f },
+			.scaling = {
+				{ size*cosf(angle), size*-sinf(angle) },
+				{ size*sinf(angle), size* cosf(angle) },
+			},
+			.tex_index = 0,
+			.tex_kind = (int32)(random>>57 & 1),
+			.texcoords = { 0, 0, INT16_MAX, INT16_MAX },
+			.color = {
+				(random>>27 & 255) / 255.0f,
+				(random>>35 & 255) / 255.0f,
+				(random>>43 & 255) / 255.0f,
+				(random>>58 & 1) ? 0.5f : 1.0f,
+			},
+		});
+	}
+}
+
+static void
+B_RunRaster(void)
+{
+	Trace();
+	
+	RB_Ctx* rb = engine->renderbackend;
+	
+	if (RB_QueryCapabilities(rb).shader_type != RB_ShaderType_Software)
+	{
+		B_Printf("only works with -software-render, skipping.\n");
+		return;
+	}
+	
+	//- Depth test scene: quad A goes from in front of quad B to behind it, left to right
+	static const B_RasterVertex_ vertices[] = {
+		{ { 0.1f, -0.9f, -0.5f }, { 255, 0, 0, 255 } },
+		{ { 0.9f, -0.9f,  0.5f }, { 255, 0, 0, 255 } },
+		{ { 0.9f, -0.1f,  0.5f }, { 255, 0, 0, 255 } },
+		{ { 0.1f, -0.1f, -0.5f }, { 255, 0, 0, 255 } },
+		
+		{ { 0.1f, -0.9f,  0.0f }, { 0, 0, 255, 255 } },
+		{ { 0.9f, -0.9f,  0.0f }, { 0, 0, 255, 255 } },
+		{ { 0.9f, -0.1f,  0.0f }, { 0, 0, 255, 255 } },
+		{ { 0.1f, -0.1f,  0.0f }, { 0, 0, 255, 255 } },
+	};
+	static const uint16 indices[] = { 0, 1, 2, 2, 3, 0, 4, 5, 6, 6, 7, 4 };
+	
+	RB_VBuffer depth_vbuffer = RB_MakeVertexBuffer(rb, &(RB_VBufferDesc) {
+		.initial_data = vertices,
+		.size = sizeof(vertices),
+	});
+	RB_IBuffer depth_ibuffer = RB_MakeIndexBuffer(rb, &(RB_IBufferDesc) {
+		.initial_data = indices,
+		.size = sizeof(indices),
+		.index_type = RB_IndexType_Uint16,
+	});
+	RB_Shader depth_shader = RB_MakeShader(rb, &(RB_ShaderDesc) {
+		.software = {
+			.vs = B_RasterDepthVs_,
+			.fs = B_RasterDepthFs_,
+			.varying_count = 4,
+		},
+	});
+	RB_Pipeline depth_pipeline = RB_MakePipeline(rb, &(RB_PipelineDesc) {
+		.flag_depth_test = true,
+		.cull_mode = RB_CullMode_None,
+		
+		.shader = depth_shader,
+		.input_layout = {
+			[0] = {
+				.format = RB_VertexFormat_Vec3,
+				.offset = offsetof(B_RasterVertex_, position),
+			},
+			[1] = {
+				.format = RB_VertexFormat_Vec4U8Norm,
+				.offset = offsetof(B_RasterVertex_, color),
+			},
+		},
+	});
+	
+	//- Text goes through the SDF path, which needs the derivatives
+	E_Font font;
+	Buffer ttf;
+	bool has_font = OS_MapFile(Str("assets/Lato-Regular.ttf"), NULL, &ttf);
+	
+	if (has_font)
+	{
+		has_font = E_MakeFont(&(E_FontDesc) {
+			.arena = engine->persistent_arena,
+			.ttf = ttf,
+			.char_height = 32.0f,
+			.prebake_ranges = {
+				{ 0x21, 0x7E },
+			},
+		}, &font);
+	}
+	
+	if (!has_font)
+		B_Printf("could not load assets/Lato-Regular.ttf, drawing no text.\n");
+	
+	const int32 max_workers = (int32)engine->worker_thread_count;
+	const E_Camera2D cam = {
+		.size = { B_RasterWidth, B_RasterHeight },
+		.zoom = 1.0f,
+	};
+	
+	Arena* batch_arena = ArenaCreate(sizeof(E_RectBatchElem) * B_RasterRectCount + (1 << 20), 64 << 10);
+	uint64 first_hash = 0;
+	
+	B_Printf("%ix%i, %i rects, %i frames\n", (int32)B_RasterWidth, (int32)B_RasterHeight, (int32)B_RasterRectCount, (int32)B_RasterFrames);
+	
+	for (int32 workers = 0; workers <= max_workers; ++workers)
+	{
+		E_SetActiveWorkerCount(workers);
+		
+		uint64 begin = OS_CurrentTick(NULL);
+		
+		for (int32 frame = 0; frame < B_RasterFrames; ++frame)
+		{
+			RB_BeginCmd(rb, &(RB_BeginDesc) {
+				.viewport_width = B_RasterWidth,
+				.viewport_height = B_RasterHeight,
+			});
+			RB_CmdClear(rb, &(RB_ClearDesc) {
+				.color = { 0.1f, 0.1f, 0.1f, 1.0f },
+				.flag_color = true,
+				.flag_depth = true,
+			});
+			
+			ArenaClear(batch_arena);
+			E_RectBatch batch = {
+				.arena = batch_arena,
+				.textures[0] = E_WhiteTexture(),
+				.elements = ArenaEndAligned(batch_arena, alignof(E_RectBatchElem)),
+			};
+			
+			B_RasterFillRects_(&batch);
+			if (has_font)
+				E_PushText(&batch, &font, Str("The quick brown fox jumps over the lazy dog."), vec2(32.0f, 16.0f), vec2(1.0f, 1.0f), GLM_VEC4_ONE);
+			E_DrawRectBatches(&batch, 1, &cam);
+			
+			RB_CmdApplyPipeline(rb, depth_pipeline);
+			RB_CmdDraw(rb, &(RB_DrawDesc) {
+				.ibuffer = depth_ibuffer,
+				.vbuffers[0] = depth_vbuffer,
+				.strides[0] = sizeof(B_RasterVertex_),
+				.index_count = ArrayLength(indices),
+			});
+			
+			RB_EndCmd(rb);
+			RB_Present(rb);
+		}
+		
+		uint64 end = OS_CurrentTick(NULL);
+		
+		for ArenaTempScope(engine->scratch_arena)
+		{
+			int32 width, height;
+			Buffer pixels;
+			SafeAssert(RB_ReadSoftwareFramebuffer(rb, engine->scratch_arena, &width, &height, &pixels));
+			
+			uint64 hash = HashString(StrMake(pixels.size, pixels.data));
+			if (workers == 0)
+				first_hash = hash;
+			
+			B_Printf("threads: %i | %.3fms per frame | output hash %X\n",
+				workers + 1,
+				B_TicksToSeconds(end - begin) * 1000.0 / B_RasterFrames,
+				hash);
+			
+			if (hash != first_hash)
+				B_Printf("           | RASTER OUTPUT DEPENDS ON THE THREAD COUNT!\n");
+			
+			// NOTE(ljre): Halfway up the quads, A is at z=-0.25 on the left and at z=0.25 on the right, B is at z=0.
+			const uint8* left = pixels.data + ((height*3/4) * width + width*13/20) * 4;
+			const uint8* right = pixels.data + ((height*3/4) * width + width*17/20) * 4;
+			
+			if (left[0] != 255 || left[2] != 0 || right[0] != 0 || right[2] != 255)
+				B_Printf("           | DEPTH TEST IS WRONG!\n");
+			
+			if (workers == max_workers)
+			{
+				uintsize max_size = UQoi_CalcMaxEncodedSize(width, height, 0);
+				uint8* encoded = ArenaPushDirty(engine->scratch_arena, max_size);
+				uintsize size = UQoi_EncodeToBuffer((const uint32*)pixels.data, width, height, 0, encoded, max_size);
+				
+				OS_WriteEntireFile(Str("bench_raster.qoi"), encoded, size);
+				B_Printf("wrote the last frame to bench_raster.qoi\n");
+				
+				// NOTE(ljre): Golden image test. When the output changes on purpose, look at bench_raster.qoi and copy it
+				//             over the reference.
+				void* reference_data;
+				uintsize reference_size;
+				uint32* reference = NULL;
+				int32 reference_width, reference_height;
+				
+				if (OS_ReadEntireFile(Str("assets/bench_raster_reference.qoi"), engine->scratch_arena, &reference_data, &reference_size))
+					reference = UQoi_Parse(reference_data, reference_size, engine->scratch_arena, &reference_width, &reference_height);
+				
+				if (!reference || reference_width != width || reference_height != height)
+					B_Printf("           | COULD NOT LOAD assets/bench_raster_reference.qoi!\n");
+				else
+				{
+					int32 wrong_pixels = 0;
+					int32 worst_error = 0;
+					
+					for (intsize i = 0; i < (intsize)width * height; ++i)
+					{
+						const uint8* expected = (const uint8*)&reference[i];
+						const uint8* got = pixels.data + i*4;
+						int32 error = 0;
+						
+						for (int32 j = 0; j < 4; ++j)
+							error = Max(error, Max(expected[j] - got[j], got[j] - expected[j]));
+						
+						wrong_pixels += (error > B_RasterMaxChannelError);
+						worst_error = Max(worst_error, error);
+					}
+					
+					B_Printf("reference image: %i pixels off by more than %i, worst channel error %i\n", wrong_pixels, (int32)B_RasterMaxChannelError, worst_error);
+					
+					if (wrong_pixels > B_RasterMaxWrongPixels)
+						B_Printf("           | RASTER OUTPUT DOESN'T MATCH THE REFERENCE!\n");
+				}
+			}
+		}
+	}
+	
+	E_SetActiveWorkerCount(max_workers);
+	
+	ArenaDestroy(batch_arena);
+	RB_FreePipeline(rb, depth_pipeline);
+	RB_FreeShader(rb, depth_shader);
+	RB_FreeIndexBuffer(rb, depth_ibuffer);
+	RB_FreeVertexBuffer(rb, depth_vbuffer);
+}
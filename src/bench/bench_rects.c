@@ -0,0 +1,194 @@
+enum
+{
+	// NOTE(ljre): Enough for E_DrawRectBatches to split it in a few appends to the vertex ring.
+	B_RectsCount = 1 << 20,
+	B_RectsJobCount = 64,
+	B_RectsIterations = 10,
+};
+
+struct B_RectsJob_
+{
+	E_RectBatch* batch;
+	int32 first;
+	int32 count;
+}
+typedef B_RectsJob_;
+
+// NOTE(ljre): Same spinning squares as the main menu of game_test.
+static void
+B_RectsFill_(E_RectBatch* batch, int32 first, int32 count)
+{
+	for (int32 i = first; i < first + count; ++i)
+	{
+		uint64 random = HashInt64(i);
+		
+		float32 angle = (random>>18 & 511) / 512.0f * (float32)Math_PI*2;
+		float32 size = 32.0f;
+		
+		E_PushRect(batch, &(E_RectBatchElem) {
+			.pos = { (random & 1023) - 512.0f, (random>>9 & 511) - 256.0f },
+			.scaling = {
+				{ size*cosf(angle), size*-sinf(angle) },
+				{ size*sinf(angle), size* cosf(angle) },
+			},
+			.tex_index = 0,
+			.tex_kind = 1,
+			.texcoords = { 0, 0, INT16_MAX, INT16_MAX },
+			.color = { (random>>27 & 255) / 255.0f, (random>>35 & 255) / 255.0f, (random>>43 & 255) / 255.0f, 1.0f },
+		});
+	}
+}
+
+static void
+B_RectsFillAsync_(E_ThreadCtx* ctx, void* data)
+{
+	B_RectsJob_* job = data;
+	B_RectsFill_(job->batch, job->first, job->count);
+}
+
+static void
+B_RectsResetBatch_(E_RectBatch* batch, Arena* arena, bool packed)
+{
+	ArenaClear(arena);
+	
+	*batch = (E_RectBatch) {
+		.arena = arena,
+		.textures[0] = E_WhiteTexture(),
+		.flag_packed = packed,
+		.elements = ArenaEndAligned(arena, alignof(E_RectBatchElem)),
+	};
+}
+
+static void
+B_RunRects(void)
+{
+	Trace();
+	
+	const int32 max_workers = (int32)engine->worker_thread_count;
+	const int32 per_job = B_RectsCount / B_RectsJobCount;
+	
+	// NOTE(ljre): Every sub-batch gets an arena of its own, so jobs can push into them at the same time.
+	Arena* single_arena = ArenaCreate(sizeof(E_RectBatchElem) * B_RectsCount + (1 << 20), 1 << 20);
+	Arena* job_arenas[B_RectsJobCount];
+	E_RectBatch single_batch;
+	E_RectBatch job_batches[B_RectsJobCount];
+	B_RectsJob_ jobs[B_RectsJobCount];
+	
+	for (int32 i = 0; i < B_RectsJobCount; ++i)
+		job_arenas[i] = ArenaCreate(sizeof(E_RectBatchElem) * per_job + (64 << 10), 64 << 10);
+	
+	B_Printf("%i rects, %i sub-batches, %i iterations\n", (int32)B_RectsCount, (int32)B_RectsJobCount, (int32)B_RectsIterations);
+	
+	for (int32 workers = 0; workers <= max_workers; ++workers)
+	{
+		E_SetActiveWorkerCount(workers);
+		
+		uint64 fill_single = 0, fill_jobs = 0, fill_packed = 0;
+		uint64 draw_single = 0, draw_jobs = 0, draw_packed = 0;
+		
+		RB_ResetNullStats(engine->renderbackend);
+		
+		for (int32 it = 0; it < B_RectsIterations; ++it)
+		{
+			// NOTE(ljre): Every iteration is a frame, so the vertex ring only needs to fit one of them.
+			RB_BeginCmd(engine->renderbackend, &(RB_BeginDesc) {
+				.viewport_width = engine->os->window.width,
+				.viewport_height = engine->os->window.height,
+			});
+			
+			//- One batch, filled by the main thread
+			B_RectsResetBatch_(&single_batch, single_arena, false);
+			
+			uint64 begin = OS_CurrentTick(NULL);
+			B_RectsFill_(&single_batch, 0, B_RectsCount);
+			uint64 filled = OS_CurrentTick(NULL);
+			E_DrawRectBatches(&single_batch, 1, NULL);
+			uint64 end = OS_CurrentTick(NULL);
+			
+			fill_single += filled - begin;
+			draw_single += end - filled;
+			
+			//- Same, but packed as it's pushed. Drawing uploads it as it is.
+			B_RectsResetBatch_(&single_batch, single_arena, true);
+			
+			begin = OS_CurrentTick(NULL);
+			B_RectsFill_(&single_batch, 0, B_RectsCount);
+			filled = OS_CurrentTick(NULL);
+			E_DrawRectBatches(&single_batch, 1, NULL);
+			end = OS_CurrentTick(NULL);
+			
+			fill_packed += filled - begin;
+			draw_packed += end - filled;
+			
+			//- Many batches, filled by jobs and drawn in order
+			E_ThreadCounter counter = { 0 };
+			
+			for (int32 i = 0; i < B_RectsJobCount; ++i)
+			{
+				B_RectsResetBatch_(&job_batches[i], job_arenas[i], false);
+				jobs[i] = (B_RectsJob_) {
+					.batch = &job_batches[i],
+					.first = i * per_job,
+					.count = per_job,
+				};
+			}
+			
+			begin = OS_CurrentTick(NULL);
+			
+			for (int32 i = 0; i < B_RectsJobCount; ++i)
+			{
+				E_QueueThreadWork(&(E_ThreadWork) {
+					.callback = B_RectsFillAsync_,
+					.data = &jobs[i],
+					.counter = &counter,
+				});
+			}
+			
+			E_WaitThreadCounter(&counter);
+			filled = OS_CurrentTick(NULL);
+			E_DrawRectBatches(job_batches, B_RectsJobCount, NULL);
+			end = OS_CurrentTick(NULL);
+			
+			fill_jobs += filled - begin;
+			draw_jobs += end - filled;
+			
+			RB_EndCmd(engine->renderbackend);
+			RB_Present(engine->renderbackend);
+		}
+		
+		float64 single_ms = B_TicksToSeconds(fill_single) * 1000.0 / B_RectsIterations;
+		float64 jobs_ms = B_TicksToSeconds(fill_jobs) * 1000.0 / B_RectsIterations;
+		
+		B_Printf("threads: %i | fill: 1 batch %.3fms, %i batches %.3fms (%.2fx) | draw: 1 batch %.3fms, %i batches %.3fms\n",
+			workers + 1,
+			single_ms,
+			(int32)B_RectsJobCount,
+			jobs_ms,
+			single_ms / jobs_ms,
+			B_TicksToSeconds(draw_single) * 1000.0 / B_RectsIterations,
+			(int32)B_RectsJobCount,
+			B_TicksToSeconds(draw_jobs) * 1000.0 / B_RectsIterations);
+		B_Printf("           | packed: fill %.3fms, draw %.3fms\n",
+			B_TicksToSeconds(fill_packed) * 1000.0 / B_RectsIterations,
+			B_TicksToSeconds(draw_packed) * 1000.0 / B_RectsIterations);
+		
+		// NOTE(ljre): Only the null backend counts. Each iteration draws all of the rects 3 times.
+		RB_NullStats stats = RB_QueryNullStats(engine->renderbackend);
+		
+		if (stats.draw_count)
+		{
+			B_Printf("           | null backend: %i draws, %.1fMB appended per iteration\n",
+				(int32)(stats.draw_count / B_RectsIterations),
+				(float64)(stats.uploaded_bytes / B_RectsIterations) / (1 << 20));
+			
+			if (stats.instance_count != 3ull * B_RectsCount * B_RectsIterations)
+				B_Printf("           | RECTS WERE LOST!\n");
+		}
+	}
+	
+	E_SetActiveWorkerCount(max_workers);
+	
+	for (int32 i = 0; i < B_RectsJobCount; ++i)
+		ArenaDestroy(job_arenas[i]);
+	ArenaDestroy(single_arena);
+}
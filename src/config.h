@@ -45,6 +45,9 @@
 #	define _CRT_SECURE_NO_WARNINGS
 #	define CONFIG_ENABLE_OPENGL
 #elif defined(CONFIG_OS_LINUX) || defined(CONFIG_OS_SDL2LINUX) || defined(CONFIG_OS_ANDROID)
+#	if defined(CONFIG_OS_LINUX) && !defined(_GNU_SOURCE)
+#		define _GNU_SOURCE // NOTE(ljre): For sched_getaffinity, pthread_setaffinity_np and friends.
+#	endif
 #	define CONFIG_ENABLE_OPENGL
 #endif
 
@@ -1,6 +1,9 @@
 API DBG_UIState
 DBG_UIBegin(E_GlobalData* engine, E_RectBatch* batch, E_Font* font, vec2 pos, vec2 scale)
 {
+	// NOTE(ljre): The background is filled in by DBG_UIEnd, so it has to be a plain E_RectBatchElem.
+	SafeAssert(!batch->flag_packed);
+	
 	DBG_UIState state = {
 		.engine = engine,
 		.batch = batch,
@@ -1,3 +1,6 @@
+// NOTE(ljre): Before anything that might include a system header, so the feature macros it sets take effect.
+#include "config.h"
+
 //~ Libraries
 #define STB_IMAGE_STATIC
 #define STBI_ONLY_PNG
@@ -22,6 +25,9 @@ static E_GlobalData global_engine;
 #include "util_json.h"
 #include "util_qoi.h"
 #include "util_gltf.h"
+#include "util_assetpack.h"
+#include "util_audiomix.h"
+#include "util_audiodsp.h"
 
 #include "engine_assets.c"
 #include "engine_audio.c"
@@ -1,11 +1,18 @@
 struct E_DecodeImageAsyncData_
 {
+	// NOTE(ljre): If 'pixels' is already set when the job starts, it's a pre-sized slot and the image is decoded
+	//             straight into it. Otherwise, it's the buffer stb_image allocated, which is handed to the main
+	//             thread as-is and freed after the upload. Either way, no locks and no extra copies.
 	alignas(64) void* pixels;
 	int32 width, height;
+	int32 mip_count;
+	bool pixels_from_stbi;
+	bool pixels_from_heap;
+	bool pixels_ready; // NOTE(ljre): Precooked pixels read in place from the mapping. Nothing to decode.
+	bool decoded_in_bands;
+	volatile int32 failed_band_count;
 	
 	intsize asset_index;
-	Arena* output_arena;
-	OS_RWLock* output_arena_lock;
 	OS_MappedFile mapped_handle;
 	Buffer mapped_contents;
 }
@@ -14,42 +21,598 @@ typedef E_DecodeImageAsyncData_;
 static void
 E_DecodeImageAsync_(E_ThreadCtx* ctx, void* user_data)
 {
-	for ArenaTempScope(ctx->scratch_arena)
+	Trace();
+	
+	E_DecodeImageAsyncData_* data = user_data;
+	Buffer encoded = data->mapped_contents;
+	
+	if (data->pixels_ready)
+		return;
+	else if (data->pixels)
+	{
+		if (!UQoi_DecodeToBuffer(encoded.data, encoded.size, data->pixels, data->width, data->height))
+			data->pixels = NULL;
+	}
+	else if (UQoi_ParseHeader(encoded.data, encoded.size, &data->width, &data->height))
+	{
+		// NOTE(ljre): Streamed QOI images have no slot, so they get their own buffer.
+		void* pixels = OS_HeapAlloc((uintsize)data->width * data->height * 4);
+		
+		if (UQoi_DecodeToBuffer(encoded.data, encoded.size, pixels, data->width, data->height))
+		{
+			data->pixels = pixels;
+			data->pixels_from_heap = true;
+		}
+		else
+			OS_HeapFree(pixels);
+	}
+	else if (encoded.size <= INT32_MAX)
 	{
-		E_DecodeImageAsyncData_* data = user_data;
-		Buffer encoded = data->mapped_contents;
 		int32 width, height;
-		void* pixels;
+		void* pixels = stbi_load_from_memory(encoded.data, (int32)encoded.size, &width, &height, &(int32){0}, 4);
 		
-		if (stbi_info_from_memory(encoded.data, (int32)encoded.size, &width, &height, &(int32){0}))
+		if (pixels)
 		{
-			uintsize size = (uintsize)width*height*4;
+			data->pixels = pixels;
+			data->pixels_from_stbi = true;
+			data->width = width;
+			data->height = height;
+		}
+	}
+		
+	// NOTE(ljre): Assets read from a pack share its mapping.
+	if (data->mapped_handle.ptr)
+		OS_UnmapFile(data->mapped_handle);
+}
+
+// NOTE(ljre): One band of a QOI image that has a band table, decoded straight into the image's slot.
+struct E_DecodeQoiBandData_
+{
+	E_DecodeImageAsyncData_* image;
+	UQoi_Bands bands;
+	int32 band;
+}
+typedef E_DecodeQoiBandData_;
+
+static void
+E_DecodeQoiBandAsync_(E_ThreadCtx* ctx, void* user_data)
+{
+	Trace();
+	
+	E_DecodeQoiBandData_* data = user_data;
+	E_DecodeImageAsyncData_* image = data->image;
+	Buffer encoded = image->mapped_contents;
+	
+	if (!UQoi_DecodeBand(encoded.data, encoded.size, &data->bands, data->band, image->pixels, image->width, image->height))
+		OS_InterlockedIncrement32(&image->failed_band_count);
+}
+
+static void
+E_FreeDecodedImage_(E_DecodeImageAsyncData_* data)
+{
+	if (data->pixels_from_stbi)
+		stbi_image_free(data->pixels);
+	else if (data->pixels_from_heap)
+		OS_HeapFree(data->pixels);
+	
+	// NOTE(ljre): Loose cooked textures keep their own mapping around until they're uploaded.
+	if (data->pixels_ready && data->mapped_handle.ptr)
+		OS_UnmapFile(data->mapped_handle);
+	
+	data->pixels = NULL;
+	data->mapped_handle = (OS_MappedFile) { 0 };
+	data->pixels_from_stbi = false;
+	data->pixels_from_heap = false;
+	data->pixels_ready = false;
+}
+
+//~ Asset Packs
+struct E_AssetPack
+{
+	OS_MappedFile mapped_handle;
+	UPak_Pack pak;
+};
+
+// NOTE(ljre): Fills 'job' with the encoded image at 'path', either from the pack or from its own mapped file.
+//             Precooked images are pointed to directly and don't need to be decoded at all.
+static bool
+E_OpenImageForDecode_(E_AssetPack* pack, String path, E_DecodeImageAsyncData_* job)
+{
+	job->mip_count = 1;
+	
+	if (!pack)
+	{
+		if (!OS_MapFile(path, &job->mapped_handle, &job->mapped_contents))
+			return false;
+		
+		const void* pixels;
+		Buffer contents = job->mapped_contents;
+		
+		if (UPak_ParseCookedTex(contents.data, contents.size, &job->width, &job->height, &job->mip_count, &pixels))
+		{
+			job->pixels = (void*)pixels;
+			job->pixels_ready = true;
+		}
+		
+		return true;
+	}
+	
+	const UPak_Entry* entry = UPak_Find(&pack->pak, path);
+	if (!entry)
+		return false;
+	
+	Buffer data = UPak_EntryData(&pack->pak, entry);
+	
+	if (entry->kind == UPak_Kind_Tex2dRGBA8)
+	{
+		job->pixels = (void*)data.data;
+		job->width = (int32)entry->width;
+		job->height = (int32)entry->height;
+		job->mip_count = (int32)Max(entry->mip_count, 1);
+		job->pixels_ready = true;
+	}
+	else
+		job->mapped_contents = data;
+	
+	return true;
+}
+
+API E_AssetPack*
+E_OpenAssetPack(Arena* arena, String path)
+{
+	Trace(); TraceText(path);
+	
+	OS_MappedFile mapped_handle;
+	Buffer contents;
+	UPak_Pack pak;
+	
+	if (!OS_MapFile(path, &mapped_handle, &contents))
+		return NULL;
+	
+	if (!UPak_Open(contents.data, contents.size, &pak))
+	{
+		OS_UnmapFile(mapped_handle);
+		return NULL;
+	}
+	
+	return ArenaPushStructInit(arena, E_AssetPack, {
+		.mapped_handle = mapped_handle,
+		.pak = pak,
+	});
+}
+
+API void
+E_CloseAssetPack(E_AssetPack* pack)
+{
+	Trace();
+	
+	if (pack->mapped_handle.ptr)
+		OS_UnmapFile(pack->mapped_handle);
+	
+	pack->mapped_handle = (OS_MappedFile) { 0 };
+	pack->pak = (UPak_Pack) { 0 };
+}
+
+API bool
+E_FindAssetInPack(E_AssetPack* pack, String name, Buffer* out_data)
+{
+	const UPak_Entry* entry = UPak_Find(&pack->pak, name);
+	
+	if (entry)
+		*out_data = UPak_EntryData(&pack->pak, entry);
+	
+	return entry != NULL;
+}
+
+//~ Asset Streaming
+struct E_AssetStreamRequest_
+{
+	E_DecodeImageAsyncData_ decode;
+	E_ThreadCounter counter;
+	
+	int32 generation;
+	int32 next_free; // NOTE(ljre): 1-indexed
+	E_AssetStreamState state;
+	bool released; // NOTE(ljre): No handle refers to this request, free it as soon as it's not in use.
+	bool cancelled;
+	
+	int32 priority;
+	uint32 sequence;
+	E_Tex2d tex;
+	E_Tex2d* out_tex;
+	E_AssetGroup* group;
+	E_AssetPack* pack;
+	E_AssetStreamCallback* callback;
+	void* user_data;
+	
+	int32 path_size;
+	char path[E_Limits_MaxAssetStreamPath];
+}
+typedef E_AssetStreamRequest_;
+
+struct E_AssetStream
+{
+	int32 first_free; // NOTE(ljre): 1-indexed
+	uint32 next_sequence;
+	
+	// NOTE(ljre): Max-heap of 1-indexed requests waiting to be dispatched, by priority and then by age.
+	int32 heap_count;
+	int32 heap[E_Limits_MaxAssetStreamRequests];
+	
+	// NOTE(ljre): Requests being decoded or waiting for upload, in dispatch order.
+	int32 inflight_count;
+	int32 inflight[E_Limits_MaxAssetStreamInFlight];
+	
+	E_AssetStreamRequest_ requests[E_Limits_MaxAssetStreamRequests];
+};
+
+static void
+E_InitAssetStream_(void)
+{
+	Trace();
+	
+	E_AssetStream* stream = ArenaPushStruct(global_engine.persistent_arena, E_AssetStream);
+	
+	stream->first_free = 1;
+	for (int32 i = 0; i < E_Limits_MaxAssetStreamRequests-1; ++i)
+		stream->requests[i].next_free = i+2;
+	
+	global_engine.asset_stream = stream;
+	global_engine.asset_stream_upload_budget = 8ull << 20;
+}
+
+static bool
+E_StreamRequestGoesFirst_(E_AssetStream* stream, int32 left, int32 right)
+{
+	E_AssetStreamRequest_* l = &stream->requests[left-1];
+	E_AssetStreamRequest_* r = &stream->requests[right-1];
+	
+	if (l->priority != r->priority)
+		return l->priority > r->priority;
+	return (int32)(l->sequence - r->sequence) < 0;
+}
+
+static void
+E_PushStreamHeap_(E_AssetStream* stream, int32 index)
+{
+	int32 i = stream->heap_count++;
+	
+	while (i > 0)
+	{
+		int32 parent = (i-1) / 2;
+		
+		if (!E_StreamRequestGoesFirst_(stream, index, stream->heap[parent]))
+			break;
+		
+		stream->heap[i] = stream->heap[parent];
+		i = parent;
+	}
+	
+	stream->heap[i] = index;
+}
+
+static int32
+E_PopStreamHeap_(E_AssetStream* stream)
+{
+	int32 result = stream->heap[0];
+	int32 last = stream->heap[--stream->heap_count];
+	int32 count = stream->heap_count;
+	int32 i = 0;
+	
+	for (;;)
+	{
+		int32 child = i*2 + 1;
+		if (child >= count)
+			break;
+		if (child+1 < count && E_StreamRequestGoesFirst_(stream, stream->heap[child+1], stream->heap[child]))
+			++child;
+		if (!E_StreamRequestGoesFirst_(stream, stream->heap[child], last))
+			break;
+		
+		stream->heap[i] = stream->heap[child];
+		i = child;
+	}
+	
+	if (count > 0)
+		stream->heap[i] = last;
+	
+	return result;
+}
+
+static void
+E_FreeStreamRequest_(E_AssetStream* stream, int32 index)
+{
+	E_AssetStreamRequest_* req = &stream->requests[index-1];
+	
+	E_FreeDecodedImage_(&req->decode);
+	
+	++req->generation;
+	req->state = E_AssetStreamState_Null;
+	req->next_free = stream->first_free;
+	stream->first_free = index;
+}
+
+static E_AssetStreamRequest_*
+E_FetchStreamRequest_(E_AssetStream* stream, E_AssetStreamHandle handle)
+{
+	if (!handle.index || handle.index > E_Limits_MaxAssetStreamRequests)
+		return NULL;
+	
+	E_AssetStreamRequest_* req = &stream->requests[handle.index-1];
+	
+	if (req->state == E_AssetStreamState_Null || req->released || (uint16)req->generation != handle.generation)
+		return NULL;
+	
+	return req;
+}
+
+static void
+E_FinishStreamRequest_(E_AssetStream* stream, int32 index, bool success)
+{
+	E_AssetStreamRequest_* req = &stream->requests[index-1];
+	
+	req->state = success ? E_AssetStreamState_Done : E_AssetStreamState_Failed;
+	
+	if (success && req->out_tex)
+		*req->out_tex = req->tex;
+	if (req->callback)
+		req->callback(req->user_data, &req->tex, success);
+	if (req->released)
+		E_FreeStreamRequest_(stream, index);
+}
+
+static void
+E_CancelAssetGroupStream_(E_AssetGroup* asset_group)
+{
+	E_AssetStream* stream = global_engine.asset_stream;
+	
+	for (int32 i = 0; i < E_Limits_MaxAssetStreamRequests; ++i)
+	{
+		E_AssetStreamRequest_* req = &stream->requests[i];
+		
+		if (req->group == asset_group && req->state != E_AssetStreamState_Null)
+			req->cancelled = true;
+	}
+	
+	asset_group->streaming_count = 0;
+}
+
+static void
+E_AssetGroupStreamCallback_(void* user_data, const E_Tex2d* tex, bool success)
+{
+	E_AssetGroup* asset_group = user_data;
+	
+	--asset_group->streaming_count;
+}
+
+static void
+E_UpdateAssetStream_(void)
+{
+	Trace();
+	
+	E_AssetStream* stream = global_engine.asset_stream;
+	E_ThreadWorkQueue* queue = global_engine.thread_work_queue;
+	
+	if (!stream->heap_count && !stream->inflight_count)
+		return;
+	
+	//- Dispatch the most important requests to the workers
+	while (stream->heap_count > 0 && stream->inflight_count < E_Limits_MaxAssetStreamInFlight)
+	{
+		int32 index = E_PopStreamHeap_(stream);
+		E_AssetStreamRequest_* req = &stream->requests[index-1];
+		
+		req->counter = (E_ThreadCounter) { 0 };
+		req->decode = (E_DecodeImageAsyncData_) { .asset_index = index };
+		
+		if (req->cancelled)
+			E_FreeStreamRequest_(stream, index);
+		else if (!E_OpenImageForDecode_(req->pack, StrMake(req->path_size, req->path), &req->decode))
+			E_FinishStreamRequest_(stream, index, false);
+		else
+		{
+			req->state = E_AssetStreamState_Decoding;
+			stream->inflight[stream->inflight_count++] = index;
+			
+			if (!req->decode.pixels_ready)
+				E_QueueThreadWork(&(E_ThreadWork) {
+					.callback = E_DecodeImageAsync_,
+					.data = &req->decode,
+					.counter = &req->counter,
+				});
+		}
+	}
+	
+	// NOTE(ljre): If there are no workers to pick the jobs up, do one per frame ourselves.
+	if (queue->active_worker_count == 0)
+		E_RunThreadWork(NULL, queue);
+	
+	//- Upload what's ready, within the budget
+	uintsize budget = global_engine.asset_stream_upload_budget;
+	uintsize uploaded_size = 0;
+	bool uploaded_any = false;
+	
+	for (int32 i = 0; i < stream->inflight_count;)
+	{
+		int32 index = stream->inflight[i];
+		E_AssetStreamRequest_* req = &stream->requests[index-1];
+		
+		if (req->counter.count > 0)
+		{
+			++i;
+			continue;
+		}
+		
+		OS_MemoryBarrier();
+		E_DecodeImageAsyncData_* decode = &req->decode;
+		
+		if (req->cancelled)
+			E_FreeStreamRequest_(stream, index);
+		else if (!decode->pixels)
+			E_FinishStreamRequest_(stream, index, false);
+		else
+		{
+			uintsize size = RB_CalcTexture2DSize(RB_TexFormat_RGBA8, decode->width, decode->height, decode->mip_count);
 			
-			if (data->output_arena_lock)
+			if (uploaded_any && uploaded_size + size > budget)
 			{
-				OS_LockExclusive(data->output_arena_lock);
-				pixels = ArenaPushMemory(data->output_arena, pixels, size);
-				OS_UnlockExclusive(data->output_arena_lock);
+				++i;
+				continue;
 			}
-			else
-				pixels = ArenaPushMemory(data->output_arena, pixels, size);
 			
-			void* temp_data = stbi_load_from_memory(encoded.data, (int32)encoded.size, &width, &height, &(int32){0}, 4);
-			MemoryCopy(pixels, temp_data, size);
-			stbi_image_free(temp_data);
+			req->tex = (E_Tex2d) {
+				.width = decode->width,
+				.height = decode->height,
+				.handle = RB_MakeTexture2D(global_engine.renderbackend, &(RB_Tex2dDesc) {
+					.pixels = decode->pixels,
+					.width = decode->width,
+					.height = decode->height,
+					.format = RB_TexFormat_RGBA8,
+					.mip_count = decode->mip_count,
+					.flag_linear_filtering = true,
+				}),
+			};
 			
-			data->pixels = pixels;
-			data->width = width;
-			data->height = height;
+			uploaded_size += size;
+			uploaded_any = true;
+			E_FreeDecodedImage_(decode);
+			E_FinishStreamRequest_(stream, index, true);
 		}
 		
-		OS_UnmapFile(data->mapped_handle);
+		--stream->inflight_count;
+		MemoryMove(&stream->inflight[i], &stream->inflight[i+1], sizeof(stream->inflight[0]) * (stream->inflight_count - i));
+	}
+}
+
+static bool
+E_PushStreamRequest_(const E_AssetStreamDesc* desc, E_AssetGroup* asset_group, E_AssetStreamHandle* out_handle)
+{
+	E_AssetStream* stream = global_engine.asset_stream;
+	int32 index = stream->first_free;
+	
+	if (!index || desc->filepath.size > E_Limits_MaxAssetStreamPath)
+		return false;
+	
+	E_AssetStreamRequest_* req = &stream->requests[index-1];
+	int32 generation = req->generation;
+	
+	stream->first_free = req->next_free;
+	*req = (E_AssetStreamRequest_) {
+		.generation = generation,
+		.state = E_AssetStreamState_Queued,
+		.released = !out_handle,
+		.priority = desc->priority,
+		.sequence = stream->next_sequence++,
+		.tex = E_WhiteTexture(),
+		.out_tex = desc->out_tex,
+		.group = asset_group,
+		.pack = desc->pack,
+		.callback = desc->callback,
+		.user_data = desc->user_data,
+		.path_size = (int32)desc->filepath.size,
+	};
+	
+	MemoryCopy(req->path, desc->filepath.data, desc->filepath.size);
+	
+	if (req->out_tex)
+		*req->out_tex = req->tex;
+	if (out_handle)
+	{
+		*out_handle = (E_AssetStreamHandle) {
+			.generation = (uint16)generation,
+			.index = (uint16)index,
+		};
+	}
+	
+	E_PushStreamHeap_(stream, index);
+	return true;
+}
+
+API bool
+E_StreamTex2d(const E_AssetStreamDesc* desc, E_AssetStreamHandle* out_handle)
+{
+	Trace();
+	
+	return E_PushStreamRequest_(desc, NULL, out_handle);
+}
+
+API E_AssetStreamState
+E_QueryAssetStream(E_AssetStreamHandle handle, E_Tex2d* out_tex)
+{
+	E_AssetStreamRequest_* req = E_FetchStreamRequest_(global_engine.asset_stream, handle);
+	
+	if (!req)
+		return E_AssetStreamState_Null;
+	if (out_tex)
+		*out_tex = req->tex;
+	
+	return req->state;
+}
+
+API void
+E_ReleaseAssetStream(E_AssetStreamHandle handle)
+{
+	Trace();
+	
+	E_AssetStream* stream = global_engine.asset_stream;
+	E_AssetStreamRequest_* req = E_FetchStreamRequest_(stream, handle);
+	
+	if (!req)
+		return;
+	
+	// NOTE(ljre): Unfinished requests are still referenced by the heap or by a decode job, so they'll be freed later.
+	if (req->state == E_AssetStreamState_Done || req->state == E_AssetStreamState_Failed)
+		E_FreeStreamRequest_(stream, handle.index);
+	else
+	{
+		req->released = true;
+		req->cancelled = true;
 	}
 }
 
+API int32
+E_PendingAssetStreamCount(void)
+{
+	E_AssetStream* stream = global_engine.asset_stream;
+	
+	return stream->heap_count + stream->inflight_count;
+}
+
+API void
+E_StreamAssets(E_AssetGroup* asset_group, int32 priority)
+{
+	Trace();
+	
+	if (!asset_group->tex2ds)
+		asset_group->tex2ds = ArenaPushArray(asset_group->arena, E_Tex2d, asset_group->tex2d_count);
+	
+	for (intsize i = 0; i < asset_group->tex2d_count; ++i)
+	{
+		if (!RB_IsNull(asset_group->tex2ds[i].handle))
+			continue;
+		
+		bool ok = E_PushStreamRequest_(&(E_AssetStreamDesc) {
+			.filepath = asset_group->tex2ds_info[i].filepath,
+			.priority = priority,
+			.out_tex = &asset_group->tex2ds[i],
+			.pack = asset_group->pack,
+			.callback = E_AssetGroupStreamCallback_,
+			.user_data = asset_group,
+		}, asset_group, NULL);
+		
+		if (!ok)
+			break;
+		
+		++asset_group->streaming_count;
+	}
+}
+
+//~ Asset Groups
 API void
 E_LoadAssets(E_AssetGroup* asset_group, Arena* scratch_arena)
 {
+	Trace();
+	
 	Arena* arena = asset_group->arena;
 	
 	if (!asset_group->tex2ds)
@@ -58,50 +621,120 @@ E_LoadAssets(E_AssetGroup* asset_group, Arena* scratch_arena)
 		asset_group->sounds = ArenaPushArray(arena, E_SoundHandle, asset_group->sound_count);
 	
 	uint64 current_time = OS_CurrentPosixTime();
+	uint64 begin_tick = OS_CurrentTick(NULL);
 	
 	//- Textures loading
 	E_DecodeImageAsyncData_* jobs = ArenaEndAligned(scratch_arena, alignof(E_DecodeImageAsyncData_));
 	intsize job_count = 0;
+	uintsize slots_size = 0;
 	
 	for (intsize i = 0; i < asset_group->tex2d_count; ++i)
 	{
 		String path = asset_group->tex2ds_info[i].filepath;
-		OS_MappedFile mapped_handle;
-		Buffer mapped_contents;
 		
-		if ((RB_IsNull(asset_group->tex2ds[i].handle) || OS_IsFileOlderThan(path, current_time)) && OS_MapFile(path, &mapped_handle, &mapped_contents))
+		// NOTE(ljre): Packs aren't hot-reloaded, so only what's missing is loaded from them.
+		if (!RB_IsNull(asset_group->tex2ds[i].handle) && (asset_group->pack || !OS_IsFileOlderThan(path, current_time)))
+			continue;
+		
+		E_DecodeImageAsyncData_* job = ArenaPushStruct(scratch_arena, E_DecodeImageAsyncData_);
+		job->asset_index = i;
+		
+		if (!E_OpenImageForDecode_(asset_group->pack, path, job))
 		{
-			++job_count;
-			ArenaPushStructInit(scratch_arena, E_DecodeImageAsyncData_, {
-				.asset_index = i,
-				.output_arena = arena,
-				.output_arena_lock = &global_engine.mt_lock,
-				.mapped_handle = mapped_handle,
-				.mapped_contents = mapped_contents,
-			});
+			ArenaPop(scratch_arena, job);
+			continue;
 		}
+			
+		// NOTE(ljre): We know the size of QOI images upfront, so they get a slot.
+		if (!job->pixels_ready && UQoi_ParseHeader(job->mapped_contents.data, job->mapped_contents.size, &job->width, &job->height))
+			slots_size += AlignUp((uintsize)job->width * job->height * 4, 63);
+			
+		++job_count;
 	}
 	
-	if (job_count == 1)
+	//- Hand out the pre-sized slots
+	if (slots_size)
 	{
-		jobs[0].output_arena_lock = NULL;
-		E_DecodeImageAsync_(&(E_ThreadCtx) { global_engine.scratch_arena }, &jobs[0]);
+		uint8* slots = ArenaPushDirtyAligned(scratch_arena, slots_size, 64);
+		
+		for (intsize i = 0; i < job_count; ++i)
+		{
+			if (!jobs[i].pixels_ready && jobs[i].width && jobs[i].height)
+			{
+				jobs[i].pixels = slots;
+				slots += AlignUp((uintsize)jobs[i].width * jobs[i].height * 4, 63);
+			}
+		}
 	}
-	else if (job_count > 1)
+	
+	//- Decode
+	E_DecodeQoiBandData_* band_jobs = ArenaEndAligned(scratch_arena, alignof(E_DecodeQoiBandData_));
+	E_ThreadCounter counter = { 0 };
+		
+	for (intsize i = 0; i < job_count; ++i)
 	{
-		for (intsize i = 0; i < job_count; ++i)
+		E_DecodeImageAsyncData_* job = &jobs[i];
+		Buffer encoded = job->mapped_contents;
+		UQoi_Bands bands;
+		
+		if (job->pixels_ready)
+			continue;
+		
+		// NOTE(ljre): Big QOI images with a band table are split across the workers, one job per band.
+		if (job->pixels && UQoi_ParseBands(encoded.data, encoded.size, job->width, job->height, &bands) && bands.band_count > 1)
 		{
-			E_QueueThreadWork(&(E_ThreadWork) {
-				.callback = E_DecodeImageAsync_,
-				.data = &jobs[i],
-			});
+			job->decoded_in_bands = true;
+			
+			for (int32 band = 0; band < bands.band_count; ++band)
+			{
+				E_DecodeQoiBandData_* band_job = ArenaPushStructInit(scratch_arena, E_DecodeQoiBandData_, {
+					.image = job,
+					.bands = bands,
+					.band = band,
+				});
+				
+				E_QueueThreadWork(&(E_ThreadWork) {
+					.callback = E_DecodeQoiBandAsync_,
+					.data = band_job,
+					.counter = &counter,
+				});
+			}
+			
+			continue;
 		}
+			
+		E_QueueThreadWork(&(E_ThreadWork) {
+			.callback = E_DecodeImageAsync_,
+			.data = job,
+			.counter = &counter,
+		});
+	}
+		
+	E_WaitThreadCounter(&counter);
+	
+	for (intsize i = 0; i < job_count; ++i)
+	{
+		if (!jobs[i].decoded_in_bands)
+			continue;
+		if (jobs[i].failed_band_count)
+			jobs[i].pixels = NULL;
+		if (jobs[i].mapped_handle.ptr)
+			OS_UnmapFile(jobs[i].mapped_handle);
 		
-		E_WaitRemainingThreadWork();
+		jobs[i].mapped_handle = (OS_MappedFile) { 0 };
 	}
 	
+	ArenaPop(scratch_arena, band_jobs);
+	
+	uint64 decoded_tick = OS_CurrentTick(NULL);
+	uint64 decoded_bytes = 0;
+	
+	//- Upload
 	for (intsize i = 0; i < job_count; ++i)
 	{
+		if (!jobs[i].pixels)
+			continue;
+		
 		intsize texindex = jobs[i].asset_index;
 		if (!RB_IsNull(asset_group->tex2ds[texindex].handle))
 			RB_FreeTexture2D(global_engine.renderbackend, asset_group->tex2ds[texindex].handle);
@@ -114,18 +747,47 @@ E_LoadAssets(E_AssetGroup* asset_group, Arena* scratch_arena)
 				.width = jobs[i].width,
 				.height = jobs[i].height,
 				.format = RB_TexFormat_RGBA8,
+				.mip_count = jobs[i].mip_count,
 				.flag_linear_filtering = true,
 			}),
 		};
+		
+		decoded_bytes += RB_CalcTexture2DSize(RB_TexFormat_RGBA8, jobs[i].width, jobs[i].height, jobs[i].mip_count);
+		E_FreeDecodedImage_(&jobs[i]);
 	}
 	
 	ArenaPop(scratch_arena, jobs);
 	asset_group->load_time = current_time;
+	asset_group->decode_ticks = decoded_tick - begin_tick;
+	asset_group->upload_ticks = OS_CurrentTick(NULL) - decoded_tick;
+	asset_group->decoded_bytes = decoded_bytes;
 }
 
 API void
 E_UnloadAssets(E_AssetGroup* asset_group)
 {
+	Trace();
+	
+	E_CancelAssetGroupStream_(asset_group);
+	RB_Tex2d white_handle = E_WhiteTexture().handle;
+	
+	for (intsize i = 0; i < asset_group->tex2d_count; ++i)
+	{
+		if (asset_group->tex2ds && !RB_IsNull(asset_group->tex2ds[i].handle))
+		{
+			// NOTE(ljre): Placeholders of textures that didn't finish streaming aren't ours to free.
+			if (asset_group->tex2ds[i].handle.id != white_handle.id)
+				RB_FreeTexture2D(global_engine.renderbackend, asset_group->tex2ds[i].handle);
+			asset_group->tex2ds[i] = (E_Tex2d) { 0 };
+		}
+	}
 	
+	for (intsize i = 0; i < asset_group->sound_count; ++i)
+	{
+		if (asset_group->sounds && E_IsValidSoundHandle(asset_group->sounds[i]))
+		{
+			E_UnloadSound(asset_group->sounds[i]);
+			asset_group->sounds[i] = (E_SoundHandle) { 0 };
+		}
+	}
 }
-
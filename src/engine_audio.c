@@ -1,7 +1,20 @@
-// TODO(ljre): There are locks and unlocks everywhere.
+// NOTE(ljre): The mixer only ever reads PCM. Short sounds are decoded whole by E_LoadSound. Long ones (music) get a
+//             stream each time they're played: a ring of PCM that a job keeps filled ahead of the mixer.
 //
-//             The point is to just mix and output audio from another thread that wakes up ~2 times per frame,
-//             but if they actually try to access the same stuff at the same time, it'll be *expensive*!
+//             The game thread and the mixer never wait on each other:
+//             - The handle tables belong to the game thread. New voices reach the mixer through 'commands', a ring
+//               with a single producer and a single consumer.
+//             - Stopping a voice just bumps the generation of its handle. The mixer drops any voice whose handle
+//               went stale the next time it runs.
+//             - The mixer publishes where each voice is at through 'voice_states', one 64-bit word per voice.
+//
+//             Only the E_Limits_MaxMixedSounds voices with the highest priority, then volume, are mixed. The others
+//             are virtual: they keep playing and moving their cursor, but their samples are never touched.
+//
+//             Voices start and stop at exact frames of the mixer clock, the count of frames mixed so far, no matter
+//             where the callbacks fall. Their fades are done by the mix kernels, so stopping doesn't click.
+//
+//             So the audio API is for the game thread only.
 
 struct E_LoadedSoundRef_
 {
@@ -13,59 +26,227 @@ typedef E_LoadedSoundRef_;
 
 struct E_PlayingSoundRef_
 {
-	int32 generation;
+	int32 volatile generation; // NOTE(ljre): Also read by the mixer.
 	int32 next_free;  // NOTE(ljre): 1-indexed
-	int32 index; // NOTE(ljre): 1-indexed
+	
+	// NOTE(ljre): What the game thread knows about the voice, so it doesn't have to ask the mixer. 'sound' is zero
+	//             while the handle is free.
+	E_SoundHandle sound;
+	int32 sample_rate;
+	float32 volume;
+	float32 speed;
 }
 typedef E_PlayingSoundRef_;
 
 struct E_LoadedSound_
 {
-	stb_vorbis* vorbis;
+	float32* samples; // NOTE(ljre): Interleaved, with UMix_PadFrames silent frames around it. NULL if the sound is streamed.
+	Buffer ogg;
 	int32 channels;
 	int32 sample_rate;
 	int32 sample_count;
 }
 typedef E_LoadedSound_;
 
-struct E_PlayingSound_
+enum E_SoundStreamState_
 {
-	int32 ref_index;
+	E_SoundStreamState_Free = 0,
+	E_SoundStreamState_Active,
+	E_SoundStreamState_Closing, // NOTE(ljre): Its job will close the decoder, free the ring and then the stream.
+}
+typedef E_SoundStreamState_;
+
+// NOTE(ljre): Single producer, single consumer. The job decodes into the ring and bumps 'write_frame', the mixer
+//             reads from it and bumps 'read_frame'. Both count frames since the start of the sound.
+struct E_SoundStream_
+{
+	volatile int32 state;
+	volatile int32 job_queued;
+	volatile int32 kick_requested; // NOTE(ljre): The mixer can't queue work itself. See E_KickRequestedSoundStreams_.
 	
+	// NOTE(ljre): Set by the game thread when the stream is opened, then only used by its job. 'sound' is only there so
+	//             E_UnloadSound can tell the streams of its sound apart, even from others sharing the same buffer.
 	E_SoundHandle sound;
-	int32 current_scaled_frame;
+	Buffer ogg;
+	stb_vorbis* vorbis;
+	float32* ring;
+	int32 channels;
+	
+	volatile bool end_reached; // NOTE(ljre): Written by the job, after the last 'write_frame'.
+	volatile uint32 write_frame;
+	volatile uint32 read_frame;
+}
+typedef E_SoundStream_;
+
+// NOTE(ljre): A voice, as the mixer sees it. Everything it needs from the loaded sound is copied in, so the mixer
+//             never touches the game thread's tables besides the generations.
+struct E_PlayingSound_
+{
+	E_PlayingSoundHandle handle;
+	int32 stream_index; // NOTE(ljre): 1-indexed, 0 if the sound was decoded upfront.
+	
+	const float32* samples;
+	int32 channels;
+	int32 sample_rate;
+	int32 sample_count;
+	
+	uint64 position; // NOTE(ljre): 32.32 fixed point, in the sound's own frames. See util_audiomix.h.
 	
 	float32 volume;
 	float32 speed;
+	int32 priority;
+	UMix_Quality quality;
+	E_AudioBus bus;
+	
+	// NOTE(ljre): On the mixer clock. The voice is heard from 'start_frame' on, and fades out from 'stop_frame' on.
+	//             'stop_frame' is UINT64_MAX until something stops the voice. See E_VoiceFadeGain_.
+	uint64 start_frame;
+	uint64 stop_frame;
+	int32 fade_in_frames;
+	int32 fade_out_frames;
 }
 typedef E_PlayingSound_;
 
+// NOTE(ljre): Mixer only. 'samples' has room for a single block.
+struct E_AudioBus_
+{
+	float32* samples;
+	float32 gain;
+	float32 target_gain;
+	
+	E_AudioBusEffects effects;
+	UDsp_Biquad filter;
+	UDsp_Reverb reverb;
+	UDsp_Compressor compressor;
+}
+typedef E_AudioBus_;
+
+enum E_AudioCommandKind_
+{
+	E_AudioCommandKind_Null = 0,
+	E_AudioCommandKind_Play,
+	E_AudioCommandKind_Stop,
+	E_AudioCommandKind_SetBusGain,
+	E_AudioCommandKind_SetBusEffects,
+}
+typedef E_AudioCommandKind_;
+
+struct E_AudioCommand_
+{
+	E_AudioCommandKind_ kind;
+	
+	union
+	{
+		E_PlayingSound_ play;
+		
+		struct
+		{
+			E_PlayingSoundHandle handle;
+			uint64 frame;
+			int32 fade_out_frames;
+		}
+		stop;
+		
+		struct
+		{
+			E_AudioBus bus;
+			float32 gain;
+		}
+		bus_gain;
+		
+		struct
+		{
+			E_AudioBus bus;
+			E_AudioBusEffects effects;
+		}
+		bus_effects;
+	};
+}
+typedef E_AudioCommand_;
+
+// NOTE(ljre): Predecoded samples of an unloaded sound, to be freed once the mixer surely can't be reading them.
+struct E_PendingSoundFree_
+{
+	float32* samples; // NOTE(ljre): The whole allocation, silence before the sound included.
+	uint32 mix_count;
+}
+typedef E_PendingSoundFree_;
+
+// NOTE(ljre): The canonical 44 bytes before the samples of a 16-bit PCM WAV file. Little-endian, like us.
+struct E_WavHeader_
+{
+	char riff_id[4];
+	uint32 riff_size;
+	char wave_id[4];
+	
+	char fmt_id[4];
+	uint32 fmt_size;
+	uint16 format;
+	uint16 channels;
+	uint32 sample_rate;
+	uint32 byte_rate;
+	uint16 block_align;
+	uint16 bits_per_sample;
+	
+	char data_id[4];
+	uint32 data_size;
+}
+typedef E_WavHeader_;
+
+static_assert(sizeof(E_WavHeader_) == 44, "WAV header should have no padding");
+
 struct E_AudioState
 {
-	OS_RWLock lock;
 	bool volatile ready;
-	int32 system_sample_rate;
-	int32 system_channels;
+	bool offline; // NOTE(ljre): Set by -offline-audio. The mixer only runs inside of E_RenderAudio.
+	int32 volatile system_sample_rate; // NOTE(ljre): Only written by the mixer after E_InitAudio_, see E_MakeAudioBuses_.
+	int32 volatile system_channels;
 	
+	// Game thread data
 	int32 loaded_sounds_table_size;
-	int32 volatile loaded_sounds_table_first_free; // NOTE(ljre): 1-indexed
+	int32 loaded_sounds_table_first_free; // NOTE(ljre): 1-indexed
 	E_LoadedSoundRef_* loaded_sounds_table;
 	
 	int32 playing_sounds_table_size;
-	int32 volatile playing_sounds_table_first_free;  // NOTE(ljre): 1-indexed
+	int32 playing_sounds_table_first_free;  // NOTE(ljre): 1-indexed
 	E_PlayingSoundRef_* playing_sounds_table;
 	
+	int32 loaded_sounds_size;
+	int32 loaded_sounds_cap;
+	E_LoadedSound_* loaded_sounds;
+	
+	int32 pending_free_count;
+	E_PendingSoundFree_ pending_frees[E_Limits_MaxLoadedSounds];
+	int32 dropped_play_count;
+	
+	// Shared data
+	E_AudioCommand_* commands;
+	uint32 volatile command_write; // NOTE(ljre): Only written by the game thread.
+	uint32 volatile command_read; // NOTE(ljre): Only written by the mixer.
+	
+	// NOTE(ljre): Only written by the mixer, indexed by the playing handle. See E_MakeVoiceState_.
+	uint64 volatile* voice_states;
+	uint32 volatile mix_count;
+	int32 volatile playing_count;
+	int32 volatile mixed_count;
+	int32 volatile stream_underrun_count;
+	int32 volatile late_mix_count;
+	int32 volatile last_mix_frames;
+	uint64 volatile last_mix_ticks;
+	uint64 volatile worst_mix_ticks;
+	uint64 volatile total_mix_ticks;
+	uint64 volatile clock_frame; // NOTE(ljre): The mixer clock, every frame mixed so far.
+	
+	E_SoundStream_ streams[E_Limits_MaxSoundStreams];
+	
 	// Audio thread data
 	Arena* arena;
-	int32 samples_cache_size_each;
+	ArenaSavepoint buses_save; // NOTE(ljre): Everything after it is the buses' memory, then scratch.
+	E_AudioBus_ buses[E_AudioBus_Count];
 	
 	int32 playing_sounds_size;
 	int32 playing_sounds_cap;
 	E_PlayingSound_* playing_sounds;
-	
-	int32 loaded_sounds_size;
-	int32 loaded_sounds_cap;
-	E_LoadedSound_* loaded_sounds;
 }
 typedef E_AudioState;
 
@@ -117,6 +298,7 @@ E_AllocPlayingSoundHandle_(E_AudioState* audio, E_PlayingSoundHandle* out_handle
 	ref->next_free = 0;
 }
 
+// NOTE(ljre): The new generation is what tells the mixer to stop the voice.
 static void
 E_DeallocPlayingSoundHandle_(E_AudioState* audio, E_PlayingSoundHandle handle)
 {
@@ -126,6 +308,7 @@ E_DeallocPlayingSoundHandle_(E_AudioState* audio, E_PlayingSoundHandle handle)
 	SafeAssert(ref_index > 0);
 	
 	++ref->generation;
+	ref->sound = (E_SoundHandle) { 0 };
 	ref->next_free = audio->playing_sounds_table_first_free;
 	audio->playing_sounds_table_first_free = ref_index;
 }
@@ -134,24 +317,682 @@ static bool
 E_IsSameSoundHandle_(E_SoundHandle left, E_SoundHandle right)
 { return left.generation == right.generation && left.index == right.index; }
 
+static E_LoadedSound_*
+E_FetchLoadedSound_(E_AudioState* audio, E_SoundHandle sound)
+{
+	if (!sound.index || sound.index > E_Limits_MaxLoadedSounds)
+		return NULL;
+	
+	E_LoadedSoundRef_* ref = &audio->loaded_sounds_table[sound.index-1];
+	
+	if (ref->generation != sound.generation || ref->next_free)
+		return NULL;
+	
+	return &audio->loaded_sounds[ref->index];
+}
+
+// NOTE(ljre): Returns the table entry of a handle the game thread still holds, or NULL.
+static E_PlayingSoundRef_*
+E_FetchPlayingSoundRef_(E_AudioState* audio, E_PlayingSoundHandle playing_sound)
+{
+	if (!playing_sound.index || playing_sound.index > E_Limits_MaxPlayingSounds)
+		return NULL;
+	
+	E_PlayingSoundRef_* ref = &audio->playing_sounds_table[playing_sound.index-1];
+	
+	if ((uint16)ref->generation != playing_sound.generation || !ref->sound.index)
+		return NULL;
+	
+	return ref;
+}
+
+//~ Voice states
+// NOTE(ljre): Packed so the mixer can publish it with a single store: the frame the voice is at in its low 32 bits,
+//             the generation of its handle in the next 16, and whether it's still playing in bit 48.
+static inline uint64
+E_MakeVoiceState_(E_PlayingSoundHandle handle, bool playing, uint64 position)
+{ return (uint64)(uint32)(position >> 32) | (uint64)handle.generation << 32 | (uint64)playing << 48; }
+
+static inline uint16
+E_VoiceStateGeneration_(uint64 state)
+{ return (uint16)(state >> 32); }
+
+static inline bool
+E_VoiceStateIsPlaying_(uint64 state)
+{ return (state >> 48) & 1; }
+
+static inline uint32
+E_VoiceStateFrame_(uint64 state)
+{ return (uint32)state; }
+
+// NOTE(ljre): A voice the mixer already took in and then let go of, because it ended or there was no room for it.
+static bool
+E_IsPlayingSoundFinished_(E_AudioState* audio, E_PlayingSoundHandle playing_sound)
+{
+	uint64 state = audio->voice_states[playing_sound.index-1];
+	
+	return E_VoiceStateGeneration_(state) == playing_sound.generation && !E_VoiceStateIsPlaying_(state);
+}
+
+// NOTE(ljre): Game thread only. Frees the handles of voices that ended by themselves.
+static void
+E_ReclaimPlayingSounds_(E_AudioState* audio)
+{
+	for (int32 i = 0; i < audio->playing_sounds_table_size; ++i)
+	{
+		E_PlayingSoundRef_* ref = &audio->playing_sounds_table[i];
+		E_PlayingSoundHandle handle = {
+			.generation = (uint16)ref->generation,
+			.index = (uint16)(i+1),
+		};
+		
+		if (ref->sound.index && E_IsPlayingSoundFinished_(audio, handle))
+			E_DeallocPlayingSoundHandle_(audio, handle);
+	}
+}
+
+// NOTE(ljre): Game thread only. A mix that started after 'mix_count' was read has seen every generation bumped
+//             before that, so once 2 more mixes are done no voice can be reading the samples anymore.
+static void
+E_FreePendingSounds_(E_AudioState* audio)
+{
+	uint32 mix_count = audio->mix_count;
+	
+	for (int32 i = audio->pending_free_count-1; i >= 0; --i)
+	{
+		E_PendingSoundFree_* pending = &audio->pending_frees[i];
+		
+		if (mix_count - pending->mix_count >= 2)
+		{
+			OS_HeapFree(pending->samples);
+			*pending = audio->pending_frees[--audio->pending_free_count];
+		}
+	}
+}
+
+//~ Streams
+static void
+E_FillSoundStream_(E_SoundStream_* stream)
+{
+	Trace();
+	
+	if (!stream->vorbis)
+	{
+		int32 err;
+		stream->vorbis = stb_vorbis_open_memory(stream->ogg.data, (int32)stream->ogg.size, &err, NULL);
+		
+		if (!stream->vorbis)
+		{
+			stream->end_reached = true;
+			return;
+		}
+	}
+	
+	const uint32 mask = E_Limits_SoundStreamRingFrames - 1;
+	uint32 write_frame = stream->write_frame;
+	// NOTE(ljre): The frames right before 'read_frame' are still read by the mixer's filters.
+	uint32 free_frames = E_Limits_SoundStreamRingFrames - UMix_PadFrames - (write_frame - stream->read_frame);
+	
+	while (free_frames > 0 && !stream->end_reached)
+	{
+		uint32 offset = write_frame & mask;
+		int32 count = (int32)Min(free_frames, E_Limits_SoundStreamRingFrames - offset);
+		float32* dest = stream->ring + offset * stream->channels;
+		int32 decoded;
+		
+		{
+			Trace(); TraceName(Str("stb_vorbis_get_samples_float_interleaved"));
+			decoded = stb_vorbis_get_samples_float_interleaved(stream->vorbis, stream->channels, dest, count * stream->channels);
+		}
+		
+		if (!decoded)
+		{
+			stream->end_reached = true;
+			break;
+		}
+		
+		// NOTE(ljre): The samples need to be visible before the mixer sees the new 'write_frame'.
+		write_frame += (uint32)decoded;
+		free_frames -= (uint32)decoded;
+		OS_MemoryBarrier();
+		stream->write_frame = write_frame;
+	}
+}
+
+static void
+E_SoundStreamJob_(E_ThreadCtx* ctx, void* user_data)
+{
+	Trace();
+	E_SoundStream_* stream = user_data;
+	
+	for (;;)
+	{
+		// NOTE(ljre): A kick that raced with the job that freed the stream. E_OpenSoundStream_ leaves it alone until
+		//             we clear 'job_queued'.
+		if (stream->state == E_SoundStreamState_Free)
+		{
+			stream->job_queued = 0;
+			return;
+		}
+		
+		if (stream->state == E_SoundStreamState_Closing)
+		{
+			if (stream->vorbis)
+				stb_vorbis_close(stream->vorbis);
+			if (stream->ring)
+				OS_HeapFree(stream->ring);
+			
+			stream->vorbis = NULL;
+			stream->ring = NULL;
+			stream->job_queued = 0;
+			OS_MemoryBarrier();
+			stream->state = E_SoundStreamState_Free;
+			return;
+		}
+		
+		E_FillSoundStream_(stream);
+		
+		// NOTE(ljre): If the stream was closed while we were decoding, whoever closed it couldn't queue us again,
+		//             so we take care of it ourselves.
+		stream->job_queued = 0;
+		OS_MemoryBarrier();
+		
+		if (stream->state != E_SoundStreamState_Closing || OS_InterlockedCompareExchange32(&stream->job_queued, 1, 0) != 0)
+			return;
+	}
+}
+
+static void
+E_KickSoundStream_(E_SoundStream_* stream, E_ThreadCounter* counter)
+{
+	if (OS_InterlockedCompareExchange32(&stream->job_queued, 1, 0) == 0)
+	{
+		E_QueueThreadWork(&(E_ThreadWork) {
+			.callback = E_SoundStreamJob_,
+			.data = stream,
+			.counter = counter,
+		});
+	}
+}
+
+// NOTE(ljre): How many frames E_RenderAudio mixes between refills of the streams. Way less than a ring holds.
+static const int32 g_audio_offline_callback_frames = 1024;
+
+// NOTE(ljre): Offline only, where nothing else kicks the streams. Fills all of them as much as possible and waits
+//             for it, so the mixer never runs past what was decoded.
+static void
+E_FillSoundStreamsAndWait_(E_AudioState* audio)
+{
+	Trace();
+	E_ThreadCounter counter = { 0 };
+	
+	for (int32 i = 0; i < E_Limits_MaxSoundStreams; ++i)
+	{
+		E_SoundStream_* stream = &audio->streams[i];
+		
+		if (stream->state == E_SoundStreamState_Active && !stream->end_reached)
+			E_KickSoundStream_(stream, &counter);
+	}
+	
+	E_WaitThreadCounter(&counter);
+}
+
+// NOTE(ljre): Game thread only.
+static int32
+E_OpenSoundStream_(E_AudioState* audio, E_SoundHandle sound, const E_LoadedSound_* loaded_sound)
+{
+	for (int32 i = 0; i < E_Limits_MaxSoundStreams; ++i)
+	{
+		E_SoundStream_* stream = &audio->streams[i];
+		
+		if (stream->state != E_SoundStreamState_Free || stream->job_queued)
+			continue;
+		
+		OS_MemoryBarrier();
+		*stream = (E_SoundStream_) {
+			.state = E_SoundStreamState_Active,
+			.sound = sound,
+			.ogg = loaded_sound->ogg,
+			.ring = OS_HeapAlloc(sizeof(float32) * E_Limits_SoundStreamRingFrames * loaded_sound->channels),
+			.channels = loaded_sound->channels,
+		};
+		
+		return i+1;
+	}
+	
+	return 0;
+}
+
+// NOTE(ljre): Mixer only.
+static void
+E_CloseSoundStream_(E_AudioState* audio, int32 stream_index)
+{
+	E_SoundStream_* stream = &audio->streams[stream_index-1];
+	
+	stream->state = E_SoundStreamState_Closing;
+	OS_MemoryBarrier();
+	stream->kick_requested = 1;
+}
+
+// NOTE(ljre): Game thread only. Queueing work might take a lock or wait for room, which the real-time mixer must
+//             never do, so it only asks for its streams to be refilled or closed and this queues the jobs.
+static void
+E_KickRequestedSoundStreams_(E_AudioState* audio)
+{
+	for (int32 i = 0; i < E_Limits_MaxSoundStreams; ++i)
+	{
+		E_SoundStream_* stream = &audio->streams[i];
+		
+		if (stream->kick_requested && OS_InterlockedCompareExchange32(&stream->kick_requested, 0, 1) == 1)
+			E_KickSoundStream_(stream, NULL);
+	}
+}
+
+
+//~ Playing sounds
+// NOTE(ljre): Mixer only.
+static bool
+E_IsPlayingSoundStale_(E_AudioState* audio, const E_PlayingSound_* playing)
+{ return (uint16)audio->playing_sounds_table[playing->handle.index-1].generation != playing->handle.generation; }
+
+// NOTE(ljre): Mixer only. The game thread is told about voices that ended, not about the ones it stopped itself.
+static void
+E_RemovePlayingSound_(E_AudioState* audio, int32 index)
+{
+	E_PlayingSound_* playing = &audio->playing_sounds[index];
+	
+	if (playing->stream_index)
+		E_CloseSoundStream_(audio, playing->stream_index);
+	if (!E_IsPlayingSoundStale_(audio, playing))
+		audio->voice_states[playing->handle.index-1] = E_MakeVoiceState_(playing->handle, false, playing->position);
+	
+	int32 last = --audio->playing_sounds_size;
+	audio->playing_sounds[index] = audio->playing_sounds[last];
+}
+
+//~ Fades
+// NOTE(ljre): How long E_StopSound takes to silence a voice, in seconds.
+static const float32 g_audio_stop_fade = 0.005f;
+
+// NOTE(ljre): Gain of the fades of the voice at 'frame' of the mixer clock. Each fade is linear.
+static float32
+E_VoiceFadeGain_(const E_PlayingSound_* playing, uint64 frame)
+{
+	if (frame < playing->start_frame)
+		return 0.0f;
+	
+	float32 gain = 1.0f;
+	uint64 since_start = frame - playing->start_frame;
+	
+	if (since_start < (uint64)playing->fade_in_frames)
+		gain = (float32)since_start / (float32)playing->fade_in_frames;
+	
+	if (frame >= playing->stop_frame)
+	{
+		uint64 since_stop = frame - playing->stop_frame;
+		
+		if (since_stop < (uint64)playing->fade_out_frames)
+			gain *= 1.0f - (float32)since_stop / (float32)playing->fade_out_frames;
+		else
+			gain = 0.0f;
+	}
+	
+	return gain;
+}
+
+// NOTE(ljre): First frame of the mixer clock where the voice is silent for good.
+static inline uint64
+E_VoiceEndFrame_(const E_PlayingSound_* playing)
+{ return (playing->stop_frame == UINT64_MAX) ? UINT64_MAX : playing->stop_frame + (uint64)playing->fade_out_frames; }
+
+// NOTE(ljre): Mixer only. 'clock_frame' is where the mixer is at. If the voice is already fading out, what's left of
+//             that fade goes into its volume, so the new one doesn't make it jump back up.
+static void
+E_StopPlayingSoundAt_(E_PlayingSound_* playing, uint64 clock_frame, uint64 frame, int32 fade_out_frames)
+{
+	if (playing->stop_frame < clock_frame)
+	{
+		uint64 since_stop = clock_frame - playing->stop_frame;
+		
+		if (since_stop < (uint64)playing->fade_out_frames)
+			playing->volume *= 1.0f - (float32)since_stop / (float32)playing->fade_out_frames;
+		else
+			playing->volume = 0.0f;
+	}
+	
+	playing->stop_frame = Max(frame, clock_frame);
+	playing->fade_out_frames = fade_out_frames;
+	
+	// NOTE(ljre): Stopped before it was ever heard, there's nothing to fade.
+	if (playing->stop_frame <= playing->start_frame)
+		playing->fade_out_frames = 0;
+}
+
+// NOTE(ljre): Mixer only. 'voice' goes into 'out' starting at 'frame' of the mixer clock. Cuts it where a fade
+//             begins or ends, so the gain is linear over each piece and the kernel can ramp it. Returns how many
+//             pieces, at most 3.
+static int32
+E_SplitVoiceAtFades_(const E_PlayingSound_* playing, const UMix_Voice* voice, uint64 frame, float32* out, int32 out_channels, UMix_Voice* out_pieces, float32** out_piece_outs)
+{
+	const uint64 cuts[] = { playing->start_frame + (uint64)playing->fade_in_frames, playing->stop_frame };
+	int32 piece_count = 0;
+	
+	for (int32 done = 0; done < voice->frame_count;)
+	{
+		uint64 at = frame + (uint64)done;
+		int32 length = voice->frame_count - done;
+		
+		for (intsize i = 0; i < ArrayLength(cuts); ++i)
+		{
+			if (cuts[i] > at && cuts[i] - at < (uint64)length)
+				length = (int32)(cuts[i] - at);
+		}
+		
+		float32 from = E_VoiceFadeGain_(playing, at);
+		float32 to = E_VoiceFadeGain_(playing, at + (uint64)length);
+		UMix_Voice* piece = &out_pieces[piece_count];
+		
+		out_piece_outs[piece_count++] = out + done * out_channels;
+		*piece = *voice;
+		piece->frame_count = length;
+		piece->phase = voice->phase + voice->step * (uint64)done;
+		piece->volume = voice->volume * from;
+		piece->volume_step = (from == to) ? 0.0f : voice->volume * (to - from) / (float32)length;
+		done += length;
+	}
+	
+	return piece_count;
+}
+
+//~ Buses
+// NOTE(ljre): Mixer only. How long a change of gain takes to get most of the way there, in seconds.
+static const float32 g_audio_bus_gain_smoothing = 0.01f;
+
+// NOTE(ljre): Mixer only.
+static void
+E_SetAudioBusEffects_(E_AudioState* audio, E_AudioBus_* bus, const E_AudioBusEffects* effects)
+{
+	const float32 sample_rate = (float32)audio->system_sample_rate;
+	bool had_reverb = (bus->effects.reverb_mix > 0.0f);
+	
+	bus->effects = *effects;
+	
+	if (effects->filter != E_AudioFilterKind_None)
+	{
+		static const UDsp_BiquadKind kinds[] = {
+			[E_AudioFilterKind_LowPass] = UDsp_BiquadKind_LowPass,
+			[E_AudioFilterKind_HighPass] = UDsp_BiquadKind_HighPass,
+			[E_AudioFilterKind_BandPass] = UDsp_BiquadKind_BandPass,
+			[E_AudioFilterKind_Peaking] = UDsp_BiquadKind_Peaking,
+		};
+		
+		UDsp_SetBiquad(&bus->filter, kinds[effects->filter], sample_rate, effects->filter_frequency, effects->filter_q, effects->filter_gain);
+	}
+	else
+		bus->filter = (UDsp_Biquad) { 0 };
+	
+	// NOTE(ljre): Whatever tail was left from the last time it was on would come back all at once.
+	if (effects->reverb_mix > 0.0f && !had_reverb)
+		UDsp_ClearReverb(&bus->reverb);
+	UDsp_SetReverb(&bus->reverb, effects->reverb_room_size, effects->reverb_damping, effects->reverb_mix);
+	
+	if (effects->compressor_ratio > 1.0f)
+		UDsp_SetCompressor(&bus->compressor, sample_rate, effects->compressor_threshold, effects->compressor_ratio, effects->compressor_attack, effects->compressor_release, effects->compressor_makeup);
+	else
+		bus->compressor = (UDsp_Compressor) { 0 };
+}
+
+// NOTE(ljre): Mixer only, or E_InitAudio_ before the mixer runs. Everything the buses need is allocated here, the
+//             mixing itself never has to. The device can change its format under us (the default one was switched,
+//             a headset was unplugged...), and then they're made again for it, keeping their gains and effects.
+static void
+E_MakeAudioBuses_(E_AudioState* audio, int32 channels, int32 sample_rate)
+{
+	Trace();
+	
+	ArenaRestore(audio->buses_save);
+	audio->system_channels = channels;
+	audio->system_sample_rate = sample_rate;
+	
+	for (int32 i = 0; i < E_AudioBus_Count; ++i)
+	{
+		E_AudioBus_* bus = &audio->buses[i];
+		E_AudioBusEffects effects = bus->effects;
+		
+		bus->samples = ArenaPushAligned(audio->arena, sizeof(float32) * E_Limits_AudioBlockFrames * channels, 64);
+		UDsp_InitReverb(&bus->reverb, audio->arena, channels, (float32)sample_rate);
+		E_SetAudioBusEffects_(audio, bus, &effects);
+	}
+}
+
+// NOTE(ljre): Mixer only.
+static void
+E_ProcessAudioBus_(E_AudioBus_* bus, int32 channels, int32 frame_count, float32 sample_rate)
+{
+	Trace();
+	
+	if (bus->effects.filter != E_AudioFilterKind_None)
+		UDsp_ProcessBiquad(&bus->filter, bus->samples, channels, frame_count);
+	if (bus->effects.reverb_mix > 0.0f)
+		UDsp_ProcessReverb(&bus->reverb, bus->samples, channels, frame_count);
+	if (bus->effects.compressor_ratio > 1.0f)
+		UDsp_ProcessCompressor(&bus->compressor, bus->samples, channels, frame_count);
+	
+	float32 next_gain = UDsp_SmoothGain(bus->gain, bus->target_gain, frame_count, sample_rate, g_audio_bus_gain_smoothing);
+	UDsp_ApplyGainRamp(bus->samples, channels, frame_count, bus->gain, next_gain);
+	bus->gain = next_gain;
+}
+
+// NOTE(ljre): Game thread only. Returns false if the mixer fell too far behind to take it.
+static bool
+E_PushAudioCommand_(E_AudioState* audio, const E_AudioCommand_* command)
+{
+	uint32 command_write = audio->command_write;
+	if (command_write - audio->command_read >= E_Limits_MaxAudioCommands)
+		return false;
+	
+	audio->commands[command_write & (E_Limits_MaxAudioCommands-1)] = *command;
+	
+	// NOTE(ljre): The command needs to be visible before the mixer sees the new 'command_write'.
+	OS_MemoryBarrier();
+	audio->command_write = command_write + 1;
+	
+	return true;
+}
+
+// NOTE(ljre): Mixer only.
+static void
+E_RunAudioCommands_(E_AudioState* audio)
+{
+	Trace();
+	
+	uint32 command_write = audio->command_write;
+	uint32 command_read = audio->command_read;
+	OS_MemoryBarrier();
+	
+	for (; command_read != command_write; ++command_read)
+	{
+		E_AudioCommand_* command = &audio->commands[command_read & (E_Limits_MaxAudioCommands-1)];
+		
+		switch (command->kind)
+		{
+			case E_AudioCommandKind_Null: Assert(false); break;
+			case E_AudioCommandKind_Play:
+			{
+				E_PlayingSound_* playing = &command->play;
+				
+				// NOTE(ljre): Stopped before it even started.
+				if (E_IsPlayingSoundStale_(audio, playing))
+				{
+					if (playing->stream_index)
+						E_CloseSoundStream_(audio, playing->stream_index);
+					break;
+				}
+				
+				// NOTE(ljre): Voices that were stopped but not dropped yet might still be taking up room.
+				if (audio->playing_sounds_size >= audio->playing_sounds_cap)
+				{
+					if (playing->stream_index)
+						E_CloseSoundStream_(audio, playing->stream_index);
+					audio->voice_states[playing->handle.index-1] = E_MakeVoiceState_(playing->handle, false, 0);
+					break;
+				}
+				
+				// NOTE(ljre): A start that was missed is a start right now, its fade in included.
+				playing->start_frame = Max(playing->start_frame, audio->clock_frame);
+				audio->playing_sounds[audio->playing_sounds_size++] = *playing;
+				audio->voice_states[playing->handle.index-1] = E_MakeVoiceState_(playing->handle, true, 0);
+			} break;
+			case E_AudioCommandKind_Stop:
+			{
+				// NOTE(ljre): Not there if it ended already, or if there was no room for it.
+				for (int32 i = 0; i < audio->playing_sounds_size; ++i)
+				{
+					E_PlayingSound_* playing = &audio->playing_sounds[i];
+					
+					if (playing->handle.index == command->stop.handle.index && playing->handle.generation == command->stop.handle.generation)
+					{
+						E_StopPlayingSoundAt_(playing, audio->clock_frame, command->stop.frame, command->stop.fade_out_frames);
+						break;
+					}
+				}
+			} break;
+			case E_AudioCommandKind_SetBusGain:
+			{
+				audio->buses[command->bus_gain.bus].target_gain = command->bus_gain.gain;
+			} break;
+			case E_AudioCommandKind_SetBusEffects:
+			{
+				E_SetAudioBusEffects_(audio, &audio->buses[command->bus_effects.bus], &command->bus_effects.effects);
+			} break;
+		}
+	}
+	
+	// NOTE(ljre): We're done reading the commands, the game thread can reuse their slots.
+	OS_MemoryBarrier();
+	audio->command_read = command_read;
+}
+
+static UMix_Quality
+E_MixQualityFromResampleQuality_(E_ResampleQuality quality)
+{
+	switch (quality)
+	{
+		case E_ResampleQuality_Linear: return UMix_Quality_Linear;
+		case E_ResampleQuality_Sinc8: return UMix_Quality_Sinc8;
+		default:
+		case E_ResampleQuality_Default:
+		case E_ResampleQuality_Sinc32: return UMix_Quality_Sinc32;
+	}
+}
+
+//~ Voice culling
+enum
+{
+	E_VoiceFlag_Mixed = 1,
+	E_VoiceFlag_Finished = 2,
+};
+
+// NOTE(ljre): 'key' orders voices by priority first, then volume. Both fit in it such that comparing keys as
+//             integers does the right thing: the priority is biased to be unsigned, and positive floats compare
+//             just like their bits do.
+struct E_MixCandidate_
+{
+	uint64 key;
+	int32 index;
+}
+typedef E_MixCandidate_;
+
+static inline E_MixCandidate_
+E_MakeMixCandidate_(const E_PlayingSound_* playing, int32 index)
+{
+	uint32 volume_bits;
+	float32 volume = Max(playing->volume, 0.0f);
+	MemoryCopy(&volume_bits, &volume, sizeof(volume_bits));
+	
+	return (E_MixCandidate_) {
+		.key = (uint64)((uint32)playing->priority ^ 0x80000000u) << 32 | volume_bits,
+		.index = index,
+	};
+}
+
+// NOTE(ljre): 'heap' is a min-heap of the best E_Limits_MaxMixedSounds candidates seen so far, its root being the
+//             first one to go once a better candidate shows up.
+static void
+E_PushMixCandidate_(E_MixCandidate_* heap, int32* heap_count, E_MixCandidate_ candidate)
+{
+	int32 i;
+	
+	if (*heap_count < E_Limits_MaxMixedSounds)
+	{
+		// NOTE(ljre): Sift up.
+		i = (*heap_count)++;
+		
+		while (i > 0 && heap[(i-1)/2].key > candidate.key)
+		{
+			heap[i] = heap[(i-1)/2];
+			i = (i-1)/2;
+		}
+		
+		heap[i] = candidate;
+		return;
+	}
+	
+	if (candidate.key <= heap[0].key)
+		return;
+	
+	// NOTE(ljre): Replace the root and sift down.
+	i = 0;
+	
+	for (;;)
+	{
+		int32 child = i*2 + 1;
+		
+		if (child >= *heap_count)
+			break;
+		if (child+1 < *heap_count && heap[child+1].key < heap[child].key)
+			++child;
+		if (heap[child].key >= candidate.key)
+			break;
+		
+		heap[i] = heap[child];
+		i = child;
+	}
+	
+	heap[i] = candidate;
+}
+
 //~ Internal API
+// NOTE(ljre): Either there's a device pulling samples, or the game does it through E_RenderAudio.
+static inline bool
+E_HasAudio_(void)
+{ return global_engine.os->has_audio || global_engine.audio->offline; }
+
 static void
 E_InitAudio_(void)
 {
 	Trace();
-	if (!global_engine.os->has_audio)
+	if (!E_HasAudio_())
 		return;
 	
 	E_AudioState* audio = global_engine.audio;
-	Arena* arena = global_engine.audio_thread_arena;
+	Arena* arena = global_engine.persistent_arena;
 	
 	const int32 max_loaded_sounds = E_Limits_MaxLoadedSounds;
 	const int32 max_playing_sounds = E_Limits_MaxPlayingSounds;
 	
-	audio->arena = arena;
+	// NOTE(ljre): The audio arena is only the mixer's scratch memory, everything that lives on goes in the
+	//             persistent one.
+	audio->arena = global_engine.audio_thread_arena;
 	audio->system_sample_rate = global_engine.os->audio.mix_sample_rate;
 	audio->system_channels = global_engine.os->audio.mix_channels;
 	
+	if (audio->offline)
+	{
+		audio->system_sample_rate = E_Limits_OfflineAudioSampleRate;
+		audio->system_channels = E_Limits_OfflineAudioChannels;
+	}
+	
 	audio->loaded_sounds_table_size = max_loaded_sounds;
 	audio->loaded_sounds_table_first_free = 1;
 	audio->loaded_sounds_table = ArenaPushArray(arena, E_LoadedSoundRef_, max_loaded_sounds);
@@ -164,6 +1005,11 @@ E_InitAudio_(void)
 	for (int32 i = 0; i < max_playing_sounds-1; ++i)
 		audio->playing_sounds_table[i].next_free = i+2;
 	
+	// NOTE(ljre): No handle has this generation yet, so no voice looks finished before the mixer takes it in.
+	audio->voice_states = ArenaPushArray(arena, uint64, max_playing_sounds);
+	for (int32 i = 0; i < max_playing_sounds; ++i)
+		audio->voice_states[i] = E_MakeVoiceState_((E_PlayingSoundHandle) { .generation = UINT16_MAX }, false, 0);
+	
 	audio->playing_sounds_size = 0;
 	audio->playing_sounds_cap = max_playing_sounds;
 	audio->playing_sounds = ArenaPushArray(arena, E_PlayingSound_, max_playing_sounds);
@@ -172,8 +1018,19 @@ E_InitAudio_(void)
 	audio->loaded_sounds_cap = max_loaded_sounds;
 	audio->loaded_sounds = ArenaPushArray(arena, E_LoadedSound_, max_loaded_sounds);
 	
-	OS_InitRWLock(&audio->lock);
+	audio->commands = ArenaPushArray(arena, E_AudioCommand_, E_Limits_MaxAudioCommands);
+	UMix_InitTables();
+	
+	for (int32 i = 0; i < E_AudioBus_Count; ++i)
+	{
+		audio->buses[i].gain = (i == E_AudioBus_Master) ? 0.25f : 1.0f;
+		audio->buses[i].target_gain = audio->buses[i].gain;
+	}
+	
+	audio->buses_save = ArenaSave(audio->arena);
+	E_MakeAudioBuses_(audio, audio->system_channels, audio->system_sample_rate);
 	
+	OS_MemoryBarrier();
 	audio->ready = true;
 }
 
@@ -187,6 +1044,26 @@ E_DeinitAudio_(void)
 	audio->ready = false;
 }
 
+static void
+E_UpdateAudio_(void)
+{
+	Trace();
+	E_ThreadWorkQueue* queue = global_engine.thread_work_queue;
+	E_AudioState* audio = global_engine.audio;
+	
+	if (!E_HasAudio_())
+		return;
+	
+	E_KickRequestedSoundStreams_(audio);
+	
+	// NOTE(ljre): Without workers, stream jobs only run when the game thread gets to them.
+	if (queue->active_worker_count == 0)
+		while (E_RunThreadWork(NULL, queue));
+	
+	E_ReclaimPlayingSounds_(audio);
+	E_FreePendingSounds_(audio);
+}
+
 static void
 E_AudioThreadProc_(void* user_data, int16* restrict out_buffer, int32 channels, int32 sample_rate, int32 sample_count)
 {
@@ -195,150 +1072,290 @@ E_AudioThreadProc_(void* user_data, int16* restrict out_buffer, int32 channels,
 	if (!audio->ready)
 		return;
 	
+	if (channels != audio->system_channels || sample_rate != audio->system_sample_rate)
+		E_MakeAudioBuses_(audio, channels, sample_rate);
+	
+	uint64 frequency;
+	uint64 begin_tick = OS_CurrentTick(&frequency);
 	ArenaSavepoint scratch_save = ArenaSave(audio->arena);
-	const float32 flt_sample_rate = (float32)sample_rate;
-	const float32 default_master_volume = 0.25f;
+	const float64 flt_sample_rate = (float64)sample_rate;
+	const int32 frame_count_total = sample_count / channels;
+	const uint64 clock_frame = audio->clock_frame;
 	
-	//- Working buffer
-	float32* working_samples = ArenaPushAligned(audio->arena, sizeof(float32)*sample_count, 16);
-	int32 working_channels = channels;
-	int32 working_sample_count = sample_count;
+	//- Take in new voices
+	// NOTE(ljre): Stopped voices fade out within this callback, and are gone by its end. E_FreePendingSounds_
+	//             counts on that.
+	const int32 stop_fade_frames = Min(frame_count_total, (int32)(g_audio_stop_fade * flt_sample_rate));
 	
-	struct ThingToMix
+	for (int32 i = 0; i < audio->playing_sounds_size; ++i)
 	{
-		float32* samples;
-		int32 channels;
-		int32 frame_count;
-		float32 scale;
-		float32 volume;
-	};
+		E_PlayingSound_* playing = &audio->playing_sounds[i];
+		
+		if (E_IsPlayingSoundStale_(audio, playing) && E_VoiceEndFrame_(playing) > clock_frame + (uint64)frame_count_total)
+			E_StopPlayingSoundAt_(playing, clock_frame, clock_frame, stop_fade_frames);
+	}
+	
+	E_RunAudioCommands_(audio);
 	
-	struct ThingToMix things_to_mix[E_Limits_MaxPlayingSounds] = { 0 };
-	int32 things_to_mix_count = 0;
+	//- Pick the voices that are heard
+	const int32 voice_count = audio->playing_sounds_size;
+	uint8* voice_flags = ArenaPushAligned(audio->arena, (uintsize)voice_count + 1, 16);
 	
-	//- Figure out what we need to mix
-	OS_LockExclusive(&audio->lock);
-	for (int32 i = 0; i < audio->playing_sounds_size;)
 	{
-		E_PlayingSound_* playing = &audio->playing_sounds[i];
-		if (Unlikely(!playing->sound.index
-			|| audio->loaded_sounds_table[playing->sound.index-1].generation != playing->sound.generation
-			|| audio->loaded_sounds_table[playing->sound.index-1].next_free != 0))
+		Trace(); TraceName(Str("Voice Culling"));
+		E_MixCandidate_ heap[E_Limits_MaxMixedSounds];
+		int32 heap_count = 0;
+		
+		// NOTE(ljre): Voices that only start after this callback don't need a spot yet.
+		for (int32 i = 0; i < voice_count; ++i)
 		{
-			goto lbl_remove;
+			if (audio->playing_sounds[i].start_frame < clock_frame + (uint64)frame_count_total)
+				E_PushMixCandidate_(heap, &heap_count, E_MakeMixCandidate_(&audio->playing_sounds[i], i));
 		}
+		for (int32 i = 0; i < heap_count; ++i)
+			voice_flags[heap[i].index] |= E_VoiceFlag_Mixed;
+	}
+	
+	int32 mixed_count = 0;
+	
+	// NOTE(ljre): The buses have room for a single block, so the callback is split into as many as it takes.
+	for (int32 block_start = 0; block_start < frame_count_total; block_start += E_Limits_AudioBlockFrames)
+	{
+		const int32 block_frames = Min(frame_count_total - block_start, E_Limits_AudioBlockFrames);
+		const uint64 block_clock = clock_frame + (uint64)block_start;
+		ArenaSavepoint block_save = ArenaSave(audio->arena);
 		
-		E_LoadedSound_* sound = &audio->loaded_sounds[audio->loaded_sounds_table[playing->sound.index-1].index];
-		float32 scale = (float32)sound->sample_rate / flt_sample_rate;
-		int32 temp_channels = Min(working_channels, sound->channels);
+		// NOTE(ljre): Each voice might be split in up to 3 pieces by its fades. See E_SplitVoiceAtFades_.
+		UMix_Voice things_to_mix[E_Limits_MaxMixedSounds * 3];
+		float32* things_to_mix_out[E_Limits_MaxMixedSounds * 3];
+		int32 things_to_mix_count = 0;
+		int32 mixed_voice_count = 0;
 		
-		int32 current_unscaled_frame = (int32)(playing->current_scaled_frame * scale);
-		playing->current_scaled_frame += sample_count / working_channels;
+		for (int32 i = 0; i < E_AudioBus_Count; ++i)
+			MemoryZero(audio->buses[i].samples, sizeof(float32) * block_frames * channels);
 		
+		//- Figure out what we need to mix
+		for (int32 i = 0; i < voice_count; ++i)
 		{
-			Trace(); TraceName(Str("stb_vorbis_seek"));
-			stb_vorbis_seek(sound->vorbis, current_unscaled_frame);
-		}
+			E_PlayingSound_* playing = &audio->playing_sounds[i];
+			bool mixed = (voice_flags[i] & E_VoiceFlag_Mixed);
+			
+			if (voice_flags[i] & E_VoiceFlag_Finished)
+				continue;
+			
+			// NOTE(ljre): The part of the block the voice is heard in. A voice can be stopped before it starts.
+			uint64 end_frame = E_VoiceEndFrame_(playing);
+			bool reaches_end = (end_frame <= block_clock + (uint64)block_frames);
+			
+			if (playing->start_frame >= block_clock + (uint64)block_frames && !reaches_end)
+				continue;
+			
+			int32 offset = (int32)(Clamp(playing->start_frame, block_clock, block_clock + (uint64)block_frames) - block_clock);
+			int32 out_frames = block_frames - offset;
+			
+			if (reaches_end)
+				out_frames = (end_frame > block_clock + (uint64)offset) ? (int32)(end_frame - block_clock - (uint64)offset) : 0;
 		
-		int32 sample_count = (int32)ceilf((float32)working_sample_count * scale);
-		float32* samples = ArenaPushAligned(audio->arena, sizeof(float32)*sample_count, 16);
+			uint64 step = UMix_MakeStep((float64)playing->sample_rate / flt_sample_rate * playing->speed);
+			int32 first_frame = (int32)(playing->position >> 32);
+			uint64 phase = (uint32)playing->position;
+			const float32* samples = NULL;
+			int32 available_frames;
+			bool is_last_chunk;
 		
-		int32 frame_count;
+			if (!playing->stream_index)
+			{
+				samples = playing->samples + (intsize)first_frame * playing->channels;
+				available_frames = playing->sample_count - first_frame;
+				is_last_chunk = true;
+			}
+			else
+			{
+				E_SoundStream_* stream = &audio->streams[playing->stream_index-1];
+				bool end_reached = stream->end_reached;
+				OS_MemoryBarrier();
+				uint32 write_frame = stream->write_frame;
+				OS_MemoryBarrier();
 		
-		{
-			Trace(); TraceName(Str("stb_vorbis_get_samples_float_interleaved"));
-			frame_count = stb_vorbis_get_samples_float_interleaved(sound->vorbis, temp_channels, samples, sample_count);
-		}
+				int32 history = UMix_HistoryFrames(playing->quality);
+				int32 lookahead = UMix_LookaheadFrames(playing->quality);
+				int32 decoded_frames = (int32)(write_frame - (uint32)first_frame);
+				int32 wanted_frames = (int32)((phase + step * out_frames) >> 32) + lookahead + 1;
+				int32 count = Min(decoded_frames, wanted_frames);
+			
+				// NOTE(ljre): Copy out what we need, the ring might wrap in the middle of it. The job leaves the frames
+				//             right before 'read_frame' alone, so the filter still has them. Anything before the start of
+				//             the sound, and after its very end, is silence. Voices that aren't heard still go through the
+				//             ring to keep their decoder in step, since seeking a Vorbis stream isn't cheap.
+				if (mixed)
+				{
+					int32 kept_history = Min(first_frame, history);
+					int32 copy_count = kept_history + count;
+					uint32 copy_first = (uint32)(first_frame - kept_history);
+					float32* copy = ArenaPushAligned(audio->arena, sizeof(float32) * (history + count + lookahead) * playing->channels, 16);
+					float32* dest = copy + (history - kept_history) * playing->channels;
+					const uint32 mask = E_Limits_SoundStreamRingFrames - 1;
+			
+					for (int32 copied = 0; copied < copy_count;)
+					{
+						uint32 ring_offset = (copy_first + copied) & mask;
+						int32 chunk = Min(copy_count - copied, (int32)(E_Limits_SoundStreamRingFrames - ring_offset));
+				
+						MemoryCopy(dest + copied * playing->channels, stream->ring + ring_offset * playing->channels, sizeof(float32) * chunk * playing->channels);
+						copied += chunk;
+					}
 		
-		frame_count = (int32)ceilf((float32)frame_count / scale);
+					samples = copy + history * playing->channels;
+				}
+			
+				available_frames = count;
+				is_last_chunk = end_reached && count == decoded_frames;
+			}
 		
-		struct ThingToMix* thing = &things_to_mix[things_to_mix_count++];
-		thing->samples = samples;
-		thing->channels = temp_channels;
-		thing->frame_count = frame_count;
-		thing->scale = scale;
-		thing->volume = playing->volume;
+			// NOTE(ljre): Every output frame reads a few input frames after the one it's at. Only the very end of the
+			//             sound can rely on the silent frames after it.
+			int32 limit = is_last_chunk ? available_frames : available_frames - UMix_LookaheadFrames(playing->quality);
+			int32 frame_count = UMix_CalcFrameCount(phase, step, limit, out_frames);
 		
-		if (playing->current_scaled_frame * scale >= sound->sample_count * sound->channels)
-		{
-			lbl_remove:;
-			E_DeallocPlayingSoundHandle_(audio, (E_PlayingSoundHandle) {
-				.index = (uint16)(audio->playing_sounds[i].ref_index + 1),
-			});
+			// NOTE(ljre): Voices that aren't heard only move their cursor.
+			if (frame_count > 0 && mixed)
+			{
+				UMix_Voice voice = {
+					.samples = samples,
+					.channels = playing->channels,
+					.frame_count = frame_count,
+					.phase = phase,
+					.step = step,
+					.volume = playing->volume,
+					.quality = playing->quality,
+				};
+				
+				things_to_mix_count += E_SplitVoiceAtFades_(
+					playing, &voice, block_clock + (uint64)offset,
+					audio->buses[playing->bus].samples + offset * channels, channels,
+					&things_to_mix[things_to_mix_count], &things_to_mix_out[things_to_mix_count]);
+				++mixed_voice_count;
+			}
+		
+			playing->position += step * frame_count;
+		
+			if (playing->stream_index)
+			{
+				E_SoundStream_* stream = &audio->streams[playing->stream_index-1];
 			
-			int32 last = --audio->playing_sounds_size;
-			audio->playing_sounds[i] = audio->playing_sounds[last];
-			audio->playing_sounds_table[audio->playing_sounds[i].ref_index].index = i+1;
+				if (frame_count < out_frames && !is_last_chunk && playing->position > 0)
+					OS_InterlockedIncrement32(&audio->stream_underrun_count);
+			
+				// NOTE(ljre): We're done reading the ring, the job can write over everything before our frame.
+				OS_MemoryBarrier();
+				stream->read_frame = (uint32)(playing->position >> 32);
+			
+				if (!audio->offline && !stream->end_reached && stream->write_frame - stream->read_frame <= E_Limits_SoundStreamRingFrames/2)
+					stream->kick_requested = 1;
+			}
+		
+			// NOTE(ljre): A stopped voice's handle might already belong to another one.
+			if (reaches_end || (is_last_chunk && (playing->position >> 32) >= (uint64)(first_frame + available_frames)))
+				voice_flags[i] |= E_VoiceFlag_Finished;
+			else if (!E_IsPlayingSoundStale_(audio, playing))
+				audio->voice_states[playing->handle.index-1] = E_MakeVoiceState_(playing->handle, true, playing->position);
 		}
-		else
-			++i;
-	}
-	OS_UnlockExclusive(&audio->lock);
 	
-	//- Actual mixing
-	for (int32 i = 0; i < things_to_mix_count; ++i)
-	{
-		struct ThingToMix* thing = &things_to_mix[i];
-		Trace(); TraceName(Str("Actual Mixing"));
+		//- Actual mixing
+		for (int32 i = 0; i < things_to_mix_count; ++i)
+		{
+			Trace(); TraceName(Str("Actual Mixing"));
+			UMix_MixVoice(things_to_mix_out[i], channels, &things_to_mix[i]);
+		}
+		
+		mixed_count = Max(mixed_count, mixed_voice_count);
 		
-		// TODO(ljre): Vectorize this loop just ~~to learn~~for the meme? :kekw
-		for (int32 frame_index = 0; frame_index < thing->frame_count; ++frame_index)
+		//- Buses
+		E_AudioBus_* master = &audio->buses[E_AudioBus_Master];
+		
+		for (int32 i = 0; i < E_AudioBus_Count; ++i)
 		{
-			float32 index_to_use = (float32)frame_index * thing->scale;
+			if (i == E_AudioBus_Master)
+				continue;
 			
-			for (int32 channel_index = 0; channel_index < working_channels; ++channel_index)
-			{
-				int32 ch = Min(channel_index, thing->channels-1);
-				int32 ind = (int32)index_to_use;
-				
-				float32 sample_a = thing->samples[(ind+0)*thing->channels + ch];
-				float32 sample_b = thing->samples[(ind+1)*thing->channels + ch];
-				float32 t = index_to_use - (int32)(index_to_use);
-				float32 sample = glm_lerp(sample_a, sample_b, t) * thing->volume;
-				
-				working_samples[frame_index*working_channels + channel_index] += sample;
-			}
+			E_AudioBus_* bus = &audio->buses[i];
+			E_ProcessAudioBus_(bus, channels, block_frames, (float32)sample_rate);
+			
+			for (int32 j = 0; j < block_frames * channels; ++j)
+				master->samples[j] += bus->samples[j];
 		}
-	}
+		
+		E_ProcessAudioBus_(master, channels, block_frames, (float32)sample_rate);
 	
-	//- Cast samples to int16 with saturation.
-	Trace(); TraceName(Str("Conversion"));
-	int32 head = 0;
-	float32 mul_float = INT16_MAX * default_master_volume;
+		//- Cast samples to int16 with saturation.
+		Trace(); TraceName(Str("Conversion"));
+		const float32* working_samples = master->samples;
+		int16* block_out = out_buffer + block_start * channels;
+		const int32 block_sample_count = block_frames * channels;
+		int32 head = 0;
+		float32 mul_float = INT16_MAX;
 	
 #ifdef CONFIG_ARCH_X86FAMILY
-	__m128 mul = _mm_set1_ps(mul_float);
+		__m128 mul = _mm_set1_ps(mul_float);
 	
 #ifdef __clang__
 #	pragma clang loop unroll(disable)
 #endif
-	for (; head+8 <= sample_count; head += 8)
-	{
-		__m128i low_half  = _mm_cvtps_epi32(_mm_mul_ps(_mm_load_ps(&working_samples[head+0]), mul));
-		__m128i high_half = _mm_cvtps_epi32(_mm_mul_ps(_mm_load_ps(&working_samples[head+4]), mul));
+		for (; head+8 <= block_sample_count; head += 8)
+		{
+			__m128i low_half  = _mm_cvtps_epi32(_mm_mul_ps(_mm_load_ps(&working_samples[head+0]), mul));
+			__m128i high_half = _mm_cvtps_epi32(_mm_mul_ps(_mm_load_ps(&working_samples[head+4]), mul));
 		
-		__m128i packed = _mm_packs_epi32(low_half, high_half);
-		_mm_storeu_si128((__m128i*)&out_buffer[head], packed);
-	}
+			__m128i packed = _mm_packs_epi32(low_half, high_half);
+			_mm_storeu_si128((__m128i*)&block_out[head], packed);
+		}
 	
 #ifdef __clang__
 #	pragma clang loop unroll(disable)
 #endif
 #endif //CONFIG_ARCH_X86FAMILY
-	for (; head+1 <= sample_count; head += 1)
-	{
-		float32 sample = working_samples[head] * mul_float;
+		for (; head+1 <= block_sample_count; head += 1)
+		{
+			float32 sample = working_samples[head] * mul_float;
 		
-		if (sample < INT16_MIN)
-			sample = INT16_MIN;
-		else if (sample > INT16_MAX)
-			sample = INT16_MAX;
+			if (sample < INT16_MIN)
+				sample = INT16_MIN;
+			else if (sample > INT16_MAX)
+				sample = INT16_MAX;
 		
-		out_buffer[head] = (int16)sample;
+			block_out[head] = (int16)sample;
+		}
+		
+		ArenaRestore(block_save);
+	}
+	
+	// NOTE(ljre): Backwards, so the voices swapped into the holes were already looked at.
+	for (int32 i = voice_count-1; i >= 0; --i)
+	{
+		if (voice_flags[i] & E_VoiceFlag_Finished)
+			E_RemovePlayingSound_(audio, i);
 	}
 	
 	//- Done
 	ArenaRestore(scratch_save);
+	
+	// NOTE(ljre): A mix slower than the audio it produced means the device ran dry.
+	uint64 mix_ticks = OS_CurrentTick(NULL) - begin_tick;
+	
+	if (mix_ticks * sample_rate > (uint64)frame_count_total * frequency)
+		++audio->late_mix_count;
+	
+	audio->playing_count = audio->playing_sounds_size;
+	audio->mixed_count = mixed_count;
+	audio->last_mix_frames = frame_count_total;
+	audio->last_mix_ticks = mix_ticks;
+	audio->worst_mix_ticks = Max(audio->worst_mix_ticks, mix_ticks);
+	audio->total_mix_ticks += mix_ticks;
+	audio->clock_frame += (uint64)frame_count_total;
+	
+	// NOTE(ljre): Everything above is published by this. See E_FreePendingSounds_.
+	OS_MemoryBarrier();
+	++audio->mix_count;
 }
 
 //~ API
@@ -348,7 +1365,7 @@ E_LoadSound(Buffer ogg, E_SoundHandle* out_sound, E_SoundInfo* out_info)
 	Trace();
 	SafeAssert(ogg.size <= INT32_MAX);
 	
-	if (!global_engine.os->has_audio)
+	if (!E_HasAudio_())
 		return false;
 	
 	E_AudioState* audio = global_engine.audio;
@@ -361,47 +1378,72 @@ E_LoadSound(Buffer ogg, E_SoundHandle* out_sound, E_SoundInfo* out_info)
 	stb_vorbis_info vorbis_info = stb_vorbis_get_info(vorbis);
 	int32 sample_count = stb_vorbis_stream_length_in_samples(vorbis);
 	float32 length = stb_vorbis_stream_length_in_seconds(vorbis);
+	int32 channels = vorbis_info.channels;
+	float32* samples = NULL;
 	
-	E_SoundHandle handle = { 0 };
-	E_SoundInfo info = {
-		.channels = vorbis_info.channels,
-		.sample_rate = vorbis_info.sample_rate,
-		.sample_count = sample_count,
-		.length = length,
-	};
-	E_LoadedSound_ loaded_sound = {
-		.vorbis = vorbis,
-		.channels = vorbis_info.channels,
-		.sample_rate = vorbis_info.sample_rate,
-		.sample_count = sample_count,
-	};
-	
-	bool ok = true;
-	OS_LockExclusive(&audio->lock);
+	// NOTE(ljre): Short sounds are decoded right now, so the mixer never has to touch them again.
+	if (sample_count <= E_Limits_MaxPredecodedSoundFrames)
 	{
-		if (!audio->loaded_sounds_table_first_free)
-			ok = false;
-		else
+		Trace(); TraceName(Str("Predecode"));
+		uintsize samples_size = sizeof(float32) * (sample_count + UMix_PadFrames) * channels;
+		int32 decoded_count = 0;
+		
+		// NOTE(ljre): The mixer's filters read a few frames before and after where a voice is at.
+		samples = (float32*)OS_HeapAlloc(sizeof(float32) * UMix_PadFrames * channels + samples_size) + UMix_PadFrames * channels;
+		MemoryZero(samples - UMix_PadFrames * channels, sizeof(float32) * UMix_PadFrames * channels);
+		
+		while (decoded_count < sample_count)
 		{
-			E_AllocSoundHandle_(audio, &handle);
-			int32 index = audio->loaded_sounds_size++;
-			audio->loaded_sounds[index] = loaded_sound;
-			audio->loaded_sounds_table[handle.index-1].index = index;
+			float32* dest = samples + decoded_count * channels;
+			int32 decoded = stb_vorbis_get_samples_float_interleaved(vorbis, channels, dest, (sample_count - decoded_count) * channels);
+			
+			if (!decoded)
+				break;
+			decoded_count += decoded;
 		}
+		
+		MemoryZero(samples + decoded_count * channels, samples_size - sizeof(float32) * decoded_count * channels);
+		sample_count = decoded_count;
 	}
-	OS_UnlockExclusive(&audio->lock);
 	
-	if (ok)
+	// NOTE(ljre): Streamed sounds get a decoder of their own each time they're played.
+	stb_vorbis_close(vorbis);
+	
+	if (!audio->loaded_sounds_table_first_free)
 	{
-		*out_sound = handle;
+		if (samples)
+			OS_HeapFree(samples - UMix_PadFrames * channels);
+		return false;
+	}
+	
+	E_SoundHandle handle;
+	E_AllocSoundHandle_(audio, &handle);
+	
+	// NOTE(ljre): Slots are reused along with their handles.
+	int32 index = handle.index-1;
+	audio->loaded_sounds_size = Max(audio->loaded_sounds_size, index+1);
+	audio->loaded_sounds_table[index].index = index;
+	audio->loaded_sounds[index] = (E_LoadedSound_) {
+		.samples = samples,
+		.ogg = ogg,
+		.channels = channels,
+		.sample_rate = vorbis_info.sample_rate,
+		.sample_count = sample_count,
+	};
+	
+	*out_sound = handle;
 		
-		if (out_info)
-			*out_info = info;
+	if (out_info)
+	{
+		*out_info = (E_SoundInfo) {
+			.channels = channels,
+			.sample_rate = vorbis_info.sample_rate,
+			.sample_count = sample_count,
+			.length = length,
+		};
 	}
-	else
-		stb_vorbis_close(vorbis);
 	
-	return ok;
+	return true;
 }
 
 API void
@@ -411,18 +1453,63 @@ E_UnloadSound(E_SoundHandle sound)
 	
 	E_AudioState* audio = global_engine.audio;
 	
-	if (!global_engine.os->has_audio)
+	if (!E_HasAudio_())
 		return;
 	if (E_IsValidSoundHandle(sound))
 	{
-		OS_LockExclusive(&audio->lock);
+		E_StopAllSounds(&sound);
 		
 		int32 index = audio->loaded_sounds_table[sound.index-1].index;
-		stb_vorbis_close(audio->loaded_sounds[index].vorbis);
+		E_LoadedSound_ loaded_sound = audio->loaded_sounds[index];
 		MemoryZero(&audio->loaded_sounds[index], sizeof(E_LoadedSound_));
 		E_DeallocSoundHandle_(audio, sound);
 		
-		OS_UnlockExclusive(&audio->lock);
+		// NOTE(ljre): The generations bumped by E_StopAllSounds need to be visible before we read 'mix_count'.
+		OS_MemoryBarrier();
+		uint32 mix_count = audio->mix_count;
+		
+		if (loaded_sound.samples)
+		{
+			// NOTE(ljre): Only happens if the mixer stopped running while lots of sounds were being unloaded.
+			while (audio->pending_free_count >= ArrayLength(audio->pending_frees))
+				E_FreePendingSounds_(audio);
+		
+			audio->pending_frees[audio->pending_free_count++] = (E_PendingSoundFree_) {
+				.samples = loaded_sound.samples - UMix_PadFrames * loaded_sound.channels,
+				.mix_count = mix_count,
+			};
+		}
+		
+		// NOTE(ljre): Streams might still be decoding from the caller's buffer. The mixer closes them once it sees
+		//             their voices were stopped, and then we wait for their jobs. This is the only place the game thread
+		//             waits on the mixer, and only if the sound is still streaming.
+		//
+		//             Offline, the mixer only runs inside of E_RenderAudio, on this same thread, so it would never get
+		//             to them. Take in the stops and drop those voices right here instead; they're cut instead of
+		//             faded out.
+		if (audio->offline)
+		{
+			E_RunAudioCommands_(audio);
+			
+			for (int32 i = audio->playing_sounds_size-1; i >= 0; --i)
+			{
+				E_PlayingSound_* playing = &audio->playing_sounds[i];
+				
+				if (playing->stream_index && E_IsSameSoundHandle_(audio->streams[playing->stream_index-1].sound, sound))
+					E_RemovePlayingSound_(audio, i);
+			}
+		}
+		
+		for (int32 i = 0; i < E_Limits_MaxSoundStreams; ++i)
+		{
+			E_SoundStream_* stream = &audio->streams[i];
+			
+			while (stream->state != E_SoundStreamState_Free && E_IsSameSoundHandle_(stream->sound, sound) && audio->ready)
+			{
+				E_KickRequestedSoundStreams_(audio);
+				E_RunThreadWork(NULL, global_engine.thread_work_queue);
+			}
+		}
 	}
 }
 
@@ -432,7 +1519,7 @@ E_IsValidSoundHandle(E_SoundHandle sound)
 	Trace();
 	E_AudioState* audio = global_engine.audio;
 	
-	if (!global_engine.os->has_audio)
+	if (!E_HasAudio_())
 		return false;
 	if (!sound.index || sound.index > E_Limits_MaxLoadedSounds)
 		return false;
@@ -451,7 +1538,7 @@ E_QuerySoundInfo(E_SoundHandle sound, E_SoundInfo* out_info)
 	E_AudioState* audio = global_engine.audio;
 	bool result = false;
 	
-	if (!global_engine.os->has_audio)
+	if (!E_HasAudio_())
 		return false;
 	if (E_IsValidSoundHandle(sound))
 	{
@@ -475,38 +1562,70 @@ E_PlaySound(E_SoundHandle sound, const E_PlaySoundOptions* options, E_PlayingSou
 	Trace();
 	E_AudioState* audio = global_engine.audio;
 	
-	if (!global_engine.os->has_audio)
+	if (!E_HasAudio_())
 		return false;
 	
-	bool result = false;
-	E_PlayingSoundHandle handle = { 0 };
+	E_LoadedSound_* loaded_sound = E_FetchLoadedSound_(audio, sound);
+	if (!loaded_sound || (uint32)options->bus >= E_AudioBus_Count)
+		return false;
+	
+	if (!audio->playing_sounds_table_first_free)
+		E_ReclaimPlayingSounds_(audio);
+	if (!audio->playing_sounds_table_first_free)
+		return false;
+	
+	// NOTE(ljre): The mixer hasn't caught up with us yet.
+	uint32 command_write = audio->command_write;
+	if (command_write - audio->command_read >= E_Limits_MaxAudioCommands)
+	{
+		++audio->dropped_play_count;
+		return false;
+	}
+	
 	E_PlayingSound_ playing = {
-		.sound = sound,
-		.current_scaled_frame = 0,
+		.samples = loaded_sound->samples,
+		.channels = loaded_sound->channels,
+		.sample_rate = loaded_sound->sample_rate,
+		.sample_count = loaded_sound->sample_count,
 		.volume = options->volume != 0.0f ? options->volume : 1.0f,
 		.speed = options->speed != 0.0f ? options->speed : 1.0f,
+		.priority = options->priority,
+		.quality = E_MixQualityFromResampleQuality_(options->quality),
+		.bus = options->bus,
+		.start_frame = options->start_frame,
+		.stop_frame = UINT64_MAX,
+		.fade_in_frames = (int32)(Max(options->fade_in, 0.0f) * (float32)audio->system_sample_rate),
 	};
 	
-	OS_LockExclusive(&audio->lock);
-	
-	if (audio->playing_sounds_table_first_free)
+	if (!loaded_sound->samples)
 	{
-		E_AllocPlayingSoundHandle_(audio, &handle);
-		result = true;
-		
-		playing.ref_index = handle.index-1;
-		
-		int32 index = audio->playing_sounds_size++;
-		audio->playing_sounds[index] = playing;
-		audio->playing_sounds_table[handle.index-1].index = index;
+		playing.stream_index = E_OpenSoundStream_(audio, sound, loaded_sound);
+		if (!playing.stream_index)
+			return false;
 	}
 	
-	OS_UnlockExclusive(&audio->lock);
+	E_AllocPlayingSoundHandle_(audio, &playing.handle);
+	
+	E_PlayingSoundRef_* ref = &audio->playing_sounds_table[playing.handle.index-1];
+	ref->sound = sound;
+	ref->sample_rate = playing.sample_rate;
+	ref->volume = playing.volume;
+	ref->speed = playing.speed;
+		
+	// NOTE(ljre): There's room for it, we checked above.
+	E_PushAudioCommand_(audio, &(E_AudioCommand_) {
+		.kind = E_AudioCommandKind_Play,
+		.play = playing,
+	});
+	
+	// NOTE(ljre): Start decoding right away. The mixer waits for the first frames before advancing the sound.
+	if (playing.stream_index && !audio->offline)
+		E_KickSoundStream_(&audio->streams[playing.stream_index-1], NULL);
 	
 	if (out_playing)
-		*out_playing = handle;
+		*out_playing = playing.handle;
 	
-	return result;
+	return true;
 }
 
 API bool
@@ -514,65 +1633,71 @@ E_StopSound(E_PlayingSoundHandle playing_sound)
 {
 	Trace();
 	E_AudioState* audio = global_engine.audio;
-	bool result = false;
 	
-	if (!global_engine.os->has_audio)
+	if (!E_HasAudio_())
 		return false;
 	
-	if (playing_sound.index && playing_sound.index <= E_Limits_MaxPlayingSounds)
-	{
-		OS_LockExclusive(&audio->lock);
-		
-		if (audio->playing_sounds_table[playing_sound.index-1].generation == playing_sound.generation
-			&& !audio->playing_sounds_table[playing_sound.index-1].next_free)
-		{
-			int32 index = audio->playing_sounds_table[playing_sound.index-1].index;
-			int32 last = --audio->playing_sounds_size;
-			audio->playing_sounds[index] = audio->playing_sounds[last];
-			audio->playing_sounds_table[audio->playing_sounds[index].ref_index].index = index+1;
-			
-			E_DeallocPlayingSoundHandle_(audio, playing_sound);
-		}
+	E_PlayingSoundRef_* ref = E_FetchPlayingSoundRef_(audio, playing_sound);
+	if (!ref)
+		return false;
 		
-		OS_UnlockExclusive(&audio->lock);
-	}
+	bool result = !E_IsPlayingSoundFinished_(audio, playing_sound);
+	E_DeallocPlayingSoundHandle_(audio, playing_sound);
 	
 	return result;
 }
 
+API bool
+E_StopSoundAt(E_PlayingSoundHandle playing_sound, uint64 frame, float32 fade_out)
+{
+	Trace();
+	E_AudioState* audio = global_engine.audio;
+	
+	if (!E_HasAudio_())
+		return false;
+	
+	E_PlayingSoundRef_* ref = E_FetchPlayingSoundRef_(audio, playing_sound);
+	if (!ref || E_IsPlayingSoundFinished_(audio, playing_sound))
+		return false;
+	
+	return E_PushAudioCommand_(audio, &(E_AudioCommand_) {
+		.kind = E_AudioCommandKind_Stop,
+		.stop = {
+			.handle = playing_sound,
+			.frame = frame,
+			.fade_out_frames = (int32)(Max(fade_out, 0.0f) * (float32)audio->system_sample_rate),
+		},
+	});
+}
+
 API bool
 E_QueryPlayingSoundInfo(E_PlayingSoundHandle playing_sound, E_PlayingSoundInfo* out_info)
 {
 	Trace();
 	E_AudioState* audio = global_engine.audio;
-	bool result = false;
 	
-	if (!global_engine.os->has_audio)
+	if (!E_HasAudio_())
 		return false;
 	
-	if (playing_sound.index && playing_sound.index <= E_Limits_MaxPlayingSounds)
-	{
-		OS_LockExclusive(&audio->lock);
+	E_PlayingSoundRef_* ref = E_FetchPlayingSoundRef_(audio, playing_sound);
+	if (!ref)
+		return false;
 		
-		if (audio->playing_sounds_table[playing_sound.index-1].generation == playing_sound.generation
-			&& !audio->playing_sounds_table[playing_sound.index-1].next_free)
-		{
-			result = true;
+	uint64 state = audio->voice_states[playing_sound.index-1];
+	if (E_VoiceStateGeneration_(state) == playing_sound.generation && !E_VoiceStateIsPlaying_(state))
+		return false;
 			
-			E_PlayingSound_* playing = &audio->playing_sounds[audio->playing_sounds_table[playing_sound.index-1].index];
+	// NOTE(ljre): If the mixer didn't take the voice in yet, it's still at the start.
+	uint32 frame = (E_VoiceStateGeneration_(state) == playing_sound.generation) ? E_VoiceStateFrame_(state) : 0;
 			
-			*out_info = (E_PlayingSoundInfo) {
-				.sound = playing->sound,
-				.at = playing->current_scaled_frame / (float32)audio->system_sample_rate,
-				.speed = playing->speed,
-				.volume = playing->volume,
-			};
-		}
+	*out_info = (E_PlayingSoundInfo) {
+		.sound = ref->sound,
+		.at = (float32)frame / (float32)ref->sample_rate,
+		.speed = ref->speed,
+		.volume = ref->volume,
+	};
 		
-		OS_UnlockExclusive(&audio->lock);
-	}
-	
-	return result;
+	return true;
 }
 
 API void
@@ -581,24 +1706,21 @@ E_StopAllSounds(E_SoundHandle* specific)
 	Trace();
 	E_AudioState* audio = global_engine.audio;
 	
-	if (!global_engine.os->has_audio)
+	if (!E_HasAudio_())
 		return;
 	
-	OS_LockExclusive(&audio->lock);
-	
-	for (int32 i = 0; i < audio->playing_sounds_size; ++i)
+	for (int32 i = 0; i < audio->playing_sounds_table_size; ++i)
 	{
-		if (!specific || E_IsSameSoundHandle_(*specific, audio->playing_sounds[i].sound))
+		E_PlayingSoundRef_* ref = &audio->playing_sounds_table[i];
+	
+		if (ref->sound.index && (!specific || E_IsSameSoundHandle_(*specific, ref->sound)))
 		{
 			E_DeallocPlayingSoundHandle_(audio, (E_PlayingSoundHandle) {
-				.index = (uint16)(audio->playing_sounds[i].ref_index + 1),
+				.generation = (uint16)ref->generation,
+				.index = (uint16)(i+1),
 			});
-			
-			audio->playing_sounds[i].sound = (E_SoundHandle) { 0 };
 		}
 	}
-	
-	OS_UnlockExclusive(&audio->lock);
 }
 
 API bool
@@ -606,24 +1728,157 @@ E_IsValidPlayingSoundHandle(E_PlayingSoundHandle playing_sound)
 {
 	Trace();
 	E_AudioState* audio = global_engine.audio;
-	bool result = true;
 	
-	if (!global_engine.os->has_audio)
+	if (!E_HasAudio_())
+		return false;
+	if (!E_FetchPlayingSoundRef_(audio, playing_sound))
+		return false;
+	if (E_IsPlayingSoundFinished_(audio, playing_sound))
 		return false;
 	
-	if (!playing_sound.index || playing_sound.index > E_Limits_MaxPlayingSounds)
-		result = false;
-	else
+	return true;
+}
+	
+API bool
+E_QueryAudioStats(E_AudioStats* out_stats)
+{
+	Trace();
+	E_AudioState* audio = global_engine.audio;
+	
+	if (!E_HasAudio_() || !audio->ready)
+		return false;
+	
+	uint64 frequency;
+	OS_CurrentTick(&frequency);
+	
+	*out_stats = (E_AudioStats) {
+		.mix_count = audio->mix_count,
+		.playing_count = audio->playing_count,
+		.mixed_count = audio->mixed_count,
+		.stream_underrun_count = audio->stream_underrun_count,
+		.late_mix_count = audio->late_mix_count,
+		.dropped_play_count = audio->dropped_play_count,
+		.last_mix_time = (float32)((float64)audio->last_mix_ticks / (float64)frequency),
+		.worst_mix_time = (float32)((float64)audio->worst_mix_ticks / (float64)frequency),
+		.total_mix_time = (float64)audio->total_mix_ticks / (float64)frequency,
+		.total_mix_length = (float64)audio->clock_frame / (float64)audio->system_sample_rate,
+		.last_mix_length = (float32)audio->last_mix_frames / (float32)audio->system_sample_rate,
+	};
+	
+	return true;
+}
+
+API bool
+E_QueryAudioClock(uint64* out_frame, int32* out_sample_rate)
+{
+	Trace();
+	E_AudioState* audio = global_engine.audio;
+	
+	if (!E_HasAudio_() || !audio->ready)
+		return false;
+	
+	if (out_frame)
+		*out_frame = audio->clock_frame;
+	if (out_sample_rate)
+		*out_sample_rate = audio->system_sample_rate;
+	
+	return true;
+}
+
+API bool
+E_SetAudioBusGain(E_AudioBus bus, float32 gain)
+{
+	Trace();
+	E_AudioState* audio = global_engine.audio;
+	
+	if (!E_HasAudio_() || (uint32)bus >= E_AudioBus_Count)
+		return false;
+	
+	return E_PushAudioCommand_(audio, &(E_AudioCommand_) {
+		.kind = E_AudioCommandKind_SetBusGain,
+		.bus_gain = {
+			.bus = bus,
+			.gain = Max(gain, 0.0f),
+		},
+	});
+}
+
+API bool
+E_SetAudioBusEffects(E_AudioBus bus, const E_AudioBusEffects* effects)
+{
+	Trace();
+	E_AudioState* audio = global_engine.audio;
+	
+	if (!E_HasAudio_() || (uint32)bus >= E_AudioBus_Count)
+		return false;
+	if ((uint32)effects->filter > E_AudioFilterKind_Peaking)
+		return false;
+	
+	return E_PushAudioCommand_(audio, &(E_AudioCommand_) {
+		.kind = E_AudioCommandKind_SetBusEffects,
+		.bus_effects = {
+			.bus = bus,
+			.effects = *effects,
+		},
+	});
+}
+
+API bool
+E_RenderAudio(int16* out_samples, int32 frame_count)
+{
+	Trace();
+	E_AudioState* audio = global_engine.audio;
+	
+	if (!audio->offline || !audio->ready)
+		return false;
+	
+	const int32 channels = audio->system_channels;
+	
+	// NOTE(ljre): In callbacks of about what a device would ask for, so the streams are refilled in between.
+	for (int32 frame = 0; frame < frame_count; frame += g_audio_offline_callback_frames)
 	{
-		OS_LockExclusive(&audio->lock);
-		
-		if (audio->playing_sounds_table[playing_sound.index-1].generation != playing_sound.generation)
-			result = false;
-		else if (audio->playing_sounds_table[playing_sound.index-1].next_free)
-			result = false;
+		int32 count = Min(frame_count - frame, g_audio_offline_callback_frames);
 		
-		OS_UnlockExclusive(&audio->lock);
+		E_FillSoundStreamsAndWait_(audio);
+		E_AudioThreadProc_(audio, out_samples + frame*channels, channels, audio->system_sample_rate, count*channels);
 	}
 	
-	return result;
+	E_UpdateAudio_();
+	
+	return true;
+}
+
+API bool
+E_RenderAudioToWav(Arena* output_arena, int32 frame_count, Buffer* out_wav)
+{
+	Trace();
+	E_AudioState* audio = global_engine.audio;
+	
+	if (!audio->offline || !audio->ready)
+		return false;
+	
+	const uint32 block_align = (uint32)audio->system_channels * sizeof(int16);
+	const uint32 data_size = (uint32)frame_count * block_align;
+	
+	E_WavHeader_* header = ArenaPushAligned(output_arena, sizeof(E_WavHeader_) + data_size, 16);
+	*header = (E_WavHeader_) {
+		.riff_id = { 'R', 'I', 'F', 'F' },
+		.riff_size = sizeof(E_WavHeader_) - 8 + data_size,
+		.wave_id = { 'W', 'A', 'V', 'E' },
+		.fmt_id = { 'f', 'm', 't', ' ' },
+		.fmt_size = 16,
+		.format = 1, // NOTE(ljre): PCM
+		.channels = (uint16)audio->system_channels,
+		.sample_rate = (uint32)audio->system_sample_rate,
+		.byte_rate = (uint32)audio->system_sample_rate * block_align,
+		.block_align = (uint16)block_align,
+		.bits_per_sample = 16,
+		.data_id = { 'd', 'a', 't', 'a' },
+		.data_size = data_size,
+	};
+	
+	E_RenderAudio((int16*)(header + 1), frame_count);
+	*out_wav = BufMake(sizeof(E_WavHeader_) + data_size, header);
+	
+	return true;
 }
@@ -4,6 +4,8 @@ E_FinishFrame(void)
 {
 	Trace();
 	
+	E_UpdateAssetStream_();
+	E_UpdateAudio_();
 	ArenaClear(global_engine.frame_arena);
 	TraceFrameEnd();
 	RB_Present(global_engine.renderbackend);
@@ -60,7 +62,7 @@ OS_UserMain(const OS_UserMainArgs* args)
 		const uintsize sz_scratch     = 32ull << 20;
 		const uintsize sz_frame       = 32ull << 20;
 		const uintsize sz_persistent  = 64ull << 20;
-		const uintsize sz_audiothread = 256ull << 10;
+		const uintsize sz_audiothread = 1ull << 20;
 		
 		uintsize game_memory_size = sz_frame + sz_persistent + sz_audiothread + sz_scratch*args->thread_count;
 		void* game_memory = OS_VirtualReserve(NULL, game_memory_size);
@@ -165,9 +167,9 @@ E_AppSetup_(const OS_SetupArgs* args, OS_InitDesc* out_init)
 	const uintsize sz_scratch     = 32ull << 20;
 	const uintsize sz_frame       = 32ull << 20;
 	const uintsize sz_persistent  = 64ull << 20;
-	const uintsize sz_audiothread = 256ull << 10;
+	const uintsize sz_audiothread = 1ull << 20;
 	
-	uintsize game_memory_size = sz_frame + sz_persistent + sz_audiothread + sz_scratch*(1+worker_thread_count);
+	uintsize game_memory_size = sz_frame + sz_persistent + sz_audiothread + sz_scratch;
 	void* game_memory = OS_VirtualReserve(NULL, game_memory_size);
 	
 	global_engine.game_memory = game_memory;
@@ -176,6 +178,8 @@ E_AppSetup_(const OS_SetupArgs* args, OS_InitDesc* out_init)
 	global_engine.running = true;
 	global_engine.enable_vsync = true;
 	global_engine.worker_thread_count = worker_thread_count;
+	global_engine.argc = args->argc;
+	global_engine.argv = args->argv;
 	
 	// NOTE(ljre): Reserving pieces of the game memory to different arenas
 	{
@@ -191,15 +195,6 @@ E_AppSetup_(const OS_SetupArgs* args, OS_InitDesc* out_init)
 		global_engine.persistent_arena = ArenaFromUncommitedMemory(memory_head, sz_persistent, pagesize);
 		memory_head += sz_persistent;
 		
-		for (int32 i = 0; i < worker_thread_count; ++i)
-		{
-			E_ThreadCtx* ctx = &global_engine.worker_threads[i];
-			
-			ctx->id = i+1;
-			ctx->scratch_arena = ArenaFromUncommitedMemory(memory_head, sz_scratch, pagesize);
-			memory_head += sz_scratch;
-		}
-		
 		global_engine.audio_thread_arena = ArenaFromUncommitedMemory(memory_head, sz_audiothread, sz_audiothread);
 		memory_head += sz_audiothread;
 		
@@ -207,15 +202,26 @@ E_AppSetup_(const OS_SetupArgs* args, OS_InitDesc* out_init)
 	}
 	
 	// NOTE(ljre): Allocate structs
-	global_engine.thread_work_queue = ArenaPushStruct(global_engine.persistent_arena, E_ThreadWorkQueue);
 	global_engine.audio = ArenaPushStruct(global_engine.audio_thread_arena, E_AudioState);
+	global_engine.worker_threads = ArenaPushArray(global_engine.persistent_arena, E_ThreadCtx, worker_thread_count);
 	
-	if (worker_thread_count > 0)
+	for (int32 i = 0; i < worker_thread_count; ++i)
+		global_engine.worker_threads[i] = (E_ThreadCtx) { .id = i+1 };
+	
+	bool use_job_fibers = false;
+	for (int32 i = 1; i < args->argc; ++i)
 	{
-		OS_InitSemaphore(&global_engine.thread_work_queue->semaphore, worker_thread_count);
-		OS_InitEventSignal(&global_engine.thread_work_queue->reached_zero_doing_work_sig);
+		String arg = StrMake(MemoryStrlen(args->argv[i]), args->argv[i]);
+		
+		// NOTE(ljre): Only a request. Without OS fibers (Android), the job system quietly stays in thread mode.
+		if (StringEquals(arg, Str("-job-fibers")))
+			use_job_fibers = true;
+		else if (StringEquals(arg, Str("-offline-audio")))
+			global_engine.audio->offline = true;
 	}
 	
+	E_InitThreadWork_(worker_thread_count, use_job_fibers);
+	E_InitAssetStream_();
 	OS_InitRWLock(&global_engine.mt_lock);
 	
 	*out_init = (OS_InitDesc) {
@@ -268,7 +274,13 @@ E_AppWorkerThreadProc_(void* user_data, int32 index)
 static void
 E_AppPullAudioSamples_(void* user_data, int16* restrict out_buffer, int32 channels, int32 sample_rate, int32 sample_count)
 {
-	E_AudioThreadProc_(user_data, out_buffer, channels, sample_rate, sample_count);
+	E_AudioState* audio = user_data;
+	
+	// NOTE(ljre): The game pulls the samples itself through E_RenderAudio.
+	if (audio->offline)
+		MemoryZero(out_buffer, sizeof(int16) * sample_count);
+	else
+		E_AudioThreadProc_(user_data, out_buffer, channels, sample_rate, sample_count);
 }
 
 API const OS_AppApi*
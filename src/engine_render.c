@@ -14,6 +14,12 @@ static RB_Shader g_render_quadshader;
 static RB_Pipeline g_render_quadpipeline;
 static RB_Capabilities g_render_caps;
 
+enum
+{
+	// NOTE(ljre): The quad shaders only sample 4 textures, even though the backend can bind more.
+	E_RectBatchMaxDrawTextures_ = 4,
+};
+
 static const char g_render_gl_quadvshader[] =
 "layout (location=0) in vec2  aPos;\n"
 "layout (location=1) in mat2  aScaling;\n"
@@ -121,6 +127,143 @@ struct E_QuadVertex91_
 }
 typedef E_QuadVertex91_;
 
+struct E_RectUniforms_
+{
+	mat4 view;
+	vec2 texsize[RB_Limits_DrawMaxTextures];
+}
+typedef E_RectUniforms_;
+
+//- Software kernels
+// NOTE(ljre): The GLSL quad shaders for the software backend. The varyings are the texcoords (0, 1), the color (2..5),
+//             the scale (6, 7), the raw position (8, 9) and the flat texindex (10, 11).
+static void
+E_QuadSoftwareVs_(const RB_SoftwareVertex* vertex, float32 out_position[4], float32* out_varyings)
+{
+	const E_RectUniforms_* uniforms = vertex->uniforms;
+	const float32* pos = vertex->inputs[0];
+	const float32* scaling0 = vertex->inputs[1];
+	const float32* scaling1 = vertex->inputs[2];
+	const float32* texindex = vertex->inputs[3];
+	const float32* texcoords = vertex->inputs[4];
+	const float32* color = vertex->inputs[5];
+	float32 rawpos[2] = { (float32)(vertex->vertex_id & 1), (float32)(vertex->vertex_id >> 1) };
+	
+	float32 local[4] = {
+		pos[0] + scaling0[0]*rawpos[0] + scaling1[0]*rawpos[1],
+		pos[1] + scaling0[1]*rawpos[0] + scaling1[1]*rawpos[1],
+		0.0f,
+		1.0f,
+	};
+	
+	for (int32 i = 0; i < 4; ++i)
+		out_position[i] = uniforms->view[0][i]*local[0] + uniforms->view[1][i]*local[1] + uniforms->view[2][i]*local[2] + uniforms->view[3][i]*local[3];
+	
+	out_varyings[0] = texcoords[0] + texcoords[2]*rawpos[0];
+	out_varyings[1] = texcoords[1] + texcoords[3]*rawpos[1];
+	out_varyings[2] = color[0];
+	out_varyings[3] = color[1];
+	out_varyings[4] = color[2];
+	out_varyings[5] = color[3];
+	out_varyings[6] = sqrtf(scaling0[0]*scaling0[0] + scaling0[1]*scaling0[1]);
+	out_varyings[7] = sqrtf(scaling1[0]*scaling1[0] + scaling1[1]*scaling1[1]);
+	out_varyings[8] = rawpos[0];
+	out_varyings[9] = rawpos[1];
+	out_varyings[10] = texindex[0];
+	out_varyings[11] = texindex[1];
+}
+
+static void
+E_QuadSoftwareFs_(const RB_SoftwareFragment* fragment, float32 out_color[4])
+{
+	const E_RectUniforms_* uniforms = fragment->uniforms;
+	const float32* texcoords = &fragment->varyings[0];
+	const float32* vcolor = &fragment->varyings[2];
+	const float32* scale = &fragment->varyings[6];
+	const float32* rawpos = &fragment->varyings[8];
+	int32 slot = (int32)fragment->varyings[10];
+	int32 kind = (int32)fragment->varyings[11];
+	float32 color[4];
+	
+	if (slot < 0 || slot >= E_RectBatchMaxDrawTextures_)
+		slot = 0;
+	
+	RB_SoftwareSample(fragment, slot, texcoords, fragment->ddx, fragment->ddy, color);
+	
+	if (kind == 1)
+	{
+		float32 r = 0.5f * Min(scale[0], scale[1]);
+		float32 qx = fabsf((rawpos[0] - 0.5f) * 2.0f * scale[0]) - scale[0] + r;
+		float32 qy = fabsf((rawpos[1] - 0.5f) * 2.0f * scale[1]) - scale[1] + r;
+		float32 outx = Max(qx, 0.0f);
+		float32 outy = Max(qy, 0.0f);
+		float32 dist = Min(Max(qx, qy), 0.0f) + sqrtf(outx*outx + outy*outy) - r;
+		
+		if (dist >= -1.0f)
+			color[3] *= Max(1.0f - (dist+1.0f)*0.5f, 0.0f);
+	}
+	else if (kind == 2)
+	{
+		// NOTE(ljre): fwidth() is the sum of both derivatives.
+		float32 density_x = (fabsf(fragment->ddx[0]) + fabsf(fragment->ddy[0])) * uniforms->texsize[slot][0];
+		float32 density_y = (fabsf(fragment->ddx[1]) + fabsf(fragment->ddy[1])) * uniforms->texsize[slot][1];
+		float32 m = Min(density_x, density_y);
+		float32 a = (color[0] - 128.0f/255.0f + 24.0f/255.0f*m*0.5f) * 255.0f/24.0f / m;
+		
+		color[0] = color[1] = color[2] = 1.0f;
+		color[3] = a;
+	}
+	
+	for (int32 i = 0; i < 4; ++i)
+		out_color[i] = color[i] * vcolor[i];
+}
+
+//- Software dispatch
+struct E_RenderSoftwareJob_
+{
+	RB_SoftwareJobProc* proc;
+	void* data;
+	intsize index;
+}
+typedef E_RenderSoftwareJob_;
+
+static void
+E_RenderSoftwareJobAsync_(E_ThreadCtx* ctx, void* data)
+{
+	E_RenderSoftwareJob_* job = data;
+	job->proc(job->data, job->index);
+}
+
+// NOTE(ljre): Lets the software backend run its tiles on the job system.
+static void
+E_RenderSoftwareDispatch_(void* user_data, intsize count, RB_SoftwareJobProc* proc, void* data)
+{
+	Trace();
+	
+	for ArenaTempScope(global_engine.scratch_arena)
+	{
+		E_RenderSoftwareJob_* jobs = ArenaPushArray(global_engine.scratch_arena, E_RenderSoftwareJob_, count);
+		E_ThreadCounter counter = { 0 };
+		
+		for (intsize i = 0; i < count; ++i)
+		{
+			jobs[i] = (E_RenderSoftwareJob_) {
+				.proc = proc,
+				.data = data,
+				.index = i,
+			};
+			
+			E_QueueThreadWork(&(E_ThreadWork) {
+				.callback = E_RenderSoftwareJobAsync_,
+				.data = &jobs[i],
+				.counter = &counter,
+			});
+		}
+		
+		E_WaitThreadCounter(&counter);
+	}
+}
+
 static void
 E_InitRender_(void)
 {
@@ -128,6 +271,7 @@ E_InitRender_(void)
 	
 	RB_Ctx* renderbackend = RB_MakeContext(global_engine.persistent_arena, global_engine.os->graphics_context);
 	global_engine.renderbackend = renderbackend;
+	RB_SetSoftwareDispatch(renderbackend, E_RenderSoftwareDispatch_, NULL);
 	
 	// NOTE(ljre): Print capabilities
 	{
@@ -162,6 +306,13 @@ E_InitRender_(void)
 			StrInit(g_render_gl_quadvshader),
 			StrInit(g_render_gl_quadfshader),
 		},
+		.software = {
+			.vs = E_QuadSoftwareVs_,
+			.fs = E_QuadSoftwareFs_,
+			.varying_count = 12,
+			.flat_varying_count = 2,
+			.derivative_count = 2,
+		},
 	});
 	
 	if (g_render_caps.shader_type >= RB_ShaderType_Hlsl40)
@@ -169,7 +320,7 @@ E_InitRender_(void)
 		uint16 ibuf[6] = { 0, 1, 2, 2, 3, 1 };
 		
 		g_render_quadvbuf = RB_MakeVertexBuffer(renderbackend, &(RB_VBufferDesc) {
-			.flag_dynamic = true,
+			.flag_ring = true,
 			.size = sizeof(E_QuadVertex_)*1024,
 		});
 		
@@ -239,8 +390,8 @@ E_InitRender_(void)
 		}
 		
 		g_render_quadvbuf = RB_MakeVertexBuffer(renderbackend, &(RB_VBufferDesc) {
-			.flag_dynamic = true,
-			.size = sizeof(E_QuadVertex91_)*1024,
+			.flag_ring = true,
+			.size = sizeof(E_QuadVertex91_)*4*1024,
 		});
 		
 		g_render_quadibuf = RB_MakeIndexBuffer(renderbackend, &(RB_IBufferDesc) {
@@ -394,10 +545,16 @@ E_MakeTex2d(const E_Tex2dDesc* desc, E_Tex2d* out_tex)
 	
 	const void* pixels;
 	int32 width, height;
+	int32 mip_count = 1;
 	RB_TexFormat format;
 	bool needs_to_call_stbi_image_free = false;
 	
-	if (desc->encoded_image.size)
+	if (desc->encoded_image.size && UPak_ParseCookedTex(desc->encoded_image.data, desc->encoded_image.size, &width, &height, &mip_count, &pixels))
+	{
+		// NOTE(ljre): Cooked textures go straight to the backend.
+		format = RB_TexFormat_RGBA8;
+	}
+	else if (desc->encoded_image.size)
 	{
 		SafeAssert(desc->encoded_image.size <= INT32_MAX);
 		
@@ -432,6 +589,7 @@ E_MakeTex2d(const E_Tex2dDesc* desc, E_Tex2d* out_tex)
 			.width = width,
 			.height = height,
 			.format = format,
+			.mip_count = mip_count,
 		}),
 		.width = width,
 		.height = height,
@@ -661,195 +819,212 @@ E_MakeFont(const E_FontDesc* desc, E_Font* out_font)
 	return true;
 }
 
-API void
-E_DrawRectBatch(const E_RectBatch* batch, const E_Camera2D* cam)
+struct E_RectVerticesData_
 {
-	Trace();
-	RB_Ctx* rb = global_engine.renderbackend;
-	Arena* scratch_arena = global_engine.scratch_arena;
+	// NOTE(ljre): Only one of these is set, depending on the batch's 'flag_packed'.
+	E_RectBatchElem* elements;
+	E_QuadVertex_* packed_elements;
+	
+	intsize count;
+	void* vertices; // NOTE(ljre): Already offset to the first element's vertices.
+	int16 tex_remap[E_Limits_RectBatchMaxTextures];
+	bool level91;
+}
+typedef E_RectVerticesData_;
+
+// NOTE(ljre): Rects drawn with the same textures. Its spans are parts of batches, one after another in the scratch
+//             arena, each with the remap from the slots of its batch to the ones of the draw.
+struct E_RectDraw_
+{
+	E_Tex2d textures[E_RectBatchMaxDrawTextures_];
+	int32 texture_count;
+	bool flag_as_is; // NOTE(ljre): A single packed span that doesn't need remapping, uploaded untouched.
 	
-	struct
-	{
-		mat4 view;
-		vec2 texsize[RB_Limits_DrawMaxTextures];
-	}
-	ubuffer = { 0 };
+	E_RectVerticesData_* spans;
+	intsize span_count;
+	intsize count;
+}
+typedef E_RectDraw_;
+
+// NOTE(ljre): Rects per job when converting batches to vertices. Smaller batches are done on the calling thread.
+static const intsize g_render_rects_per_job = 16 << 10;
+// NOTE(ljre): Rects converted in the scratch arena and appended to the vertex buffer at once. Bigger draws are split.
+static const intsize g_render_rects_per_draw = 256 << 10;
+
+static inline void
+E_PackRect_(E_QuadVertex_* out, const E_RectBatchElem* elem, int16 tex_index)
+{
+	out->pos[0] = elem->pos[0];
+	out->pos[1] = elem->pos[1];
+	out->scaling[0][0] = elem->scaling[0][0];
+	out->scaling[0][1] = elem->scaling[0][1];
+	out->scaling[1][0] = elem->scaling[1][0];
+	out->scaling[1][1] = elem->scaling[1][1];
+	out->texindex[0] = tex_index;
+	out->texindex[1] = elem->tex_kind;
+	out->texcoords[0] = elem->texcoords[0];
+	out->texcoords[1] = elem->texcoords[1];
+	out->texcoords[2] = elem->texcoords[2];
+	out->texcoords[3] = elem->texcoords[3];
+	
+#if defined(CONFIG_ARCH_X86FAMILY)
+	// NOTE(ljre): Truncates just like the casts below, all 4 channels at once.
+	__m128i color = _mm_cvttps_epi32(_mm_mul_ps(_mm_loadu_ps(elem->color), _mm_set1_ps(255.0f)));
+	color = _mm_packs_epi32(color, color);
+	color = _mm_packus_epi16(color, color);
+	
+	int32 packed_color = _mm_cvtsi128_si32(color);
+	MemoryCopy(out->color, &packed_color, sizeof(out->color));
+#else
+	out->color[0] = (uint8)(255.0f*elem->color[0]);
+	out->color[1] = (uint8)(255.0f*elem->color[1]);
+	out->color[2] = (uint8)(255.0f*elem->color[2]);
+	out->color[3] = (uint8)(255.0f*elem->color[3]);
+#endif
+}
+
+static void
+E_WriteRectVertices_(const E_RectVerticesData_* data)
+{
+	Trace();
 	
-	if (!cam)
+	if (!data->level91)
 	{
-		cam = &(E_Camera2D) {
-			.pos = { 0.0f, 0.0f },
-			.size = { (float32)global_engine.os->window.width, (float32)global_engine.os->window.height },
-			.zoom = 1.0f,
-			.angle = 0.0f,
-		};
-	}
-	
-	E_CalcViewMatrix2D(cam, ubuffer.view);
+		E_QuadVertex_* vertices = data->vertices;
 	
-	for (intsize i = 0; i < ArrayLength(batch->textures); ++i)
-	{
-		if (!RB_IsNull(batch->textures[i].handle))
+		if (data->elements)
 		{
-			ubuffer.texsize[i][0] = batch->textures[i].width;
-			ubuffer.texsize[i][1] = batch->textures[i].height;
+			for (intsize i = 0; i < data->count; ++i)
+			{
+				const E_RectBatchElem* elem = &data->elements[i];
+				E_PackRect_(&vertices[i], elem, data->tex_remap[(uint16)elem->tex_index % E_Limits_RectBatchMaxTextures]);
+			}
 		}
 		else
 		{
-			ubuffer.texsize[i][0] = 2.0f;
-			ubuffer.texsize[i][1] = 2.0f;
-		}
-	}
-	
-	RB_UpdateUniformBuffer(rb, g_render_quadubuf, BufMake(sizeof(ubuffer), &ubuffer));
-	
-	if (g_render_caps.shader_type >= RB_ShaderType_Hlsl40)
-	{
-		intsize count = (intsize)batch->count;
-		uintsize size = sizeof(E_QuadVertex_) * count;
-		E_QuadVertex_* vertices = ArenaPushDirtyAligned(scratch_arena, size, 16);
-		
-		for (intsize i = 0; i < count; ++i)
-		{
-			E_RectBatchElem* elem = &batch->elements[i];
+			MemoryCopy(vertices, data->packed_elements, sizeof(E_QuadVertex_) * data->count);
 			
-			vertices[i] = (E_QuadVertex_) {
-				.pos = {
-					elem->pos[0],
-					elem->pos[1],
-				},
-				.scaling = {
-					elem->scaling[0][0], elem->scaling[0][1],
-					elem->scaling[1][0], elem->scaling[1][1],
-				},
-				.color = {
-					(uint8)(255.0f*elem->color[0]),
-					(uint8)(255.0f*elem->color[1]),
-					(uint8)(255.0f*elem->color[2]),
-					(uint8)(255.0f*elem->color[3]),
-				},
-				.texcoords = {
-					elem->texcoords[0],
-					elem->texcoords[1],
-					elem->texcoords[2],
-					elem->texcoords[3],
-				},
-				.texindex = { elem->tex_index, elem->tex_kind },
-			};
+			for (intsize i = 0; i < data->count; ++i)
+				vertices[i].texindex[0] = data->tex_remap[(uint16)vertices[i].texindex[0] % E_Limits_RectBatchMaxTextures];
 		}
-		
-		RB_UpdateVertexBuffer(rb, g_render_quadvbuf, BufMake(size, vertices));
-		ArenaPop(scratch_arena, vertices);
 	}
 	else
 	{
-		intsize count = (intsize)batch->count;
-		uintsize size = sizeof(E_RectBatchElem) * count * 4;
-		E_QuadVertex91_* vertices = ArenaPushDirtyAligned(scratch_arena, size, 16);
+		E_QuadVertex91_* vertices = data->vertices;
 		
-		for (intsize i = 0; i < count; ++i)
+		for (intsize i = 0; i < data->count; ++i)
 		{
-			E_RectBatchElem* elem = &batch->elements[i];
+			E_QuadVertex_ elem;
+			
+			if (data->elements)
+				E_PackRect_(&elem, &data->elements[i], data->elements[i].tex_index);
+			else
+				elem = data->packed_elements[i];
+			
+			int16 tex_index = data->tex_remap[(uint16)elem.texindex[0] % E_Limits_RectBatchMaxTextures];
 			vec2 size = {
-				sqrtf(elem->scaling[0][0]*elem->scaling[0][0] + elem->scaling[0][1]*elem->scaling[0][1]),
-				sqrtf(elem->scaling[1][0]*elem->scaling[1][0] + elem->scaling[1][1]*elem->scaling[1][1]),
-			};
-			uint8 color[4] = {
-				(uint8)(255.0f*elem->color[0]),
-				(uint8)(255.0f*elem->color[1]),
-				(uint8)(255.0f*elem->color[2]),
-				(uint8)(255.0f*elem->color[3]),
+				sqrtf(elem.scaling[0][0]*elem.scaling[0][0] + elem.scaling[0][1]*elem.scaling[0][1]),
+				sqrtf(elem.scaling[1][0]*elem.scaling[1][0] + elem.scaling[1][1]*elem.scaling[1][1]),
 			};
 			
 			vertices[i*4 + 0] = (E_QuadVertex91_) {
-				.pos = { elem->pos[0], elem->pos[1] },
+				.pos = { elem.pos[0], elem.pos[1] },
 				.normpos = { 0.0f, 0.0f },
 				.size = { size[0], size[1] },
-				.texindex = { elem->tex_index, elem->tex_kind },
-				.texcoords = { elem->texcoords[0], elem->texcoords[1] },
-				.color = { color[0], color[1], color[2], color[3], },
+				.texindex = { tex_index, elem.texindex[1] },
+				.texcoords = { elem.texcoords[0], elem.texcoords[1] },
+				.color = { elem.color[0], elem.color[1], elem.color[2], elem.color[3], },
 			};
 			
 			vertices[i*4 + 1] = (E_QuadVertex91_) {
-				.pos = { elem->pos[0], elem->pos[1] },
+				.pos = { elem.pos[0], elem.pos[1] },
 				.normpos = { 1.0f, 0.0f },
 				.size = { size[0], size[1] },
-				.texindex = { elem->tex_index, elem->tex_kind },
-				.texcoords = { elem->texcoords[0] + elem->texcoords[2], elem->texcoords[1] },
-				.color = { color[0], color[1], color[2], color[3], },
+				.texindex = { tex_index, elem.texindex[1] },
+				.texcoords = { elem.texcoords[0] + elem.texcoords[2], elem.texcoords[1] },
+				.color = { elem.color[0], elem.color[1], elem.color[2], elem.color[3], },
 			};
 			
 			vertices[i*4 + 2] = (E_QuadVertex91_) {
-				.pos = { elem->pos[0], elem->pos[1] },
+				.pos = { elem.pos[0], elem.pos[1] },
 				.normpos = { 0.0f, 1.0f },
 				.size = { size[0], size[1] },
-				.texindex = { elem->tex_index, elem->tex_kind },
-				.texcoords = { elem->texcoords[0], elem->texcoords[1] + elem->texcoords[3] },
-				.color = { color[0], color[1], color[2], color[3], },
+				.texindex = { tex_index, elem.texindex[1] },
+				.texcoords = { elem.texcoords[0], elem.texcoords[1] + elem.texcoords[3] },
+				.color = { elem.color[0], elem.color[1], elem.color[2], elem.color[3], },
 			};
 			
 			vertices[i*4 + 3] = (E_QuadVertex91_) {
-				.pos = { elem->pos[0], elem->pos[1] },
+				.pos = { elem.pos[0], elem.pos[1] },
 				.normpos = { 1.0f, 1.0f },
 				.size = { size[0], size[1] },
-				.texindex = { elem->tex_index, elem->tex_kind },
-				.texcoords = { elem->texcoords[0] + elem->texcoords[2], elem->texcoords[1] + elem->texcoords[3] },
-				.color = { color[0], color[1], color[2], color[3], },
+				.texindex = { tex_index, elem.texindex[1] },
+				.texcoords = { elem.texcoords[0] + elem.texcoords[2], elem.texcoords[1] + elem.texcoords[3] },
+				.color = { elem.color[0], elem.color[1], elem.color[2], elem.color[3], },
 			};
 			
 			vec2 tmp;
-			glm_mat2_mulv(elem->scaling, vertices[i*4 + 1].normpos, tmp);
+			glm_mat2_mulv(elem.scaling, vertices[i*4 + 1].normpos, tmp);
 			glm_vec2_add(tmp, vertices[i*4 + 1].pos, vertices[i*4 + 1].pos);
-			glm_mat2_mulv(elem->scaling, vertices[i*4 + 2].normpos, tmp);
+			glm_mat2_mulv(elem.scaling, vertices[i*4 + 2].normpos, tmp);
 			glm_vec2_add(tmp, vertices[i*4 + 2].pos, vertices[i*4 + 2].pos);
-			glm_mat2_mulv(elem->scaling, vertices[i*4 + 3].normpos, tmp);
+			glm_mat2_mulv(elem.scaling, vertices[i*4 + 3].normpos, tmp);
 			glm_vec2_add(tmp, vertices[i*4 + 3].pos, vertices[i*4 + 3].pos);
 		}
-		
-		RB_UpdateVertexBuffer(rb, g_render_quadvbuf, BufMake(size, vertices));
-		ArenaPop(scratch_arena, vertices);
 	}
-	
-	RB_CmdApplyPipeline(rb, g_render_quadpipeline);
-	
+}
+
+static void
+E_WriteRectVerticesAsync_(E_ThreadCtx* ctx, void* data)
+{
+	E_WriteRectVertices_(data);
+}
+
+// NOTE(ljre): Draws 'count' rects whose vertices start at 'offset' in g_render_quadvbuf.
+static void
+E_DrawRectVertices_(uint32 offset, intsize count, bool level91, const E_Tex2d textures[E_RectBatchMaxDrawTextures_])
+{
+	RB_Tex2d draw_textures[RB_Limits_DrawMaxTextures] = { 0 };
 	uint32 instance_count = 0;
-	uint32 index_count = batch->count * 6;
-	uint32 offset = 0;
+	uint32 index_count = (uint32)count * 6;
 	uint32 vertex_size = sizeof(E_QuadVertex_);
 	
-	if (g_render_caps.shader_type < RB_ShaderType_Hlsl40 && g_render_caps.shader_type >= RB_ShaderType_Hlsl40Level91)
+	for (intsize i = 0; i < E_RectBatchMaxDrawTextures_; ++i)
+		draw_textures[i] = !RB_IsNull(textures[i].handle) ? textures[i].handle : g_render_whitetex;
+	
+	if (level91)
 	{
-		intsize batches = batch->count / (UINT16_MAX/4);
+		intsize full_draws = count / (UINT16_MAX/4);
 		vertex_size = sizeof(E_QuadVertex91_);
 		
-		for (intsize i = 0; i < batches; ++i)
+		for (intsize i = 0; i < full_draws; ++i)
 		{
-			RB_CmdDraw(global_engine.renderbackend, &(RB_DrawDesc) {
+			RB_DrawDesc desc = {
 				.ibuffer = g_render_quadibuf,
 				.ubuffer = g_render_quadubuf,
 				.vbuffers = { g_render_quadvbuf, },
 				.strides = { vertex_size },
 				.offsets = { offset },
 				.index_count = UINT16_MAX/4*6,
-				.textures = {
-					[0] = !RB_IsNull(batch->textures[0].handle) ? batch->textures[0].handle : g_render_whitetex,
-					[1] = !RB_IsNull(batch->textures[1].handle) ? batch->textures[1].handle : g_render_whitetex,
-					[2] = !RB_IsNull(batch->textures[2].handle) ? batch->textures[2].handle : g_render_whitetex,
-					[3] = !RB_IsNull(batch->textures[3].handle) ? batch->textures[3].handle : g_render_whitetex,
-				},
-			});
+			};
+			
+			MemoryCopy(desc.textures, draw_textures, sizeof(desc.textures));
+			RB_CmdDraw(global_engine.renderbackend, &desc);
 			
-			offset += vertex_size * UINT16_MAX / 4;
+			offset += vertex_size * 4 * (UINT16_MAX/4);
 			index_count -= UINT16_MAX/4*6;
 		}
+		
+		if (!index_count)
+			return;
 	}
 	else
 	{
-		instance_count = batch->count;
+		instance_count = (uint32)count;
 		index_count = 6;
 	}
 	
-	RB_CmdDraw(global_engine.renderbackend, &(RB_DrawDesc) {
+	RB_DrawDesc desc = {
 		.ibuffer = g_render_quadibuf,
 		.ubuffer = g_render_quadubuf,
 		.vbuffers = { g_render_quadvbuf },
@@ -857,13 +1032,312 @@ E_DrawRectBatch(const E_RectBatch* batch, const E_Camera2D* cam)
 		.offsets = { offset },
 		.index_count = index_count,
 		.instance_count = instance_count,
-		.textures = {
-			[0] = !RB_IsNull(batch->textures[0].handle) ? batch->textures[0].handle : g_render_whitetex,
-			[1] = !RB_IsNull(batch->textures[1].handle) ? batch->textures[1].handle : g_render_whitetex,
-			[2] = !RB_IsNull(batch->textures[2].handle) ? batch->textures[2].handle : g_render_whitetex,
-			[3] = !RB_IsNull(batch->textures[3].handle) ? batch->textures[3].handle : g_render_whitetex,
-		},
-	});
+	};
+	
+	MemoryCopy(desc.textures, draw_textures, sizeof(desc.textures));
+	RB_CmdDraw(global_engine.renderbackend, &desc);
+}
+
+static int32
+E_FindRectDrawSlot_(E_RectDraw_* draw, E_Tex2d texture)
+{
+	RB_Ctx* rb = global_engine.renderbackend;
+	int32 slot = 0;
+	
+	while (slot < draw->texture_count && !RB_IsSame(rb, draw->textures[slot].handle, texture.handle))
+		++slot;
+	
+	if (slot == draw->texture_count)
+	{
+		if (draw->texture_count >= ArrayLength(draw->textures))
+			return -1;
+		
+		draw->textures[draw->texture_count++] = texture;
+	}
+
+	return slot;
+}
+
+static void
+E_PushRectDrawSpan_(E_RectDraw_* draw, const E_RectBatch* batch, intsize first, intsize count, const int16* tex_remap, bool level91)
+{
+	E_RectVerticesData_* span = ArenaPushStruct(global_engine.scratch_arena, E_RectVerticesData_);
+	
+	if (batch->flag_packed)
+		span->packed_elements = batch->packed_elements + first;
+	else
+		span->elements = batch->elements + first;
+	
+	span->count = count;
+	span->level91 = level91;
+	
+	// NOTE(ljre): Slots that none of the rects use are -1.
+	for (int32 i = 0; i < E_Limits_RectBatchMaxTextures; ++i)
+		span->tex_remap[i] = ClampMin(tex_remap[i], 0);
+	
+	if (!draw->span_count)
+		draw->spans = span;
+	
+	draw->span_count += 1;
+	draw->count += count;
+	draw->flag_as_is = false;
+}
+
+static void
+E_FlushRectDraw_(E_RectDraw_* draw, E_RectUniforms_* uniforms, bool level91)
+{
+	RB_Ctx* rb = global_engine.renderbackend;
+	Arena* scratch_arena = global_engine.scratch_arena;
+	
+	if (draw->count > 0)
+	{
+		for (intsize i = 0; i < ArrayLength(draw->textures); ++i)
+		{
+			if (!RB_IsNull(draw->textures[i].handle))
+			{
+				uniforms->texsize[i][0] = draw->textures[i].width;
+				uniforms->texsize[i][1] = draw->textures[i].height;
+			}
+			else
+			{
+				uniforms->texsize[i][0] = 2.0f;
+				uniforms->texsize[i][1] = 2.0f;
+			}
+		}
+	
+		RB_UpdateUniformBuffer(rb, g_render_quadubuf, BufMake(sizeof(*uniforms), uniforms));
+	
+		if (draw->flag_as_is)
+		{
+			Buffer data = BufMake(sizeof(E_QuadVertex_) * draw->count, draw->spans[0].packed_elements);
+			uint32 offset = RB_AppendVertexBuffer(rb, g_render_quadvbuf, data);
+			E_DrawRectVertices_(offset, draw->count, level91, draw->textures);
+		}
+		else
+		{
+			uintsize rect_size = level91 ? sizeof(E_QuadVertex91_) * 4 : sizeof(E_QuadVertex_);
+			intsize span_index = 0;
+			intsize span_first = 0;
+		
+			// NOTE(ljre): Every draw of at most g_render_rects_per_draw rects is split in jobs of at most
+			//             g_render_rects_per_job rects, written straight to their place in the vertices. Small draws
+			//             don't go through the job system at all.
+			for (intsize first = 0; first < draw->count; first += g_render_rects_per_draw)
+			{
+				intsize draw_count = Min(g_render_rects_per_draw, draw->count - first);
+				uint8* vertices = ArenaPushDirtyAligned(scratch_arena, rect_size * draw_count, 16);
+				E_ThreadCounter counter = { 0 };
+		
+				for (intsize done = 0; done < draw_count;)
+				{
+					E_RectVerticesData_* data = &draw->spans[span_index];
+					intsize j = first + done - span_first;
+			
+					if (j >= data->count)
+					{
+						span_first += data->count;
+						++span_index;
+						continue;
+					}
+				
+					E_RectVerticesData_* job = ArenaPushStructData(scratch_arena, E_RectVerticesData_, data);
+					job->elements = data->elements ? data->elements + j : NULL;
+					job->packed_elements = data->packed_elements ? data->packed_elements + j : NULL;
+					job->count = Min(Min(g_render_rects_per_job, data->count - j), draw_count - done);
+					job->vertices = vertices + rect_size * done;
+				
+					if (draw->count <= g_render_rects_per_job)
+						E_WriteRectVertices_(job);
+					else
+					{
+						E_QueueThreadWork(&(E_ThreadWork) {
+							.callback = E_WriteRectVerticesAsync_,
+							.data = job,
+							.counter = &counter,
+						});
+					}
+			
+					done += job->count;
+				}
+		
+				E_WaitThreadCounter(&counter);
+		
+				uint32 offset = RB_AppendVertexBuffer(rb, g_render_quadvbuf, BufMake(rect_size * draw_count, vertices));
+				E_DrawRectVertices_(offset, draw_count, level91, draw->textures);
+				ArenaPop(scratch_arena, vertices);
+			}
+		}
+	}
+	
+	if (draw->span_count)
+		ArenaPop(scratch_arena, draw->spans);
+	
+	*draw = (E_RectDraw_) { 0 };
+}
+
+// NOTE(ljre): Adds the whole batch to 'draw' if the textures of its slots fit, without looking at the rects.
+static bool
+E_MergeRectBatch_(E_RectDraw_* draw, const E_RectBatch* batch, const E_Tex2d* slot_textures, int32 last_set, bool level91)
+{
+	E_RectDraw_ merged = *draw;
+	int16 tex_remap[E_Limits_RectBatchMaxTextures];
+	bool as_is = (draw->count == 0 && batch->flag_packed && !level91);
+	
+	for (int32 i = 0; i <= last_set; ++i)
+	{
+		int32 slot = E_FindRectDrawSlot_(&merged, slot_textures[i]);
+		
+		if (slot == -1)
+			return false;
+		
+		tex_remap[i] = (int16)slot;
+		as_is &= (slot == i);
+	}
+	
+	// NOTE(ljre): Rects shouldn't use the slots after the last one set. They draw white if the draw has it.
+	int32 white_slot = 0;
+	
+	for (int32 i = 0; i < merged.texture_count; ++i)
+	{
+		if (RB_IsSame(global_engine.renderbackend, merged.textures[i].handle, g_render_whitetex))
+			white_slot = i;
+	}
+	
+	for (int32 i = last_set + 1; i < E_Limits_RectBatchMaxTextures; ++i)
+		tex_remap[i] = (int16)white_slot;
+	
+	E_PushRectDrawSpan_(&merged, batch, 0, batch->count, tex_remap, level91);
+	merged.flag_as_is = as_is;
+	*draw = merged;
+	
+	return true;
+}
+
+// NOTE(ljre): The batch alone has more textures than a draw can sample, so look at the slot of every rect and start
+//             a new draw whenever one doesn't fit.
+static void
+E_SplitRectBatch_(E_RectDraw_* draw, E_RectUniforms_* uniforms, const E_RectBatch* batch, const E_Tex2d* slot_textures, bool level91)
+{
+	int16 tex_remap[E_Limits_RectBatchMaxTextures];
+	intsize first = 0;
+	
+	for (int32 i = 0; i < E_Limits_RectBatchMaxTextures; ++i)
+		tex_remap[i] = -1;
+	
+	for (intsize i = 0; i < batch->count; ++i)
+	{
+		int16 tex_index = batch->flag_packed ? batch->packed_elements[i].texindex[0] : batch->elements[i].tex_index;
+		int32 slot = (uint16)tex_index % E_Limits_RectBatchMaxTextures;
+		
+		if (tex_remap[slot] != -1)
+			continue;
+		
+		int32 draw_slot = E_FindRectDrawSlot_(draw, slot_textures[slot]);
+		
+		if (draw_slot == -1)
+		{
+			E_PushRectDrawSpan_(draw, batch, first, i - first, tex_remap, level91);
+			E_FlushRectDraw_(draw, uniforms, level91);
+			
+			for (int32 j = 0; j < E_Limits_RectBatchMaxTextures; ++j)
+				tex_remap[j] = -1;
+			
+			first = i;
+			draw_slot = E_FindRectDrawSlot_(draw, slot_textures[slot]);
+		}
+		
+		tex_remap[slot] = (int16)draw_slot;
+	}
+	
+	E_PushRectDrawSpan_(draw, batch, first, batch->count - first, tex_remap, level91);
+}
+
+API void
+E_DrawRectBatch(const E_RectBatch* batch, const E_Camera2D* cam)
+{
+	E_DrawRectBatches(batch, 1, cam);
+}
+
+API void
+E_DrawRectBatches(const E_RectBatch* batches, intsize batch_count, const E_Camera2D* cam)
+{
+	Trace();
+	RB_Ctx* rb = global_engine.renderbackend;
+	bool level91 = (g_render_caps.shader_type < RB_ShaderType_Hlsl40);
+	E_RectUniforms_ uniforms = { 0 };
+	E_RectDraw_ draw = { 0 };
+	
+	// NOTE(ljre): A compound literal inside of the 'if' would be gone by the time we use it.
+	E_Camera2D default_cam = {
+		.pos = { 0.0f, 0.0f },
+		.size = { (float32)global_engine.os->window.width, (float32)global_engine.os->window.height },
+		.zoom = 1.0f,
+		.angle = 0.0f,
+	};
+	
+	if (!cam)
+		cam = &default_cam;
+	
+	E_CalcViewMatrix2D(cam, uniforms.view);
+	RB_CmdApplyPipeline(rb, g_render_quadpipeline);
+	
+	//- Merge batches into as few draws as their textures allow
+	for (intsize i = 0; i < batch_count; ++i)
+	{
+		const E_RectBatch* batch = &batches[i];
+		E_Tex2d slot_textures[E_Limits_RectBatchMaxTextures];
+		int32 last_set = -1;
+		
+		if (!batch->count)
+			continue;
+		
+		// NOTE(ljre): Null slots draw as the white texture, so they all share a slot with it.
+		for (int32 j = 0; j < E_Limits_RectBatchMaxTextures; ++j)
+		{
+			slot_textures[j] = batch->textures[j];
+			
+			if (!RB_IsNull(slot_textures[j].handle))
+				last_set = j;
+			else
+				slot_textures[j] = E_WhiteTexture();
+		}
+		
+		bool merged = E_MergeRectBatch_(&draw, batch, slot_textures, last_set, level91);
+		
+		if (!merged && draw.count > 0)
+		{
+			E_FlushRectDraw_(&draw, &uniforms, level91);
+			merged = E_MergeRectBatch_(&draw, batch, slot_textures, last_set, level91);
+		}
+		
+		if (!merged)
+			E_SplitRectBatch_(&draw, &uniforms, batch, slot_textures, level91);
+	}
+	
+	E_FlushRectDraw_(&draw, &uniforms, level91);
+}
+
+static inline bool
+E_IsRectBatchAtArenaEnd_(const E_RectBatch* batch)
+{
+	if (batch->flag_packed)
+		return batch->packed_elements + batch->count == (E_QuadVertex_*)ArenaEnd(batch->arena);
+	else
+		return batch->elements + batch->count == (E_RectBatchElem*)ArenaEnd(batch->arena);
+}
+
+static inline void
+E_PushRectToBatch_(E_RectBatch* batch, const E_RectBatchElem* rect)
+{
+	if (batch->flag_packed)
+	{
+		E_QuadVertex_* vertex = ArenaPushDirtyAligned(batch->arena, sizeof(E_QuadVertex_), alignof(E_QuadVertex_));
+		E_PackRect_(vertex, rect, rect->tex_index);
+	}
+	else
+		ArenaPushStructData(batch->arena, E_RectBatchElem, rect);
+	
+	++batch->count;
 }
 
 API bool
@@ -872,14 +1346,14 @@ E_PushText(E_RectBatch* batch, E_Font* font, String text, vec2 pos, vec2 scale,
 	Trace();
 	
 	RB_Ctx* rb = global_engine.renderbackend;
-	Arena* arena = batch->arena;
-	SafeAssert(batch->elements + batch->count == (E_RectBatchElem*)ArenaEnd(arena));
+	SafeAssert(E_IsRectBatchAtArenaEnd_(batch));
 	
 	int32 int_texindex = -1;
 	
+	// NOTE(ljre): Any slot will do, E_DrawRectBatches splits the draws when more than 4 textures are used.
 	for (int32 i = 0; i < ArrayLength(batch->textures); ++i)
 	{
-		if (RB_IsNull(batch->textures[i].handle))
+		if (RB_IsNull(batch->textures[i].handle) && int_texindex == -1)
 			int_texindex = i;
 		
 		if (RB_IsSame(rb, batch->textures[i].handle, font->texture.handle))
@@ -948,8 +1422,7 @@ E_PushText(E_RectBatch* batch, E_Font* font, String text, vec2 pos, vec2 scale,
 		float32 x = curr_x + (float32)(glyph->xoff + glyph->bearing * font->char_scale) * scale[0];
 		float32 y = curr_y + (float32)(glyph->yoff + font->ascent * font->char_scale) * scale[1];
 		
-		++batch->count;
-		ArenaPushStructInit(arena, E_RectBatchElem, {
+		E_PushRectToBatch_(batch, &(E_RectBatchElem) {
 			.pos = { x, y, },
 			.scaling = {
 				[0][0] = (float32)glyph->width * scale[0],
@@ -976,12 +1449,9 @@ API void
 E_PushRect(E_RectBatch* batch, const E_RectBatchElem* rect)
 {
 	Trace();
-	Arena* arena = batch->arena;
-	
-	SafeAssert(batch->elements + batch->count == (E_RectBatchElem*)ArenaEnd(arena));
 	
-	++batch->count;
-	ArenaPushStructData(arena, E_RectBatchElem, rect);
+	SafeAssert(E_IsRectBatchAtArenaEnd_(batch));
+	E_PushRectToBatch_(batch, rect);
 }
 
 API bool
@@ -991,6 +1461,19 @@ E_DecodeImage(Arena* output_arena, Buffer image, void** out_pixels, int32* out_w
 	SafeAssert(image.size <= INT32_MAX);
 	
 	int32 width, height;
+	int32 mip_count;
+	const void* cooked_pixels;
+	
+	// NOTE(ljre): Only the base level of cooked textures is returned.
+	if (UPak_ParseCookedTex(image.data, image.size, &width, &height, &mip_count, &cooked_pixels))
+	{
+		*out_pixels = ArenaPushMemoryAligned(output_arena, cooked_pixels, (uintsize)width*height*4, 16);
+		*out_width = width;
+		*out_height = height;
+		
+		return true;
+	}
+	
 	void* temp_data;
 	{
 		Trace(); TraceName(Str("stbi_load_from_memory"));
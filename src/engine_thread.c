@@ -1,13 +1,563 @@
+enum E_ThreadFiberState_
+{
+	E_ThreadFiberState_Running,
+	E_ThreadFiberState_Finished,
+	E_ThreadFiberState_Waiting,
+}
+typedef E_ThreadFiberState_;
+
+struct E_ThreadFiber_
+{
+	E_ThreadCtx ctx;
+	OS_Fiber os_fiber;
+	OS_Fiber scheduler;
+	
+	E_ThreadFiberState_ state;
+	E_ThreadWork work;
+	E_ThreadCounter* wait_counter;
+	struct E_ThreadFiber_* next_free;
+}
+typedef E_ThreadFiber_;
+
+static thread_local E_ThreadCtx* g_thread_ctx;
+static thread_local E_ThreadFiber_* g_thread_fiber;
+static E_ThreadCtx g_thread_main_ctx;
+
+// NOTE(ljre): Fibers can be resumed on a different thread than the one they were suspended on, so the compiler
+//             must not cache the address of a thread-local across a fiber switch. Always read them through these.
+#if defined(_MSC_VER) && !defined(__clang__)
+#	define E_NoInline_ __declspec(noinline)
+#else
+#	define E_NoInline_ __attribute__((noinline))
+#endif
+
+static E_NoInline_ E_ThreadCtx*
+E_CurrentThreadCtx_(void)
+{ return g_thread_ctx; }
+
+static E_NoInline_ E_ThreadFiber_*
+E_CurrentThreadFiber_(void)
+{ return g_thread_fiber; }
+
+static inline void
+E_SpinPause_(void)
+{
+#if defined(CONFIG_ARCH_X86FAMILY)
+	_mm_pause();
+#elif defined(CONFIG_ARCH_ARMFAMILY) && (defined(__GNUC__) || defined(__clang__))
+	__asm__ __volatile__ ("yield");
+#endif
+}
+
+//~ NOTE(ljre): Deque operations
+static bool
+E_PushWork_(E_ThreadWorkDeque* deque, const E_ThreadWork* work)
+{
+	const uint32 mask = ArrayLength(deque->works) - 1;
+	uint32 bottom = (uint32)deque->bottom;
+	uint32 top = (uint32)deque->top;
+	
+	if (bottom - top >= (uint32)ArrayLength(deque->works))
+		return false;
+	
+	deque->works[bottom & mask] = *work;
+	OS_MemoryBarrier();
+	deque->bottom = (int32)(bottom + 1);
+	
+	return true;
+}
+
+static bool
+E_PopWork_(E_ThreadWorkDeque* deque, E_ThreadWork* out_work)
+{
+	const uint32 mask = ArrayLength(deque->works) - 1;
+	uint32 bottom = (uint32)deque->bottom - 1;
+	
+	deque->bottom = (int32)bottom;
+	OS_MemoryBarrier();
+	uint32 top = (uint32)deque->top;
+	int32 size = (int32)(bottom - top);
+	
+	if (size < 0)
+	{
+		// NOTE(ljre): Deque was empty.
+		deque->bottom = (int32)top;
+		return false;
+	}
+	
+	*out_work = deque->works[bottom & mask];
+	if (size > 0)
+		return true;
+	
+	// NOTE(ljre): Last item. Race against thieves for it.
+	bool result = (OS_InterlockedCompareExchange32(&deque->top, (int32)(top + 1), (int32)top) == (int32)top);
+	deque->bottom = (int32)(top + 1);
+	
+	return result;
+}
+
+// NOTE(ljre): Returns 1 if stole work, 0 if the deque was empty, -1 if we lost a race and should retry.
+static int32
+E_StealWork_(E_ThreadWorkDeque* deque, E_ThreadWork* out_work)
+{
+	const uint32 mask = ArrayLength(deque->works) - 1;
+	uint32 top = (uint32)deque->top;
+	OS_MemoryBarrier();
+	uint32 bottom = (uint32)deque->bottom;
+	
+	if ((int32)(bottom - top) <= 0)
+		return 0;
+	
+	E_ThreadWork work = deque->works[top & mask];
+	if (OS_InterlockedCompareExchange32(&deque->top, (int32)(top + 1), (int32)top) != (int32)top)
+		return -1;
+	
+	*out_work = work;
+	return 1;
+}
+
+static bool
+E_PopInjectedWork_(E_ThreadWorkQueue* queue, E_ThreadWork* out_work)
+{
+	if (!queue->inject_count)
+		return false;
+	
+	bool result = false;
+	OS_LockExclusive(&queue->inject_lock);
+	
+	if (queue->inject_count > 0)
+	{
+		*out_work = queue->inject_works[queue->inject_head];
+		queue->inject_head = (queue->inject_head + 1) & (ArrayLength(queue->inject_works) - 1);
+		queue->inject_count -= 1;
+		result = true;
+	}
+	
+	OS_UnlockExclusive(&queue->inject_lock);
+	return result;
+}
+
+static bool
+E_FindWork_(E_ThreadCtx* ctx, E_ThreadWorkQueue* queue, E_ThreadWork* out_work)
+{
+	const int32 deque_count = queue->deque_count;
+	
+	if (ctx->id < deque_count && E_PopWork_(&queue->deques[ctx->id], out_work))
+		return true;
+	if (E_PopInjectedWork_(queue, out_work))
+		return true;
+	
+	bool should_retry;
+	do
+	{
+		should_retry = false;
+		
+		for (int32 i = 1; i < deque_count; ++i)
+		{
+			int32 victim = (int32)((ctx->id + i) % deque_count);
+			int32 stolen = E_StealWork_(&queue->deques[victim], out_work);
+			
+			if (stolen > 0)
+				return true;
+			if (stolen < 0)
+				should_retry = true;
+		}
+		
+		if (should_retry)
+			E_SpinPause_();
+	}
+	while (should_retry);
+	
+	return false;
+}
+
+static bool
+E_HasVisibleWork_(E_ThreadWorkQueue* queue)
+{
+	if (queue->inject_count > 0)
+		return true;
+	
+	for (int32 i = 0; i < queue->deque_count; ++i)
+	{
+		E_ThreadWorkDeque* deque = &queue->deques[i];
+		
+		if ((int32)((uint32)deque->bottom - (uint32)deque->top) > 0)
+			return true;
+	}
+	
+	return false;
+}
+
+static void
+E_WakeWorkers_(E_ThreadWorkQueue* queue)
+{
+	// NOTE(ljre): The work we just published needs to be visible before we read 'sleeping_count'. Workers do
+	//             the opposite: increment 'sleeping_count' and then check for work. This way, one of us always
+	//             sees the other.
+	OS_MemoryBarrier();
+	
+	if (queue->sleeping_count > 0)
+		OS_SignalSemaphore(&queue->semaphore, 1);
+}
+
+static void E_ExecuteWork_(E_ThreadCtx* ctx, E_ThreadWorkQueue* queue, const E_ThreadWork* work);
+
+// NOTE(ljre): Marks a suspended fiber that is ready to be resumed. Schedulers check for it, it's never called.
+static void
+E_ResumeFiberWork_(E_ThreadCtx* ctx, void* data)
+{ SafeAssert(false); }
+
+static void
+E_SubmitWork_(E_ThreadWorkQueue* queue, const E_ThreadWork* work)
+{
+	E_ThreadCtx* ctx = E_CurrentThreadCtx_();
+	bool pushed = false;
+	
+	if (ctx && ctx->id < queue->deque_count)
+	{
+		pushed = E_PushWork_(&queue->deques[ctx->id], work);
+		
+		if (!pushed && work->callback != E_ResumeFiberWork_)
+		{
+			// NOTE(ljre): Our deque is full, so just do it now.
+			E_ThreadFiber_* fiber = E_CurrentThreadFiber_();
+			
+			E_ExecuteWork_(fiber ? &fiber->ctx : ctx, queue, work);
+			return;
+		}
+	}
+	
+	if (!pushed)
+	{
+		for (;;)
+		{
+			OS_LockExclusive(&queue->inject_lock);
+			
+			if (queue->inject_count < ArrayLength(queue->inject_works))
+			{
+				int32 index = (queue->inject_head + queue->inject_count) & (ArrayLength(queue->inject_works) - 1);
+				
+				queue->inject_works[index] = *work;
+				queue->inject_count += 1;
+				OS_UnlockExclusive(&queue->inject_lock);
+				break;
+			}
+			
+			OS_UnlockExclusive(&queue->inject_lock);
+			E_SpinPause_();
+		}
+	}
+	
+	E_WakeWorkers_(queue);
+}
+
+// NOTE(ljre): Returns false if 'dependency' already reached zero and the work should be submitted right away.
+static bool
+E_TryDeferWork_(E_ThreadWorkQueue* queue, const E_ThreadWork* work, bool* out_pool_full)
+{
+	E_ThreadCounter* dependency = work->dependency;
+	bool result = false;
+	
+	OS_LockExclusive(&queue->waiting_lock);
+	
+	if (dependency->count > 0)
+	{
+		int32 index = queue->first_free_waiting;
+		
+		if (index)
+			queue->first_free_waiting = queue->waiting_pool[index-1].next;
+		else if (queue->waiting_pool_count < ArrayLength(queue->waiting_pool))
+			index = ++queue->waiting_pool_count;
+		
+		if (index)
+		{
+			E_ThreadWaitingWork_* waiting = &queue->waiting_pool[index-1];
+			
+			waiting->work = *work;
+			waiting->next = dependency->first_waiting;
+			dependency->first_waiting = index;
+			result = true;
+		}
+		else
+			*out_pool_full = true;
+	}
+	
+	OS_UnlockExclusive(&queue->waiting_lock);
+	return result;
+}
+
+static void
+E_DecrementThreadCounter_(E_ThreadWorkQueue* queue, E_ThreadCounter* counter)
+{
+	// NOTE(ljre): Counters usually live on the stack of whoever waits on them, and that waiter returns as soon as
+	//             it sees zero. So the waiting list has to be unlinked before that, and 'counter' must not be
+	//             touched after the decrement that brings it to zero. Only decrements done under 'waiting_lock'
+	//             can do that; the ones that can't reach zero skip the lock.
+	for (;;)
+	{
+		int32 count = counter->count;
+		
+		if (count <= 1)
+			break;
+		if (OS_InterlockedCompareExchange32(&counter->count, count - 1, count) == count)
+			return;
+	}
+	
+	OS_LockExclusive(&queue->waiting_lock);
+	
+	int32 first_waiting = counter->first_waiting;
+	counter->first_waiting = 0;
+	
+	if (OS_InterlockedDecrement32(&counter->count) != 0)
+	{
+		// NOTE(ljre): Someone incremented it again in the meantime. Whoever brings it back to zero releases them.
+		counter->first_waiting = first_waiting;
+		OS_UnlockExclusive(&queue->waiting_lock);
+		return;
+	}
+	
+	OS_UnlockExclusive(&queue->waiting_lock);
+	
+	// NOTE(ljre): Release the works that were waiting on this counter.
+	while (first_waiting)
+	{
+		E_ThreadWork released[32];
+		int32 released_count = 0;
+		
+		OS_LockExclusive(&queue->waiting_lock);
+		
+		while (first_waiting && released_count < ArrayLength(released))
+		{
+			int32 index = first_waiting;
+			E_ThreadWaitingWork_* waiting = &queue->waiting_pool[index-1];
+			
+			released[released_count++] = waiting->work;
+			first_waiting = waiting->next;
+			waiting->next = queue->first_free_waiting;
+			queue->first_free_waiting = index;
+		}
+		
+		OS_UnlockExclusive(&queue->waiting_lock);
+		
+		for (int32 i = 0; i < released_count; ++i)
+			E_SubmitWork_(queue, &released[i]);
+	}
+	
+	OS_MemoryBarrier();
+	if (queue->counter_waiter_count > 0)
+		OS_SignalSemaphore(&queue->counter_semaphore, queue->counter_waiter_count);
+}
+
+static void
+E_ExecuteWork_(E_ThreadCtx* ctx, E_ThreadWorkQueue* queue, const E_ThreadWork* work)
+{
+	E_ThreadCounter* counter = work->counter;
+	
+	// NOTE(ljre): Worker threads reserve their scratch arena here, so the ones that never get any work (or that
+	//             are parked) don't take any address space.
+	if (!ctx->scratch_arena)
+	{
+		const uintsize sz_scratch = 32ull << 20;
+		const uintsize pagesize = 1ull << 20;
+		ctx->scratch_arena = ArenaCreate(sz_scratch, pagesize);
+	}
+	
+	work->callback(ctx, work->data);
+	
+	if (counter)
+		E_DecrementThreadCounter_(queue, counter);
+	E_DecrementThreadCounter_(queue, &queue->pending);
+}
+
+//~ NOTE(ljre): Fibers
+static void
+E_ThreadFiberProc_(void* user_data)
+{
+	E_ThreadFiber_* fiber = user_data;
+	E_ThreadWorkQueue* queue = global_engine.thread_work_queue;
+	
+	for (;;)
+	{
+		E_ExecuteWork_(&fiber->ctx, queue, &fiber->work);
+		
+		fiber->state = E_ThreadFiberState_Finished;
+		OS_SwitchToFiber(fiber->scheduler);
+	}
+}
+
+static E_ThreadFiber_*
+E_AcquireFiber_(E_ThreadWorkQueue* queue)
+{
+	const uintsize stack_size = 1ull << 20;
+	const uintsize sz_scratch = 8ull << 20;
+	const uintsize pagesize = 64ull << 10;
+	E_ThreadFiber_* fiber = NULL;
+	
+	OS_LockExclusive(&queue->fiber_lock);
+	
+	if (queue->first_free_fiber)
+	{
+		fiber = queue->first_free_fiber;
+		queue->first_free_fiber = fiber->next_free;
+	}
+	else if (queue->fiber_count < E_Limits_MaxThreadFibers)
+	{
+		E_ThreadFiber_* new_fiber = &queue->fibers[queue->fiber_count];
+		
+		new_fiber->os_fiber = OS_CreateFiber(E_ThreadFiberProc_, new_fiber, stack_size);
+		
+		if (new_fiber->os_fiber.ptr)
+		{
+			new_fiber->ctx.scratch_arena = ArenaCreate(sz_scratch, pagesize);
+			fiber = new_fiber;
+			++queue->fiber_count;
+		}
+	}
+	
+	OS_UnlockExclusive(&queue->fiber_lock);
+	return fiber;
+}
+
+static void
+E_ReleaseFiber_(E_ThreadWorkQueue* queue, E_ThreadFiber_* fiber)
+{
+	OS_LockExclusive(&queue->fiber_lock);
+	fiber->next_free = queue->first_free_fiber;
+	queue->first_free_fiber = fiber;
+	OS_UnlockExclusive(&queue->fiber_lock);
+}
+
+// NOTE(ljre): Should only be called from a thread's own fiber, never from inside of a work.
+static void
+E_RunWorkOnFiber_(E_ThreadCtx* ctx, E_ThreadWorkQueue* queue, const E_ThreadWork* work)
+{
+	E_ThreadFiber_* fiber;
+	
+	if (work->callback == E_ResumeFiberWork_)
+		fiber = work->data;
+	else
+	{
+		fiber = E_AcquireFiber_(queue);
+		
+		if (!fiber)
+		{
+			// NOTE(ljre): Out of fibers. Run it on the thread itself; waiting inside of it will block it.
+			E_ExecuteWork_(ctx, queue, work);
+			return;
+		}
+		
+		fiber->work = *work;
+	}
+	
+	fiber->ctx.id = ctx->id;
+	fiber->scheduler = queue->thread_fibers[ctx->id];
+	fiber->state = E_ThreadFiberState_Running;
+	
+	g_thread_fiber = fiber;
+	OS_SwitchToFiber(fiber->os_fiber);
+	g_thread_fiber = NULL;
+	
+	switch (fiber->state)
+	{
+		case E_ThreadFiberState_Running: SafeAssert(false); break;
+		case E_ThreadFiberState_Finished: E_ReleaseFiber_(queue, fiber); break;
+		case E_ThreadFiberState_Waiting:
+		{
+			// NOTE(ljre): Only now that we're off its stack the fiber can be made resumable. It's queued as a
+			//             special work once the counter it's waiting on reaches zero.
+			E_ThreadWork resume = {
+				.callback = E_ResumeFiberWork_,
+				.data = fiber,
+				.dependency = fiber->wait_counter,
+			};
+			
+			bool pool_full = false;
+			if (!E_TryDeferWork_(queue, &resume, &pool_full))
+				E_SubmitWork_(queue, &resume);
+		} break;
+	}
+}
+
+//~ NOTE(ljre): Internal API
+static void
+E_InitThreadWork_(int32 worker_thread_count, bool use_fibers)
+{
+	E_ThreadWorkQueue* queue = ArenaPushStruct(global_engine.persistent_arena, E_ThreadWorkQueue);
+	
+	queue->deque_count = 1 + worker_thread_count;
+	queue->active_worker_count = worker_thread_count;
+	queue->deques = ArenaPushArray(global_engine.persistent_arena, E_ThreadWorkDeque, queue->deque_count);
+	queue->thread_fibers = ArenaPushArray(global_engine.persistent_arena, OS_Fiber, queue->deque_count);
+	
+	if (worker_thread_count > 0)
+	{
+		OS_InitSemaphore(&queue->semaphore, worker_thread_count);
+		OS_InitSemaphore(&queue->park_semaphore, worker_thread_count);
+	}
+	
+	OS_InitSemaphore(&queue->counter_semaphore, 1 + worker_thread_count);
+	OS_InitRWLock(&queue->inject_lock);
+	OS_InitRWLock(&queue->waiting_lock);
+	OS_InitRWLock(&queue->fiber_lock);
+	
+	if (use_fibers)
+	{
+		queue->thread_fibers[0] = OS_ConvertThreadToFiber();
+		queue->fibers_enabled = (queue->thread_fibers[0].ptr != NULL);
+		
+		if (queue->fibers_enabled)
+			queue->fibers = ArenaPushArray(global_engine.persistent_arena, E_ThreadFiber_, E_Limits_MaxThreadFibers);
+	}
+	
+	g_thread_main_ctx = (E_ThreadCtx) {
+		.scratch_arena = global_engine.scratch_arena,
+		.id = 0,
+	};
+	
+	g_thread_ctx = &g_thread_main_ctx;
+	global_engine.thread_work_queue = queue;
+}
+
 static void
 E_WorkerThreadProc_(void* arg)
 {
 	E_ThreadCtx* ctx = arg;
 	E_ThreadWorkQueue* queue = global_engine.thread_work_queue;
 	
+	g_thread_ctx = ctx;
+	
+	if (queue->fibers_enabled)
+	{
+		queue->thread_fibers[ctx->id] = OS_ConvertThreadToFiber();
+		SafeAssert(queue->thread_fibers[ctx->id].ptr);
+	}
+	
 	for (;;)
 	{
-		if (!E_RunThreadWork(ctx, queue))
+		if (ctx->id > queue->active_worker_count)
+		{
+			OS_WaitForSemaphore(&queue->park_semaphore);
+			continue;
+		}
+		
+		if (E_RunThreadWork(ctx, queue))
+			continue;
+		
+		// NOTE(ljre): Spin for a little bit before going to sleep.
+		bool found_work = false;
+		for (int32 i = 0; i < 256 && !found_work; ++i)
+		{
+			E_SpinPause_();
+			found_work = E_HasVisibleWork_(queue);
+		}
+		
+		if (found_work)
+			continue;
+		
+		OS_InterlockedIncrement32(&queue->sleeping_count);
+		if (!E_HasVisibleWork_(queue))
 			OS_WaitForSemaphore(&queue->semaphore);
+		OS_InterlockedDecrement32(&queue->sleeping_count);
 	}
 }
 
@@ -17,62 +567,98 @@ E_RunThreadWork(E_ThreadCtx* ctx, E_ThreadWorkQueue* queue)
 {
 	Trace();
 	
-	E_ThreadCtx default_ctx;
+	if (!queue)
+		queue = global_engine.thread_work_queue;
+	
+	// NOTE(ljre): Inside of a fiber, waiting already lets the thread do other work.
+	if (E_CurrentThreadFiber_())
+		return false;
+	
 	if (!ctx)
 	{
-		default_ctx = (E_ThreadCtx) {
-			.scratch_arena = global_engine.scratch_arena,
-			.id = 0,
-		};
-		
-		ctx = &default_ctx;
+		ctx = E_CurrentThreadCtx_();
+		if (!ctx)
+			ctx = &g_thread_main_ctx;
 	}
 	
-	if (!queue)
-		queue = global_engine.thread_work_queue;
+	E_ThreadWork work;
+	if (!E_FindWork_(ctx, queue, &work))
+		return false;
 	
-	for (;;)
+	if (queue->fibers_enabled)
+		E_RunWorkOnFiber_(ctx, queue, &work);
+	else
+		E_ExecuteWork_(ctx, queue, &work);
+	
+	return true;
+}
+
+API void
+E_QueueThreadWork(const E_ThreadWork* work)
+{
+	Trace();
+	
+	E_ThreadWorkQueue* queue = global_engine.thread_work_queue;
+	
+	OS_InterlockedIncrement32(&queue->pending.count);
+	if (work->counter)
+		OS_InterlockedIncrement32(&work->counter->count);
+	
+	if (work->dependency && work->dependency->count > 0)
 	{
-		int32 doing_head = queue->doing_head;
-		if (doing_head == queue->remaining_head)
-			break;
+		bool pool_full = false;
 		
-		int32 next_index = (doing_head+1) % ArrayLength(queue->works);
-		int32 index = OS_InterlockedCompareExchange32(&queue->doing_head, next_index, doing_head);
-		
-		if (index == doing_head)
-		{
-			int32 doing_count;
-			
-			OS_InterlockedIncrement32(&queue->doing_count);
-			
-			E_ThreadWork work = queue->works[index];
-			work.callback(ctx, work.data);
-			
-			doing_count = OS_InterlockedDecrement32(&queue->doing_count);
-			if (doing_count == 0 && queue->remaining_head == queue->doing_head)
-				OS_SetEventSignal(&queue->reached_zero_doing_work_sig);
-			
-			return true;
-		}
+		if (E_TryDeferWork_(queue, work, &pool_full))
+			return;
+		if (pool_full)
+			E_WaitThreadCounter(work->dependency);
 	}
 	
-	return false;
+	E_SubmitWork_(queue, work);
 }
 
 API void
-E_QueueThreadWork(const E_ThreadWork* work)
+E_WaitThreadCounter(E_ThreadCounter* counter)
 {
 	Trace();
 	
 	E_ThreadWorkQueue* queue = global_engine.thread_work_queue;
-	int32 index = queue->remaining_head;
-	int32 next_index = (index+1) % ArrayLength(queue->works);
+	E_ThreadFiber_* fiber = E_CurrentThreadFiber_();
 	
-	queue->works[index] = *work;
-	queue->remaining_head = next_index;
+	if (fiber)
+	{
+		// NOTE(ljre): Suspend this fiber until the counter reaches zero. We might wake up on another thread.
+		while (counter->count > 0)
+		{
+			fiber->state = E_ThreadFiberState_Waiting;
+			fiber->wait_counter = counter;
+			OS_SwitchToFiber(fiber->scheduler);
+		}
+		
+		return;
+	}
 	
-	OS_SignalSemaphore(&queue->semaphore, 1);
+	while (counter->count > 0)
+	{
+		if (E_RunThreadWork(NULL, queue))
+			continue;
+		
+		// NOTE(ljre): Nothing to help with. Spin for a little bit, then sleep until some counter reaches zero.
+		bool should_stop_waiting = false;
+		for (int32 i = 0; i < 256 && !should_stop_waiting; ++i)
+		{
+			E_SpinPause_();
+			should_stop_waiting = (counter->count <= 0 || E_HasVisibleWork_(queue));
+		}
+		
+		if (should_stop_waiting)
+			continue;
+		
+		OS_InterlockedIncrement32(&queue->counter_waiter_count);
+		if (counter->count > 0 && !E_HasVisibleWork_(queue))
+			OS_WaitForSemaphore(&queue->counter_semaphore);
+		OS_InterlockedDecrement32(&queue->counter_waiter_count);
+	}
 }
 
 API void
@@ -80,5 +666,24 @@ E_WaitRemainingThreadWork(void)
 {
 	Trace();
 	
-	OS_WaitEventSignal(&global_engine.thread_work_queue->reached_zero_doing_work_sig);
+	E_WaitThreadCounter(&global_engine.thread_work_queue->pending);
+}
+
+API void
+E_SetActiveWorkerCount(int32 count)
+{
+	Trace();
+	
+	E_ThreadWorkQueue* queue = global_engine.thread_work_queue;
+	int32 worker_thread_count = (int32)global_engine.worker_thread_count;
+	
+	queue->active_worker_count = Clamp(count, 0, worker_thread_count);
+	OS_MemoryBarrier();
+	
+	// NOTE(ljre): Wake everyone so they can check if they should be parked or not.
+	if (worker_thread_count > 0)
+	{
+		OS_SignalSemaphore(&queue->park_semaphore, worker_thread_count);
+		OS_SignalSemaphore(&queue->semaphore, worker_thread_count);
+	}
 }
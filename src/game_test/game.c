@@ -285,6 +285,7 @@ G_UpdateAndRender(void)
 						case RB_ShaderType_Hlsl40Level91: shader_type = "HLSL vs/ps_4_0_level_9_1"; break;
 						case RB_ShaderType_Hlsl40Level93: shader_type = "HLSL vs/ps_4_0_level_9_3"; break;
 						case RB_ShaderType_Hlsl40: shader_type = "HLSL vs/ps_4_0"; break;
+						case RB_ShaderType_Software: shader_type = "C kernels"; break;
 					}
 					
 					DBG_UIPushTextF(&debugui, "API: %S\nDriver Renderer: %S\nDriver Vendor: %S\nDriver Version: %S", caps.backend_api, caps.driver_renderer, caps.driver_vendor, caps.driver_version);
@@ -63,6 +63,29 @@ static const char g_scene3d_gl_fs[] =
 "}\n"
 "\n";
 
+// NOTE(ljre): Same as the GLSL ones, for the software backend. The only varying is the texcoord.
+static void
+G_Scene3DSoftwareVs_(const RB_SoftwareVertex* vertex, float32 out_position[4], float32* out_varyings)
+{
+	const G_Scene3DUBuffer* uniforms = vertex->uniforms;
+	const float32* position = vertex->inputs[0];
+	float32 world[4];
+	
+	for (int32 i = 0; i < 4; ++i)
+		world[i] = uniforms->model[0][i]*position[0] + uniforms->model[1][i]*position[1] + uniforms->model[2][i]*position[2] + uniforms->model[3][i];
+	for (int32 i = 0; i < 4; ++i)
+		out_position[i] = uniforms->view[0][i]*world[0] + uniforms->view[1][i]*world[1] + uniforms->view[2][i]*world[2] + uniforms->view[3][i]*world[3];
+	
+	out_varyings[0] = vertex->inputs[1][0];
+	out_varyings[1] = vertex->inputs[1][1];
+}
+
+static void
+G_Scene3DSoftwareFs_(const RB_SoftwareFragment* fragment, float32 out_color[4])
+{
+	RB_SoftwareSample(fragment, 0, fragment->varyings, fragment->ddx, fragment->ddy, out_color);
+}
+
 uint8 typedef BYTE;
 #include <d3d11_gametest_scene3d_vs.inc>
 #include <d3d11_gametest_scene3d_ps.inc>
@@ -97,6 +120,12 @@ G_Scene3DInit(void)
 			StrInit(g_scene3d_gl_vs),
 			StrInit(g_scene3d_gl_fs),
 		},
+		.software = {
+			.vs = G_Scene3DSoftwareVs_,
+			.fs = G_Scene3DSoftwareFs_,
+			.varying_count = 2,
+			.derivative_count = 2,
+		},
 	});
 	
 	s->pipeline = RB_MakePipeline(engine->renderbackend, &(RB_PipelineDesc) {
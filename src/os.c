@@ -91,6 +91,25 @@ int __declspec(dllexport) AmdPowerXpressRequestHighPerformance = 1;
 #		include "os_win32_d3d11.c"
 #	endif
 #elif defined(CONFIG_OS_LINUX)
+#	include <stdio.h>
+#	include <stdlib.h>
+#	include <errno.h>
+#	include <time.h>
+#	include <signal.h>
+#	include <unistd.h>
+#	include <fcntl.h>
+#	include <dlfcn.h>
+#	include <sched.h>
+#	include <pthread.h>
+#	include <semaphore.h>
+#	include <ucontext.h>
+#	include <malloc.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+
+static uint64 Linux_GetTimer(void);
+static Arena* Linux_GetThreadScratchArena(void);
+
 #	include "os_linux.c"
 #elif defined(CONFIG_OS_ANDROID)
 #	include "os_android.c"
@@ -1400,6 +1400,50 @@ OS_InterlockedDecrement32(volatile int32* ptr)
 	return result;
 }
 
+API int32
+OS_InterlockedExchange32(volatile int32* ptr, int32 new_value)
+{
+	Trace();
+	
+	int32 result = __atomic_exchange_n(ptr, new_value, __ATOMIC_SEQ_CST);
+	return result;
+}
+
+API int32
+OS_InterlockedAdd32(volatile int32* ptr, int32 value)
+{
+	Trace();
+	
+	int32 result = __sync_add_and_fetch(ptr, value);
+	__sync_synchronize();
+	return result;
+}
+
+API void
+OS_MemoryBarrier(void)
+{
+	__sync_synchronize();
+}
+
+// NOTE(ljre): No fibers on Android. Bionic only has the ucontext functions from API level 28 on, which is above what
+//             we target, so OS_ConvertThreadToFiber gives back a null fiber and the job system stays with plain
+//             worker threads. Nothing should ever get to OS_SwitchToFiber here.
+API OS_Fiber
+OS_ConvertThreadToFiber(void)
+{ return (OS_Fiber) { 0 }; }
+
+API OS_Fiber
+OS_CreateFiber(OS_FiberProc* proc, void* user_data, uintsize stack_size)
+{ return (OS_Fiber) { 0 }; }
+
+API void
+OS_SwitchToFiber(OS_Fiber fiber)
+{ SafeAssert(false); }
+
+API void
+OS_DeleteFiber(OS_Fiber fiber)
+{}
+
 #ifdef CONFIG_DEBUG
 API void
 OS_DebugMessageBox(const char* fmt, ...)
@@ -0,0 +1,1227 @@
+// NOTE(ljre): Headless host. There's no window, input or GPU here: the graphics context is null, or software with
+//             '-software-render', and the audio device is a thread that pulls samples at the rate a real one would
+//             and throws them away. It's meant for running G_Main loops, asset loading and benchmarks on machines
+//             without a display.
+
+struct Linux_MappedFile
+{
+	int fd;
+	const void* base_address;
+	uintsize size;
+}
+typedef Linux_MappedFile;
+
+struct Linux_Semaphore
+{
+	sem_t sem;
+	int32 max_count;
+}
+typedef Linux_Semaphore;
+
+struct Linux_EventSignal
+{
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	bool is_set;
+}
+typedef Linux_EventSignal;
+
+struct Linux_Fiber
+{
+	ucontext_t context;
+	OS_FiberProc* proc;
+	void* user_data;
+	void* stack;
+	uintsize stack_size;
+	bool is_thread;
+}
+typedef Linux_Fiber;
+
+enum
+{
+	Linux_Limits_AudioSampleRate = 48000,
+	Linux_Limits_AudioChannels = 2,
+	Linux_Limits_AudioFramePullRate = 480, // NOTE(ljre): 10ms at 48kHz.
+	Linux_Limits_MaxNumaNodes = 64,
+};
+
+//~ NOTE(ljre): Globals
+static OS_WindowGraphicsContext g_graphics_context;
+static OS_State g_os;
+static thread_local Linux_Fiber* g_linux_current_fiber;
+
+struct
+{
+	uint64 process_started_time;
+	uint64 next_present_time;
+	bool vsync_disabled;
+	bool software_render;
+	int32 max_frames;
+	volatile sig_atomic_t got_quit_signal;
+	pthread_t worker_threads[OS_Limits_MaxWorkerThreadCount];
+	bool worker_thread_started[OS_Limits_MaxWorkerThreadCount];
+	
+	int32 user_thread_count;
+	bool thread_affinity;
+	int32 cpu_core_count;
+	int32 cpu_placement_count;
+	cpu_set_t cpu_placements[OS_Limits_MaxWorkerThreadCount];
+	int32 argc;
+	const char* const* argv;
+	
+	const OS_AppApi* app_api;
+	void* workerthread_user_data;
+	void* audiothread_user_data;
+	
+	bool no_audio;
+	bool audio_thread_started;
+	volatile int32 audio_thread_should_stop;
+	pthread_t audio_thread;
+	OS_AudioDeviceInfo audio_device;
+}
+static g_linux;
+
+//~ NOTE(ljre): Utils
+static uint64
+Linux_GetTimer(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	
+	return (uint64)t.tv_sec * 1000000000ull + (uint64)t.tv_nsec;
+}
+
+static void
+Linux_SleepUntil_(uint64 timer)
+{
+	struct timespec t = {
+		.tv_sec = (time_t)(timer / 1000000000ull),
+		.tv_nsec = (long)(timer % 1000000000ull),
+	};
+	
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL) == EINTR)
+	{}
+}
+
+static Arena*
+Linux_GetThreadScratchArena(void)
+{
+	static thread_local Arena* this_arena;
+	
+	if (!this_arena)
+		this_arena = ArenaCreate(64 << 10, 64 << 10);
+	
+	return this_arena;
+}
+
+static bool
+Linux_ParseIntArg_(String arg, String prefix, int32* out_value)
+{
+	if (!StringStartsWith(arg, prefix))
+		return false;
+	
+	int32 value = 0;
+	arg = StringSubstr(arg, prefix.size, -1);
+	
+	for (intsize i = 0; i < arg.size && arg.data[i] >= '0' && arg.data[i] <= '9'; ++i)
+		value = Min(value*10 + (arg.data[i] - '0'), INT32_MAX/10 - 1);
+	
+	*out_value = value;
+	return true;
+}
+
+// NOTE(ljre): Reads sysfs' "0-3,8,10-11" lists.
+static bool
+Linux_ReadCpuList_(const char* path, cpu_set_t* out_set)
+{
+	char buffer[1024];
+	int fd = open(path, O_RDONLY);
+	
+	if (fd == -1)
+		return false;
+	
+	ssize_t size = read(fd, buffer, sizeof(buffer) - 1);
+	close(fd);
+	
+	if (size <= 0)
+		return false;
+	
+	buffer[size] = 0;
+	CPU_ZERO(out_set);
+	
+	for (const char* it = buffer; *it >= '0' && *it <= '9';)
+	{
+		int32 first = 0, last;
+		
+		while (*it >= '0' && *it <= '9')
+			first = first*10 + (*it++ - '0');
+		
+		last = first;
+		
+		if (*it == '-')
+		{
+			last = 0;
+			++it;
+			
+			while (*it >= '0' && *it <= '9')
+				last = last*10 + (*it++ - '0');
+		}
+		
+		for (int32 cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu)
+			CPU_SET(cpu, out_set);
+		
+		if (*it == ',')
+			++it;
+	}
+	
+	return true;
+}
+
+//~ NOTE(ljre): Functions
+static void
+Linux_QuitSignalHandler_(int signum)
+{
+	(void)signum;
+	g_linux.got_quit_signal = true;
+}
+
+// NOTE(ljre): Same as Win32_QueryCpuTopology_, from sysfs. Only the CPUs we're allowed to run on count, so a
+//             cpuset or 'taskset' on the build machines also sizes the worker pool.
+static void
+Linux_QueryCpuTopology_(void)
+{
+	cpu_set_t allowed;
+	
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+	{
+		// NOTE(ljre): Assume SMT and don't place anything.
+		long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+		
+		g_linux.cpu_core_count = ClampMin((int32)cpu_count / 2, 1);
+		g_linux.cpu_placement_count = 0;
+		return;
+	}
+	
+	cpu_set_t main_node;
+	int main_cpu = sched_getcpu();
+	char path[128];
+	
+	CPU_ZERO(&main_node);
+	
+	for (int32 node = 0; node < Linux_Limits_MaxNumaNodes && main_cpu >= 0; ++node)
+	{
+		cpu_set_t node_cpus;
+		snprintf(path, sizeof(path), "/sys/devices/system/node/node%i/cpulist", node);
+		
+		if (Linux_ReadCpuList_(path, &node_cpus) && CPU_ISSET(main_cpu, &node_cpus))
+		{
+			main_node = node_cpus;
+			break;
+		}
+	}
+	
+	cpu_set_t seen;
+	int32 core_count = 0;
+	int32 placement_count = 0;
+	
+	CPU_ZERO(&seen);
+	
+	for (int32 pass = 0; pass < 2; ++pass)
+	{
+		for (int32 cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+		{
+			if (!CPU_ISSET(cpu, &allowed) || CPU_ISSET(cpu, &seen))
+				continue;
+			
+			bool is_on_main_node = CPU_ISSET(cpu, &main_node);
+			
+			if (is_on_main_node != (pass == 0))
+				continue;
+			
+			cpu_set_t core;
+			snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%i/topology/thread_siblings_list", cpu);
+			
+			if (!Linux_ReadCpuList_(path, &core))
+				CPU_ZERO(&core);
+			
+			CPU_AND(&core, &core, &allowed);
+			CPU_SET(cpu, &core);
+			CPU_OR(&seen, &seen, &core);
+			
+			if (placement_count < ArrayLength(g_linux.cpu_placements))
+				g_linux.cpu_placements[placement_count++] = core;
+			
+			++core_count;
+		}
+	}
+	
+	g_linux.cpu_core_count = ClampMin(core_count, 1);
+	g_linux.cpu_placement_count = placement_count;
+}
+
+static void
+Linux_PlaceThread_(pthread_t thread, int32 index)
+{
+	if (g_linux.cpu_placement_count > 0)
+	{
+		cpu_set_t* affinity = &g_linux.cpu_placements[index % g_linux.cpu_placement_count];
+		
+		if (pthread_setaffinity_np(thread, sizeof(*affinity), affinity) != 0)
+			OS_DebugLog("Failed to set the affinity of thread %i.\n", index);
+	}
+}
+
+static void*
+Linux_ThreadProc_(void* user_data)
+{
+	g_linux.app_api->worker_thread_proc(g_linux.workerthread_user_data, (int32)(intsize)user_data);
+	return NULL;
+}
+
+static bool
+Linux_NullPresentAndVsync_(int32 vsync_count)
+{
+	Trace();
+	
+	// NOTE(ljre): Nothing to wait on, so pretend there's a 60Hz display. Otherwise G_Main loops would spin as fast
+	//             as they can, which is what '-no-vsync' is for.
+	if (g_linux.vsync_disabled || vsync_count <= 0)
+		return true;
+	
+	const uint64 frame_time = 1000000000ull / 60;
+	uint64 now = Linux_GetTimer();
+	
+	g_linux.next_present_time += frame_time * vsync_count;
+	if (g_linux.next_present_time < now)
+		g_linux.next_present_time = now;
+	else
+		Linux_SleepUntil_(g_linux.next_present_time);
+	
+	return true;
+}
+
+static void*
+Linux_AudioThreadProc_(void* user_data)
+{
+	OS_AudioThreadProc* const userproc = g_linux.app_api->pull_audio_samples;
+	void* const userdata = g_linux.audiothread_user_data;
+	
+	const int32 frame_count = Linux_Limits_AudioFramePullRate;
+	const int32 channels = Linux_Limits_AudioChannels;
+	const int32 sample_rate = Linux_Limits_AudioSampleRate;
+	const int32 sample_count = frame_count * channels;
+	const uint64 period = (uint64)frame_count * 1000000000ull / (uint64)sample_rate;
+	
+	int16 buffer[Linux_Limits_AudioFramePullRate * Linux_Limits_AudioChannels];
+	uint64 next_pull_time = Linux_GetTimer();
+	
+	while (!__atomic_load_n(&g_linux.audio_thread_should_stop, __ATOMIC_ACQUIRE))
+	{
+		Trace();
+		
+		userproc(userdata, buffer, channels, sample_rate, sample_count);
+		
+		// NOTE(ljre): A real device would drop what we were late for instead of asking for it all at once.
+		uint64 now = Linux_GetTimer();
+		next_pull_time += period;
+		
+		if (next_pull_time + period < now)
+			next_pull_time = now;
+		else
+			Linux_SleepUntil_(next_pull_time);
+	}
+	
+	return NULL;
+}
+
+static bool
+Linux_InitAudio_(OS_State* os_state)
+{
+	Trace();
+	
+	g_linux.audio_device = (OS_AudioDeviceInfo) {
+		.interface_name = StrInit("Null"),
+		.description = StrInit("Null audio device"),
+		.name = StrInit("Null"),
+		.id = 1,
+	};
+	
+	g_linux.audio_thread_should_stop = 0;
+	if (pthread_create(&g_linux.audio_thread, NULL, Linux_AudioThreadProc_, NULL) != 0)
+		return false;
+	
+	g_linux.audio_thread_started = true;
+	
+	os_state->audio.mix_sample_rate = Linux_Limits_AudioSampleRate;
+	os_state->audio.mix_channels = Linux_Limits_AudioChannels;
+	os_state->audio.mix_frame_pull_rate = Linux_Limits_AudioFramePullRate;
+	os_state->audio.device_count = 1;
+	os_state->audio.devices = &g_linux.audio_device;
+	os_state->audio.current_device_id = g_linux.audio_device.id;
+	
+	return true;
+}
+
+static void
+Linux_DeinitAudio_(OS_State* os_state)
+{
+	Trace();
+	
+	if (g_linux.audio_thread_started)
+	{
+		__atomic_store_n(&g_linux.audio_thread_should_stop, 1, __ATOMIC_RELEASE);
+		pthread_join(g_linux.audio_thread, NULL);
+		g_linux.audio_thread_started = false;
+	}
+	
+	os_state->has_audio = false;
+}
+
+//~ NOTE(ljre): Entry point
+int
+main(int argc, char** argv)
+{
+	//- Init
+	Linux_QueryCpuTopology_();
+	
+	g_linux.process_started_time = Linux_GetTimer();
+	g_linux.next_present_time = g_linux.process_started_time;
+	g_linux.user_thread_count = Clamp(g_linux.cpu_core_count, 1, OS_Limits_MaxWorkerThreadCount);
+	g_linux.argc = argc;
+	g_linux.argv = (const char* const*)argv;
+	
+	for (int32 i = 1; i < g_linux.argc; ++i)
+	{
+		String arg = StrMake(MemoryStrlen(g_linux.argv[i]), g_linux.argv[i]);
+		int32 value;
+		
+		if (StringEquals(arg, Str("-no-worker-threads")))
+			g_linux.user_thread_count = 1;
+		else if (StringEquals(arg, Str("-thread-affinity")))
+			g_linux.thread_affinity = true;
+		else if (Linux_ParseIntArg_(arg, Str("-worker-threads="), &value))
+			g_linux.user_thread_count = Clamp(value + 1, 1, OS_Limits_MaxWorkerThreadCount);
+		else if (StringEquals(arg, Str("-no-vsync")))
+			g_linux.vsync_disabled = true;
+		else if (StringEquals(arg, Str("-no-audio")))
+			g_linux.no_audio = true;
+		else if (StringEquals(arg, Str("-software-render")))
+			g_linux.software_render = true;
+		else if (Linux_ParseIntArg_(arg, Str("-max-frames="), &value))
+			g_linux.max_frames = value;
+	}
+	
+	if (g_linux.thread_affinity)
+		Linux_PlaceThread_(pthread_self(), 0);
+	
+	{
+		struct sigaction action = {
+			.sa_handler = Linux_QuitSignalHandler_,
+		};
+		
+		sigemptyset(&action.sa_mask);
+		sigaction(SIGINT, &action, NULL);
+		sigaction(SIGTERM, &action, NULL);
+	}
+	
+	//- Call Setup
+	g_linux.app_api = GetAppApi();
+	
+	{
+		OS_InitDesc os_init = { 0 };
+		OS_SetupArgs setup = {
+			.argc = g_linux.argc,
+			.argv = g_linux.argv,
+			
+			.worker_thread_count = g_linux.user_thread_count-1,
+		};
+		g_linux.app_api->setup(&setup, &os_init);
+		
+		g_linux.workerthread_user_data = os_init.workerthread_user_data;
+		g_linux.audiothread_user_data = os_init.audiothread_user_data;
+	}
+	
+	OS_WindowState window_state = {
+		.width = 1280,
+		.height = 720,
+	};
+	
+	// NOTE(ljre): '-software-render' actually draws the frames, on the CPU, so they can be read back.
+	g_graphics_context = (OS_WindowGraphicsContext) {
+		.api = g_linux.software_render ? OS_WindowGraphicsApi_Software : OS_WindowGraphicsApi_Null,
+		.present_and_vsync = Linux_NullPresentAndVsync_,
+	};
+	
+	{
+		bool audio_initialized_successfully = false;
+		
+		if (g_linux.app_api->pull_audio_samples && !g_linux.no_audio && !(audio_initialized_successfully = Linux_InitAudio_(&g_os)))
+			OS_DebugLog("Failed to initialize audio.\n");
+		
+		for (int32 i = 1; i < g_linux.user_thread_count; ++i)
+		{
+			g_linux.worker_thread_started[i] = (0 == pthread_create(&g_linux.worker_threads[i], NULL, Linux_ThreadProc_, (void*)(uintptr)i));
+			
+			if (g_linux.worker_thread_started[i] && g_linux.thread_affinity)
+				Linux_PlaceThread_(g_linux.worker_threads[i], i);
+		}
+		
+		g_os.has_audio = audio_initialized_successfully;
+		g_os.has_keyboard = false;
+		g_os.has_mouse = false;
+		g_os.has_gestures = false;
+		g_os.has_gamepad_support = false;
+		
+		g_os.window = window_state;
+		g_os.graphics_context = &g_graphics_context;
+	}
+	
+	//- Run
+	int32 frame_count = 0;
+	
+	while (!g_os.is_terminating)
+	{
+		g_linux.app_api->update(&g_os);
+		++frame_count;
+		
+		if (g_linux.got_quit_signal || (g_linux.max_frames > 0 && frame_count >= g_linux.max_frames))
+			g_os.window.should_close = true;
+	}
+	
+	//- Terminate
+	// NOTE(ljre): There's no TerminateThread. Workers sleep on the queue's semaphore once there's no work, and die
+	//             with the process when we return.
+	Linux_DeinitAudio_(&g_os);
+	g_linux.app_api->shutdown(&g_os);
+	
+	return 0;
+}
+
+//~ NOTE(ljre): API
+API void
+OS_ExitWithErrorMessage(const char* fmt, ...)
+{
+	Arena* scratch_arena = Linux_GetThreadScratchArena();
+	
+	va_list args;
+	va_start(args, fmt);
+	String str = ArenaVPrintf(scratch_arena, fmt, args);
+	va_end(args);
+	
+	str = ArenaPrintf(scratch_arena, "Fatal Error!\n%S\n", str);
+	fwrite(str.data, 1, str.size, stderr);
+	exit(1);
+	/* no return */
+}
+
+API void
+OS_MessageBox(String title, String message)
+{
+	Trace();
+	Arena* scratch_arena = Linux_GetThreadScratchArena();
+	
+	for ArenaTempScope(scratch_arena)
+	{
+		String str = ArenaPrintf(scratch_arena, "[%S] %S\n", title, message);
+		fwrite(str.data, 1, str.size, stderr);
+	}
+}
+
+API void*
+OS_HeapAlloc(uintsize size)
+{
+	Trace();
+	
+	return calloc(1, size);
+}
+
+API void*
+OS_HeapRealloc(void* ptr, uintsize size)
+{
+	Trace();
+	
+	// NOTE(ljre): Zero the new bytes, as HEAP_ZERO_MEMORY does on Win32.
+	uintsize old_size = ptr ? malloc_usable_size(ptr) : 0;
+	uint8* result = realloc(ptr, size);
+	
+	if (result && size > old_size)
+		MemoryZero(result + old_size, size - old_size);
+	
+	return result;
+}
+
+API void
+OS_HeapFree(void* ptr)
+{
+	Trace();
+	
+	free(ptr);
+}
+
+API void*
+OS_VirtualReserve(void* address, uintsize size)
+{
+	Trace();
+	
+	void* result = mmap(address, size, PROT_NONE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_NORESERVE, -1, 0);
+	
+	if (result == MAP_FAILED)
+		result = NULL;
+	
+	return result;
+}
+
+API bool
+OS_VirtualCommit(void* ptr, uintsize size)
+{
+	Trace();
+	
+	return mprotect(ptr, size, PROT_READ|PROT_WRITE) == 0;
+}
+
+API void
+OS_VirtualDecommit(void* ptr, uintsize size)
+{
+	Trace();
+	
+	int ok = madvise(ptr, size, MADV_DONTNEED) == 0 && mprotect(ptr, size, PROT_NONE) == 0;
+	SafeAssert(ok);
+}
+
+API void
+OS_VirtualRelease(void* ptr, uintsize size)
+{
+	Trace();
+	
+	int ok = munmap(ptr, size) == 0;
+	SafeAssert(ok);
+}
+
+API uint64
+OS_CurrentPosixTime(void)
+{
+	time_t result = time(NULL);
+	if (result == -1)
+		result = 0;
+	
+	return (uint64)result;
+}
+
+API uint64
+OS_CurrentTick(uint64* out_ticks_per_second)
+{
+	if (out_ticks_per_second)
+		*out_ticks_per_second = 1000000000ull;
+	return Linux_GetTimer() - g_linux.process_started_time;
+}
+
+API float64
+OS_GetTimeInSeconds(void)
+{
+	uint64 time = Linux_GetTimer();
+	return (float64)(time - g_linux.process_started_time) / 1000000000.0;
+}
+
+API bool
+OS_ReadEntireFile(String path, Arena* output_arena, void** out_data, uintsize* out_size)
+{
+	Trace(); TraceText(path);
+	
+	Arena* scratch_arena = Linux_GetThreadScratchArena();
+	int fd;
+	
+	for ArenaTempScope(scratch_arena)
+	{
+		const char* cpath = ArenaPushCString(scratch_arena, path);
+		fd = open(cpath, O_RDONLY | O_CLOEXEC);
+	}
+	
+	if (fd == -1)
+		return false;
+	
+	struct stat stat_data;
+	if (fstat(fd, &stat_data) != 0)
+	{
+		close(fd);
+		return false;
+	}
+	
+	ArenaSavepoint output_arena_save = ArenaSave(output_arena);
+	uintsize file_size = (uintsize)stat_data.st_size;
+	uint8* file_data = ArenaPushDirtyAligned(output_arena, file_size, 1);
+	
+	uintsize still_to_read = file_size;
+	uint8* p = file_data;
+	while (still_to_read > 0)
+	{
+		ssize_t did_read = read(fd, p, still_to_read);
+		
+		if (did_read == -1 && errno == EINTR)
+			continue;
+		
+		if (did_read <= 0)
+		{
+			ArenaRestore(output_arena_save);
+			close(fd);
+			return false;
+		}
+		
+		still_to_read -= (uintsize)did_read;
+		p += did_read;
+	}
+	
+	*out_data = file_data;
+	*out_size = file_size;
+	
+	close(fd);
+	return true;
+}
+
+API bool
+OS_WriteEntireFile(String path, const void* data, uintsize size)
+{
+	Trace(); TraceText(path);
+	
+	Arena* scratch_arena = Linux_GetThreadScratchArena();
+	int fd;
+	
+	for ArenaTempScope(scratch_arena)
+	{
+		const char* cpath = ArenaPushCString(scratch_arena, path);
+		fd = open(cpath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	}
+	
+	if (fd == -1)
+		return false;
+	
+	const uint8* head = data;
+	
+	while (size > 0)
+	{
+		ssize_t bytes_written = write(fd, head, size);
+		
+		if (bytes_written == -1 && errno == EINTR)
+			continue;
+		
+		if (bytes_written <= 0)
+		{
+			close(fd);
+			return false;
+		}
+		
+		size -= (uintsize)bytes_written;
+		head += bytes_written;
+	}
+	
+	close(fd);
+	return true;
+}
+
+API bool
+OS_IsFileOlderThan(String path, uint64 posix_timestamp)
+{
+	Trace(); TraceText(path);
+	
+	Arena* scratch_arena = Linux_GetThreadScratchArena();
+	struct stat stat_data;
+	bool result = false;
+	
+	for ArenaTempScope(scratch_arena)
+	{
+		const char* cpath = ArenaPushCString(scratch_arena, path);
+		
+		if (stat(cpath, &stat_data) == 0)
+			result = ((uint64)stat_data.st_mtime < posix_timestamp);
+	}
+	
+	return result;
+}
+
+API bool
+OS_MapFile(String path, OS_MappedFile* out_mapped_file, Buffer* out_buffer)
+{
+	Trace(); TraceText(path);
+	
+	Arena* scratch_arena = Linux_GetThreadScratchArena();
+	int fd;
+	
+	for ArenaTempScope(scratch_arena)
+	{
+		const char* cpath = ArenaPushCString(scratch_arena, path);
+		fd = open(cpath, O_RDONLY | O_CLOEXEC);
+	}
+	
+	if (fd == -1)
+		return false;
+	
+	struct stat stat_data;
+	if (fstat(fd, &stat_data) != 0)
+	{
+		close(fd);
+		return false;
+	}
+	
+	uintsize size = (uintsize)stat_data.st_size;
+	void* base_address = NULL;
+	
+	// NOTE(ljre): mmap refuses empty mappings, but an empty file is still a file.
+	if (size > 0)
+	{
+		base_address = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		
+		if (base_address == MAP_FAILED)
+		{
+			close(fd);
+			return false;
+		}
+	}
+	
+	Linux_MappedFile* mapdata = OS_HeapAlloc(sizeof(Linux_MappedFile));
+	mapdata->fd = fd;
+	mapdata->base_address = base_address;
+	mapdata->size = size;
+	
+	if (out_buffer)
+		*out_buffer = BufMake(size, base_address);
+	if (out_mapped_file)
+		*out_mapped_file = (OS_MappedFile) { mapdata };
+	
+	return true;
+}
+
+API bool
+OS_GetMappedFileBuffer(OS_MappedFile mapped_file, Buffer* out_buffer)
+{
+	Linux_MappedFile* mapdata = mapped_file.ptr;
+	
+	if (mapdata)
+	{
+		if (out_buffer)
+			*out_buffer = BufMake(mapdata->size, mapdata->base_address);
+		
+		return true;
+	}
+	
+	return false;
+}
+
+API void
+OS_UnmapFile(OS_MappedFile mapped_file)
+{
+	Linux_MappedFile* mapdata = mapped_file.ptr;
+	
+	if (mapdata)
+	{
+		if (mapdata->base_address)
+			munmap((void*)mapdata->base_address, mapdata->size);
+		close(mapdata->fd);
+		OS_HeapFree(mapdata);
+	}
+}
+
+API OS_LibraryHandle
+OS_LoadLibrary(String name)
+{
+	Trace();
+	Arena* scratch_arena = Linux_GetThreadScratchArena();
+	OS_LibraryHandle handle = { 0 };
+	
+	for ArenaTempScope(scratch_arena)
+	{
+		String fullname = ArenaPrintf(scratch_arena, "lib%S.so%0", name);
+		handle.ptr = dlopen((const char*)fullname.data, RTLD_LAZY);
+		
+		if (handle.ptr)
+			OS_DebugLog("Loaded Library: %S\n", fullname);
+	}
+	
+	return handle;
+}
+
+API void*
+OS_LoadSymbol(OS_LibraryHandle handle, const char* symbol_name)
+{
+	Trace();
+	void* symbol = NULL;
+	
+	if (handle.ptr)
+		symbol = dlsym(handle.ptr, symbol_name);
+	
+	return symbol;
+}
+
+API void
+OS_UnloadLibrary(OS_LibraryHandle* handle)
+{
+	Trace();
+	
+	if (handle->ptr)
+		dlclose(handle->ptr);
+	handle->ptr = NULL;
+}
+
+API void
+OS_InitRWLock(OS_RWLock* lock)
+{
+	Trace();
+	
+	pthread_rwlock_t* mem = OS_HeapAlloc(sizeof(pthread_rwlock_t));
+	SafeAssert(pthread_rwlock_init(mem, NULL) == 0);
+	
+	lock->ptr = mem;
+}
+
+API void
+OS_LockShared(OS_RWLock* lock)
+{ SafeAssert(pthread_rwlock_rdlock(lock->ptr) == 0); }
+
+API void
+OS_LockExclusive(OS_RWLock* lock)
+{ SafeAssert(pthread_rwlock_wrlock(lock->ptr) == 0); }
+
+API bool
+OS_TryLockShared(OS_RWLock* lock)
+{ return pthread_rwlock_tryrdlock(lock->ptr) == 0; }
+
+API bool
+OS_TryLockExclusive(OS_RWLock* lock)
+{ return pthread_rwlock_trywrlock(lock->ptr) == 0; }
+
+API void
+OS_UnlockShared(OS_RWLock* lock)
+{ SafeAssert(pthread_rwlock_unlock(lock->ptr) == 0); }
+
+API void
+OS_UnlockExclusive(OS_RWLock* lock)
+{ SafeAssert(pthread_rwlock_unlock(lock->ptr) == 0); }
+
+API void
+OS_DeinitRWLock(OS_RWLock* lock)
+{
+	Trace();
+	
+	if (lock->ptr)
+	{
+		SafeAssert(pthread_rwlock_destroy(lock->ptr) == 0);
+		OS_HeapFree(lock->ptr);
+		lock->ptr = NULL;
+	}
+}
+
+// NOTE(ljre): Starts full and never goes over 'max_count', like a Win32 semaphore.
+API void
+OS_InitSemaphore(OS_Semaphore* sem, int32 max_count)
+{
+	Trace();
+	
+	sem->ptr = NULL;
+	
+	if (max_count > 0)
+	{
+		Linux_Semaphore* mem = OS_HeapAlloc(sizeof(Linux_Semaphore));
+		SafeAssert(sem_init(&mem->sem, 0, (unsigned)max_count) == 0);
+		mem->max_count = max_count;
+		sem->ptr = mem;
+	}
+}
+
+API bool
+OS_WaitForSemaphore(OS_Semaphore* sem)
+{
+	//Trace();
+	Assert(sem);
+	
+	Linux_Semaphore* mem = sem->ptr;
+	
+	if (mem)
+	{
+		int result;
+		
+		do
+			result = sem_wait(&mem->sem);
+		while (result == -1 && errno == EINTR);
+		
+		return result == 0;
+	}
+	
+	return false;
+}
+
+API void
+OS_SignalSemaphore(OS_Semaphore* sem, int32 count)
+{
+	Trace();
+	Assert(sem);
+	
+	Linux_Semaphore* mem = sem->ptr;
+	
+	if (mem)
+	{
+		int value = 0;
+		
+		if (sem_getvalue(&mem->sem, &value) == 0)
+			count = Min(count, mem->max_count - value);
+		
+		while (count-- > 0 && sem_post(&mem->sem) == 0)
+		{}
+	}
+}
+
+API void
+OS_DeinitSemaphore(OS_Semaphore* sem)
+{
+	Trace();
+	Assert(sem);
+	
+	if (sem->ptr)
+	{
+		Linux_Semaphore* mem = sem->ptr;
+		
+		sem_destroy(&mem->sem);
+		OS_HeapFree(mem);
+		sem->ptr = NULL;
+	}
+}
+
+// NOTE(ljre): Auto-reset, like the Win32 event it replaces: a wait consumes the signal and only wakes one thread.
+API void
+OS_InitEventSignal(OS_EventSignal* sig)
+{
+	Trace();
+	
+	Linux_EventSignal* mem = OS_HeapAlloc(sizeof(Linux_EventSignal));
+	SafeAssert(pthread_mutex_init(&mem->mutex, NULL) == 0);
+	SafeAssert(pthread_cond_init(&mem->cond, NULL) == 0);
+	
+	sig->ptr = mem;
+}
+
+API bool
+OS_WaitEventSignal(OS_EventSignal* sig)
+{
+	Trace();
+	SafeAssert(sig && sig->ptr);
+	
+	Linux_EventSignal* mem = sig->ptr;
+	
+	pthread_mutex_lock(&mem->mutex);
+	while (!mem->is_set)
+		pthread_cond_wait(&mem->cond, &mem->mutex);
+	mem->is_set = false;
+	pthread_mutex_unlock(&mem->mutex);
+	
+	return true;
+}
+
+API void
+OS_SetEventSignal(OS_EventSignal* sig)
+{
+	Trace();
+	SafeAssert(sig && sig->ptr);
+	
+	Linux_EventSignal* mem = sig->ptr;
+	
+	pthread_mutex_lock(&mem->mutex);
+	mem->is_set = true;
+	pthread_cond_signal(&mem->cond);
+	pthread_mutex_unlock(&mem->mutex);
+}
+
+API void
+OS_ResetEventSignal(OS_EventSignal* sig)
+{
+	Trace();
+	SafeAssert(sig && sig->ptr);
+	
+	Linux_EventSignal* mem = sig->ptr;
+	
+	pthread_mutex_lock(&mem->mutex);
+	mem->is_set = false;
+	pthread_mutex_unlock(&mem->mutex);
+}
+
+API void
+OS_DeinitEventSignal(OS_EventSignal* sig)
+{
+	Trace();
+	SafeAssert(sig && sig->ptr);
+	
+	Linux_EventSignal* mem = sig->ptr;
+	
+	pthread_cond_destroy(&mem->cond);
+	pthread_mutex_destroy(&mem->mutex);
+	OS_HeapFree(mem);
+	sig->ptr = NULL;
+}
+
+API int32
+OS_InterlockedCompareExchange32(volatile int32* ptr, int32 new_value, int32 expected)
+{
+	__atomic_compare_exchange_n(ptr, &expected, new_value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	return expected;
+}
+
+API int64
+OS_InterlockedCompareExchange64(volatile int64* ptr, int64 new_value, int64 expected)
+{
+	__atomic_compare_exchange_n(ptr, &expected, new_value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	return expected;
+}
+
+API void*
+OS_InterlockedCompareExchangePtr(void* volatile* ptr, void* new_value, void* expected)
+{
+	__atomic_compare_exchange_n(ptr, &expected, new_value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	return expected;
+}
+
+API int32
+OS_InterlockedIncrement32(volatile int32* ptr)
+{ return __atomic_add_fetch(ptr, 1, __ATOMIC_SEQ_CST); }
+
+API int32
+OS_InterlockedDecrement32(volatile int32* ptr)
+{ return __atomic_sub_fetch(ptr, 1, __ATOMIC_SEQ_CST); }
+
+API int32
+OS_InterlockedExchange32(volatile int32* ptr, int32 new_value)
+{ return __atomic_exchange_n(ptr, new_value, __ATOMIC_SEQ_CST); }
+
+API int32
+OS_InterlockedAdd32(volatile int32* ptr, int32 value)
+{ return __atomic_add_fetch(ptr, value, __ATOMIC_SEQ_CST); }
+
+API void
+OS_MemoryBarrier(void)
+{ __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+
+// NOTE(ljre): ucontext fibers. swapcontext also saves the signal mask with a syscall, so switches cost more than
+//             they do on Win32.
+static void
+Linux_FiberProc_(void)
+{
+	Linux_Fiber* fiber = g_linux_current_fiber;
+	
+	fiber->proc(fiber->user_data);
+	Unreachable();
+}
+
+API OS_Fiber
+OS_ConvertThreadToFiber(void)
+{
+	Trace();
+	
+	Linux_Fiber* fiber = OS_HeapAlloc(sizeof(Linux_Fiber));
+	fiber->is_thread = true;
+	g_linux_current_fiber = fiber;
+	
+	return (OS_Fiber) { fiber };
+}
+
+API OS_Fiber
+OS_CreateFiber(OS_FiberProc* proc, void* user_data, uintsize stack_size)
+{
+	Trace();
+	
+	// NOTE(ljre): Same default as CreateFiberEx.
+	if (!stack_size)
+		stack_size = 1 << 20;
+	
+	Linux_Fiber* fiber = OS_HeapAlloc(sizeof(Linux_Fiber));
+	fiber->proc = proc;
+	fiber->user_data = user_data;
+	fiber->stack_size = stack_size;
+	fiber->stack = mmap(NULL, stack_size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_STACK, -1, 0);
+	
+	if (fiber->stack == MAP_FAILED || getcontext(&fiber->context) != 0)
+	{
+		if (fiber->stack != MAP_FAILED)
+			munmap(fiber->stack, stack_size);
+		
+		OS_HeapFree(fiber);
+		return (OS_Fiber) { 0 };
+	}
+	
+	fiber->context.uc_stack.ss_sp = fiber->stack;
+	fiber->context.uc_stack.ss_size = stack_size;
+	fiber->context.uc_link = NULL;
+	makecontext(&fiber->context, Linux_FiberProc_, 0);
+	
+	return (OS_Fiber) { fiber };
+}
+
+API void
+OS_SwitchToFiber(OS_Fiber fiber)
+{
+	Linux_Fiber* data = fiber.ptr;
+	Linux_Fiber* current = g_linux_current_fiber;
+	SafeAssert(data && current);
+	
+	g_linux_current_fiber = data;
+	swapcontext(&current->context, &data->context);
+}
+
+API void
+OS_DeleteFiber(OS_Fiber fiber)
+{
+	Trace();
+	
+	Linux_Fiber* data = fiber.ptr;
+	if (!data)
+		return;
+	
+	if (data->is_thread)
+	{
+		if (g_linux_current_fiber == data)
+			g_linux_current_fiber = NULL;
+	}
+	else
+		munmap(data->stack, data->stack_size);
+	
+	OS_HeapFree(data);
+}
+
+#ifdef CONFIG_DEBUG
+API void
+OS_DebugMessageBox(const char* fmt, ...)
+{
+	Arena* scratch_arena = Linux_GetThreadScratchArena();
+	
+	for ArenaTempScope(scratch_arena)
+	{
+		va_list args;
+		va_start(args, fmt);
+		String str = ArenaVPrintf(scratch_arena, fmt, args);
+		va_end(args);
+		
+		OS_MessageBox(Str("OS_DebugMessageBox"), str);
+	}
+}
+
+API void
+OS_DebugLog(const char* fmt, ...)
+{
+	Arena* scratch_arena = Linux_GetThreadScratchArena();
+	
+	for ArenaTempScope(scratch_arena)
+	{
+		va_list args;
+		va_start(args, fmt);
+		String str = ArenaVPrintf(scratch_arena, fmt, args);
+		va_end(args);
+		
+		fwrite(str.data, 1, str.size, stderr);
+	}
+}
+
+API int
+OS_DebugLogPrintfFormat(const char* fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	int result = vfprintf(stderr, fmt, args);
+	va_end(args);
+	
+	return result;
+}
+#endif //CONFIG_DEBUG
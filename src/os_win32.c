@@ -10,6 +10,15 @@ struct Win32_MappedFile
 }
 typedef Win32_MappedFile;
 
+struct Win32_Fiber
+{
+	LPVOID handle;
+	OS_FiberProc* proc;
+	void* user_data;
+	bool is_thread;
+}
+typedef Win32_Fiber;
+
 //~ NOTE(ljre): Globals
 static OS_WindowGraphicsContext g_graphics_context;
 static OS_State g_os;
@@ -28,6 +37,10 @@ struct
 	HANDLE worker_threads[OS_Limits_MaxWorkerThreadCount];
 	
 	int32 user_thread_count;
+	bool thread_affinity;
+	int32 cpu_core_count;
+	int32 cpu_placement_count;
+	GROUP_AFFINITY cpu_placements[OS_Limits_MaxWorkerThreadCount];
 	int32 argc;
 	const char* const* argv;
 	
@@ -260,6 +273,96 @@ WindowProc(HWND window, UINT message, WPARAM wparam, LPARAM lparam)
 	return result;
 }
 
+// NOTE(ljre): Counts the physical cores and lists where threads go when '-thread-affinity' is set: one per core,
+//             the ones on the NUMA node of the main thread first. A thread may run on any SMT sibling of its core,
+//             and only shares it once there are more threads than cores.
+static void
+Win32_QueryCpuTopology_(void)
+{
+	DWORD size = 0;
+	GetLogicalProcessorInformationEx(RelationAll, NULL, &size);
+	
+	uint8* infos = (size > 0) ? OS_HeapAlloc(size) : NULL;
+	
+	if (!infos || !GetLogicalProcessorInformationEx(RelationAll, (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)infos, &size))
+	{
+		// NOTE(ljre): Assume SMT and don't place anything.
+		SYSTEM_INFO system_info = { 0 };
+		GetNativeSystemInfo(&system_info);
+		
+		g_win32.cpu_core_count = ClampMin((int32)system_info.dwNumberOfProcessors / 2, 1);
+		g_win32.cpu_placement_count = 0;
+		
+		if (infos)
+			OS_HeapFree(infos);
+		return;
+	}
+	
+	PROCESSOR_NUMBER main_processor = { 0 };
+	GROUP_AFFINITY main_node = { 0 };
+	GetCurrentProcessorNumberEx(&main_processor);
+	
+	for (DWORD offset = 0; offset < size; offset += ((SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)(infos + offset))->Size)
+	{
+		SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* info = (void*)(infos + offset);
+		
+		if (info->Relationship == RelationNumaNode)
+		{
+			GROUP_AFFINITY node = info->NumaNode.GroupMask;
+			
+			if (node.Group == main_processor.Group && (node.Mask & ((KAFFINITY)1 << main_processor.Number)))
+				main_node = node;
+		}
+	}
+	
+	int32 core_count = 0;
+	int32 placement_count = 0;
+	
+	for (int32 pass = 0; pass < 2; ++pass)
+	{
+		for (DWORD offset = 0; offset < size; offset += ((SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)(infos + offset))->Size)
+		{
+			SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* info = (void*)(infos + offset);
+			
+			if (info->Relationship != RelationProcessorCore)
+				continue;
+			
+			GROUP_AFFINITY core = info->Processor.GroupMask[0];
+			bool is_on_main_node = (core.Group == main_node.Group && (core.Mask & main_node.Mask));
+			
+			if (is_on_main_node != (pass == 0))
+				continue;
+			
+			if (placement_count < ArrayLength(g_win32.cpu_placements))
+			{
+				g_win32.cpu_placements[placement_count++] = (GROUP_AFFINITY) {
+					.Mask = core.Mask,
+					.Group = core.Group,
+				};
+			}
+			
+			++core_count;
+		}
+	}
+	
+	g_win32.cpu_core_count = ClampMin(core_count, 1);
+	g_win32.cpu_placement_count = placement_count;
+	
+	OS_HeapFree(infos);
+}
+
+static void
+Win32_PlaceThread_(HANDLE thread, int32 index)
+{
+	if (g_win32.cpu_placement_count > 0)
+	{
+		GROUP_AFFINITY affinity = g_win32.cpu_placements[index % g_win32.cpu_placement_count];
+		
+		if (!SetThreadGroupAffinity(thread, &affinity, NULL))
+			OS_DebugLog("Failed to set the affinity of thread %i.", index);
+	}
+}
+
 static DWORD WINAPI
 Win32_ThreadProc_(void* user_data)
 {
@@ -332,17 +435,11 @@ WinMain(HINSTANCE instance, HINSTANCE previous, LPSTR cmd_args, int cmd_show)
 	}
 #endif
 	
-	int32 cpu_core_count = 1;
-	{
-		SYSTEM_INFO system_info = { 0 };
-		GetNativeSystemInfo(&system_info);
-		
-		cpu_core_count = system_info.dwNumberOfProcessors;
-	}
+	Win32_QueryCpuTopology_();
 	
 	g_win32.process_started_time = Win32_GetTimer();
 	g_win32.instance = instance;
-	g_win32.user_thread_count = Clamp(cpu_core_count/2, 1, OS_Limits_MaxWorkerThreadCount);
+	g_win32.user_thread_count = Clamp(g_win32.cpu_core_count, 1, OS_Limits_MaxWorkerThreadCount);
 	g_win32.argc = __argc;
 	g_win32.argv = (const char* const*)__argv;
 	
@@ -356,6 +453,18 @@ WinMain(HINSTANCE instance, HINSTANCE previous, LPSTR cmd_args, int cmd_show)
 			g_win32.init_config.desired_graphics_api = OS_WindowGraphicsApi_Direct3D11;
 		else if (StringEquals(arg, Str("-no-worker-threads")))
 			g_win32.user_thread_count = 1;
+		else if (StringEquals(arg, Str("-thread-affinity")))
+			g_win32.thread_affinity = true;
+		else if (StringStartsWith(arg, Str("-worker-threads=")))
+		{
+			int32 count = 0;
+			arg = StringSubstr(arg, sizeof("-worker-threads=")-1, -1);
+			
+			for (intsize j = 0; j < arg.size && arg.data[j] >= '0' && arg.data[j] <= '9'; ++j)
+				count = Min(count*10 + (arg.data[j] - '0'), OS_Limits_MaxWorkerThreadCount);
+			
+			g_win32.user_thread_count = Clamp(count + 1, 1, OS_Limits_MaxWorkerThreadCount);
+		}
 		else if (StringEquals(arg, Str("-no-vsync")))
 			g_win32.vsync_disabled = true;
 		else if (StringStartsWith(arg, Str("-d3d11=")))
@@ -381,6 +490,9 @@ WinMain(HINSTANCE instance, HINSTANCE previous, LPSTR cmd_args, int cmd_show)
 		}
 	}
 	
+	if (g_win32.thread_affinity)
+		Win32_PlaceThread_(GetCurrentThread(), 0);
+	
 	//- Call Setup
 	g_win32.app_api = GetAppApi();
 	
@@ -463,6 +575,9 @@ WinMain(HINSTANCE instance, HINSTANCE previous, LPSTR cmd_args, int cmd_show)
 		{
 			HANDLE handle = CreateThread(NULL, 0, Win32_ThreadProc_, (void*)(uintptr)i, 0, NULL);
 			g_win32.worker_threads[i] = handle;
+			
+			if (handle && g_win32.thread_affinity)
+				Win32_PlaceThread_(handle, i);
 		}
 		
 		g_os.has_audio = audio_initialized_successfully;
@@ -1189,6 +1304,90 @@ API int32
 OS_InterlockedDecrement32(volatile int32* ptr)
 { return (int32)InterlockedDecrement((volatile LONG*)ptr); }
 
+API int32
+OS_InterlockedExchange32(volatile int32* ptr, int32 new_value)
+{ return (int32)InterlockedExchange((volatile LONG*)ptr, (LONG)new_value); }
+
+API int32
+OS_InterlockedAdd32(volatile int32* ptr, int32 value)
+{ return (int32)InterlockedExchangeAdd((volatile LONG*)ptr, (LONG)value) + value; }
+
+API void
+OS_MemoryBarrier(void)
+{ MemoryBarrier(); }
+
+static VOID CALLBACK
+Win32_FiberProc_(LPVOID param)
+{
+	Win32_Fiber* fiber = param;
+	
+	fiber->proc(fiber->user_data);
+	Unreachable();
+}
+
+API OS_Fiber
+OS_ConvertThreadToFiber(void)
+{
+	Trace();
+	
+	Win32_Fiber* fiber = OS_HeapAlloc(sizeof(Win32_Fiber));
+	fiber->handle = ConvertThreadToFiberEx(fiber, FIBER_FLAG_FLOAT_SWITCH);
+	fiber->is_thread = true;
+	
+	if (!fiber->handle)
+	{
+		OS_HeapFree(fiber);
+		fiber = NULL;
+	}
+	
+	return (OS_Fiber) { fiber };
+}
+
+API OS_Fiber
+OS_CreateFiber(OS_FiberProc* proc, void* user_data, uintsize stack_size)
+{
+	Trace();
+	
+	Win32_Fiber* fiber = OS_HeapAlloc(sizeof(Win32_Fiber));
+	fiber->proc = proc;
+	fiber->user_data = user_data;
+	fiber->handle = CreateFiberEx(0, stack_size, FIBER_FLAG_FLOAT_SWITCH, Win32_FiberProc_, fiber);
+	
+	if (!fiber->handle)
+	{
+		OS_HeapFree(fiber);
+		fiber = NULL;
+	}
+	
+	return (OS_Fiber) { fiber };
+}
+
+API void
+OS_SwitchToFiber(OS_Fiber fiber)
+{
+	Win32_Fiber* data = fiber.ptr;
+	SafeAssert(data);
+	
+	SwitchToFiber(data->handle);
+}
+
+API void
+OS_DeleteFiber(OS_Fiber fiber)
+{
+	Trace();
+	
+	Win32_Fiber* data = fiber.ptr;
+	if (!data)
+		return;
+	
+	if (data->is_thread)
+		ConvertFiberToThread();
+	else
+		DeleteFiber(data->handle);
+	
+	OS_HeapFree(data);
+}
+
 #ifdef CONFIG_DEBUG
 API void
 OS_DebugMessageBox(const char* fmt, ...)
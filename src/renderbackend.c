@@ -2,6 +2,8 @@
 #include "api_os.h"
 #include "api_renderbackend.h"
 
+#include <math.h>
+
 struct RB_GenericHandle_ { uint32 id; } typedef RB_GenericHandle_;
 
 enum RB_ResourceKind_
@@ -23,6 +25,7 @@ enum RB_ResourceKind_
 	RB_ResourceKind_UpdateIndexBuffer_,
 	RB_ResourceKind_UpdateStructuredBuffer_,
 	RB_ResourceKind_UpdateUniformBuffer_,
+	RB_ResourceKind_AppendVertexBuffer_,
 	
 	RB_ResourceKind_FreeTexture2D_,
 	RB_ResourceKind_FreeVertexBuffer_,
@@ -68,6 +71,7 @@ struct RB_ResourceCall_
 		RB_ComputeShaderDesc compute_shader;
 		
 		struct { Buffer new_data; } update;
+		struct { Buffer data; uint32* out_offset; } append;
 	};
 }
 typedef RB_ResourceCall_;
@@ -94,6 +98,7 @@ struct RB_Ctx
 	Arena* arena;
 	const OS_WindowGraphicsContext* graphics_context;
 	RB_Capabilities caps;
+	uint64 frame_index;
 	
 	void* rt;
 	void (*rt_free_ctx)(RB_Ctx* ctx);
@@ -160,6 +165,83 @@ RB_PoolFreeImpl_(void* pool_ptr, uint32 max_size, uintsize obj_size, uint32 inde
 	pool->first_free = index;
 }
 
+// NOTE(ljre): Where the next append to a ring buffer goes, shared by the backends. When it doesn't fit in what's
+//             left, it goes to 0 and the backend discards the buffer. The capacity grows so that
+//             RB_Limits_RingFramesInFlight frames as big as the current one fit, and the backend recreates the buffer
+//             when it's not as big as the capacity anymore.
+struct RB_Ring_
+{
+	uint64 frame_index;
+	uintsize capacity;
+	uintsize head;
+	uintsize frame_size;
+}
+typedef RB_Ring_;
+
+enum { RB_RingAlignment_ = 16 };
+
+static uint32
+RB_RingAppend_(RB_Ring_* ring, uint64 frame_index, uintsize size, bool* out_discard)
+{
+	if (ring->frame_index != frame_index)
+	{
+		ring->frame_index = frame_index;
+		ring->frame_size = 0;
+	}
+	
+	uintsize offset = AlignUp(ring->head, RB_RingAlignment_-1);
+	uintsize wanted = (ring->frame_size + size) * RB_Limits_RingFramesInFlight;
+	bool discard = false;
+	
+	if (wanted > ring->capacity)
+	{
+		uintsize capacity = ClampMin(ring->capacity, 4096);
+		while (capacity < wanted)
+			capacity *= 2;
+		
+		ring->capacity = capacity;
+		offset = 0;
+		discard = true;
+	}
+	else if (offset + size > ring->capacity)
+	{
+		offset = 0;
+		discard = true;
+	}
+	
+	SafeAssert(ring->capacity <= UINT32_MAX);
+	
+	ring->head = offset + size;
+	ring->frame_size += size;
+	*out_discard = discard;
+	return (uint32)offset;
+}
+
+static uint32
+RB_VertexFormatSize_(RB_VertexFormat format)
+{
+	static const uint8 sizetable[] = {
+		[RB_VertexFormat_Scalar] = 4,
+		[RB_VertexFormat_Vec2] = 8,
+		[RB_VertexFormat_Vec3] = 12,
+		[RB_VertexFormat_Vec4] = 16,
+		[RB_VertexFormat_Mat2] = 16,
+		[RB_VertexFormat_Mat3] = 36,
+		[RB_VertexFormat_Mat4] = 64,
+		[RB_VertexFormat_Vec2I16Norm] = 4,
+		[RB_VertexFormat_Vec2I16] = 4,
+		[RB_VertexFormat_Vec2F16] = 4,
+		[RB_VertexFormat_Vec4I16Norm] = 8,
+		[RB_VertexFormat_Vec4I16] = 8,
+		[RB_VertexFormat_Vec4F16] = 8,
+		[RB_VertexFormat_Vec4U8Norm] = 4,
+		[RB_VertexFormat_Vec4U8] = 4,
+	};
+	
+	SafeAssert(format > 0 && format < ArrayLength(sizetable));
+	return sizetable[format];
+}
+
 #ifdef CONFIG_ENABLE_D3D11
 #	include "api_os_d3d11.h"
 #	include "renderbackend_d3d11.c"
@@ -168,6 +250,9 @@ RB_PoolFreeImpl_(void* pool_ptr, uint32 max_size, uintsize obj_size, uint32 inde
 #	include "api_os_opengl.h"
 #	include "renderbackend_opengl.c"
 #endif
+#include "renderbackend_null.c"
+#include "renderbackend_software.c"
+#include "renderbackend_deferred.c"
 
 //~
 API RB_Ctx*
@@ -182,7 +267,8 @@ RB_MakeContext(Arena* arena, const OS_WindowGraphicsContext* graphics_context)
 	
 	switch (graphics_context->api)
 	{
-		default: break;
+		default: RB_SetupNullRuntime_(ctx); break;
+		case OS_WindowGraphicsApi_Software: RB_SetupSoftwareRuntime_(ctx); break;
 #ifdef CONFIG_ENABLE_D3D11
 		case OS_WindowGraphicsApi_Direct3D11: RB_SetupD3d11Runtime_(ctx); break;
 #endif
@@ -194,6 +280,46 @@ RB_MakeContext(Arena* arena, const OS_WindowGraphicsContext* graphics_context)
 	return ctx;
 }
 
+API RB_Ctx*
+RB_MakeDeferredContext(RB_Ctx* parent, Arena* arena)
+{
+	Trace();
+	
+	// NOTE(ljre): Only the parent can run what's recorded, so it has to be a real one.
+	SafeAssert(parent->rt_cmd != RB_DeferredCommand_);
+	
+	RB_Ctx* ctx = ArenaPushStructInit(arena, RB_Ctx, {
+		.arena = arena,
+		.graphics_context = parent->graphics_context,
+	});
+	
+	RB_SetupDeferredRuntime_(ctx, parent);
+	
+	return ctx;
+}
+
+API void
+RB_SubmitDeferredContext(RB_Ctx* ctx, RB_Ctx* deferred)
+{
+	Trace();
+	
+	SafeAssert(deferred->rt_cmd == RB_DeferredCommand_);
+	RB_DeferredRuntime_* rt = deferred->rt;
+	SafeAssert(rt->parent == ctx);
+	
+	for (RB_DeferredCall_* call = rt->first; call; call = call->next)
+	{
+		if (call->is_resource)
+			ctx->rt_resource(ctx, &call->resource);
+		else
+			ctx->rt_cmd(ctx, &call->command);
+	}
+	
+	rt->first = NULL;
+	rt->last = NULL;
+	ArenaRestore(rt->recording);
+}
+
 API void
 RB_FreeContext(RB_Ctx* ctx)
 {
@@ -212,6 +338,7 @@ RB_Present(RB_Ctx* ctx)
 	Trace();
 	
 	ctx->graphics_context->present_and_vsync(1);
+	++ctx->frame_index;
 }
 
 API bool
@@ -234,6 +361,96 @@ API RB_Capabilities
 RB_QueryCapabilities(RB_Ctx* ctx)
 { return ctx->caps; }
 
+API RB_NullStats
+RB_QueryNullStats(RB_Ctx* ctx)
+{
+	if (ctx->rt_cmd != RB_NullCommand_)
+		return (RB_NullStats) { 0 };
+	
+	RB_NullRuntime_* rt = ctx->rt;
+	return rt->stats;
+}
+
+API void
+RB_ResetNullStats(RB_Ctx* ctx)
+{
+	if (ctx->rt_cmd != RB_NullCommand_)
+		return;
+	
+	RB_NullRuntime_* rt = ctx->rt;
+	int32 live_resource_count = rt->stats.live_resource_count;
+	
+	rt->stats = (RB_NullStats) {
+		.live_resource_count = live_resource_count,
+	};
+}
+
+API void
+RB_RecordNullCalls(RB_Ctx* ctx, Arena* arena)
+{
+	if (ctx->rt_cmd != RB_NullCommand_)
+		return;
+	
+	RB_NullRuntime_* rt = ctx->rt;
+	rt->record_arena = arena;
+	
+	if (arena)
+	{
+		rt->stats.calls = NULL;
+		rt->stats.call_count = 0;
+	}
+}
+
+API void
+RB_SetSoftwareDispatch(RB_Ctx* ctx, RB_SoftwareDispatchProc* dispatch, void* user_data)
+{
+	if (ctx->rt_cmd != RB_SoftwareCommand_)
+		return;
+	
+	RB_SoftwareRuntime_* rt = ctx->rt;
+	rt->dispatch = dispatch;
+	rt->dispatch_user_data = user_data;
+}
+
+API bool
+RB_ReadSoftwareFramebuffer(RB_Ctx* ctx, Arena* arena, int32* out_width, int32* out_height, Buffer* out_pixels)
+{
+	Trace();
+	
+	if (ctx->rt_cmd != RB_SoftwareCommand_)
+		return false;
+	
+	RB_SoftwareRuntime_* rt = ctx->rt;
+	uintsize size = sizeof(uint32) * rt->width * rt->height;
+	
+	if (!size)
+		return false;
+	
+	*out_width = rt->width;
+	*out_height = rt->height;
+	*out_pixels = BufMake(size, ArenaPushMemoryAligned(arena, rt->color, size, 4));
+	
+	return true;
+}
+
+API void
+RB_SoftwareSample(const RB_SoftwareFragment* fragment, int32 slot, const float32 uv[2], const float32 uv_ddx[2], const float32 uv_ddy[2], float32 out_color[4])
+{
+	const RB_SoftwareTexture_* tex = NULL;
+	
+	if (slot >= 0 && slot < RB_Limits_DrawMaxTextures)
+		tex = fragment->textures[slot];
+	
+	if (!tex)
+	{
+		out_color[0] = out_color[1] = out_color[2] = 0.0f;
+		out_color[3] = 1.0f;
+		return;
+	}
+	
+	RB_SoftwareSampleTexture_(tex, uv, uv_ddx, uv_ddy, out_color);
+}
+
 //~
 API RB_Tex2d
 RB_MakeTexture2D(RB_Ctx* ctx, const RB_Tex2dDesc* desc)
@@ -241,6 +458,9 @@ RB_MakeTexture2D(RB_Ctx* ctx, const RB_Tex2dDesc* desc)
 	Trace();
 	RB_Tex2d handle = { 0 };
 	
+	SafeAssert(desc->mip_count >= 0 && desc->mip_count <= RB_Limits_Tex2dMaxMips);
+	SafeAssert(desc->mip_count <= 1 || (!desc->flag_dynamic && !desc->flag_render_target));
+	
 	ctx->rt_resource(ctx, &(RB_ResourceCall_) {
 		.kind = RB_ResourceKind_MakeTexture2D_,
 		.handle = &handle.id,
@@ -473,6 +693,22 @@ RB_UpdateVertexBuffer(RB_Ctx* ctx, RB_VBuffer res, Buffer new_data)
 	});
 }
 
+API uint32
+RB_AppendVertexBuffer(RB_Ctx* ctx, RB_VBuffer res, Buffer data)
+{
+	Trace();
+	uint32 offset = 0;
+	ctx->rt_resource(ctx, &(RB_ResourceCall_) {
+		.kind = RB_ResourceKind_AppendVertexBuffer_,
+		.handle = &res.id,
+		.append = {
+			.data = data,
+			.out_offset = &offset,
+		},
+	});
+	return offset;
+}
+
 API void
 RB_UpdateIndexBuffer(RB_Ctx* ctx, RB_IBuffer res, Buffer new_data)
 {
@@ -519,6 +755,29 @@ RB_UpdateTexture2D(RB_Ctx* ctx, RB_Tex2d res, Buffer new_data)
 	});
 }
 
+API uintsize
+RB_CalcTexture2DSize(RB_TexFormat format, int32 width, int32 height, int32 mip_count)
+{
+	uintsize pixel_size = 0;
+	
+	switch (format)
+	{
+		case 0: case RB_TexFormat_Count: break;
+		
+		case RB_TexFormat_A8: case RB_TexFormat_R8: pixel_size = 1; break;
+		case RB_TexFormat_D16: case RB_TexFormat_RG8: pixel_size = 2; break;
+		case RB_TexFormat_RGB8: pixel_size = 3; break;
+		case RB_TexFormat_D24S8: case RB_TexFormat_RGBA8: pixel_size = 4; break;
+	}
+	
+	uintsize size = 0;
+	
+	for (int32 i = 0; i < Max(mip_count, 1); ++i)
+		size += (uintsize)Max(width >> i, 1) * Max(height >> i, 1) * pixel_size;
+	
+	return size;
+}
+
 //~
 API void
 RB_BeginCmd(RB_Ctx* ctx, const RB_BeginDesc* desc)
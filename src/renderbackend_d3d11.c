@@ -40,6 +40,7 @@ struct RB_D3d11Buffer_
 	ID3D11Buffer* buffer;
 	ID3D11UnorderedAccessView* uav; // only if structured buffer
 	DXGI_FORMAT index_type; // only if index buffer
+	RB_Ring_ ring; // only if ring vertex buffer
 }
 typedef RB_D3d11Buffer_;
 
@@ -158,7 +159,7 @@ RB_D3d11Resource_(RB_Ctx* ctx, const RB_ResourceCall_* resc)
 			bool dynamic = resc->tex2d.flag_dynamic;
 			uint32 pixel_size;
 			DXGI_FORMAT format = RB_D3d11TexFormatToDxgi_(resc->tex2d.format, &pixel_size);
-			uint32 pitch = width * pixel_size;
+			int32 mip_count = Max(resc->tex2d.mip_count, 1);
 			
 			Assert(width && height && format);
 			
@@ -177,7 +178,7 @@ RB_D3d11Resource_(RB_Ctx* ctx, const RB_ResourceCall_* resc)
 			const D3D11_TEXTURE2D_DESC tex_desc = {
 				.Width = width,
 				.Height = height,
-				.MipLevels = 1,
+				.MipLevels = mip_count,
 				.ArraySize = 1,
 				.Format = format,
 				.SampleDesc = {
@@ -190,17 +191,26 @@ RB_D3d11Resource_(RB_Ctx* ctx, const RB_ResourceCall_* resc)
 				.MiscFlags = 0,
 			};
 			
-			const D3D11_SUBRESOURCE_DATA* tex_initial = (!pixels) ? NULL : &(D3D11_SUBRESOURCE_DATA) {
-				.pSysMem = pixels,
-				.SysMemPitch = (uint32)pitch,
-			};
+			// NOTE(ljre): One subresource per mip level, all of them packed one after the other in 'pixels'.
+			D3D11_SUBRESOURCE_DATA tex_initial[RB_Limits_Tex2dMaxMips] = { 0 };
+			const uint8* level_pixels = pixels;
+			
+			for (int32 i = 0; i < mip_count && pixels; ++i)
+			{
+				uint32 level_width = Max(width >> i, 1);
+				uint32 level_height = Max(height >> i, 1);
+				
+				tex_initial[i].pSysMem = level_pixels;
+				tex_initial[i].SysMemPitch = level_width * pixel_size;
+				level_pixels += (uintsize)level_width * level_height * pixel_size;
+			}
 			
 			const D3D11_SHADER_RESOURCE_VIEW_DESC resource_view_desc = {
 				.Format = tex_desc.Format,
 				.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D,
 				.Texture2D = {
 					.MostDetailedMip = 0,
-					.MipLevels = 1,
+					.MipLevels = mip_count,
 				},
 			};
 			
@@ -208,7 +218,7 @@ RB_D3d11Resource_(RB_Ctx* ctx, const RB_ResourceCall_* resc)
 			ID3D11ShaderResourceView* resource_view;
 			ID3D11SamplerState* sampler_state = resc->tex2d.flag_linear_filtering ? rt->linear_sampler : rt->nearest_sampler;
 			
-			D3d11Call(ID3D11Device_CreateTexture2D(D3d11.device, &tex_desc, tex_initial, &texture));
+			D3d11Call(ID3D11Device_CreateTexture2D(D3d11.device, &tex_desc, pixels ? tex_initial : NULL, &texture));
 			D3d11Call(ID3D11Device_CreateShaderResourceView(D3d11.device, (ID3D11Resource*)texture, &resource_view_desc, &resource_view));
 			
 			RB_D3d11Texture2D_* pool_data = RB_PoolAlloc_(&rt->texpool, &handle);
@@ -237,7 +247,7 @@ RB_D3d11Resource_(RB_Ctx* ctx, const RB_ResourceCall_* resc)
 				bind_flags = D3D11_BIND_VERTEX_BUFFER;
 				size = resc->vbuffer.size;
 				data = resc->vbuffer.initial_data;
-				usage = resc->vbuffer.flag_dynamic ? D3D11_USAGE_DYNAMIC : D3D11_USAGE_IMMUTABLE;
+				usage = (resc->vbuffer.flag_dynamic || resc->vbuffer.flag_ring) ? D3D11_USAGE_DYNAMIC : D3D11_USAGE_IMMUTABLE;
 				misc = 0;
 			}
 			if (0) case RB_ResourceKind_MakeIndexBuffer_:
@@ -293,7 +303,9 @@ RB_D3d11Resource_(RB_Ctx* ctx, const RB_ResourceCall_* resc)
 			RB_D3d11Buffer_* pool_data = RB_PoolAlloc_(&rt->bufferpool, &handle);
 			pool_data->buffer = buffer;
 			
-			if (resc->kind == RB_ResourceKind_MakeIndexBuffer_)
+			if (resc->kind == RB_ResourceKind_MakeVertexBuffer_ && resc->vbuffer.flag_ring)
+				pool_data->ring.capacity = size;
+			else if (resc->kind == RB_ResourceKind_MakeIndexBuffer_)
 			{
 				switch (index_type)
 				{
@@ -662,6 +674,43 @@ RB_D3d11Resource_(RB_Ctx* ctx, const RB_ResourceCall_* resc)
 			ID3D11DeviceContext_Unmap(D3d11.context, (ID3D11Resource*)buffer, 0);
 		} break;
 		
+		case RB_ResourceKind_AppendVertexBuffer_:
+		{
+			Assert(handle);
+			Buffer data = resc->append.data;
+			
+			RB_D3d11Buffer_* pool_data = RB_PoolFetch_(&rt->bufferpool, handle);
+			ID3D11Buffer* buffer = pool_data->buffer;
+			SafeAssert(pool_data->ring.capacity);
+			
+			bool discard;
+			uint32 offset = RB_RingAppend_(&pool_data->ring, ctx->frame_index, data.size, &discard);
+			
+			// Grow if needed
+			D3D11_BUFFER_DESC desc = { 0 };
+			ID3D11Buffer_GetDesc(buffer, &desc);
+			
+			if (desc.ByteWidth < pool_data->ring.capacity)
+			{
+				ID3D11Buffer_Release(buffer);
+				desc.ByteWidth = (uint32)pool_data->ring.capacity;
+				
+				D3d11Call(ID3D11Device_CreateBuffer(D3d11.device, &desc, NULL, &buffer));
+				pool_data->buffer = buffer;
+			}
+			
+			// NOTE(ljre): NO_OVERWRITE promises we don't touch what the GPU might still be reading, which is what
+			//             the ring is for. Only a fresh buffer can be written from 0 again.
+			D3D11_MAP map_type = discard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+			D3D11_MAPPED_SUBRESOURCE map;
+			D3d11Call(ID3D11DeviceContext_Map(D3d11.context, (ID3D11Resource*)buffer, 0, map_type, 0, &map));
+			
+			MemoryCopy((uint8*)map.pData + offset, data.data, data.size);
+			
+			ID3D11DeviceContext_Unmap(D3d11.context, (ID3D11Resource*)buffer, 0);
+			*resc->append.out_offset = offset;
+		} break;
+		
 		case RB_ResourceKind_UpdateTexture2D_:
 		{
 			Assert(handle);
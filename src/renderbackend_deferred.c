@@ -0,0 +1,115 @@
+// NOTE(ljre): What a context made by RB_MakeDeferredContext has instead of a backend. The RB_Cmd* calls and the
+//             updates among them are copied into the arena of the context, and RB_SubmitDeferredContext replays them
+//             on the parent in the same order. Everything that has to answer right away (making, freeing and
+//             appending) asserts here and must be called on the parent instead.
+
+struct RB_DeferredCall_ typedef RB_DeferredCall_;
+struct RB_DeferredCall_
+{
+	RB_DeferredCall_* next;
+	bool is_resource;
+	uint32 handle; // 'resource.handle' points here.
+	
+	union
+	{
+		RB_ResourceCall_ resource;
+		RB_CommandCall_ command;
+	};
+};
+
+struct RB_DeferredRuntime_
+{
+	RB_Ctx* parent;
+	ArenaSavepoint recording; // everything after it is calls.
+	RB_DeferredCall_* first;
+	RB_DeferredCall_* last;
+}
+typedef RB_DeferredRuntime_;
+
+static RB_DeferredCall_*
+RB_DeferredPush_(RB_Ctx* ctx)
+{
+	RB_DeferredRuntime_* rt = ctx->rt;
+	RB_DeferredCall_* call = ArenaPushStruct(ctx->arena, RB_DeferredCall_);
+	
+	if (rt->last)
+		rt->last->next = call;
+	else
+		rt->first = call;
+	
+	rt->last = call;
+	
+	return call;
+}
+
+static void
+RB_DeferredFreeCtx_(RB_Ctx* ctx)
+{
+
+}
+
+static bool
+RB_DeferredIsValidHandle_(RB_Ctx* ctx, uint32 handle)
+{
+	RB_DeferredRuntime_* rt = ctx->rt;
+	
+	return rt->parent->rt_is_valid_handle(rt->parent, handle);
+}
+
+static void
+RB_DeferredResource_(RB_Ctx* ctx, const RB_ResourceCall_* resc)
+{
+	switch (resc->kind)
+	{
+		// NOTE(ljre): These need a handle or an offset right away, so they have to be called on the parent.
+		default: SafeAssert(false); break;
+		
+		case RB_ResourceKind_UpdateTexture2D_:
+		case RB_ResourceKind_UpdateVertexBuffer_:
+		case RB_ResourceKind_UpdateIndexBuffer_:
+		case RB_ResourceKind_UpdateStructuredBuffer_:
+		case RB_ResourceKind_UpdateUniformBuffer_:
+		{
+			SafeAssert(*resc->handle != 0);
+			
+			RB_DeferredCall_* call = RB_DeferredPush_(ctx);
+			call->is_resource = true;
+			call->handle = *resc->handle;
+			call->resource = *resc;
+			call->resource.handle = &call->handle;
+			
+			// NOTE(ljre): The caller is free to reuse its memory as soon as this returns.
+			Buffer new_data = resc->update.new_data;
+			
+			if (new_data.size)
+				call->resource.update.new_data.data = ArenaPushMemoryAligned(ctx->arena, new_data.data, new_data.size, 16);
+		} break;
+	}
+}
+
+static void
+RB_DeferredCommand_(RB_Ctx* ctx, const RB_CommandCall_* cmd)
+{
+	// NOTE(ljre): The parent begins and ends, the deferred contexts only fill what's in between.
+	SafeAssert(cmd->kind != RB_CommandKind_Begin_ && cmd->kind != RB_CommandKind_End_);
+	
+	RB_DeferredCall_* call = RB_DeferredPush_(ctx);
+	call->command = *cmd;
+}
+
+static void
+RB_SetupDeferredRuntime_(RB_Ctx* ctx, RB_Ctx* parent)
+{
+	RB_DeferredRuntime_* rt = ArenaPushStruct(ctx->arena, RB_DeferredRuntime_);
+	rt->parent = parent;
+	rt->recording = ArenaSave(ctx->arena);
+	
+	ctx->rt = rt;
+	ctx->rt_free_ctx = RB_DeferredFreeCtx_;
+	ctx->rt_is_valid_handle = RB_DeferredIsValidHandle_;
+	ctx->rt_resource = RB_DeferredResource_;
+	ctx->rt_cmd = RB_DeferredCommand_;
+	
+	// NOTE(ljre): Whatever is recorded runs on the parent, so it has the same limits.
+	ctx->caps = parent->caps;
+}
@@ -0,0 +1,571 @@
+// NOTE(ljre): Draws nothing. Every handle comes from the same pool, so using one kind of resource where another was
+//             expected is caught, and so are use after free and commands outside of RB_BeginCmd/RB_EndCmd.
+
+struct RB_NullPoolEntry_
+{
+	// NOTE(ljre): First because the free list of the pool is written over it. 'kind' is 0 while it's free.
+	uintsize size;
+	RB_NullResourceKind kind;
+	
+	bool flag_dynamic : 1;
+	bool flag_ring : 1;
+	bool flag_render_target : 1;
+	
+	RB_TexFormat format; // used if texture.
+	int32 width;
+	int32 height;
+	RB_IndexType index_type; // used if index buffer.
+	RB_Ring_ ring; // used if ring vertex buffer.
+	RB_Shader shader; // used if pipeline.
+	RB_LayoutDesc input_layout[RB_Limits_PipelineMaxVertexInputs]; // used if pipeline.
+}
+typedef RB_NullPoolEntry_;
+
+struct RB_NullRuntime_
+{
+	bool in_cmd;
+	RB_Pipeline curr_pipeline;
+	
+	RB_NullStats stats;
+	Arena* record_arena;
+	
+	struct { uint32 size, first_free; RB_NullPoolEntry_ data[1024]; } pool;
+}
+typedef RB_NullRuntime_;
+
+static RB_NullPoolEntry_*
+RB_NullFetch_(RB_NullRuntime_* rt, uint32 handle, RB_NullResourceKind kind)
+{
+	SafeAssert(handle != 0 && handle <= rt->pool.size);
+	RB_NullPoolEntry_* entry = RB_PoolFetch_(&rt->pool, handle);
+	SafeAssert(entry->kind == kind);
+	
+	return entry;
+}
+
+static void
+RB_NullRecord_(RB_NullRuntime_* rt, const RB_NullCall* call)
+{
+	if (!rt->record_arena)
+		return;
+	
+	RB_NullCall* recorded = ArenaPushStructData(rt->record_arena, RB_NullCall, call);
+	
+	if (!rt->stats.calls)
+		rt->stats.calls = recorded;
+	
+	// NOTE(ljre): Something else was pushed to the arena since the last call.
+	SafeAssert(recorded == rt->stats.calls + rt->stats.call_count);
+	++rt->stats.call_count;
+}
+
+static void
+RB_NullFreeCtx_(RB_Ctx* ctx)
+{
+
+}
+
+static bool
+RB_NullIsValidHandle_(RB_Ctx* ctx, uint32 handle)
+{
+	RB_NullRuntime_* rt = ctx->rt;
+	
+	return handle <= rt->pool.size && rt->pool.data[handle-1].kind != 0;
+}
+
+static void
+RB_NullResource_(RB_Ctx* ctx, const RB_ResourceCall_* resc)
+{
+	RB_NullRuntime_* rt = ctx->rt;
+	uint32 handle = *resc->handle;
+	RB_NullCall call = {
+		.handle = handle,
+		.frame_index = ctx->frame_index,
+	};
+	
+	switch (resc->kind)
+	{
+		case 0: Assert(false); break;
+		
+		case RB_ResourceKind_MakeTexture2D_:
+		{
+			const RB_Tex2dDesc* desc = &resc->tex2d;
+			
+			SafeAssert(desc->width > 0 && desc->width <= ctx->caps.max_texture_size);
+			SafeAssert(desc->height > 0 && desc->height <= ctx->caps.max_texture_size);
+			SafeAssert(desc->format > 0 && desc->format < RB_TexFormat_Count);
+			SafeAssert(!desc->flag_dynamic || desc->mip_count <= 1);
+			
+			RB_NullPoolEntry_* entry = RB_PoolAlloc_(&rt->pool, &handle);
+			entry->kind = RB_NullResourceKind_Texture2D;
+			entry->size = RB_CalcTexture2DSize(desc->format, desc->width, desc->height, desc->mip_count);
+			entry->flag_dynamic = desc->flag_dynamic;
+			entry->flag_render_target = desc->flag_render_target;
+			entry->format = desc->format;
+			entry->width = desc->width;
+			entry->height = desc->height;
+			
+			call.kind = RB_NullCallKind_Make;
+			call.resource = RB_NullResourceKind_Texture2D;
+			call.size = desc->pixels ? entry->size : 0;
+		} break;
+		
+		//case RB_ResourceKind_MakeVertexBuffer_:
+		//case RB_ResourceKind_MakeIndexBuffer_:
+		//case RB_ResourceKind_MakeUniformBuffer_:
+		//case RB_ResourceKind_MakeStructuredBuffer_:
+		{
+			RB_NullResourceKind kind;
+			const void* initial_data;
+			uintsize size;
+			
+			if (0) case RB_ResourceKind_MakeVertexBuffer_:
+			{
+				kind = RB_NullResourceKind_VertexBuffer;
+				initial_data = resc->vbuffer.initial_data;
+				size = resc->vbuffer.size;
+				SafeAssert(!resc->vbuffer.flag_ring || !initial_data);
+			}
+			if (0) case RB_ResourceKind_MakeIndexBuffer_:
+			{
+				kind = RB_NullResourceKind_IndexBuffer;
+				initial_data = resc->ibuffer.initial_data;
+				size = resc->ibuffer.size;
+				SafeAssert(resc->ibuffer.index_type == RB_IndexType_Uint16 || resc->ibuffer.index_type == RB_IndexType_Uint32);
+				SafeAssert(resc->ibuffer.index_type != RB_IndexType_Uint32 || ctx->caps.has_32bit_index);
+			}
+			if (0) case RB_ResourceKind_MakeUniformBuffer_:
+			{
+				kind = RB_NullResourceKind_UniformBuffer;
+				initial_data = resc->ubuffer.initial_data;
+				size = resc->ubuffer.size;
+			}
+			if (0) case RB_ResourceKind_MakeStructuredBuffer_:
+			{
+				kind = RB_NullResourceKind_StructuredBuffer;
+				initial_data = resc->sbuffer.initial_data;
+				size = resc->sbuffer.size;
+				SafeAssert(ctx->caps.has_structured_buffer);
+				SafeAssert(resc->sbuffer.stride && size % resc->sbuffer.stride == 0);
+			}
+			
+			SafeAssert(size > 0 && size <= UINT32_MAX);
+			
+			RB_NullPoolEntry_* entry = RB_PoolAlloc_(&rt->pool, &handle);
+			entry->kind = kind;
+			entry->size = size;
+			
+			if (kind == RB_NullResourceKind_VertexBuffer)
+			{
+				entry->flag_dynamic = resc->vbuffer.flag_dynamic || resc->vbuffer.flag_ring;
+				entry->flag_ring = resc->vbuffer.flag_ring;
+				
+				if (entry->flag_ring)
+					entry->ring.capacity = size;
+			}
+			else if (kind == RB_NullResourceKind_IndexBuffer)
+			{
+				entry->flag_dynamic = resc->ibuffer.flag_dynamic;
+				entry->index_type = resc->ibuffer.index_type;
+				SafeAssert(size % (entry->index_type == RB_IndexType_Uint16 ? 2 : 4) == 0);
+			}
+			
+			call.kind = RB_NullCallKind_Make;
+			call.resource = kind;
+			call.size = initial_data ? size : 0;
+		} break;
+		
+		case RB_ResourceKind_MakeShader_:
+		{
+			SafeAssert(resc->shader.glsl.vs.size && resc->shader.glsl.fs.size);
+			
+			RB_NullPoolEntry_* entry = RB_PoolAlloc_(&rt->pool, &handle);
+			entry->kind = RB_NullResourceKind_Shader;
+			
+			call.kind = RB_NullCallKind_Make;
+			call.resource = RB_NullResourceKind_Shader;
+		} break;
+		
+		case RB_ResourceKind_MakeComputeShader_:
+		{
+			SafeAssert(ctx->caps.has_compute_shaders);
+			SafeAssert(resc->compute_shader.glsl.size);
+			
+			RB_NullPoolEntry_* entry = RB_PoolAlloc_(&rt->pool, &handle);
+			entry->kind = RB_NullResourceKind_ComputeShader;
+			
+			call.kind = RB_NullCallKind_Make;
+			call.resource = RB_NullResourceKind_ComputeShader;
+		} break;
+		
+		case RB_ResourceKind_MakeRenderTarget_:
+		{
+			int32 color_count = 0;
+			
+			for (intsize i = 0; i < ArrayLength(resc->render_target.color); ++i)
+			{
+				if (!resc->render_target.color[i].id)
+					continue;
+				
+				RB_NullPoolEntry_* tex = RB_NullFetch_(rt, resc->render_target.color[i].id, RB_NullResourceKind_Texture2D);
+				SafeAssert(tex->flag_render_target);
+				++color_count;
+			}
+			
+			SafeAssert(color_count > 0 && color_count <= ctx->caps.max_render_target_textures);
+			
+			if (resc->render_target.depth_stencil.id)
+			{
+				RB_NullPoolEntry_* tex = RB_NullFetch_(rt, resc->render_target.depth_stencil.id, RB_NullResourceKind_Texture2D);
+				SafeAssert(tex->flag_render_target);
+				SafeAssert(tex->format == RB_TexFormat_D16 || tex->format == RB_TexFormat_D24S8);
+			}
+			
+			RB_NullPoolEntry_* entry = RB_PoolAlloc_(&rt->pool, &handle);
+			entry->kind = RB_NullResourceKind_RenderTarget;
+			
+			call.kind = RB_NullCallKind_Make;
+			call.resource = RB_NullResourceKind_RenderTarget;
+		} break;
+		
+		case RB_ResourceKind_MakePipeline_:
+		{
+			const RB_PipelineDesc* desc = &resc->pipeline;
+			
+			SafeAssert(desc->blend_source >= 0 && desc->blend_source <= RB_BlendFunc_InvDstAlpha);
+			SafeAssert(desc->blend_dest >= 0 && desc->blend_dest <= RB_BlendFunc_InvDstAlpha);
+			SafeAssert(desc->blend_source_alpha >= 0 && desc->blend_source_alpha <= RB_BlendFunc_InvDstAlpha);
+			SafeAssert(desc->blend_dest_alpha >= 0 && desc->blend_dest_alpha <= RB_BlendFunc_InvDstAlpha);
+			SafeAssert(desc->blend_op >= 0 && desc->blend_op <= RB_BlendOp_Subtract);
+			SafeAssert(desc->blend_op_alpha >= 0 && desc->blend_op_alpha <= RB_BlendOp_Subtract);
+			SafeAssert(desc->fill_mode >= 0 && desc->fill_mode <= RB_FillMode_Wireframe);
+			SafeAssert(desc->fill_mode != RB_FillMode_Wireframe || ctx->caps.has_wireframe_fillmode);
+			SafeAssert(desc->cull_mode >= 0 && desc->cull_mode <= RB_CullMode_Back);
+			
+			RB_NullFetch_(rt, desc->shader.id, RB_NullResourceKind_Shader);
+			
+			for (intsize i = 0; i < ArrayLength(desc->input_layout); ++i)
+			{
+				if (!desc->input_layout[i].format)
+					break;
+				
+				RB_VertexFormatSize_(desc->input_layout[i].format);
+				SafeAssert(desc->input_layout[i].buffer_slot < RB_Limits_DrawMaxVertexBuffers);
+				SafeAssert(!desc->input_layout[i].divisor || ctx->caps.has_instancing);
+			}
+			
+			RB_NullPoolEntry_* entry = RB_PoolAlloc_(&rt->pool, &handle);
+			entry->kind = RB_NullResourceKind_Pipeline;
+			entry->shader = desc->shader;
+			MemoryCopy(entry->input_layout, desc->input_layout, sizeof(entry->input_layout));
+			
+			call.kind = RB_NullCallKind_Make;
+			call.resource = RB_NullResourceKind_Pipeline;
+		} break;
+		
+		//case RB_ResourceKind_UpdateVertexBuffer_:
+		//case RB_ResourceKind_UpdateIndexBuffer_:
+		//case RB_ResourceKind_UpdateUniformBuffer_:
+		//case RB_ResourceKind_UpdateStructuredBuffer_:
+		{
+			RB_NullResourceKind kind;
+			
+			if (0) case RB_ResourceKind_UpdateVertexBuffer_: kind = RB_NullResourceKind_VertexBuffer;
+			if (0) case RB_ResourceKind_UpdateIndexBuffer_: kind = RB_NullResourceKind_IndexBuffer;
+			if (0) case RB_ResourceKind_UpdateUniformBuffer_: kind = RB_NullResourceKind_UniformBuffer;
+			if (0) case RB_ResourceKind_UpdateStructuredBuffer_: kind = RB_NullResourceKind_StructuredBuffer;
+			
+			Buffer new_data = resc->update.new_data;
+			RB_NullPoolEntry_* entry = RB_NullFetch_(rt, handle, kind);
+			
+			SafeAssert(!entry->flag_ring);
+			SafeAssert(new_data.size > 0 && new_data.size <= UINT32_MAX);
+			
+			if (kind == RB_NullResourceKind_IndexBuffer)
+				SafeAssert(new_data.size % (entry->index_type == RB_IndexType_Uint16 ? 2 : 4) == 0);
+			
+			// NOTE(ljre): The other backends grow the buffer to fit.
+			entry->size = new_data.size;
+			
+			call.kind = RB_NullCallKind_Update;
+			call.resource = kind;
+			call.size = new_data.size;
+		} break;
+		
+		case RB_ResourceKind_AppendVertexBuffer_:
+		{
+			Buffer data = resc->append.data;
+			RB_NullPoolEntry_* entry = RB_NullFetch_(rt, handle, RB_NullResourceKind_VertexBuffer);
+			SafeAssert(entry->flag_ring);
+			
+			bool discard;
+			uint32 offset = RB_RingAppend_(&entry->ring, ctx->frame_index, data.size, &discard);
+			
+			entry->size = entry->ring.capacity;
+			rt->stats.ring_discard_count += discard;
+			*resc->append.out_offset = offset;
+			
+			call.kind = RB_NullCallKind_Append;
+			call.resource = RB_NullResourceKind_VertexBuffer;
+			call.size = data.size;
+		} break;
+		
+		case RB_ResourceKind_UpdateTexture2D_:
+		{
+			Buffer new_data = resc->update.new_data;
+			RB_NullPoolEntry_* entry = RB_NullFetch_(rt, handle, RB_NullResourceKind_Texture2D);
+			
+			SafeAssert(entry->flag_dynamic);
+			SafeAssert(new_data.size == RB_CalcTexture2DSize(entry->format, entry->width, entry->height, 1));
+			
+			call.kind = RB_NullCallKind_Update;
+			call.resource = RB_NullResourceKind_Texture2D;
+			call.size = new_data.size;
+		} break;
+		
+		//case RB_ResourceKind_FreeTexture2D_:
+		//case RB_ResourceKind_FreeVertexBuffer_:
+		//case RB_ResourceKind_FreeIndexBuffer_:
+		//case RB_ResourceKind_FreeUniformBuffer_:
+		//case RB_ResourceKind_FreeStructuredBuffer_:
+		//case RB_ResourceKind_FreeShader_:
+		//case RB_ResourceKind_FreeRenderTarget_:
+		//case RB_ResourceKind_FreePipeline_:
+		//case RB_ResourceKind_FreeComputeShader_:
+		{
+			RB_NullResourceKind kind;
+			
+			if (0) case RB_ResourceKind_FreeTexture2D_: kind = RB_NullResourceKind_Texture2D;
+			if (0) case RB_ResourceKind_FreeVertexBuffer_: kind = RB_NullResourceKind_VertexBuffer;
+			if (0) case RB_ResourceKind_FreeIndexBuffer_: kind = RB_NullResourceKind_IndexBuffer;
+			if (0) case RB_ResourceKind_FreeUniformBuffer_: kind = RB_NullResourceKind_UniformBuffer;
+			if (0) case RB_ResourceKind_FreeStructuredBuffer_: kind = RB_NullResourceKind_StructuredBuffer;
+			if (0) case RB_ResourceKind_FreeShader_: kind = RB_NullResourceKind_Shader;
+			if (0) case RB_ResourceKind_FreeRenderTarget_: kind = RB_NullResourceKind_RenderTarget;
+			if (0) case RB_ResourceKind_FreePipeline_: kind = RB_NullResourceKind_Pipeline;
+			if (0) case RB_ResourceKind_FreeComputeShader_: kind = RB_NullResourceKind_ComputeShader;
+			
+			RB_NullPoolEntry_* entry = RB_NullFetch_(rt, handle, kind);
+			entry->kind = RB_NullResourceKind_Null;
+			
+			RB_PoolFree_(&rt->pool, handle);
+			handle = 0;
+			
+			call.kind = RB_NullCallKind_Free;
+			call.resource = kind;
+		} break;
+	}
+	
+	switch (call.kind)
+	{
+		default: break;
+		case RB_NullCallKind_Make: call.handle = handle; ++rt->stats.make_count; ++rt->stats.live_resource_count; break;
+		case RB_NullCallKind_Update: ++rt->stats.update_count; break;
+		case RB_NullCallKind_Append: ++rt->stats.append_count; break;
+		case RB_NullCallKind_Free: ++rt->stats.free_count; --rt->stats.live_resource_count; break;
+	}
+	
+	rt->stats.uploaded_bytes += call.size;
+	RB_NullRecord_(rt, &call);
+	
+	*resc->handle = handle;
+}
+
+static void
+RB_NullCommand_(RB_Ctx* ctx, const RB_CommandCall_* cmd)
+{
+	RB_NullRuntime_* rt = ctx->rt;
+	RB_NullCall call = {
+		.frame_index = ctx->frame_index,
+	};
+	
+	SafeAssert(rt->in_cmd == (cmd->kind != RB_CommandKind_Begin_));
+	
+	switch (cmd->kind)
+	{
+		case 0: Assert(false); break;
+		
+		case RB_CommandKind_Begin_:
+		{
+			SafeAssert(cmd->begin.viewport_width > 0 && cmd->begin.viewport_height > 0);
+			
+			rt->in_cmd = true;
+			rt->curr_pipeline = (RB_Pipeline) { 0 };
+			++rt->stats.begin_count;
+			
+			call.kind = RB_NullCallKind_Begin;
+			call.begin = cmd->begin;
+		} break;
+		
+		case RB_CommandKind_End_:
+		{
+			rt->in_cmd = false;
+			
+			call.kind = RB_NullCallKind_End;
+		} break;
+		
+		case RB_CommandKind_Clear_:
+		{
+			++rt->stats.clear_count;
+			
+			call.kind = RB_NullCallKind_Clear;
+			call.clear = cmd->clear;
+		} break;
+		
+		case RB_CommandKind_ApplyPipeline_:
+		{
+			RB_NullPoolEntry_* pipeline = RB_NullFetch_(rt, cmd->apply_pipeline.handle.id, RB_NullResourceKind_Pipeline);
+			RB_NullFetch_(rt, pipeline->shader.id, RB_NullResourceKind_Shader);
+			
+			rt->curr_pipeline = cmd->apply_pipeline.handle;
+			++rt->stats.pipeline_count;
+			
+			call.kind = RB_NullCallKind_ApplyPipeline;
+			call.handle = cmd->apply_pipeline.handle.id;
+		} break;
+		
+		case RB_CommandKind_ApplyRenderTarget_:
+		{
+			if (cmd->apply_render_target.handle.id)
+				RB_NullFetch_(rt, cmd->apply_render_target.handle.id, RB_NullResourceKind_RenderTarget);
+			
+			call.kind = RB_NullCallKind_ApplyRenderTarget;
+			call.handle = cmd->apply_render_target.handle.id;
+		} break;
+		
+		case RB_CommandKind_Draw_:
+		{
+			const RB_DrawDesc* desc = &cmd->draw;
+			RB_NullPoolEntry_* pipeline = RB_NullFetch_(rt, rt->curr_pipeline.id, RB_NullResourceKind_Pipeline);
+			
+			// Buffers
+			RB_NullPoolEntry_* ibuffer = RB_NullFetch_(rt, desc->ibuffer.id, RB_NullResourceKind_IndexBuffer);
+			uint64 index_size = (ibuffer->index_type == RB_IndexType_Uint16) ? 2 : 4;
+			
+			SafeAssert(desc->index_count > 0);
+			SafeAssert(((uint64)desc->base_index + desc->index_count) * index_size <= ibuffer->size);
+			SafeAssert(!desc->instance_count || ctx->caps.has_instancing);
+			
+			if (desc->ubuffer.id)
+				RB_NullFetch_(rt, desc->ubuffer.id, RB_NullResourceKind_UniformBuffer);
+			if (desc->sbuffer.id)
+				RB_NullFetch_(rt, desc->sbuffer.id, RB_NullResourceKind_StructuredBuffer);
+			
+			// Vertex Layout
+			for (intsize i = 0; i < ArrayLength(pipeline->input_layout); ++i)
+			{
+				const RB_LayoutDesc* layout = &pipeline->input_layout[i];
+				
+				if (!layout->format)
+					break;
+				
+				RB_NullPoolEntry_* vbuffer = RB_NullFetch_(rt, desc->vbuffers[layout->buffer_slot].id, RB_NullResourceKind_VertexBuffer);
+				uint64 stride = desc->strides[layout->buffer_slot];
+				uint64 offset = (uint64)desc->offsets[layout->buffer_slot] + layout->offset;
+				
+				// NOTE(ljre): Without looking at the indices, only the instanced attributes can be checked for the
+				//             whole draw. The others at least need the first vertex in the buffer.
+				if (layout->divisor && desc->instance_count)
+					offset += stride * ((desc->instance_count - 1) / layout->divisor);
+				
+				SafeAssert(stride > 0);
+				SafeAssert(offset + RB_VertexFormatSize_(layout->format) <= vbuffer->size);
+			}
+			
+			// Samplers
+			int32 texture_count = 0;
+			
+			for (intsize i = 0; i < ArrayLength(desc->textures); ++i)
+			{
+				if (!desc->textures[i].id)
+					continue;
+				
+				RB_NullFetch_(rt, desc->textures[i].id, RB_NullResourceKind_Texture2D);
+				++texture_count;
+			}
+			
+			SafeAssert(texture_count <= ctx->caps.max_textures_per_drawcall);
+			
+			// Draw Call
+			++rt->stats.draw_count;
+			rt->stats.index_count += (uint64)desc->index_count * Max(desc->instance_count, 1);
+			
+			if (desc->instance_count)
+			{
+				++rt->stats.instanced_draw_count;
+				rt->stats.instance_count += desc->instance_count;
+			}
+			
+			call.kind = RB_NullCallKind_Draw;
+			call.handle = rt->curr_pipeline.id;
+			call.draw = *desc;
+		} break;
+		
+		case RB_CommandKind_Dispatch_:
+		{
+			const RB_DispatchDesc* desc = &cmd->dispatch;
+			
+			SafeAssert(ctx->caps.has_compute_shaders);
+			RB_NullFetch_(rt, desc->shader.id, RB_NullResourceKind_ComputeShader);
+			SafeAssert(desc->count_x && desc->count_y && desc->count_z);
+			
+			if (desc->ubuffer.id)
+				RB_NullFetch_(rt, desc->ubuffer.id, RB_NullResourceKind_UniformBuffer);
+			if (desc->sbuffer.id)
+				RB_NullFetch_(rt, desc->sbuffer.id, RB_NullResourceKind_StructuredBuffer);
+			
+			for (intsize i = 0; i < ArrayLength(desc->textures); ++i)
+			{
+				if (desc->textures[i].id)
+					RB_NullFetch_(rt, desc->textures[i].id, RB_NullResourceKind_Texture2D);
+			}
+			
+			++rt->stats.dispatch_count;
+			
+			call.kind = RB_NullCallKind_Dispatch;
+			call.handle = desc->shader.id;
+			call.dispatch = *desc;
+		} break;
+	}
+	
+	RB_NullRecord_(rt, &call);
+}
+
+static void
+RB_SetupNullRuntime_(RB_Ctx* ctx)
+{
+	RB_NullRuntime_* rt = ArenaPushStruct(ctx->arena, RB_NullRuntime_);
+	ctx->rt = rt;
+	ctx->rt_free_ctx = RB_NullFreeCtx_;
+	ctx->rt_is_valid_handle = RB_NullIsValidHandle_;
+	ctx->rt_resource = RB_NullResource_;
+	ctx->rt_cmd = RB_NullCommand_;
+	
+	//- Capabilities
+	// NOTE(ljre): Same as the OpenGL backend, so the engine takes the same paths it would take on most machines.
+	RB_Capabilities caps = {
+		.backend_api = StrInit("Null"),
+		.driver_renderer = StrInit("None"),
+		.driver_vendor = StrInit("None"),
+		.driver_version = StrInit("None"),
+		.shader_type = RB_ShaderType_Glsl,
+		
+		.max_texture_size = 8192,
+		.max_render_target_textures = 4,
+		.max_textures_per_drawcall = RB_Limits_DrawMaxTextures,
+	};
+	
+	caps.has_instancing = true;
+	caps.has_32bit_index = true;
+	caps.has_separate_alpha_blend = true;
+	caps.has_compute_shaders = false;
+	caps.has_structured_buffer = false;
+	caps.has_f16_formats = false;
+	caps.has_f16_shader_ops = false;
+	caps.has_wireframe_fillmode = true;
+	
+	for (int32 i = 1; i < RB_TexFormat_Count; ++i)
+		caps.supported_texture_formats[i / 64] |= 1ull << (i % 64);
+	
+	ctx->caps = caps;
+}
@@ -4,6 +4,7 @@ struct RB_OpenGLBuffer_
 {
 	uint32 id;
 	uint32 index_type; // used if index buffer.
+	RB_Ring_ ring; // used if ring vertex buffer.
 }
 typedef RB_OpenGLBuffer_;
 
@@ -167,18 +168,34 @@ RB_OpenGLResource_(RB_Ctx* ctx, const RB_ResourceCall_* resc)
 			
 			bool mag_linear = resc->tex2d.flag_linear_filtering;
 			bool min_linear = mag_linear;
+			int32 mip_count = Max(resc->tex2d.mip_count, 1);
+			GLenum min_filter = min_linear ? GL_LINEAR : GL_NEAREST;
+			
+			if (mip_count > 1)
+				min_filter = min_linear ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_NEAREST;
 			
 			GL.glGenTextures(1, &id);
 			GL.glBindTexture(GL_TEXTURE_2D, id);
 			
 			GL.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, mag_linear ? GL_LINEAR : GL_NEAREST);
-			GL.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, min_linear ? GL_LINEAR : GL_NEAREST);
+			GL.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, min_filter);
 			GL.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 			GL.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+			GL.glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mip_count - 1);
 			
 			{
 				Trace(); TraceName(Str("glTexImage2D"));
-				GL.glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, unsized_format, datatype, pixels);
+				const uint8* level_pixels = pixels;
+				
+				for (int32 i = 0; i < mip_count; ++i)
+				{
+					int32 level_width = Max(width >> i, 1);
+					int32 level_height = Max(height >> i, 1);
+					
+					GL.glTexImage2D(GL_TEXTURE_2D, i, format, level_width, level_height, 0, unsized_format, datatype, level_pixels);
+					if (level_pixels)
+						level_pixels += RB_CalcTexture2DSize(resc->tex2d.format, level_width, level_height, 1);
+				}
 			}
 			
 			GL.glBindTexture(GL_TEXTURE_2D, 0);
@@ -202,7 +219,7 @@ RB_OpenGLResource_(RB_Ctx* ctx, const RB_ResourceCall_* resc)
 				kind = GL_ARRAY_BUFFER;
 				initial_data = resc->vbuffer.initial_data;
 				size = resc->vbuffer.size;
-				dynamic = resc->vbuffer.flag_dynamic;
+				dynamic = resc->vbuffer.flag_dynamic || resc->vbuffer.flag_ring;
 			}
 			if (0) case RB_ResourceKind_MakeIndexBuffer_:
 			{
@@ -230,7 +247,9 @@ RB_OpenGLResource_(RB_Ctx* ctx, const RB_ResourceCall_* resc)
 			RB_OpenGLBuffer_* pool_data = RB_PoolAlloc_(&rt->bufferpool, &handle);
 			pool_data->id = id;
 			
-			if (resc->kind == RB_ResourceKind_MakeIndexBuffer_)
+			if (resc->kind == RB_ResourceKind_MakeVertexBuffer_ && resc->vbuffer.flag_ring)
+				pool_data->ring.capacity = size;
+			else if (resc->kind == RB_ResourceKind_MakeIndexBuffer_)
 			{
 				switch (resc->ibuffer.index_type)
 				{
@@ -416,6 +435,38 @@ RB_OpenGLResource_(RB_Ctx* ctx, const RB_ResourceCall_* resc)
 			GL.glBindBuffer(kind, 0);
 		} break;
 		
+		case RB_ResourceKind_AppendVertexBuffer_:
+		{
+			Assert(handle);
+			Buffer data = resc->append.data;
+			
+			RB_OpenGLBuffer_* pool_data = RB_PoolFetch_(&rt->bufferpool, handle);
+			SafeAssert(pool_data->ring.capacity);
+			
+			bool discard;
+			uint32 offset = RB_RingAppend_(&pool_data->ring, ctx->frame_index, data.size, &discard);
+			
+			GL.glBindBuffer(GL_ARRAY_BUFFER, pool_data->id);
+			
+			// NOTE(ljre): Orphaning gives us new storage (of the new capacity, if it grew), then the writes don't
+			//             need to sync with the GPU since the ring never writes over what it might be reading.
+			if (discard)
+				GL.glBufferData(GL_ARRAY_BUFFER, pool_data->ring.capacity, NULL, GL_DYNAMIC_DRAW);
+			
+			if (data.size)
+			{
+				uint32 access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+				void* map = GL.glMapBufferRange(GL_ARRAY_BUFFER, offset, data.size, access);
+				SafeAssert(map);
+				
+				MemoryCopy(map, data.data, data.size);
+				GL.glUnmapBuffer(GL_ARRAY_BUFFER);
+			}
+			
+			GL.glBindBuffer(GL_ARRAY_BUFFER, 0);
+			*resc->append.out_offset = offset;
+		} break;
+		
 		case RB_ResourceKind_UpdateTexture2D_:
 		{
 			Assert(handle);
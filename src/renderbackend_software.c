@@ -0,0 +1,1531 @@
+// NOTE(ljre): Draws on the CPU, into a framebuffer that RB_ReadSoftwareFramebuffer reads back. Every draw runs as
+//             soon as it's made, in chunks of triangles: setup jobs shade the vertices, clip and cull the triangles
+//             of their part of the chunk and bin them in the tiles they touch, then one job per tile rasterizes its
+//             bins in the order the setup jobs were made. Only the job of a tile writes to its pixels, so what comes
+//             out doesn't depend on how many threads ran the jobs.
+//
+//             The shaders are C kernels (see RB_SoftwareVertexProc). Everything follows the OpenGL backend: the
+//             same front face, blending, depth test (LESS, and no writes without it), repeating texture coordinates
+//             and the same conversions of the vertex formats.
+
+enum
+{
+	RB_SoftwareTileSize_ = 64,
+	RB_SoftwareSubpixelBits_ = 8,
+	RB_SoftwareJobTriangles_ = 4096,
+	RB_SoftwareMaxSetupJobs_ = 32,
+	RB_SoftwareBinBlockSize_ = 62,
+	RB_SoftwareVertexCacheSize_ = 16,
+	RB_SoftwareMaxFramebufferSize_ = 16384,
+	
+	// NOTE(ljre): Triangles are only clipped against the sides of the screen when they go past this many times 'w'.
+	//             The ones in between are left to the rasterizer, which only walks what's inside of the viewport.
+	RB_SoftwareGuardBand_ = 2,
+};
+
+struct RB_SoftwareBuffer_
+{
+	// NOTE(ljre): First because the free list of the pool is written over it. 'data' is NULL while it's free.
+	uintsize size;
+	uint8* data;
+	RB_IndexType index_type; // used if index buffer.
+	bool flag_ring : 1;
+	RB_Ring_ ring; // used if ring vertex buffer.
+}
+typedef RB_SoftwareBuffer_;
+
+// NOTE(ljre): Always stored as RGBA8. The mips follow each other in 'pixels', which is NULL while it's free.
+struct RB_SoftwareTexture_
+{
+	int32 width; // NOTE(ljre): First because the free list of the pool is written over it.
+	int32 height;
+	uint32* pixels;
+	int32 mip_count;
+	RB_TexFormat format;
+	uint32 mip_offsets[RB_Limits_Tex2dMaxMips];
+	
+	bool flag_dynamic : 1;
+	bool flag_linear_filtering : 1;
+}
+typedef RB_SoftwareTexture_;
+
+struct RB_SoftwareShader_
+{
+	RB_SoftwareVertexProc* vs;
+	RB_SoftwareFragmentProc* fs;
+	int32 varying_count;
+	int32 flat_varying_count;
+	int32 derivative_count;
+}
+typedef RB_SoftwareShader_;
+
+struct RB_SoftwarePipeline_
+{
+	bool flag_blend : 1;
+	bool flag_cw_backface : 1;
+	bool flag_depth_test : 1;
+	
+	// NOTE(ljre): Already with the defaults of the OpenGL backend for the ones left as 0.
+	RB_BlendFunc blend_source;
+	RB_BlendFunc blend_dest;
+	RB_BlendOp blend_op;
+	RB_BlendFunc blend_source_alpha;
+	RB_BlendFunc blend_dest_alpha;
+	RB_BlendOp blend_op_alpha;
+	RB_CullMode cull_mode;
+	
+	RB_Shader shader;
+	RB_LayoutDesc input_layout[RB_Limits_PipelineMaxVertexInputs];
+}
+typedef RB_SoftwarePipeline_;
+
+struct RB_SoftwareRuntime_
+{
+	RB_SoftwareDispatchProc* dispatch;
+	void* dispatch_user_data;
+	
+	bool in_cmd;
+	RB_Pipeline curr_pipeline;
+	
+	// NOTE(ljre): 'color' is RGBA8 with R in the lowest byte, from the top row down.
+	uint32* color;
+	float32* depth;
+	int32 width;
+	int32 height;
+	int32* active_tiles; // of the current chunk of a draw, as many as there are tiles.
+	
+	// NOTE(ljre): One for each setup job, where its triangles and bins go. Made when first needed.
+	Arena* job_arenas[RB_SoftwareMaxSetupJobs_];
+	
+	struct { uint32 size, first_free; RB_SoftwareBuffer_ data[512]; } bufpool;
+	struct { uint32 size, first_free; RB_SoftwareTexture_ data[512]; } texpool;
+	struct { uint32 size, first_free; RB_SoftwareShader_ data[64]; } shaderpool;
+	struct { uint32 size, first_free; RB_SoftwarePipeline_ data[64]; } pipelinepool;
+}
+typedef RB_SoftwareRuntime_;
+
+//~ Draws
+// NOTE(ljre): 'varyings' holds the smooth varyings of the 3 vertices, already divided by 'w', then the flat ones.
+struct RB_SoftwareTri_
+{
+	int32 x[3], y[3]; // RB_SoftwareSubpixelBits_ fixed point, in pixels.
+	int32 min_x, min_y, max_x, max_y; // pixels, inclusive and inside of the framebuffer.
+	float32 z[3]; // divided by the area, so the edge functions can weigh them as they are.
+	float32 inv_w[3]; // same.
+	float32 inv_area;
+	bool affine; // every vertex has the same w, as everything 2D does.
+	float32 varyings[];
+}
+typedef RB_SoftwareTri_;
+
+struct RB_SoftwareBinBlock_ typedef RB_SoftwareBinBlock_;
+struct RB_SoftwareBinBlock_
+{
+	RB_SoftwareBinBlock_* next;
+	int32 count;
+	RB_SoftwareTri_* tris[RB_SoftwareBinBlockSize_];
+};
+
+struct RB_SoftwareBins_
+{
+	RB_SoftwareBinBlock_** heads;
+	RB_SoftwareBinBlock_** tails;
+}
+typedef RB_SoftwareBins_;
+
+struct RB_SoftwareInput_
+{
+	const uint8* data; // already at the first element.
+	uintsize size; // left in the buffer from 'data'.
+	uint32 stride;
+	uint32 location;
+	RB_LayoutDesc layout;
+}
+typedef RB_SoftwareInput_;
+
+struct RB_SoftwareDraw_
+{
+	RB_SoftwareRuntime_* rt;
+	const RB_SoftwarePipeline_* pipeline;
+	const RB_SoftwareShader_* shader;
+	
+	const uint8* indices;
+	RB_IndexType index_type;
+	uint32 tris_per_instance;
+	const void* uniforms;
+	const void* textures[RB_Limits_DrawMaxTextures];
+	
+	RB_SoftwareInput_ inputs[RB_Limits_PipelineMaxVertexInputs];
+	int32 input_count;
+	int32 smooth_count;
+	
+	int32 tiles_x;
+	int32 tiles_y;
+	
+	// NOTE(ljre): Of the current chunk.
+	uint64 first_tri;
+	uint64 tri_count;
+	int32 setup_job_count;
+	RB_SoftwareBins_ bins[RB_SoftwareMaxSetupJobs_];
+	int32* active_tiles;
+}
+typedef RB_SoftwareDraw_;
+
+struct RB_SoftwareClipVertex_
+{
+	float32 pos[4];
+	float32 varyings[RB_Limits_SoftwareMaxVaryings];
+}
+typedef RB_SoftwareClipVertex_;
+
+#define RB_SoftwareFetch_(pool, handle) RB_SoftwareFetchImpl_(pool, ArrayLength((pool)->data), sizeof((pool)->data[0]), handle)
+
+// NOTE(ljre): Same as RB_PoolFetch_, but also catches handles that were never allocated.
+static void*
+RB_SoftwareFetchImpl_(void* pool_ptr, uint32 max_size, uintsize obj_size, uint32 handle)
+{
+	RB_Pool_* pool = pool_ptr;
+	SafeAssert(handle != 0 && handle <= pool->size);
+	
+	return RB_PoolFetchImpl_(pool_ptr, max_size, obj_size, handle);
+}
+
+static void
+RB_SoftwareRunJobs_(RB_SoftwareRuntime_* rt, intsize count, RB_SoftwareJobProc* proc, void* data)
+{
+	if (count > 1 && rt->dispatch)
+		rt->dispatch(rt->dispatch_user_data, count, proc, data);
+	else
+	{
+		for (intsize i = 0; i < count; ++i)
+			proc(data, i);
+	}
+}
+
+static void
+RB_SoftwareFetchVertex_(const RB_SoftwareDraw_* draw, uint32 index, uint32 instance, RB_SoftwareVertex* out)
+{
+	for (int32 i = 0; i < draw->input_count; ++i)
+	{
+		const RB_SoftwareInput_* input = &draw->inputs[i];
+		uint64 element = input->layout.divisor ? instance / input->layout.divisor : index;
+		uint64 offset = element * input->stride;
+		
+		SafeAssert(offset + RB_VertexFormatSize_(input->layout.format) <= input->size);
+		
+		const uint8* data = input->data + offset;
+		float32 (*loc)[4] = &out->inputs[input->location];
+		
+		// NOTE(ljre): Whatever isn't in the format is (0, 0, 0, 1), same as GLSL.
+		loc[0][0] = 0.0f;
+		loc[0][1] = 0.0f;
+		loc[0][2] = 0.0f;
+		loc[0][3] = 1.0f;
+		
+		switch (input->layout.format)
+		{
+			default: SafeAssert(false); break;
+			
+			//case RB_VertexFormat_Scalar:
+			//case RB_VertexFormat_Vec2:
+			//case RB_VertexFormat_Vec3:
+			//case RB_VertexFormat_Vec4:
+			{
+				int32 count;
+				
+				if (0) case RB_VertexFormat_Scalar: count = 1;
+				if (0) case RB_VertexFormat_Vec2: count = 2;
+				if (0) case RB_VertexFormat_Vec3: count = 3;
+				if (0) case RB_VertexFormat_Vec4: count = 4;
+				
+				MemoryCopy(loc[0], data, sizeof(float32) * count);
+			} break;
+			
+			//case RB_VertexFormat_Mat2:
+			//case RB_VertexFormat_Mat3:
+			//case RB_VertexFormat_Mat4:
+			{
+				int32 count;
+				
+				if (0) case RB_VertexFormat_Mat2: count = 2;
+				if (0) case RB_VertexFormat_Mat3: count = 3;
+				if (0) case RB_VertexFormat_Mat4: count = 4;
+				
+				for (int32 col = 0; col < count; ++col)
+				{
+					loc[col][0] = loc[col][1] = loc[col][2] = 0.0f;
+					loc[col][3] = 1.0f;
+					MemoryCopy(loc[col], data + sizeof(float32) * count * col, sizeof(float32) * count);
+				}
+			} break;
+			
+			//case RB_VertexFormat_Vec2I16Norm:
+			//case RB_VertexFormat_Vec4I16Norm:
+			//case RB_VertexFormat_Vec2I16:
+			//case RB_VertexFormat_Vec4I16:
+			{
+				int32 count;
+				bool norm;
+				
+				if (0) case RB_VertexFormat_Vec2I16Norm: { count = 2; norm = true; }
+				if (0) case RB_VertexFormat_Vec4I16Norm: { count = 4; norm = true; }
+				if (0) case RB_VertexFormat_Vec2I16: { count = 2; norm = false; }
+				if (0) case RB_VertexFormat_Vec4I16: { count = 4; norm = false; }
+				
+				int16 values[4];
+				MemoryCopy(values, data, sizeof(int16) * count);
+				
+				for (int32 j = 0; j < count; ++j)
+					loc[0][j] = norm ? Max(values[j] / 32767.0f, -1.0f) : (float32)values[j];
+			} break;
+			
+			//case RB_VertexFormat_Vec4U8Norm:
+			//case RB_VertexFormat_Vec4U8:
+			{
+				bool norm;
+				
+				if (0) case RB_VertexFormat_Vec4U8Norm: norm = true;
+				if (0) case RB_VertexFormat_Vec4U8: norm = false;
+				
+				for (int32 j = 0; j < 4; ++j)
+					loc[0][j] = norm ? data[j] / 255.0f : (float32)data[j];
+			} break;
+		}
+	}
+}
+
+// NOTE(ljre): Adds the triangle to the bins of every tile its bounding box touches.
+static void
+RB_SoftwareBinTri_(RB_SoftwareDraw_* draw, RB_SoftwareBins_* bins, Arena* arena, RB_SoftwareTri_* tri)
+{
+	int32 tile_x0 = tri->min_x / RB_SoftwareTileSize_;
+	int32 tile_y0 = tri->min_y / RB_SoftwareTileSize_;
+	int32 tile_x1 = tri->max_x / RB_SoftwareTileSize_;
+	int32 tile_y1 = tri->max_y / RB_SoftwareTileSize_;
+	
+	for (int32 ty = tile_y0; ty <= tile_y1; ++ty)
+	{
+		for (int32 tx = tile_x0; tx <= tile_x1; ++tx)
+		{
+			int32 tile = ty * draw->tiles_x + tx;
+			RB_SoftwareBinBlock_* block = bins->tails[tile];
+			
+			if (!block || block->count >= ArrayLength(block->tris))
+			{
+				RB_SoftwareBinBlock_* new_block = ArenaPushStruct(arena, RB_SoftwareBinBlock_);
+				
+				if (block)
+					block->next = new_block;
+				else
+					bins->heads[tile] = new_block;
+				
+				bins->tails[tile] = new_block;
+				block = new_block;
+			}
+			
+			block->tris[block->count++] = tri;
+		}
+	}
+}
+
+// NOTE(ljre): Projects an already clipped triangle to the framebuffer, culls it and bins it.
+static void
+RB_SoftwareSetupTri_(RB_SoftwareDraw_* draw, RB_SoftwareBins_* bins, Arena* arena, const RB_SoftwareClipVertex_* v[3], const float32* flat_varyings)
+{
+	RB_SoftwareRuntime_* rt = draw->rt;
+	const RB_SoftwarePipeline_* pipeline = draw->pipeline;
+	const float32 subpixel = (float32)(1 << RB_SoftwareSubpixelBits_);
+	
+	int32 x[3], y[3];
+	float32 z[3], inv_w[3];
+	
+	for (int32 i = 0; i < 3; ++i)
+	{
+		// NOTE(ljre): Only possible when the near plane didn't catch it, so there's nothing to draw.
+		if (!(v[i]->pos[3] > 0.0f))
+			return;
+		
+		inv_w[i] = 1.0f / v[i]->pos[3];
+		
+		float32 ndc_x = v[i]->pos[0] * inv_w[i];
+		float32 ndc_y = v[i]->pos[1] * inv_w[i];
+		float32 ndc_z = v[i]->pos[2] * inv_w[i];
+		
+		x[i] = (int32)floorf((ndc_x * 0.5f + 0.5f) * rt->width * subpixel + 0.5f);
+		y[i] = (int32)floorf((0.5f - ndc_y * 0.5f) * rt->height * subpixel + 0.5f);
+		z[i] = ndc_z * 0.5f + 0.5f;
+	}
+	
+	int64 area = (int64)(x[2] - x[1]) * (y[0] - y[1]) - (int64)(y[2] - y[1]) * (x[0] - x[1]);
+	
+	if (area == 0)
+		return;
+	
+	// NOTE(ljre): y goes down here, so a negative area is counter-clockwise in NDC.
+	bool ccw = (area < 0);
+	bool front = pipeline->flag_cw_backface ? ccw : !ccw;
+	
+	if (pipeline->cull_mode == RB_CullMode_Back && !front)
+		return;
+	if (pipeline->cull_mode == RB_CullMode_Front && front)
+		return;
+	
+	int32 order[3] = { 0, 1, 2 };
+	
+	if (area < 0)
+	{
+		order[1] = 2;
+		order[2] = 1;
+		area = -area;
+	}
+	
+	//- Bounding box
+	const int32 half = 1 << (RB_SoftwareSubpixelBits_ - 1);
+	int32 min_x = Min(Min(x[0], x[1]), x[2]);
+	int32 min_y = Min(Min(y[0], y[1]), y[2]);
+	int32 max_x = Max(Max(x[0], x[1]), x[2]);
+	int32 max_y = Max(Max(y[0], y[1]), y[2]);
+	
+	// NOTE(ljre): The pixels whose centers are inside of the box.
+	min_x = Max((min_x + half - 1) >> RB_SoftwareSubpixelBits_, 0);
+	min_y = Max((min_y + half - 1) >> RB_SoftwareSubpixelBits_, 0);
+	max_x = Min((max_x - half) >> RB_SoftwareSubpixelBits_, rt->width - 1);
+	max_y = Min((max_y - half) >> RB_SoftwareSubpixelBits_, rt->height - 1);
+	
+	if (min_x > max_x || min_y > max_y)
+		return;
+	
+	//- Store it
+	int32 smooth_count = draw->smooth_count;
+	int32 flat_count = draw->shader->flat_varying_count;
+	uintsize size = sizeof(RB_SoftwareTri_) + sizeof(float32) * (smooth_count * 3 + flat_count);
+	RB_SoftwareTri_* tri = ArenaPushDirtyAligned(arena, size, alignof(RB_SoftwareTri_));
+	float32 inv_area = 1.0f / (float32)area;
+	
+	tri->inv_area = inv_area;
+	tri->affine = (inv_w[0] == inv_w[1] && inv_w[1] == inv_w[2]);
+	
+	tri->min_x = min_x;
+	tri->min_y = min_y;
+	tri->max_x = max_x;
+	tri->max_y = max_y;
+	
+	for (int32 i = 0; i < 3; ++i)
+	{
+		int32 j = order[i];
+		
+		tri->x[i] = x[j];
+		tri->y[i] = y[j];
+		tri->z[i] = z[j] * inv_area;
+		tri->inv_w[i] = inv_w[j] * inv_area;
+		
+		MemoryCopy(tri->varyings + i*smooth_count, v[j]->varyings, sizeof(float32) * smooth_count);
+	}
+	
+	MemoryCopy(tri->varyings + smooth_count * 3, flat_varyings, sizeof(float32) * flat_count);
+	RB_SoftwareBinTri_(draw, bins, arena, tri);
+}
+
+// NOTE(ljre): Signed distances to the planes of RB_SoftwareClipTri_, >= 0 when inside.
+static inline void
+RB_SoftwareClipDistances_(const float32 pos[4], float32 out[6])
+{
+	const float32 band = (float32)RB_SoftwareGuardBand_;
+	
+	out[0] = pos[2] + pos[3];
+	out[1] = pos[3] - pos[2];
+	out[2] = band * pos[3] + pos[0];
+	out[3] = band * pos[3] - pos[0];
+	out[4] = band * pos[3] + pos[1];
+	out[5] = band * pos[3] - pos[1];
+}
+
+static inline uint32
+RB_SoftwareOutcode_(const float32 pos[4])
+{
+	float32 dist[6];
+	uint32 code = 0;
+	
+	RB_SoftwareClipDistances_(pos, dist);
+	
+	for (int32 i = 0; i < 6; ++i)
+		code |= (uint32)(dist[i] < 0.0f) << i;
+	
+	return code;
+}
+
+// NOTE(ljre): Sutherland-Hodgman against the near and far planes and the guard band, then fanned back into triangles.
+static void
+RB_SoftwareClipTri_(RB_SoftwareDraw_* draw, RB_SoftwareBins_* bins, Arena* arena, const RB_SoftwareClipVertex_* tri[3])
+{
+	int32 varying_count = draw->shader->varying_count;
+	const float32* flat_varyings = tri[2]->varyings + draw->smooth_count;
+	uint32 codes[3];
+	
+	for (int32 i = 0; i < 3; ++i)
+		codes[i] = RB_SoftwareOutcode_(tri[i]->pos);
+	
+	if (codes[0] & codes[1] & codes[2])
+		return;
+	
+	if (!(codes[0] | codes[1] | codes[2]))
+	{
+		RB_SoftwareSetupTri_(draw, bins, arena, tri, flat_varyings);
+		return;
+	}
+	
+	// NOTE(ljre): A triangle clipped by 6 planes has at most 9 vertices.
+	RB_SoftwareClipVertex_ polys[2][9];
+	int32 count = 3;
+	int32 curr = 0;
+	
+	for (int32 i = 0; i < 3; ++i)
+		polys[0][i] = *tri[i];
+	
+	for (int32 plane = 0; plane < 6 && count > 0; ++plane)
+	{
+		if (!((codes[0] | codes[1] | codes[2]) & (1u << plane)))
+			continue;
+		
+		RB_SoftwareClipVertex_* in = polys[curr];
+		RB_SoftwareClipVertex_* out = polys[curr ^ 1];
+		int32 out_count = 0;
+		
+		for (int32 i = 0; i < count; ++i)
+		{
+			const RB_SoftwareClipVertex_* a = &in[i];
+			const RB_SoftwareClipVertex_* b = &in[(i + 1) % count];
+			float32 dist_a[6], dist_b[6];
+			
+			RB_SoftwareClipDistances_(a->pos, dist_a);
+			RB_SoftwareClipDistances_(b->pos, dist_b);
+			
+			float32 da = dist_a[plane];
+			float32 db = dist_b[plane];
+			
+			if (da >= 0.0f)
+				out[out_count++] = *a;
+			
+			if ((da >= 0.0f) != (db >= 0.0f))
+			{
+				float32 t = da / (da - db);
+				RB_SoftwareClipVertex_* v = &out[out_count++];
+				
+				for (int32 j = 0; j < 4; ++j)
+					v->pos[j] = a->pos[j] + (b->pos[j] - a->pos[j]) * t;
+				for (int32 j = 0; j < varying_count; ++j)
+					v->varyings[j] = a->varyings[j] + (b->varyings[j] - a->varyings[j]) * t;
+			}
+		}
+		
+		count = out_count;
+		curr ^= 1;
+	}
+	
+	for (int32 i = 1; i + 1 < count; ++i)
+	{
+		const RB_SoftwareClipVertex_* fan[3] = { &polys[curr][0], &polys[curr][i], &polys[curr][i + 1] };
+		RB_SoftwareSetupTri_(draw, bins, arena, fan, flat_varyings);
+	}
+}
+
+static void
+RB_SoftwareSetupJob_(void* data, intsize job_index)
+{
+	Trace();
+	
+	RB_SoftwareDraw_* draw = data;
+	RB_SoftwareRuntime_* rt = draw->rt;
+	RB_SoftwareBins_* bins = &draw->bins[job_index];
+	Arena* arena = rt->job_arenas[job_index];
+	int32 tile_count = draw->tiles_x * draw->tiles_y;
+	
+	ArenaClear(arena);
+	bins->heads = ArenaPushArray(arena, RB_SoftwareBinBlock_*, tile_count);
+	bins->tails = ArenaPushArray(arena, RB_SoftwareBinBlock_*, tile_count);
+	
+	// NOTE(ljre): Direct mapped, by the index and instance of the vertex.
+	struct
+	{
+		uint64 key;
+		RB_SoftwareClipVertex_ vertex;
+	}
+	cache[RB_SoftwareVertexCacheSize_];
+	
+	for (int32 i = 0; i < ArrayLength(cache); ++i)
+		cache[i].key = UINT64_MAX;
+	
+	uint64 first = draw->first_tri + (uint64)job_index * RB_SoftwareJobTriangles_;
+	uint64 end = Min(first + RB_SoftwareJobTriangles_, draw->first_tri + draw->tri_count);
+	
+	for (uint64 t = first; t < end; ++t)
+	{
+		uint32 instance = (uint32)(t / draw->tris_per_instance);
+		uint32 first_index = (uint32)(t % draw->tris_per_instance) * 3;
+		RB_SoftwareClipVertex_ verts[3];
+		
+		for (int32 i = 0; i < 3; ++i)
+		{
+			uint32 index;
+			
+			if (draw->index_type == RB_IndexType_Uint16)
+				index = ((const uint16*)draw->indices)[first_index + i];
+			else
+				index = ((const uint32*)draw->indices)[first_index + i];
+			
+			uint64 key = (uint64)instance << 32 | index;
+			uint32 slot = (uint32)(HashInt64(key) % RB_SoftwareVertexCacheSize_);
+			
+			if (cache[slot].key != key)
+			{
+				RB_SoftwareVertex vertex = {
+					.vertex_id = index,
+					.instance_id = instance,
+					.uniforms = draw->uniforms,
+				};
+				
+				RB_SoftwareFetchVertex_(draw, index, instance, &vertex);
+				draw->shader->vs(&vertex, cache[slot].vertex.pos, cache[slot].vertex.varyings);
+				cache[slot].key = key;
+			}
+			
+			// NOTE(ljre): Copied, since the next vertex of the triangle might take the same slot.
+			verts[i] = cache[slot].vertex;
+		}
+		
+		const RB_SoftwareClipVertex_* tri[3] = { &verts[0], &verts[1], &verts[2] };
+		RB_SoftwareClipTri_(draw, bins, arena, tri);
+	}
+}
+
+static inline void
+RB_SoftwareUnpack_(uint32 color, float32 out[4])
+{
+	out[0] = (float32)(color       & 255) * (1.0f / 255.0f);
+	out[1] = (float32)(color >>  8 & 255) * (1.0f / 255.0f);
+	out[2] = (float32)(color >> 16 & 255) * (1.0f / 255.0f);
+	out[3] = (float32)(color >> 24 & 255) * (1.0f / 255.0f);
+}
+
+static inline uint32
+RB_SoftwarePack_(const float32 color[4])
+{
+	uint32 result = 0;
+	
+	for (int32 i = 0; i < 4; ++i)
+		result |= (uint32)(int32)(color[i] * 255.0f + 0.5f) << (i * 8);
+	
+	return result;
+}
+
+static inline float32
+RB_SoftwareBlendFactor_(RB_BlendFunc func, const float32 src[4], const float32 dst[4], int32 channel)
+{
+	switch (func)
+	{
+		default:
+		case RB_BlendFunc_Zero: return 0.0f;
+		case RB_BlendFunc_One: return 1.0f;
+		case RB_BlendFunc_SrcColor: return src[channel];
+		case RB_BlendFunc_InvSrcColor: return 1.0f - src[channel];
+		case RB_BlendFunc_DstColor: return dst[channel];
+		case RB_BlendFunc_InvDstColor: return 1.0f - dst[channel];
+		case RB_BlendFunc_SrcAlpha: return src[3];
+		case RB_BlendFunc_InvSrcAlpha: return 1.0f - src[3];
+		case RB_BlendFunc_DstAlpha: return dst[3];
+		case RB_BlendFunc_InvDstAlpha: return 1.0f - dst[3];
+	}
+}
+
+static inline uint32
+RB_SoftwareBlend_(const RB_SoftwarePipeline_* pipeline, const float32 src[4], uint32 dst_color)
+{
+	float32 dst[4], result[4];
+	RB_SoftwareUnpack_(dst_color, dst);
+	
+	for (int32 i = 0; i < 4; ++i)
+	{
+		RB_BlendFunc source = (i < 3) ? pipeline->blend_source : pipeline->blend_source_alpha;
+		RB_BlendFunc dest = (i < 3) ? pipeline->blend_dest : pipeline->blend_dest_alpha;
+		RB_BlendOp op = (i < 3) ? pipeline->blend_op : pipeline->blend_op_alpha;
+		
+		float32 a = src[i] * RB_SoftwareBlendFactor_(source, src, dst, i);
+		float32 b = dst[i] * RB_SoftwareBlendFactor_(dest, src, dst, i);
+		
+		result[i] = (op == RB_BlendOp_Subtract) ? a - b : a + b;
+		result[i] = Clamp(result[i], 0.0f, 1.0f);
+	}
+	
+	return RB_SoftwarePack_(result);
+}
+
+// NOTE(ljre): The weights of each vertex at the point where the edge functions are 'e', perspective correct unless
+//             the triangle is affine.
+static inline void
+RB_SoftwareWeights_(const RB_SoftwareTri_* tri, const int64 e[3], float32 out_b[3])
+{
+	if (tri->affine)
+	{
+		for (int32 k = 0; k < 3; ++k)
+			out_b[k] = (float32)e[k] * tri->inv_area;
+		return;
+	}
+	
+	for (int32 k = 0; k < 3; ++k)
+		out_b[k] = (float32)e[k] * tri->inv_w[k];
+	
+	float32 w = 1.0f / (out_b[0] + out_b[1] + out_b[2]);
+	
+	for (int32 k = 0; k < 3; ++k)
+		out_b[k] *= w;
+}
+
+static inline void
+RB_SoftwareInterpolate_(const RB_SoftwareTri_* tri, int32 smooth_count, int32 count, const float32 b[3], float32* out)
+{
+	const float32* v0 = tri->varyings;
+	const float32* v1 = tri->varyings + smooth_count;
+	const float32* v2 = tri->varyings + smooth_count*2;
+	
+	for (int32 i = 0; i < count; ++i)
+		out[i] = b[0]*v0[i] + b[1]*v1[i] + b[2]*v2[i];
+}
+
+static void
+RB_SoftwareRasterTri_(const RB_SoftwareDraw_* draw, const RB_SoftwareTri_* tri, int32 x0, int32 y0, int32 x1, int32 y1)
+{
+	RB_SoftwareRuntime_* rt = draw->rt;
+	const RB_SoftwarePipeline_* pipeline = draw->pipeline;
+	const RB_SoftwareShader_* shader = draw->shader;
+	const int32 one = 1 << RB_SoftwareSubpixelBits_;
+	const int32 smooth_count = draw->smooth_count;
+	const int32 derivative_count = shader->derivative_count;
+	
+	float32 varyings[RB_Limits_SoftwareMaxVaryings];
+	float32 ddx[RB_Limits_SoftwareMaxVaryings];
+	float32 ddy[RB_Limits_SoftwareMaxVaryings];
+	
+	MemoryCopy(varyings + smooth_count, tri->varyings + smooth_count*3, sizeof(float32) * shader->flat_varying_count);
+	
+	//- Edge functions
+	// NOTE(ljre): Edge 'k' is the one in front of vertex 'k', positive inside. Pixels exactly on an edge are only
+	//             drawn if it's a top or left edge, so triangles sharing an edge never draw a pixel twice.
+	int64 row[3], step_x[3], step_y[3], bias[3];
+	int64 px = (int64)x0 * one + one/2;
+	int64 py = (int64)y0 * one + one/2;
+	
+	for (int32 k = 0; k < 3; ++k)
+	{
+		int32 a = (k + 1) % 3;
+		int32 b = (k + 2) % 3;
+		int64 dx = tri->x[b] - tri->x[a];
+		int64 dy = tri->y[b] - tri->y[a];
+		
+		row[k] = dx * (py - tri->y[a]) - dy * (px - tri->x[a]);
+		step_x[k] = -dy * one;
+		step_y[k] = dx * one;
+		bias[k] = (dy < 0 || (dy == 0 && dx > 0)) ? 0 : -1;
+	}
+	
+	// NOTE(ljre): The derivatives of an affine triangle are the same everywhere. The edge functions always add up to
+	//             the same, so stepping the weights by 'step_x' and 'step_y' gives the differences right away.
+	if (tri->affine && derivative_count)
+	{
+		float32 bx[3], by[3];
+		
+		for (int32 k = 0; k < 3; ++k)
+		{
+			bx[k] = (float32)step_x[k] * tri->inv_area;
+			by[k] = (float32)step_y[k] * tri->inv_area;
+		}
+		
+		RB_SoftwareInterpolate_(tri, smooth_count, derivative_count, bx, ddx);
+		RB_SoftwareInterpolate_(tri, smooth_count, derivative_count, by, ddy);
+	}
+	
+	RB_SoftwareFragment fragment = {
+		.varyings = varyings,
+		.ddx = ddx,
+		.ddy = ddy,
+		.uniforms = draw->uniforms,
+		.textures = draw->textures,
+	};
+	
+	for (int32 y = y0; y <= y1; ++y)
+	{
+		int64 e[3] = { row[0], row[1], row[2] };
+		
+		for (int32 x = x0; x <= x1; ++x)
+		{
+			if (((e[0] + bias[0]) | (e[1] + bias[1]) | (e[2] + bias[2])) >= 0)
+			{
+				intsize pixel = (intsize)y * rt->width + x;
+				float32 z =
+					(float32)e[0] * tri->z[0] +
+					(float32)e[1] * tri->z[1] +
+					(float32)e[2] * tri->z[2];
+				
+				if (!pipeline->flag_depth_test || z < rt->depth[pixel])
+				{
+					float32 b[3];
+					RB_SoftwareWeights_(tri, e, b);
+					RB_SoftwareInterpolate_(tri, smooth_count, smooth_count, b, varyings);
+					
+					if (derivative_count && !tri->affine)
+					{
+						int64 ex[3] = { e[0] + step_x[0], e[1] + step_x[1], e[2] + step_x[2] };
+						int64 ey[3] = { e[0] + step_y[0], e[1] + step_y[1], e[2] + step_y[2] };
+						float32 bx[3], by[3];
+						
+						RB_SoftwareWeights_(tri, ex, bx);
+						RB_SoftwareWeights_(tri, ey, by);
+						RB_SoftwareInterpolate_(tri, smooth_count, derivative_count, bx, ddx);
+						RB_SoftwareInterpolate_(tri, smooth_count, derivative_count, by, ddy);
+						
+						for (int32 i = 0; i < derivative_count; ++i)
+						{
+							ddx[i] -= varyings[i];
+							ddy[i] -= varyings[i];
+						}
+					}
+					
+					fragment.frag_coord[0] = x + 0.5f;
+					fragment.frag_coord[1] = y + 0.5f;
+					fragment.frag_coord[2] = z;
+					fragment.frag_coord[3] =
+						(float32)e[0] * tri->inv_w[0] +
+						(float32)e[1] * tri->inv_w[1] +
+						(float32)e[2] * tri->inv_w[2];
+					
+					float32 color[4];
+					shader->fs(&fragment, color);
+					
+					for (int32 i = 0; i < 4; ++i)
+						color[i] = Clamp(color[i], 0.0f, 1.0f);
+					
+					if (pipeline->flag_blend)
+						rt->color[pixel] = RB_SoftwareBlend_(pipeline, color, rt->color[pixel]);
+					else
+						rt->color[pixel] = RB_SoftwarePack_(color);
+					
+					if (pipeline->flag_depth_test)
+						rt->depth[pixel] = z;
+				}
+			}
+			
+			e[0] += step_x[0];
+			e[1] += step_x[1];
+			e[2] += step_x[2];
+		}
+		
+		row[0] += step_y[0];
+		row[1] += step_y[1];
+		row[2] += step_y[2];
+	}
+}
+
+static void
+RB_SoftwareRasterJob_(void* data, intsize job_index)
+{
+	Trace();
+	
+	RB_SoftwareDraw_* draw = data;
+	RB_SoftwareRuntime_* rt = draw->rt;
+	int32 tile = draw->active_tiles[job_index];
+	int32 tile_x0 = (tile % draw->tiles_x) * RB_SoftwareTileSize_;
+	int32 tile_y0 = (tile / draw->tiles_x) * RB_SoftwareTileSize_;
+	int32 tile_x1 = Min(tile_x0 + RB_SoftwareTileSize_, rt->width) - 1;
+	int32 tile_y1 = Min(tile_y0 + RB_SoftwareTileSize_, rt->height) - 1;
+	
+	for (int32 i = 0; i < draw->setup_job_count; ++i)
+	{
+		for (RB_SoftwareBinBlock_* block = draw->bins[i].heads[tile]; block; block = block->next)
+		{
+			for (int32 j = 0; j < block->count; ++j)
+			{
+				const RB_SoftwareTri_* tri = block->tris[j];
+				
+				RB_SoftwareRasterTri_(draw, tri,
+					Max(tri->min_x, tile_x0),
+					Max(tri->min_y, tile_y0),
+					Min(tri->max_x, tile_x1),
+					Min(tri->max_y, tile_y1));
+			}
+		}
+	}
+}
+
+//~ Textures
+static void
+RB_SoftwareConvertPixels_(RB_TexFormat format, const uint8* src, intsize count, uint32* dst)
+{
+	switch (format)
+	{
+		default: SafeAssert(false); break;
+		
+		case RB_TexFormat_A8:
+		{
+			for (intsize i = 0; i < count; ++i)
+				dst[i] = (uint32)src[i] << 24;
+		} break;
+		
+		case RB_TexFormat_R8:
+		{
+			for (intsize i = 0; i < count; ++i)
+				dst[i] = src[i] | 0xFF000000u;
+		} break;
+		
+		case RB_TexFormat_RG8:
+		{
+			for (intsize i = 0; i < count; ++i)
+				dst[i] = src[i*2] | (uint32)src[i*2+1] << 8 | 0xFF000000u;
+		} break;
+		
+		case RB_TexFormat_RGB8:
+		{
+			for (intsize i = 0; i < count; ++i)
+				dst[i] = src[i*3] | (uint32)src[i*3+1] << 8 | (uint32)src[i*3+2] << 16 | 0xFF000000u;
+		} break;
+		
+		case RB_TexFormat_RGBA8: MemoryCopy(dst, src, sizeof(uint32) * count); break;
+	}
+}
+
+static void
+RB_SoftwareSampleLevel_(const RB_SoftwareTexture_* tex, int32 level, bool linear, float32 s, float32 t, float32 out_color[4])
+{
+	int32 width = Max(tex->width >> level, 1);
+	int32 height = Max(tex->height >> level, 1);
+	const uint32* pixels = tex->pixels + tex->mip_offsets[level];
+	
+	if (!linear)
+	{
+		int32 x = Min((int32)(s * width), width - 1);
+		int32 y = Min((int32)(t * height), height - 1);
+		
+		RB_SoftwareUnpack_(pixels[y * width + x], out_color);
+		return;
+	}
+	
+	// NOTE(ljre): Texel centers are at the halves. 's' and 't' are already in [0, 1), so this only wraps once.
+	float32 u = s * width - 0.5f;
+	float32 v = t * height - 0.5f;
+	float32 floor_u = floorf(u);
+	float32 floor_v = floorf(v);
+	float32 frac_u = u - floor_u;
+	float32 frac_v = v - floor_v;
+	
+	int32 x0 = ((int32)floor_u + width) % width;
+	int32 y0 = ((int32)floor_v + height) % height;
+	int32 x1 = (x0 + 1) % width;
+	int32 y1 = (y0 + 1) % height;
+	
+	float32 texels[4][4];
+	RB_SoftwareUnpack_(pixels[y0 * width + x0], texels[0]);
+	RB_SoftwareUnpack_(pixels[y0 * width + x1], texels[1]);
+	RB_SoftwareUnpack_(pixels[y1 * width + x0], texels[2]);
+	RB_SoftwareUnpack_(pixels[y1 * width + x1], texels[3]);
+	
+	for (int32 i = 0; i < 4; ++i)
+	{
+		float32 top = texels[0][i] + (texels[1][i] - texels[0][i]) * frac_u;
+		float32 bottom = texels[2][i] + (texels[3][i] - texels[2][i]) * frac_u;
+		
+		out_color[i] = top + (bottom - top) * frac_v;
+	}
+}
+
+// NOTE(ljre): Same filters as the OpenGL backend: LINEAR_MIPMAP_LINEAR or NEAREST_MIPMAP_NEAREST.
+static void
+RB_SoftwareSampleTexture_(const RB_SoftwareTexture_* tex, const float32 uv[2], const float32 uv_ddx[2], const float32 uv_ddy[2], float32 out_color[4])
+{
+	float32 s = uv[0] - floorf(uv[0]);
+	float32 t = uv[1] - floorf(uv[1]);
+	
+	// NOTE(ljre): NaNs, infinities and tiny negatives that round up to 1.
+	if (!(s >= 0.0f && s < 1.0f))
+		s = 0.0f;
+	if (!(t >= 0.0f && t < 1.0f))
+		t = 0.0f;
+	
+	float32 lod = 0.0f;
+	
+	if (uv_ddx && uv_ddy && tex->mip_count > 1)
+	{
+		float32 dx_u = uv_ddx[0] * tex->width;
+		float32 dx_v = uv_ddx[1] * tex->height;
+		float32 dy_u = uv_ddy[0] * tex->width;
+		float32 dy_v = uv_ddy[1] * tex->height;
+		float32 rho2 = Max(dx_u*dx_u + dx_v*dx_v, dy_u*dy_u + dy_v*dy_v);
+		
+		lod = Min(0.5f * log2f(rho2), (float32)(tex->mip_count - 1));
+	}
+	
+	bool linear = tex->flag_linear_filtering;
+	
+	if (!(lod > 0.0f))
+		RB_SoftwareSampleLevel_(tex, 0, linear, s, t, out_color);
+	else if (!linear)
+	{
+		int32 level = Clamp((int32)ceilf(lod + 0.5f) - 1, 0, tex->mip_count - 1);
+		RB_SoftwareSampleLevel_(tex, level, false, s, t, out_color);
+	}
+	else
+	{
+		int32 level = (int32)lod;
+		float32 frac = lod - (float32)level;
+		
+		RB_SoftwareSampleLevel_(tex, level, true, s, t, out_color);
+		
+		if (frac > 0.0f && level + 1 < tex->mip_count)
+		{
+			float32 next[4];
+			RB_SoftwareSampleLevel_(tex, level + 1, true, s, t, next);
+			
+			for (int32 i = 0; i < 4; ++i)
+				out_color[i] += (next[i] - out_color[i]) * frac;
+		}
+	}
+}
+
+//~ Runtime
+static void
+RB_SoftwareFreeCtx_(RB_Ctx* ctx)
+{
+	RB_SoftwareRuntime_* rt = ctx->rt;
+	
+	for (intsize i = 0; i < ArrayLength(rt->job_arenas); ++i)
+	{
+		if (rt->job_arenas[i])
+			ArenaDestroy(rt->job_arenas[i]);
+	}
+	
+	// NOTE(ljre): Whatever wasn't freed by the user, same as the other backends leave it to the driver.
+	for (uint32 i = 0; i < rt->bufpool.size; ++i)
+	{
+		if (rt->bufpool.data[i].data)
+			OS_HeapFree(rt->bufpool.data[i].data);
+	}
+	
+	for (uint32 i = 0; i < rt->texpool.size; ++i)
+	{
+		if (rt->texpool.data[i].pixels)
+			OS_HeapFree(rt->texpool.data[i].pixels);
+	}
+	
+	OS_HeapFree(rt->color);
+	OS_HeapFree(rt->depth);
+	OS_HeapFree(rt->active_tiles);
+}
+
+static bool
+RB_SoftwareIsValidHandle_(RB_Ctx* ctx, uint32 handle)
+{
+	return handle != 0;
+}
+
+static void
+RB_SoftwareResource_(RB_Ctx* ctx, const RB_ResourceCall_* resc)
+{
+	RB_SoftwareRuntime_* rt = ctx->rt;
+	uint32 handle = *resc->handle;
+	
+	switch (resc->kind)
+	{
+		case 0: Assert(false); break;
+		
+		case RB_ResourceKind_MakeTexture2D_:
+		{
+			const RB_Tex2dDesc* desc = &resc->tex2d;
+			
+			SafeAssert(desc->width > 0 && desc->width <= ctx->caps.max_texture_size);
+			SafeAssert(desc->height > 0 && desc->height <= ctx->caps.max_texture_size);
+			SafeAssert(desc->format >= RB_TexFormat_A8 && desc->format <= RB_TexFormat_RGBA8);
+			SafeAssert(!desc->flag_render_target);
+			
+			RB_SoftwareTexture_* tex = RB_PoolAlloc_(&rt->texpool, &handle);
+			tex->width = desc->width;
+			tex->height = desc->height;
+			tex->mip_count = Max(desc->mip_count, 1);
+			tex->format = desc->format;
+			tex->flag_dynamic = desc->flag_dynamic;
+			tex->flag_linear_filtering = desc->flag_linear_filtering;
+			
+			uintsize texel_count = 0;
+			
+			for (int32 i = 0; i < tex->mip_count; ++i)
+			{
+				tex->mip_offsets[i] = (uint32)texel_count;
+				texel_count += (uintsize)Max(desc->width >> i, 1) * Max(desc->height >> i, 1);
+			}
+			
+			tex->pixels = OS_HeapAlloc(sizeof(uint32) * texel_count);
+			
+			if (desc->pixels)
+				RB_SoftwareConvertPixels_(desc->format, desc->pixels, texel_count, tex->pixels);
+		} break;
+		
+		//case RB_ResourceKind_MakeVertexBuffer_:
+		//case RB_ResourceKind_MakeIndexBuffer_:
+		//case RB_ResourceKind_MakeUniformBuffer_:
+		{
+			const void* initial_data;
+			uintsize size;
+			
+			if (0) case RB_ResourceKind_MakeVertexBuffer_:
+			{
+				initial_data = resc->vbuffer.initial_data;
+				size = resc->vbuffer.size;
+				SafeAssert(!resc->vbuffer.flag_ring || !initial_data);
+			}
+			if (0) case RB_ResourceKind_MakeIndexBuffer_:
+			{
+				initial_data = resc->ibuffer.initial_data;
+				size = resc->ibuffer.size;
+				SafeAssert(resc->ibuffer.index_type == RB_IndexType_Uint16 || resc->ibuffer.index_type == RB_IndexType_Uint32);
+			}
+			if (0) case RB_ResourceKind_MakeUniformBuffer_:
+			{
+				initial_data = resc->ubuffer.initial_data;
+				size = resc->ubuffer.size;
+			}
+			
+			SafeAssert(size > 0 && size <= UINT32_MAX);
+			
+			RB_SoftwareBuffer_* buffer = RB_PoolAlloc_(&rt->bufpool, &handle);
+			buffer->size = size;
+			buffer->data = OS_HeapAlloc(size);
+			
+			if (initial_data)
+				MemoryCopy(buffer->data, initial_data, size);
+			
+			if (resc->kind == RB_ResourceKind_MakeVertexBuffer_ && resc->vbuffer.flag_ring)
+			{
+				buffer->flag_ring = true;
+				buffer->ring.capacity = size;
+			}
+			else if (resc->kind == RB_ResourceKind_MakeIndexBuffer_)
+				buffer->index_type = resc->ibuffer.index_type;
+		} break;
+		
+		case RB_ResourceKind_MakeShader_:
+		{
+			const RB_ShaderDesc* desc = &resc->shader;
+			
+			SafeAssert(desc->software.vs && desc->software.fs);
+			SafeAssert(desc->software.varying_count >= 0 && desc->software.varying_count <= RB_Limits_SoftwareMaxVaryings);
+			SafeAssert(desc->software.flat_varying_count >= 0 && desc->software.flat_varying_count <= desc->software.varying_count);
+			SafeAssert(desc->software.derivative_count >= 0);
+			SafeAssert(desc->software.derivative_count <= desc->software.varying_count - desc->software.flat_varying_count);
+			
+			RB_SoftwareShader_* shader = RB_PoolAlloc_(&rt->shaderpool, &handle);
+			shader->vs = desc->software.vs;
+			shader->fs = desc->software.fs;
+			shader->varying_count = desc->software.varying_count;
+			shader->flat_varying_count = desc->software.flat_varying_count;
+			shader->derivative_count = desc->software.derivative_count;
+		} break;
+		
+		case RB_ResourceKind_MakePipeline_:
+		{
+			const RB_PipelineDesc* desc = &resc->pipeline;
+			
+			SafeAssert(desc->blend_source >= 0 && desc->blend_source <= RB_BlendFunc_InvDstAlpha);
+			SafeAssert(desc->blend_dest >= 0 && desc->blend_dest <= RB_BlendFunc_InvDstAlpha);
+			SafeAssert(desc->blend_source_alpha >= 0 && desc->blend_source_alpha <= RB_BlendFunc_InvDstAlpha);
+			SafeAssert(desc->blend_dest_alpha >= 0 && desc->blend_dest_alpha <= RB_BlendFunc_InvDstAlpha);
+			SafeAssert(desc->blend_op >= 0 && desc->blend_op <= RB_BlendOp_Subtract);
+			SafeAssert(desc->blend_op_alpha >= 0 && desc->blend_op_alpha <= RB_BlendOp_Subtract);
+			SafeAssert(desc->fill_mode == RB_FillMode_Solid);
+			SafeAssert(desc->cull_mode >= 0 && desc->cull_mode <= RB_CullMode_Back);
+			
+			RB_SoftwareFetch_(&rt->shaderpool, desc->shader.id);
+			uint32 location = 0;
+			
+			for (intsize i = 0; i < ArrayLength(desc->input_layout); ++i)
+			{
+				const RB_LayoutDesc* layout = &desc->input_layout[i];
+				
+				if (!layout->format)
+					break;
+				
+				SafeAssert(layout->format != RB_VertexFormat_Vec2F16 && layout->format != RB_VertexFormat_Vec4F16);
+				SafeAssert(layout->buffer_slot < RB_Limits_DrawMaxVertexBuffers);
+				RB_VertexFormatSize_(layout->format);
+				
+				switch (layout->format)
+				{
+					default: location += 1; break;
+					case RB_VertexFormat_Mat2: location += 2; break;
+					case RB_VertexFormat_Mat3: location += 3; break;
+					case RB_VertexFormat_Mat4: location += 4; break;
+				}
+			}
+			
+			SafeAssert(location <= RB_Limits_PipelineMaxVertexInputs);
+			
+			RB_SoftwarePipeline_* pipeline = RB_PoolAlloc_(&rt->pipelinepool, &handle);
+			pipeline->flag_blend = desc->flag_blend;
+			pipeline->flag_cw_backface = desc->flag_cw_backface;
+			pipeline->flag_depth_test = desc->flag_depth_test;
+			pipeline->blend_source = desc->blend_source ? desc->blend_source : RB_BlendFunc_One;
+			pipeline->blend_dest = desc->blend_dest ? desc->blend_dest : RB_BlendFunc_Zero;
+			pipeline->blend_op = desc->blend_op;
+			pipeline->blend_source_alpha = desc->blend_source_alpha ? desc->blend_source_alpha : RB_BlendFunc_One;
+			pipeline->blend_dest_alpha = desc->blend_dest_alpha ? desc->blend_dest_alpha : RB_BlendFunc_Zero;
+			pipeline->blend_op_alpha = desc->blend_op_alpha;
+			pipeline->cull_mode = desc->cull_mode;
+			pipeline->shader = desc->shader;
+			MemoryCopy(pipeline->input_layout, desc->input_layout, sizeof(pipeline->input_layout));
+		} break;
+		
+		// NOTE(ljre): Not supported, see the capabilities.
+		case RB_ResourceKind_MakeStructuredBuffer_:
+		case RB_ResourceKind_MakeRenderTarget_:
+		case RB_ResourceKind_MakeComputeShader_:
+		case RB_ResourceKind_UpdateStructuredBuffer_:
+		case RB_ResourceKind_FreeStructuredBuffer_:
+		case RB_ResourceKind_FreeRenderTarget_:
+		case RB_ResourceKind_FreeComputeShader_:
+		{
+			SafeAssert(false);
+		} break;
+		
+		case RB_ResourceKind_UpdateVertexBuffer_:
+		case RB_ResourceKind_UpdateIndexBuffer_:
+		case RB_ResourceKind_UpdateUniformBuffer_:
+		{
+			Buffer new_data = resc->update.new_data;
+			RB_SoftwareBuffer_* buffer = RB_SoftwareFetch_(&rt->bufpool, handle);
+			
+			SafeAssert(buffer->data && !buffer->flag_ring);
+			SafeAssert(new_data.size > 0 && new_data.size <= UINT32_MAX);
+			
+			// NOTE(ljre): The other backends grow the buffer to fit.
+			if (new_data.size > buffer->size)
+				buffer->data = OS_HeapRealloc(buffer->data, new_data.size);
+			
+			buffer->size = new_data.size;
+			MemoryCopy(buffer->data, new_data.data, new_data.size);
+		} break;
+		
+		case RB_ResourceKind_AppendVertexBuffer_:
+		{
+			Buffer data = resc->append.data;
+			RB_SoftwareBuffer_* buffer = RB_SoftwareFetch_(&rt->bufpool, handle);
+			SafeAssert(buffer->data && buffer->flag_ring);
+			
+			// NOTE(ljre): Draws are done by the time they return, so nothing reads what's discarded and the buffer can
+			//             just grow in place.
+			bool discard;
+			uint32 offset = RB_RingAppend_(&buffer->ring, ctx->frame_index, data.size, &discard);
+			
+			if (buffer->ring.capacity != buffer->size)
+			{
+				buffer->data = OS_HeapRealloc(buffer->data, buffer->ring.capacity);
+				buffer->size = buffer->ring.capacity;
+			}
+			
+			MemoryCopy(buffer->data + offset, data.data, data.size);
+			*resc->append.out_offset = offset;
+		} break;
+		
+		case RB_ResourceKind_UpdateTexture2D_:
+		{
+			Buffer new_data = resc->update.new_data;
+			RB_SoftwareTexture_* tex = RB_SoftwareFetch_(&rt->texpool, handle);
+			
+			SafeAssert(tex->pixels && tex->flag_dynamic);
+			SafeAssert(new_data.size == RB_CalcTexture2DSize(tex->format, tex->width, tex->height, 1));
+			
+			RB_SoftwareConvertPixels_(tex->format, new_data.data, (intsize)tex->width * tex->height, tex->pixels);
+		} break;
+		
+		case RB_ResourceKind_FreeVertexBuffer_:
+		case RB_ResourceKind_FreeIndexBuffer_:
+		case RB_ResourceKind_FreeUniformBuffer_:
+		{
+			RB_SoftwareBuffer_* buffer = RB_SoftwareFetch_(&rt->bufpool, handle);
+			SafeAssert(buffer->data);
+			
+			OS_HeapFree(buffer->data);
+			buffer->data = NULL;
+			RB_PoolFree_(&rt->bufpool, handle);
+			handle = 0;
+		} break;
+		
+		case RB_ResourceKind_FreeTexture2D_:
+		{
+			RB_SoftwareTexture_* tex = RB_SoftwareFetch_(&rt->texpool, handle);
+			SafeAssert(tex->pixels);
+			
+			OS_HeapFree(tex->pixels);
+			tex->pixels = NULL;
+			RB_PoolFree_(&rt->texpool, handle);
+			handle = 0;
+		} break;
+		
+		case RB_ResourceKind_FreeShader_:
+		{
+			RB_SoftwareFetch_(&rt->shaderpool, handle);
+			RB_PoolFree_(&rt->shaderpool, handle);
+			handle = 0;
+		} break;
+		
+		case RB_ResourceKind_FreePipeline_:
+		{
+			RB_SoftwareFetch_(&rt->pipelinepool, handle);
+			RB_PoolFree_(&rt->pipelinepool, handle);
+			handle = 0;
+		} break;
+	}
+	
+	*resc->handle = handle;
+}
+
+static void
+RB_SoftwareRunDraw_(RB_Ctx* ctx, const RB_DrawDesc* desc)
+{
+	Trace();
+	
+	RB_SoftwareRuntime_* rt = ctx->rt;
+	RB_SoftwarePipeline_* pipeline = RB_SoftwareFetch_(&rt->pipelinepool, rt->curr_pipeline.id);
+	RB_SoftwareShader_* shader = RB_SoftwareFetch_(&rt->shaderpool, pipeline->shader.id);
+	
+	// Buffers
+	RB_SoftwareBuffer_* ibuffer = RB_SoftwareFetch_(&rt->bufpool, desc->ibuffer.id);
+	uint64 index_size = (ibuffer->index_type == RB_IndexType_Uint16) ? 2 : 4;
+	
+	SafeAssert(ibuffer->data && ibuffer->index_type);
+	SafeAssert(((uint64)desc->base_index + desc->index_count) * index_size <= ibuffer->size);
+	
+	RB_SoftwareDraw_ draw = {
+		.rt = rt,
+		.pipeline = pipeline,
+		.shader = shader,
+		.indices = ibuffer->data + desc->base_index * index_size,
+		.index_type = ibuffer->index_type,
+		.tris_per_instance = desc->index_count / 3,
+		.smooth_count = shader->varying_count - shader->flat_varying_count,
+		.tiles_x = (rt->width + RB_SoftwareTileSize_ - 1) / RB_SoftwareTileSize_,
+		.tiles_y = (rt->height + RB_SoftwareTileSize_ - 1) / RB_SoftwareTileSize_,
+		.active_tiles = rt->active_tiles,
+	};
+	
+	if (desc->ubuffer.id)
+	{
+		RB_SoftwareBuffer_* ubuffer = RB_SoftwareFetch_(&rt->bufpool, desc->ubuffer.id);
+		SafeAssert(ubuffer->data);
+		draw.uniforms = ubuffer->data;
+	}
+	
+	// Vertex Layout
+	uint32 location = 0;
+	
+	for (intsize i = 0; i < ArrayLength(pipeline->input_layout); ++i)
+	{
+		const RB_LayoutDesc* layout = &pipeline->input_layout[i];
+		
+		if (!layout->format)
+			break;
+		
+		RB_SoftwareBuffer_* vbuffer = RB_SoftwareFetch_(&rt->bufpool, desc->vbuffers[layout->buffer_slot].id);
+		uint64 offset = (uint64)desc->offsets[layout->buffer_slot] + layout->offset;
+		
+		SafeAssert(vbuffer->data && offset <= vbuffer->size);
+		
+		draw.inputs[draw.input_count++] = (RB_SoftwareInput_) {
+			.data = vbuffer->data + offset,
+			.size = vbuffer->size - offset,
+			.stride = desc->strides[layout->buffer_slot],
+			.location = location,
+			.layout = *layout,
+		};
+		
+		switch (layout->format)
+		{
+			default: location += 1; break;
+			case RB_VertexFormat_Mat2: location += 2; break;
+			case RB_VertexFormat_Mat3: location += 3; break;
+			case RB_VertexFormat_Mat4: location += 4; break;
+		}
+	}
+	
+	// Samplers
+	for (intsize i = 0; i < ArrayLength(desc->textures); ++i)
+	{
+		if (!desc->textures[i].id)
+			continue;
+		
+		RB_SoftwareTexture_* tex = RB_SoftwareFetch_(&rt->texpool, desc->textures[i].id);
+		SafeAssert(tex->pixels);
+		draw.textures[i] = tex;
+	}
+	
+	// Draw Call
+	if (!draw.tris_per_instance)
+		return;
+	
+	const uint64 chunk_size = (uint64)RB_SoftwareMaxSetupJobs_ * RB_SoftwareJobTriangles_;
+	uint64 total = (uint64)draw.tris_per_instance * Max(desc->instance_count, 1);
+	int32 tile_count = draw.tiles_x * draw.tiles_y;
+	
+	for (uint64 first = 0; first < total; first += chunk_size)
+	{
+		draw.first_tri = first;
+		draw.tri_count = Min(chunk_size, total - first);
+		draw.setup_job_count = (int32)((draw.tri_count + RB_SoftwareJobTriangles_ - 1) / RB_SoftwareJobTriangles_);
+		
+		for (int32 i = 0; i < draw.setup_job_count; ++i)
+		{
+			if (!rt->job_arenas[i])
+				rt->job_arenas[i] = ArenaCreate(1ull << 30, 64 << 10);
+		}
+		
+		RB_SoftwareRunJobs_(rt, draw.setup_job_count, RB_SoftwareSetupJob_, &draw);
+		
+		int32 active_count = 0;
+		
+		for (int32 tile = 0; tile < tile_count; ++tile)
+		{
+			for (int32 i = 0; i < draw.setup_job_count; ++i)
+			{
+				if (draw.bins[i].heads[tile])
+				{
+					draw.active_tiles[active_count++] = tile;
+					break;
+				}
+			}
+		}
+		
+		RB_SoftwareRunJobs_(rt, active_count, RB_SoftwareRasterJob_, &draw);
+	}
+}
+
+static void
+RB_SoftwareCommand_(RB_Ctx* ctx, const RB_CommandCall_* cmd)
+{
+	RB_SoftwareRuntime_* rt = ctx->rt;
+	
+	SafeAssert(rt->in_cmd == (cmd->kind != RB_CommandKind_Begin_));
+	
+	switch (cmd->kind)
+	{
+		case 0: Assert(false); break;
+		
+		case RB_CommandKind_Begin_:
+		{
+			int32 width = cmd->begin.viewport_width;
+			int32 height = cmd->begin.viewport_height;
+			
+			SafeAssert(width > 0 && width <= RB_SoftwareMaxFramebufferSize_);
+			SafeAssert(height > 0 && height <= RB_SoftwareMaxFramebufferSize_);
+			
+			// NOTE(ljre): Resizing loses what was drawn, same as resizing a window.
+			if (width != rt->width || height != rt->height)
+			{
+				intsize pixel_count = (intsize)width * height;
+				intsize tile_count = (intsize)((width + RB_SoftwareTileSize_ - 1) / RB_SoftwareTileSize_) * ((height + RB_SoftwareTileSize_ - 1) / RB_SoftwareTileSize_);
+				
+				OS_HeapFree(rt->color);
+				OS_HeapFree(rt->depth);
+				OS_HeapFree(rt->active_tiles);
+				
+				rt->color = OS_HeapAlloc(sizeof(uint32) * pixel_count);
+				rt->depth = OS_HeapAlloc(sizeof(float32) * pixel_count);
+				rt->active_tiles = OS_HeapAlloc(sizeof(int32) * tile_count);
+				rt->width = width;
+				rt->height = height;
+				
+				MemoryZero(rt->color, sizeof(uint32) * pixel_count);
+				for (intsize i = 0; i < pixel_count; ++i)
+					rt->depth[i] = 1.0f;
+			}
+			
+			rt->in_cmd = true;
+			rt->curr_pipeline = (RB_Pipeline) { 0 };
+		} break;
+		
+		case RB_CommandKind_End_:
+		{
+			rt->in_cmd = false;
+		} break;
+		
+		case RB_CommandKind_Clear_:
+		{
+			intsize pixel_count = (intsize)rt->width * rt->height;
+			
+			if (cmd->clear.flag_color)
+			{
+				float32 color[4];
+				
+				for (int32 i = 0; i < 4; ++i)
+					color[i] = Clamp(cmd->clear.color[i], 0.0f, 1.0f);
+				
+				uint32 packed = RB_SoftwarePack_(color);
+				
+				for (intsize i = 0; i < pixel_count; ++i)
+					rt->color[i] = packed;
+			}
+			
+			if (cmd->clear.flag_depth)
+			{
+				for (intsize i = 0; i < pixel_count; ++i)
+					rt->depth[i] = 1.0f;
+			}
+		} break;
+		
+		case RB_CommandKind_ApplyPipeline_:
+		{
+			RB_SoftwareFetch_(&rt->pipelinepool, cmd->apply_pipeline.handle.id);
+			rt->curr_pipeline = cmd->apply_pipeline.handle;
+		} break;
+		
+		case RB_CommandKind_ApplyRenderTarget_:
+		{
+			// NOTE(ljre): No render targets, only the framebuffer.
+			SafeAssert(!cmd->apply_render_target.handle.id);
+		} break;
+		
+		case RB_CommandKind_Draw_: RB_SoftwareRunDraw_(ctx, &cmd->draw); break;
+		case RB_CommandKind_Dispatch_: SafeAssert(false); break;
+	}
+}
+
+static void
+RB_SetupSoftwareRuntime_(RB_Ctx* ctx)
+{
+	RB_SoftwareRuntime_* rt = ArenaPushStruct(ctx->arena, RB_SoftwareRuntime_);
+	ctx->rt = rt;
+	ctx->rt_free_ctx = RB_SoftwareFreeCtx_;
+	ctx->rt_is_valid_handle = RB_SoftwareIsValidHandle_;
+	ctx->rt_resource = RB_SoftwareResource_;
+	ctx->rt_cmd = RB_SoftwareCommand_;
+	
+	//- Capabilities
+	RB_Capabilities caps = {
+		.backend_api = StrInit("Software"),
+		.driver_renderer = StrInit("None"),
+		.driver_vendor = StrInit("None"),
+		.driver_version = StrInit("None"),
+		.shader_type = RB_ShaderType_Software,
+		
+		.max_texture_size = 8192,
+		.max_render_target_textures = 0,
+		.max_textures_per_drawcall = RB_Limits_DrawMaxTextures,
+	};
+	
+	caps.has_instancing = true;
+	caps.has_32bit_index = true;
+	caps.has_separate_alpha_blend = true;
+	caps.has_compute_shaders = false;
+	caps.has_structured_buffer = false;
+	caps.has_f16_formats = false;
+	caps.has_f16_shader_ops = false;
+	caps.has_wireframe_fillmode = false;
+	
+	for (int32 i = RB_TexFormat_A8; i <= RB_TexFormat_RGBA8; ++i)
+		caps.supported_texture_formats[i / 64] |= 1ull << (i % 64);
+	
+	ctx->caps = caps;
+}
@@ -0,0 +1,373 @@
+#ifndef UTIL_ASSETPACK_H
+#define UTIL_ASSETPACK_H
+
+// NOTE(ljre): Layout of a pack file, everything in little-endian:
+//
+//             [UPak_Header] [UPak_Entry * entry_count, sorted by name_hash] [names] [blobs]
+//
+//             Every blob starts at a multiple of UPak_BlobAlignment, so the whole file can be mapped once and
+//             its contents used in place.
+//
+//             Cooked textures can also live outside of a pack, as a standalone blob:
+//
+//             [UPak_CookedTexHeader] [mip chain]
+enum
+{
+	UPak_Version = 1,
+	UPak_BlobAlignment = 64,
+	UPak_MaxMipCount = 16,
+};
+
+enum UPak_Kind
+{
+	UPak_Kind_Raw = 0,        // NOTE(ljre): The source file, as-is.
+	UPak_Kind_Tex2dRGBA8 = 1, // NOTE(ljre): Precooked RGBA8 mip chain, ready for RB_MakeTexture2D.
+}
+typedef UPak_Kind;
+
+struct UPak_Header
+{
+	uint8 magic[4];
+	uint32 version;
+	uint32 entry_count;
+	uint32 names_size;
+	uint64 total_size;
+}
+typedef UPak_Header;
+
+struct UPak_Entry
+{
+	uint64 name_hash; // NOTE(ljre): HashString of the name.
+	uint64 offset;
+	uint64 size;
+	uint32 name_offset; // NOTE(ljre): Relative to the start of the names section.
+	uint32 name_size;
+	uint32 kind;
+	uint32 width;
+	uint32 height;
+	uint32 mip_count; // NOTE(ljre): 0 is the same as 1, just the base level.
+}
+typedef UPak_Entry;
+
+struct UPak_CookedTexHeader
+{
+	uint8 magic[4];
+	uint32 width;
+	uint32 height;
+	uint32 mip_count;
+}
+typedef UPak_CookedTexHeader;
+
+static_assert(sizeof(UPak_Header) == 24, "pack header should have no padding");
+static_assert(sizeof(UPak_Entry) == 48, "pack entry should have no padding");
+static_assert(sizeof(UPak_CookedTexHeader) == 16, "cooked texture header should have no padding");
+
+struct UPak_Pack
+{
+	const uint8* data;
+	uintsize size;
+	
+	const UPak_Entry* entries;
+	uint32 entry_count;
+	const char* names;
+	uint32 names_size;
+}
+typedef UPak_Pack;
+
+// NOTE(ljre): Used by the packer. 'data' is only read.
+struct UPak_WriteEntry
+{
+	String name;
+	UPak_Kind kind;
+	int32 width;
+	int32 height;
+	int32 mip_count;
+	Buffer data;
+}
+typedef UPak_WriteEntry;
+
+//~ NOTE(ljre): Mip chains
+// NOTE(ljre): Levels are stored largest first and tightly packed. Each level is half of the previous one, rounded
+//             down, and at least 1.
+static uintsize
+UPak_CalcMipChainSize(uint32 width, uint32 height, uint32 mip_count)
+{
+	uintsize size = 0;
+	
+	for (uint32 i = 0; i < Max(mip_count, 1); ++i)
+		size += (uintsize)Max(width >> i, 1) * Max(height >> i, 1) * 4;
+	
+	return size;
+}
+
+static int32
+UPak_CalcFullMipCount(int32 width, int32 height)
+{
+	int32 count = 1;
+	
+	while ((width > 1 || height > 1) && count < UPak_MaxMipCount)
+	{
+		width = Max(width / 2, 1);
+		height = Max(height / 2, 1);
+		++count;
+	}
+	
+	return count;
+}
+
+// NOTE(ljre): 'chain' already holds the base level and has room for UPak_CalcMipChainSize bytes. The other levels
+//             are filled in with a 2x2 box filter.
+static void
+UPak_GenerateMips(uint32* chain, int32 width, int32 height, int32 mip_count)
+{
+	Trace();
+	
+	const uint8* src = (const uint8*)chain;
+	int32 src_width = width;
+	int32 src_height = height;
+	
+	for (int32 level = 1; level < mip_count; ++level)
+	{
+		int32 dst_width = Max(src_width / 2, 1);
+		int32 dst_height = Max(src_height / 2, 1);
+		uint8* dst = (uint8*)src + (uintsize)src_width * src_height * 4;
+		
+		for (int32 y = 0; y < dst_height; ++y)
+		{
+			const uint8* row0 = src + (uintsize)Min(y*2, src_height-1) * src_width * 4;
+			const uint8* row1 = src + (uintsize)Min(y*2+1, src_height-1) * src_width * 4;
+			
+			for (int32 x = 0; x < dst_width; ++x)
+			{
+				int32 x0 = Min(x*2, src_width-1) * 4;
+				int32 x1 = Min(x*2+1, src_width-1) * 4;
+				
+				for (int32 c = 0; c < 4; ++c)
+					dst[(y*dst_width + x)*4 + c] = (uint8)((row0[x0+c] + row0[x1+c] + row1[x0+c] + row1[x1+c] + 2) / 4);
+			}
+		}
+		
+		src = dst;
+		src_width = dst_width;
+		src_height = dst_height;
+	}
+}
+
+//~ NOTE(ljre): Cooked textures
+static bool
+UPak_ParseCookedTex(const uint8* data, uintsize size, int32* out_width, int32* out_height, int32* out_mip_count, const void** out_pixels)
+{
+	if (size < sizeof(UPak_CookedTexHeader))
+		return false;
+	
+	UPak_CookedTexHeader header;
+	MemoryCopy(&header, data, sizeof(header));
+	
+	if (MemoryCompare(header.magic, "ctex", 4) != 0 || !header.width || !header.height ||
+		header.width > INT32_MAX || header.height > INT32_MAX || header.mip_count > UPak_MaxMipCount)
+	{
+		return false;
+	}
+	
+	if (UPak_CalcMipChainSize(header.width, header.height, header.mip_count) != size - sizeof(header))
+		return false;
+	
+	*out_width = (int32)header.width;
+	*out_height = (int32)header.height;
+	*out_mip_count = (int32)Max(header.mip_count, 1);
+	*out_pixels = data + sizeof(header);
+	
+	return true;
+}
+
+static inline UPak_CookedTexHeader
+UPak_MakeCookedTexHeader(int32 width, int32 height, int32 mip_count)
+{
+	return (UPak_CookedTexHeader) {
+		.magic = "ctex",
+		.width = (uint32)width,
+		.height = (uint32)height,
+		.mip_count = (uint32)mip_count,
+	};
+}
+
+//~ NOTE(ljre): Reading
+static bool
+UPak_Open(const uint8* data, uintsize size, UPak_Pack* out_pack)
+{
+	Trace();
+	
+	if (size < sizeof(UPak_Header) || ((uintptr)data & (alignof(UPak_Entry)-1)) != 0)
+		return false;
+	
+	const UPak_Header* header = (const UPak_Header*)data;
+	
+	if (MemoryCompare(header->magic, "upak", 4) != 0 || header->version != UPak_Version || header->total_size != size)
+		return false;
+	
+	uint64 entries_end = sizeof(UPak_Header) + (uint64)header->entry_count * sizeof(UPak_Entry);
+	uint64 names_end = entries_end + header->names_size;
+	
+	if (names_end > size)
+		return false;
+	
+	const UPak_Entry* entries = (const UPak_Entry*)(data + sizeof(UPak_Header));
+	
+	// NOTE(ljre): Validate everything once so lookups don't have to.
+	for (uint32 i = 0; i < header->entry_count; ++i)
+	{
+		const UPak_Entry* entry = &entries[i];
+		
+		if (entry->offset < names_end || entry->offset > size || entry->size > size - entry->offset)
+			return false;
+		if (entry->offset % UPak_BlobAlignment != 0)
+			return false;
+		if ((uint64)entry->name_offset + entry->name_size > header->names_size)
+			return false;
+		if (i > 0 && entries[i-1].name_hash > entry->name_hash)
+			return false;
+		if (entry->kind == UPak_Kind_Tex2dRGBA8 && (entry->mip_count > UPak_MaxMipCount ||
+			UPak_CalcMipChainSize(entry->width, entry->height, entry->mip_count) != entry->size))
+		{
+			return false;
+		}
+	}
+	
+	*out_pack = (UPak_Pack) {
+		.data = data,
+		.size = size,
+		.entries = entries,
+		.entry_count = header->entry_count,
+		.names = (const char*)(data + entries_end),
+		.names_size = header->names_size,
+	};
+	
+	return true;
+}
+
+static inline String
+UPak_EntryName(const UPak_Pack* pack, const UPak_Entry* entry)
+{ return StrMake(entry->name_size, pack->names + entry->name_offset); }
+
+static inline Buffer
+UPak_EntryData(const UPak_Pack* pack, const UPak_Entry* entry)
+{ return BufMake(entry->size, pack->data + entry->offset); }
+
+static const UPak_Entry*
+UPak_Find(const UPak_Pack* pack, String name)
+{
+	uint64 hash = HashString(name);
+	uint32 low = 0;
+	uint32 high = pack->entry_count;
+	
+	// NOTE(ljre): Lower bound of 'hash', then walk through collisions.
+	while (low < high)
+	{
+		uint32 mid = low + (high - low) / 2;
+		
+		if (pack->entries[mid].name_hash < hash)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	
+	for (uint32 i = low; i < pack->entry_count && pack->entries[i].name_hash == hash; ++i)
+	{
+		if (StringEquals(UPak_EntryName(pack, &pack->entries[i]), name))
+			return &pack->entries[i];
+	}
+	
+	return NULL;
+}
+
+//~ NOTE(ljre): Writing
+// NOTE(ljre): Upper bound of the pack size, since the padding between blobs depends on their final order.
+static uintsize
+UPak_CalcMaxSize(const UPak_WriteEntry* entries, int32 entry_count)
+{
+	uintsize size = sizeof(UPak_Header) + sizeof(UPak_Entry) * (uintsize)entry_count;
+	
+	for (int32 i = 0; i < entry_count; ++i)
+		size += entries[i].name.size + entries[i].data.size + UPak_BlobAlignment-1;
+	
+	return size;
+}
+
+// NOTE(ljre): 'out_data' should be at least UPak_CalcMaxSize bytes and aligned to UPak_BlobAlignment. 'entries'
+//             is sorted in place. Returns the actual size of the pack, or 0 if there are duplicated names.
+static uintsize
+UPak_Write(UPak_WriteEntry* entries, int32 entry_count, uint8* out_data, uintsize out_size)
+{
+	Trace();
+	
+	SafeAssert(out_size >= UPak_CalcMaxSize(entries, entry_count));
+	
+	// NOTE(ljre): Insertion sort by hash. Packs are built offline and aren't that big.
+	for (int32 i = 1; i < entry_count; ++i)
+	{
+		UPak_WriteEntry entry = entries[i];
+		uint64 hash = HashString(entry.name);
+		int32 j = i;
+		
+		for (; j > 0 && HashString(entries[j-1].name) > hash; --j)
+			entries[j] = entries[j-1];
+		
+		entries[j] = entry;
+	}
+	
+	for (int32 i = 0; i < entry_count; ++i)
+	{
+		for (int32 j = i+1; j < entry_count && HashString(entries[j].name) == HashString(entries[i].name); ++j)
+		{
+			if (StringEquals(entries[i].name, entries[j].name))
+				return 0;
+		}
+	}
+	
+	MemorySet(out_data, 0, out_size);
+	
+	uint32 names_size = 0;
+	for (int32 i = 0; i < entry_count; ++i)
+		names_size += (uint32)entries[i].name.size;
+	
+	UPak_Header* header = (UPak_Header*)out_data;
+	UPak_Entry* out_entries = (UPak_Entry*)(out_data + sizeof(UPak_Header));
+	char* names = (char*)(out_entries + entry_count);
+	uintsize offset = (uintsize)(names - (char*)out_data) + names_size;
+	uint32 name_offset = 0;
+	
+	for (int32 i = 0; i < entry_count; ++i)
+	{
+		const UPak_WriteEntry* entry = &entries[i];
+		
+		offset = AlignUp(offset, UPak_BlobAlignment-1);
+		out_entries[i] = (UPak_Entry) {
+			.name_hash = HashString(entry->name),
+			.offset = offset,
+			.size = entry->data.size,
+			.name_offset = name_offset,
+			.name_size = (uint32)entry->name.size,
+			.kind = entry->kind,
+			.width = (uint32)entry->width,
+			.height = (uint32)entry->height,
+			.mip_count = (uint32)entry->mip_count,
+		};
+		
+		MemoryCopy(names + name_offset, entry->name.data, entry->name.size);
+		MemoryCopy(out_data + offset, entry->data.data, entry->data.size);
+		name_offset += (uint32)entry->name.size;
+		offset += entry->data.size;
+	}
+	
+	*header = (UPak_Header) {
+		.magic = "upak",
+		.version = UPak_Version,
+		.entry_count = (uint32)entry_count,
+		.names_size = names_size,
+		.total_size = offset,
+	};
+	
+	return offset;
+}
+
+#endif //UTIL_ASSETPACK_H
@@ -0,0 +1,367 @@
+#ifndef UTIL_AUDIODSP_H
+#define UTIL_AUDIODSP_H
+
+// NOTE(ljre): Effects that process interleaved float32 blocks in place. Each one keeps its state between blocks, so a
+//             signal can be split into blocks of any size and still come out the same.
+//
+//             Nothing in here allocates: UDsp_InitReverb takes its delay lines from an arena, once.
+enum
+{
+	UDsp_MaxChannels = 8,
+	UDsp_ReverbCombCount = 4,
+	UDsp_ReverbAllpassCount = 2,
+};
+
+//~ NOTE(ljre): Gain
+// NOTE(ljre): Goes from 'from' to 'to' linearly over the block.
+static void
+UDsp_ApplyGainRamp(float32* samples, int32 channels, int32 frame_count, float32 from, float32 to)
+{
+	if (from == to)
+	{
+		if (from != 1.0f)
+		{
+			for (int32 i = 0; i < frame_count * channels; ++i)
+				samples[i] *= from;
+		}
+		
+		return;
+	}
+	
+	float32 delta = (to - from) / (float32)frame_count;
+	float32 gain = from;
+	
+	for (int32 i = 0; i < frame_count; ++i, gain += delta)
+	{
+		for (int32 ch = 0; ch < channels; ++ch)
+			samples[i*channels + ch] *= gain;
+	}
+}
+
+// NOTE(ljre): Moves 'current' towards 'target' for a block of 'frame_count' frames. 'time' is how many seconds it
+//             takes to get about 63% of the way there.
+static float32
+UDsp_SmoothGain(float32 current, float32 target, int32 frame_count, float32 sample_rate, float32 time)
+{
+	if (time <= 0.0f)
+		return target;
+	
+	float32 next = target + (current - target) * expf(-(float32)frame_count / (time * sample_rate));
+	
+	// NOTE(ljre): Close enough, so we can go back to not ramping at all.
+	if (fabsf(next - target) < 1e-4f)
+		next = target;
+	
+	return next;
+}
+
+//~ NOTE(ljre): Biquad
+enum UDsp_BiquadKind
+{
+	UDsp_BiquadKind_LowPass = 0,
+	UDsp_BiquadKind_HighPass,
+	UDsp_BiquadKind_BandPass,
+	UDsp_BiquadKind_Peaking,
+}
+typedef UDsp_BiquadKind;
+
+struct UDsp_Biquad
+{
+	float32 b0, b1, b2;
+	float32 a1, a2;
+	
+	// NOTE(ljre): Transposed direct form II, one pair per channel.
+	float32 z1[UDsp_MaxChannels];
+	float32 z2[UDsp_MaxChannels];
+}
+typedef UDsp_Biquad;
+
+// NOTE(ljre): Coefficients from the RBJ audio EQ cookbook. 'gain_db' is only used by UDsp_BiquadKind_Peaking. Changing
+//             the coefficients of a filter that's running keeps its state, so sweeping it doesn't click much.
+static void
+UDsp_SetBiquad(UDsp_Biquad* biquad, UDsp_BiquadKind kind, float32 sample_rate, float32 frequency, float32 q, float32 gain_db)
+{
+	float64 w0 = 2.0 * Math_PI_64 * Min(frequency, sample_rate * 0.49f) / sample_rate;
+	float64 cos_w0 = cos(w0);
+	float64 alpha = sin(w0) / (2.0 * (q > 0.0f ? q : Math_SQRT2_64 * 0.5));
+	float64 a = pow(10.0, gain_db / 40.0);
+	float64 b0, b1, b2, a0, a1, a2;
+	
+	switch (kind)
+	{
+		default:
+		case UDsp_BiquadKind_LowPass:
+		{
+			b0 = (1.0 - cos_w0) * 0.5;
+			b1 = 1.0 - cos_w0;
+			b2 = (1.0 - cos_w0) * 0.5;
+			a0 = 1.0 + alpha;
+			a1 = -2.0 * cos_w0;
+			a2 = 1.0 - alpha;
+		} break;
+		case UDsp_BiquadKind_HighPass:
+		{
+			b0 = (1.0 + cos_w0) * 0.5;
+			b1 = -(1.0 + cos_w0);
+			b2 = (1.0 + cos_w0) * 0.5;
+			a0 = 1.0 + alpha;
+			a1 = -2.0 * cos_w0;
+			a2 = 1.0 - alpha;
+		} break;
+		case UDsp_BiquadKind_BandPass:
+		{
+			b0 = alpha;
+			b1 = 0.0;
+			b2 = -alpha;
+			a0 = 1.0 + alpha;
+			a1 = -2.0 * cos_w0;
+			a2 = 1.0 - alpha;
+		} break;
+		case UDsp_BiquadKind_Peaking:
+		{
+			b0 = 1.0 + alpha * a;
+			b1 = -2.0 * cos_w0;
+			b2 = 1.0 - alpha * a;
+			a0 = 1.0 + alpha / a;
+			a1 = -2.0 * cos_w0;
+			a2 = 1.0 - alpha / a;
+		} break;
+	}
+	
+	biquad->b0 = (float32)(b0 / a0);
+	biquad->b1 = (float32)(b1 / a0);
+	biquad->b2 = (float32)(b2 / a0);
+	biquad->a1 = (float32)(a1 / a0);
+	biquad->a2 = (float32)(a2 / a0);
+}
+
+static void
+UDsp_ProcessBiquad(UDsp_Biquad* biquad, float32* samples, int32 channels, int32 frame_count)
+{
+	const float32 b0 = biquad->b0, b1 = biquad->b1, b2 = biquad->b2;
+	const float32 a1 = biquad->a1, a2 = biquad->a2;
+	
+	for (int32 ch = 0; ch < Min(channels, UDsp_MaxChannels); ++ch)
+	{
+		float32 z1 = biquad->z1[ch];
+		float32 z2 = biquad->z2[ch];
+		float32* s = samples + ch;
+		
+		for (int32 i = 0; i < frame_count; ++i, s += channels)
+		{
+			float32 x = *s;
+			float32 y = b0*x + z1;
+			
+			z1 = b1*x - a1*y + z2;
+			z2 = b2*x - a2*y;
+			*s = y;
+		}
+		
+		// NOTE(ljre): Don't let the state decay into denormals once the input goes silent.
+		biquad->z1[ch] = (fabsf(z1) < 1e-15f) ? 0.0f : z1;
+		biquad->z2[ch] = (fabsf(z2) < 1e-15f) ? 0.0f : z2;
+	}
+}
+
+//~ NOTE(ljre): Compressor
+// NOTE(ljre): Feed-forward, with a peak detector shared by all channels so the stereo image doesn't move. With an
+//             infinite ratio and no attack it's a limiter: no sample comes out louder than the threshold (before the
+//             makeup gain).
+struct UDsp_Compressor
+{
+	float32 threshold; // NOTE(ljre): Linear.
+	float32 exponent; // NOTE(ljre): 1 - 1/ratio.
+	float32 attack_coef;
+	float32 release_coef;
+	float32 makeup; // NOTE(ljre): Linear.
+	
+	float32 envelope;
+}
+typedef UDsp_Compressor;
+
+static void
+UDsp_SetCompressor(UDsp_Compressor* comp, float32 sample_rate, float32 threshold_db, float32 ratio, float32 attack, float32 release, float32 makeup_db)
+{
+	comp->threshold = powf(10.0f, threshold_db / 20.0f);
+	comp->exponent = (ratio > 1.0f) ? 1.0f - 1.0f / ratio : 0.0f;
+	comp->attack_coef = (attack > 0.0f) ? expf(-1.0f / (attack * sample_rate)) : 0.0f;
+	comp->release_coef = (release > 0.0f) ? expf(-1.0f / (release * sample_rate)) : 0.0f;
+	comp->makeup = powf(10.0f, makeup_db / 20.0f);
+}
+
+static void
+UDsp_ProcessCompressor(UDsp_Compressor* comp, float32* samples, int32 channels, int32 frame_count)
+{
+	const float32 threshold = comp->threshold;
+	const float32 exponent = comp->exponent;
+	const float32 makeup = comp->makeup;
+	float32 envelope = comp->envelope;
+	
+	for (int32 i = 0; i < frame_count; ++i)
+	{
+		float32* frame = samples + i*channels;
+		float32 peak = 0.0f;
+		
+		for (int32 ch = 0; ch < channels; ++ch)
+			peak = Max(peak, fabsf(frame[ch]));
+		
+		float32 coef = (peak > envelope) ? comp->attack_coef : comp->release_coef;
+		envelope = peak + (envelope - peak) * coef;
+		
+		// NOTE(ljre): (threshold/envelope)^exponent is the gain that puts the envelope back on the slope of the ratio.
+		float32 gain = makeup;
+		if (envelope > threshold)
+		{
+			if (exponent == 1.0f)
+				gain *= threshold / envelope;
+			else
+				gain *= powf(threshold / envelope, exponent);
+		}
+		
+		for (int32 ch = 0; ch < channels; ++ch)
+			frame[ch] *= gain;
+	}
+	
+	comp->envelope = (envelope < 1e-15f) ? 0.0f : envelope;
+}
+
+//~ NOTE(ljre): Reverb
+// NOTE(ljre): Schroeder style, tuned after Freeverb: parallel combs with a lowpass in their feedback, then allpasses
+//             in series. Each channel gets its delay lines a bit longer than the one before, which spreads the image.
+struct UDsp_ReverbLine_
+{
+	float32* buffer;
+	int32 length;
+	int32 index;
+	float32 store; // NOTE(ljre): Lowpass state of the combs.
+}
+typedef UDsp_ReverbLine_;
+
+struct UDsp_Reverb
+{
+	int32 channels;
+	float32 feedback;
+	float32 damping;
+	float32 wet;
+	float32 dry;
+	
+	UDsp_ReverbLine_ combs[UDsp_MaxChannels][UDsp_ReverbCombCount];
+	UDsp_ReverbLine_ allpasses[UDsp_MaxChannels][UDsp_ReverbAllpassCount];
+}
+typedef UDsp_Reverb;
+
+// NOTE(ljre): Lengths in frames at 44100Hz.
+static const int32 g_udsp_comb_lengths[UDsp_ReverbCombCount] = { 1116, 1188, 1277, 1356 };
+static const int32 g_udsp_allpass_lengths[UDsp_ReverbAllpassCount] = { 556, 441 };
+static const int32 g_udsp_stereo_spread = 23;
+
+static void
+UDsp_InitReverb(UDsp_Reverb* reverb, Arena* arena, int32 channels, float32 sample_rate)
+{
+	float32 scale = sample_rate / 44100.0f;
+	
+	*reverb = (UDsp_Reverb) {
+		.channels = Min(channels, UDsp_MaxChannels),
+		.dry = 1.0f,
+	};
+	
+	for (int32 ch = 0; ch < reverb->channels; ++ch)
+	{
+		for (int32 i = 0; i < UDsp_ReverbCombCount; ++i)
+		{
+			UDsp_ReverbLine_* line = &reverb->combs[ch][i];
+			
+			line->length = (int32)((g_udsp_comb_lengths[i] + ch * g_udsp_stereo_spread) * scale);
+			line->buffer = ArenaPushArray(arena, float32, line->length);
+		}
+		
+		for (int32 i = 0; i < UDsp_ReverbAllpassCount; ++i)
+		{
+			UDsp_ReverbLine_* line = &reverb->allpasses[ch][i];
+			
+			line->length = (int32)((g_udsp_allpass_lengths[i] + ch * g_udsp_stereo_spread) * scale);
+			line->buffer = ArenaPushArray(arena, float32, line->length);
+		}
+	}
+}
+
+// NOTE(ljre): 'room_size' and 'damping' go from 0 to 1. 'mix' is how much of the output is reverb.
+static void
+UDsp_SetReverb(UDsp_Reverb* reverb, float32 room_size, float32 damping, float32 mix)
+{
+	room_size = Clamp(room_size, 0.0f, 1.0f);
+	damping = Clamp(damping, 0.0f, 1.0f);
+	mix = Clamp(mix, 0.0f, 1.0f);
+	
+	reverb->feedback = 0.7f + room_size * 0.28f;
+	reverb->damping = damping * 0.4f;
+	reverb->wet = mix * 3.0f;
+	reverb->dry = 1.0f - mix;
+}
+
+// NOTE(ljre): Forgets the tail.
+static void
+UDsp_ClearReverb(UDsp_Reverb* reverb)
+{
+	for (int32 ch = 0; ch < reverb->channels; ++ch)
+	{
+		for (int32 i = 0; i < UDsp_ReverbCombCount; ++i)
+		{
+			MemoryZero(reverb->combs[ch][i].buffer, sizeof(float32) * reverb->combs[ch][i].length);
+			reverb->combs[ch][i].store = 0.0f;
+		}
+		
+		for (int32 i = 0; i < UDsp_ReverbAllpassCount; ++i)
+			MemoryZero(reverb->allpasses[ch][i].buffer, sizeof(float32) * reverb->allpasses[ch][i].length);
+	}
+}
+
+static void
+UDsp_ProcessReverb(UDsp_Reverb* reverb, float32* samples, int32 channels, int32 frame_count)
+{
+	// NOTE(ljre): Freeverb's input gain, doubled since we have half as many combs.
+	const float32 input_gain = 0.03f;
+	const float32 feedback = reverb->feedback;
+	const float32 damping = reverb->damping;
+	
+	for (int32 ch = 0; ch < Min(channels, reverb->channels); ++ch)
+	{
+		UDsp_ReverbLine_* combs = reverb->combs[ch];
+		UDsp_ReverbLine_* allpasses = reverb->allpasses[ch];
+		float32* s = samples + ch;
+		
+		for (int32 i = 0; i < frame_count; ++i, s += channels)
+		{
+			float32 input = *s * input_gain;
+			float32 out = 0.0f;
+			
+			for (int32 j = 0; j < UDsp_ReverbCombCount; ++j)
+			{
+				UDsp_ReverbLine_* line = &combs[j];
+				float32 delayed = line->buffer[line->index];
+				
+				// NOTE(ljre): A tail that faded out shouldn't turn into denormals. Everything else is fed by 'store', so
+				//             it's enough to flush it.
+				line->store = delayed * (1.0f - damping) + line->store * damping;
+				line->store = (fabsf(line->store) < 1e-15f) ? 0.0f : line->store;
+				line->buffer[line->index] = input + line->store * feedback;
+				line->index = (line->index + 1 < line->length) ? line->index + 1 : 0;
+				out += delayed;
+			}
+			
+			for (int32 j = 0; j < UDsp_ReverbAllpassCount; ++j)
+			{
+				UDsp_ReverbLine_* line = &allpasses[j];
+				float32 delayed = line->buffer[line->index];
+				
+				line->buffer[line->index] = out + delayed * 0.5f;
+				line->index = (line->index + 1 < line->length) ? line->index + 1 : 0;
+				out = delayed - out;
+			}
+			
+			*s = *s * reverb->dry + out * reverb->wet;
+		}
+	}
+}
+
+#endif //UTIL_AUDIODSP_H
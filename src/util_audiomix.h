@@ -0,0 +1,715 @@
+#ifndef UTIL_AUDIOMIX_H
+#define UTIL_AUDIOMIX_H
+
+// NOTE(ljre): Mix kernels. Each one resamples a voice and adds it to an interleaved float32 buffer.
+//
+//             Positions are 32.32 fixed point: the integer part is the frame in 'samples', the fractional part is
+//             how far we are into the next one. The fraction is only ever turned into a float from its top 24 bits,
+//             so every path below computes exactly the same interpolation weights.
+//
+//             Besides linear interpolation, voices can go through a windowed-sinc filter of 8 or 32 taps. Its
+//             coefficients are precomputed by UMix_InitTables for UMix_SincPhases fractional positions, and each output
+//             frame uses the row of the position closest to it. An output frame at frame N reads the frames from
+//             N - UMix_TapCount()/2 + 1 to N + UMix_TapCount()/2, so 'samples' needs UMix_PadFrames readable frames
+//             before and after it.
+enum
+{
+	UMix_FracShift = 8,
+	UMix_MaxTaps = 32,
+	UMix_PadFrames = UMix_MaxTaps/2,
+	UMix_SincPhaseBits = 10,
+	UMix_SincPhases = 1 << UMix_SincPhaseBits,
+};
+
+enum UMix_Quality
+{
+	UMix_Quality_Linear = 0,
+	UMix_Quality_Sinc8,
+	UMix_Quality_Sinc32,
+}
+typedef UMix_Quality;
+
+struct UMix_Voice
+{
+	const float32* samples; // NOTE(ljre): Interleaved.
+	int32 channels;
+	int32 frame_count; // NOTE(ljre): Output frames to mix.
+	uint64 phase; // NOTE(ljre): Position of the first output frame in 'samples'.
+	uint64 step; // NOTE(ljre): How much the position advances per output frame.
+	float32 volume;
+	float32 volume_step; // NOTE(ljre): Added to 'volume' for each output frame. Only for short fades, see UMix_MixVoice.
+	UMix_Quality quality;
+}
+typedef UMix_Voice;
+
+// NOTE(ljre): Rows of coefficients, one per fractional position. They're made for ratios close to 1, which is what
+//             the mixer sees most of the time: downsampling by a lot still aliases, just much less than linear does.
+struct UMix_Tables
+{
+	bool ready;
+	alignas(64) float32 sinc8[(UMix_SincPhases+1) * 8];
+	alignas(64) float32 sinc32[(UMix_SincPhases+1) * 32];
+}
+typedef UMix_Tables;
+
+static UMix_Tables global_umix_tables;
+
+static inline uint64
+UMix_MakeStep(float64 ratio)
+{ return (uint64)(ratio * 4294967296.0 + 0.5); }
+
+static inline bool
+UMix_IsSameRate(uint64 phase, uint64 step)
+{ return step == (uint64)1 << 32 && (uint32)phase == 0; }
+
+static inline float32
+UMix_FracToFloat_(uint64 phase)
+{ return (float32)((uint32)phase >> UMix_FracShift) * (1.0f / 16777216.0f); }
+
+static inline int32
+UMix_TapCount(UMix_Quality quality)
+{
+	switch (quality)
+	{
+		default:
+		case UMix_Quality_Linear: return 2;
+		case UMix_Quality_Sinc8: return 8;
+		case UMix_Quality_Sinc32: return 32;
+	}
+}
+
+// NOTE(ljre): How many of the frames before the one it's at an output frame reads.
+static inline int32
+UMix_HistoryFrames(UMix_Quality quality)
+{ return UMix_TapCount(quality)/2 - 1; }
+
+// NOTE(ljre): How many of the frames after the one it's at an output frame reads.
+static inline int32
+UMix_LookaheadFrames(UMix_Quality quality)
+{ return UMix_TapCount(quality)/2; }
+
+static inline const float32*
+UMix_SincTable_(UMix_Quality quality)
+{ return (quality == UMix_Quality_Sinc32) ? global_umix_tables.sinc32 : global_umix_tables.sinc8; }
+
+// NOTE(ljre): Rounds to the nearest row. The last one is for a fraction of 1.
+static inline const float32*
+UMix_SincRow_(const float32* table, int32 taps, uint64 phase)
+{ return table + (intsize)(((uint64)(uint32)phase + ((uint64)1 << (31 - UMix_SincPhaseBits))) >> (32 - UMix_SincPhaseBits)) * taps; }
+
+// NOTE(ljre): How many output frames, starting at 'phase', are at a position before 'limit'. At most 'max_count'.
+static inline int32
+UMix_CalcFrameCount(uint64 phase, uint64 step, int32 limit, int32 max_count)
+{
+	uint64 end = (uint64)Max(limit, 0) << 32;
+	
+	if (end <= phase)
+		return 0;
+	
+	return (int32)Min((end - phase + step-1) / step, (uint64)max_count);
+}
+
+//~ NOTE(ljre): Tables
+static float64
+UMix_BesselI0_(float64 x)
+{
+	float64 result = 1.0;
+	float64 term = 1.0;
+	
+	for (int32 k = 1; k < 32; ++k)
+	{
+		term *= (x * 0.5 / k) * (x * 0.5 / k);
+		result += term;
+	}
+	
+	return result;
+}
+
+// NOTE(ljre): Kaiser-windowed sinc. 'cutoff' is in cycles per input frame. Each row is normalized so a constant
+//             signal keeps its level no matter the fraction.
+static void
+UMix_BuildSincTable_(float32* table, int32 taps, float64 cutoff, float64 beta)
+{
+	const float64 half_width = taps / 2;
+	const float64 window_scale = 1.0 / UMix_BesselI0_(beta);
+	
+	for (int32 row = 0; row <= UMix_SincPhases; ++row)
+	{
+		float64 frac = (float64)row / UMix_SincPhases;
+		float64 coefs[UMix_MaxTaps];
+		float64 sum = 0.0;
+		
+		for (int32 k = 0; k < taps; ++k)
+		{
+			float64 x = (float64)(k - (taps/2 - 1)) - frac;
+			float64 t = x / half_width;
+			float64 window = (t*t < 1.0) ? UMix_BesselI0_(beta * sqrt(1.0 - t*t)) * window_scale : 0.0;
+			float64 sinc = (x == 0.0) ? 2.0*cutoff : sin(2.0*Math_PI_64*cutoff*x) / (Math_PI_64*x);
+			
+			coefs[k] = sinc * window;
+			sum += coefs[k];
+		}
+		
+		for (int32 k = 0; k < taps; ++k)
+			table[row*taps + k] = (float32)(coefs[k] / sum);
+	}
+}
+
+//~ NOTE(ljre): Kernels
+static inline float32
+UMix_SincDot_(const float32* src, int32 stride, const float32* row, int32 taps)
+{
+	float32 result = 0.0f;
+	
+	for (int32 k = 0; k < taps; ++k)
+		result += src[k*stride] * row[k];
+	
+	return result;
+}
+
+static void
+UMix_Generic_(float32* restrict out, int32 out_channels, const UMix_Voice* voice)
+{
+	const float32* src = voice->samples;
+	uint64 phase = voice->phase;
+	
+	// NOTE(ljre): Same as in UMix_MixVoice, at the same rate it's just a copy.
+	if (voice->quality != UMix_Quality_Linear && !UMix_IsSameRate(voice->phase, voice->step))
+	{
+		const float32* table = UMix_SincTable_(voice->quality);
+		const int32 taps = UMix_TapCount(voice->quality);
+		const int32 history = UMix_HistoryFrames(voice->quality);
+		
+		for (intsize i = 0; i < voice->frame_count; ++i, phase += voice->step)
+		{
+			const float32* a = src + ((intsize)(phase >> 32) - history) * voice->channels;
+			const float32* row = UMix_SincRow_(table, taps, phase);
+			float32 volume = voice->volume + voice->volume_step * (float32)i;
+			
+			for (int32 ch = 0; ch < out_channels; ++ch)
+			{
+				int32 in_ch = Min(ch, voice->channels-1);
+				
+				out[i*out_channels + ch] += UMix_SincDot_(a + in_ch, voice->channels, row, taps) * volume;
+			}
+		}
+		
+		return;
+	}
+	
+	for (intsize i = 0; i < voice->frame_count; ++i, phase += voice->step)
+	{
+		const float32* a = src + (intsize)(phase >> 32) * voice->channels;
+		const float32* b = a + voice->channels;
+		float32 t = UMix_FracToFloat_(phase);
+		float32 volume = voice->volume + voice->volume_step * (float32)i;
+		
+		for (int32 ch = 0; ch < out_channels; ++ch)
+		{
+			int32 in_ch = Min(ch, voice->channels-1);
+			
+			out[i*out_channels + ch] += (a[in_ch] + (b[in_ch] - a[in_ch]) * t) * volume;
+		}
+	}
+}
+
+// NOTE(ljre): The SIMD loops stop at 'count' rounded down to their width rather than testing 'i+4 <= count'. That way
+//             the compiler knows exactly where the scalar tail starts, and gcc doesn't take a constant frame count
+//             (like the one in bench_mix.c) as a tail loop that runs until 'i*2' overflows.
+static void
+UMix_MonoToStereoSameRate_(float32* restrict out, const UMix_Voice* voice)
+{
+	const float32* src = voice->samples + (voice->phase >> 32);
+	const float32 volume = voice->volume;
+	const intsize count = voice->frame_count;
+	intsize i = 0;
+	
+#if defined(__AVX2__)
+	__m256 vol8 = _mm256_set1_ps(volume);
+	
+	for (; i < (count & ~(intsize)7); i += 8)
+	{
+		__m256 s = _mm256_mul_ps(_mm256_loadu_ps(src + i), vol8);
+		__m256 lo = _mm256_unpacklo_ps(s, s);
+		__m256 hi = _mm256_unpackhi_ps(s, s);
+		
+		_mm256_storeu_ps(out + i*2 + 0, _mm256_add_ps(_mm256_loadu_ps(out + i*2 + 0), _mm256_permute2f128_ps(lo, hi, 0x20)));
+		_mm256_storeu_ps(out + i*2 + 8, _mm256_add_ps(_mm256_loadu_ps(out + i*2 + 8), _mm256_permute2f128_ps(lo, hi, 0x31)));
+	}
+#endif
+#if defined(CONFIG_ARCH_X86FAMILY)
+	__m128 vol = _mm_set1_ps(volume);
+	
+	for (; i < (count & ~(intsize)3); i += 4)
+	{
+		__m128 s = _mm_mul_ps(_mm_loadu_ps(src + i), vol);
+		
+		_mm_storeu_ps(out + i*2 + 0, _mm_add_ps(_mm_loadu_ps(out + i*2 + 0), _mm_unpacklo_ps(s, s)));
+		_mm_storeu_ps(out + i*2 + 4, _mm_add_ps(_mm_loadu_ps(out + i*2 + 4), _mm_unpackhi_ps(s, s)));
+	}
+#elif defined(CONFIG_ARCH_AARCH64)
+	for (; i < (count & ~(intsize)3); i += 4)
+	{
+		float32x4_t s = vmulq_n_f32(vld1q_f32(src + i), volume);
+		float32x4x2_t pairs = vzipq_f32(s, s);
+		
+		vst1q_f32(out + i*2 + 0, vaddq_f32(vld1q_f32(out + i*2 + 0), pairs.val[0]));
+		vst1q_f32(out + i*2 + 4, vaddq_f32(vld1q_f32(out + i*2 + 4), pairs.val[1]));
+	}
+#endif
+	
+	for (; i < count; ++i)
+	{
+		float32 s = src[i] * volume;
+		
+		out[i*2 + 0] += s;
+		out[i*2 + 1] += s;
+	}
+}
+
+static void
+UMix_StereoToStereoSameRate_(float32* restrict out, const UMix_Voice* voice)
+{
+	const float32* src = voice->samples + (voice->phase >> 32) * 2;
+	const float32 volume = voice->volume;
+	const intsize count = (intsize)voice->frame_count * 2;
+	intsize i = 0;
+	
+#if defined(__AVX2__)
+	__m256 vol8 = _mm256_set1_ps(volume);
+	
+	for (; i < (count & ~(intsize)7); i += 8)
+		_mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_loadu_ps(out + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), vol8)));
+#endif
+#if defined(CONFIG_ARCH_X86FAMILY)
+	__m128 vol = _mm_set1_ps(volume);
+	
+	for (; i < (count & ~(intsize)3); i += 4)
+		_mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(_mm_loadu_ps(src + i), vol)));
+#elif defined(CONFIG_ARCH_AARCH64)
+	for (; i < (count & ~(intsize)3); i += 4)
+		vst1q_f32(out + i, vmlaq_n_f32(vld1q_f32(out + i), vld1q_f32(src + i), volume));
+#endif
+	
+	for (; i < count; ++i)
+		out[i] += src[i] * volume;
+}
+
+static void
+UMix_MonoToStereo_(float32* restrict out, const UMix_Voice* voice)
+{
+	const float32* src = voice->samples;
+	const float32 volume = voice->volume;
+	const uint64 step = voice->step;
+	uint64 phase = voice->phase;
+	const intsize count = voice->frame_count;
+	intsize i = 0;
+	
+#if defined(__AVX2__)
+	// NOTE(ljre): The accumulator lives in 64-bit lanes: 'pos_lo' has frames 0..3 of the group, 'pos_hi' has 4..7.
+	__m256i pos_lo = _mm256_setr_epi64x((int64)phase, (int64)(phase + step), (int64)(phase + step*2), (int64)(phase + step*3));
+	__m256i pos_hi = _mm256_add_epi64(pos_lo, _mm256_set1_epi64x((int64)(step*4)));
+	__m256i step8 = _mm256_set1_epi64x((int64)(step*8));
+	__m256 vol8 = _mm256_set1_ps(volume);
+	__m256 frac_mul8 = _mm256_set1_ps(1.0f / 16777216.0f);
+	
+	for (; i < (count & ~(intsize)7); i += 8)
+	{
+		// NOTE(ljre): High halves are the indices, low halves are the fractions. The shuffle leaves them in the
+		//             order 0 1 4 5 2 3 6 7, the permute puts them back in place.
+		__m256 lo = _mm256_castsi256_ps(pos_lo);
+		__m256 hi = _mm256_castsi256_ps(pos_hi);
+		__m256i index = _mm256_permute4x64_epi64(_mm256_castps_si256(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3,1,3,1))), _MM_SHUFFLE(3,1,2,0));
+		__m256i frac = _mm256_permute4x64_epi64(_mm256_castps_si256(_mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2,0,2,0))), _MM_SHUFFLE(3,1,2,0));
+		
+		__m256 a = _mm256_i32gather_ps(src + 0, index, 4);
+		__m256 b = _mm256_i32gather_ps(src + 1, index, 4);
+		__m256 t = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(frac, UMix_FracShift)), frac_mul8);
+		__m256 s = _mm256_mul_ps(_mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a), t)), vol8);
+		__m256 s_lo = _mm256_unpacklo_ps(s, s);
+		__m256 s_hi = _mm256_unpackhi_ps(s, s);
+		
+		_mm256_storeu_ps(out + i*2 + 0, _mm256_add_ps(_mm256_loadu_ps(out + i*2 + 0), _mm256_permute2f128_ps(s_lo, s_hi, 0x20)));
+		_mm256_storeu_ps(out + i*2 + 8, _mm256_add_ps(_mm256_loadu_ps(out + i*2 + 8), _mm256_permute2f128_ps(s_lo, s_hi, 0x31)));
+		
+		pos_lo = _mm256_add_epi64(pos_lo, step8);
+		pos_hi = _mm256_add_epi64(pos_hi, step8);
+	}
+	
+	phase = voice->phase + step * (uint64)i;
+#endif
+#if defined(CONFIG_ARCH_X86FAMILY)
+	__m128 vol = _mm_set1_ps(volume);
+	__m128 frac_mul = _mm_set1_ps(1.0f / 16777216.0f);
+	
+	for (; i < (count & ~(intsize)3); i += 4)
+	{
+		uint64 p0 = phase, p1 = p0 + step, p2 = p1 + step, p3 = p2 + step;
+		const float32* s0 = src + (p0 >> 32);
+		const float32* s1 = src + (p1 >> 32);
+		const float32* s2 = src + (p2 >> 32);
+		const float32* s3 = src + (p3 >> 32);
+		
+		__m128 a = _mm_setr_ps(s0[0], s1[0], s2[0], s3[0]);
+		__m128 b = _mm_setr_ps(s0[1], s1[1], s2[1], s3[1]);
+		__m128i frac = _mm_setr_epi32((int32)((uint32)p0 >> UMix_FracShift), (int32)((uint32)p1 >> UMix_FracShift), (int32)((uint32)p2 >> UMix_FracShift), (int32)((uint32)p3 >> UMix_FracShift));
+		__m128 t = _mm_mul_ps(_mm_cvtepi32_ps(frac), frac_mul);
+		__m128 s = _mm_mul_ps(_mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t)), vol);
+		
+		_mm_storeu_ps(out + i*2 + 0, _mm_add_ps(_mm_loadu_ps(out + i*2 + 0), _mm_unpacklo_ps(s, s)));
+		_mm_storeu_ps(out + i*2 + 4, _mm_add_ps(_mm_loadu_ps(out + i*2 + 4), _mm_unpackhi_ps(s, s)));
+		
+		phase = p3 + step;
+	}
+#elif defined(CONFIG_ARCH_AARCH64)
+	for (; i < (count & ~(intsize)3); i += 4)
+	{
+		uint64 p0 = phase, p1 = p0 + step, p2 = p1 + step, p3 = p2 + step;
+		const float32* s0 = src + (p0 >> 32);
+		const float32* s1 = src + (p1 >> 32);
+		const float32* s2 = src + (p2 >> 32);
+		const float32* s3 = src + (p3 >> 32);
+		
+		// NOTE(ljre): Each load picks up a frame and the one after it.
+		float32x4_t a01b01 = vcombine_f32(vld1_f32(s0), vld1_f32(s1));
+		float32x4_t a23b23 = vcombine_f32(vld1_f32(s2), vld1_f32(s3));
+		float32x4x2_t ab = vuzpq_f32(a01b01, a23b23);
+		uint32 fracs[4] = { (uint32)p0 >> UMix_FracShift, (uint32)p1 >> UMix_FracShift, (uint32)p2 >> UMix_FracShift, (uint32)p3 >> UMix_FracShift };
+		float32x4_t t = vmulq_n_f32(vcvtq_f32_u32(vld1q_u32(fracs)), 1.0f / 16777216.0f);
+		float32x4_t s = vmulq_n_f32(vmlaq_f32(ab.val[0], vsubq_f32(ab.val[1], ab.val[0]), t), volume);
+		float32x4x2_t pairs = vzipq_f32(s, s);
+		
+		vst1q_f32(out + i*2 + 0, vaddq_f32(vld1q_f32(out + i*2 + 0), pairs.val[0]));
+		vst1q_f32(out + i*2 + 4, vaddq_f32(vld1q_f32(out + i*2 + 4), pairs.val[1]));
+		
+		phase = p3 + step;
+	}
+#endif
+	
+	for (; i < count; ++i, phase += step)
+	{
+		const float32* a = src + (phase >> 32);
+		float32 s = (a[0] + (a[1] - a[0]) * UMix_FracToFloat_(phase)) * volume;
+		
+		out[i*2 + 0] += s;
+		out[i*2 + 1] += s;
+	}
+}
+
+static void
+UMix_StereoToStereo_(float32* restrict out, const UMix_Voice* voice)
+{
+	const float32* src = voice->samples;
+	const float32 volume = voice->volume;
+	const uint64 step = voice->step;
+	uint64 phase = voice->phase;
+	const intsize count = voice->frame_count;
+	intsize i = 0;
+	
+	// NOTE(ljre): A single unaligned load of 4 floats picks up both frames a stereo output frame needs, so there's
+	//             nothing for gathers to win here and AVX2 doesn't get a path of its own.
+#if defined(CONFIG_ARCH_X86FAMILY)
+	__m128 vol = _mm_set1_ps(volume);
+	__m128 frac_mul = _mm_set1_ps(1.0f / 16777216.0f);
+	
+	for (; i < (count & ~(intsize)1); i += 2)
+	{
+		uint64 p0 = phase, p1 = p0 + step;
+		__m128 ab0 = _mm_loadu_ps(src + (p0 >> 32) * 2);
+		__m128 ab1 = _mm_loadu_ps(src + (p1 >> 32) * 2);
+		
+		__m128 a = _mm_movelh_ps(ab0, ab1);
+		__m128 b = _mm_movehl_ps(ab1, ab0);
+		__m128i frac = _mm_setr_epi32((int32)((uint32)p0 >> UMix_FracShift), (int32)((uint32)p0 >> UMix_FracShift), (int32)((uint32)p1 >> UMix_FracShift), (int32)((uint32)p1 >> UMix_FracShift));
+		__m128 t = _mm_mul_ps(_mm_cvtepi32_ps(frac), frac_mul);
+		__m128 s = _mm_mul_ps(_mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t)), vol);
+		
+		_mm_storeu_ps(out + i*2, _mm_add_ps(_mm_loadu_ps(out + i*2), s));
+		
+		phase = p1 + step;
+	}
+#elif defined(CONFIG_ARCH_AARCH64)
+	for (; i < (count & ~(intsize)1); i += 2)
+	{
+		uint64 p0 = phase, p1 = p0 + step;
+		float32x4_t ab0 = vld1q_f32(src + (p0 >> 32) * 2);
+		float32x4_t ab1 = vld1q_f32(src + (p1 >> 32) * 2);
+		
+		float32x4_t a = vcombine_f32(vget_low_f32(ab0), vget_low_f32(ab1));
+		float32x4_t b = vcombine_f32(vget_high_f32(ab0), vget_high_f32(ab1));
+		float32x2_t t0 = vdup_n_f32(UMix_FracToFloat_(p0));
+		float32x2_t t1 = vdup_n_f32(UMix_FracToFloat_(p1));
+		float32x4_t s = vmulq_n_f32(vmlaq_f32(a, vsubq_f32(b, a), vcombine_f32(t0, t1)), volume);
+		
+		vst1q_f32(out + i*2, vaddq_f32(vld1q_f32(out + i*2), s));
+		
+		phase = p1 + step;
+	}
+#endif
+	
+	for (; i < count; ++i, phase += step)
+	{
+		const float32* a = src + (phase >> 32) * 2;
+		float32 t = UMix_FracToFloat_(phase);
+		
+		out[i*2 + 0] += (a[0] + (a[2] - a[0]) * t) * volume;
+		out[i*2 + 1] += (a[1] + (a[3] - a[1]) * t) * volume;
+	}
+}
+
+// NOTE(ljre): Every kernel below goes 4 taps at a time, and both 8 and 32 are multiples of 8.
+static void
+UMix_SincMonoToStereo_(float32* restrict out, const UMix_Voice* voice)
+{
+	const float32* table = UMix_SincTable_(voice->quality);
+	const int32 taps = UMix_TapCount(voice->quality);
+	const float32* src = voice->samples - UMix_HistoryFrames(voice->quality);
+	const float32 volume = voice->volume;
+	const uint64 step = voice->step;
+	uint64 phase = voice->phase;
+	const intsize count = voice->frame_count;
+	intsize i = 0;
+	
+	// NOTE(ljre): 4 output frames at a time, each one a dot product of 'taps' frames with its row. The partial sums
+	//             are only added up horizontally once all 4 are done.
+#if defined(__AVX2__)
+	__m256 vol8 = _mm256_set1_ps(volume);
+	
+	for (; i < (count & ~(intsize)3); i += 4)
+	{
+		__m256 acc[4];
+		
+		for (int32 j = 0; j < 4; ++j, phase += step)
+		{
+			const float32* s = src + (intsize)(phase >> 32);
+			const float32* row = UMix_SincRow_(table, taps, phase);
+			__m256 sum = _mm256_mul_ps(_mm256_loadu_ps(s), _mm256_load_ps(row));
+			
+			for (int32 k = 8; k < taps; k += 8)
+				sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(s + k), _mm256_load_ps(row + k)));
+			
+			acc[j] = sum;
+		}
+		
+		__m256 t = _mm256_hadd_ps(_mm256_hadd_ps(acc[0], acc[1]), _mm256_hadd_ps(acc[2], acc[3]));
+		__m128 s = _mm_add_ps(_mm256_castps256_ps128(t), _mm256_extractf128_ps(t, 1));
+		s = _mm_mul_ps(s, _mm256_castps256_ps128(vol8));
+		
+		_mm_storeu_ps(out + i*2 + 0, _mm_add_ps(_mm_loadu_ps(out + i*2 + 0), _mm_unpacklo_ps(s, s)));
+		_mm_storeu_ps(out + i*2 + 4, _mm_add_ps(_mm_loadu_ps(out + i*2 + 4), _mm_unpackhi_ps(s, s)));
+	}
+#elif defined(CONFIG_ARCH_X86FAMILY)
+	__m128 vol = _mm_set1_ps(volume);
+	
+	for (; i < (count & ~(intsize)3); i += 4)
+	{
+		__m128 acc[4];
+		
+		for (int32 j = 0; j < 4; ++j, phase += step)
+		{
+			const float32* s = src + (intsize)(phase >> 32);
+			const float32* row = UMix_SincRow_(table, taps, phase);
+			__m128 sum = _mm_mul_ps(_mm_loadu_ps(s), _mm_load_ps(row));
+			
+			for (int32 k = 4; k < taps; k += 4)
+				sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(s + k), _mm_load_ps(row + k)));
+			
+			acc[j] = sum;
+		}
+		
+		_MM_TRANSPOSE4_PS(acc[0], acc[1], acc[2], acc[3]);
+		__m128 s = _mm_mul_ps(_mm_add_ps(_mm_add_ps(acc[0], acc[1]), _mm_add_ps(acc[2], acc[3])), vol);
+		
+		_mm_storeu_ps(out + i*2 + 0, _mm_add_ps(_mm_loadu_ps(out + i*2 + 0), _mm_unpacklo_ps(s, s)));
+		_mm_storeu_ps(out + i*2 + 4, _mm_add_ps(_mm_loadu_ps(out + i*2 + 4), _mm_unpackhi_ps(s, s)));
+	}
+#elif defined(CONFIG_ARCH_AARCH64)
+	for (; i < (count & ~(intsize)3); i += 4)
+	{
+		float32x4_t acc[4];
+		
+		for (int32 j = 0; j < 4; ++j, phase += step)
+		{
+			const float32* s = src + (intsize)(phase >> 32);
+			const float32* row = UMix_SincRow_(table, taps, phase);
+			float32x4_t sum = vmulq_f32(vld1q_f32(s), vld1q_f32(row));
+			
+			for (int32 k = 4; k < taps; k += 4)
+				sum = vmlaq_f32(sum, vld1q_f32(s + k), vld1q_f32(row + k));
+			
+			acc[j] = sum;
+		}
+		
+		float32x4_t s = vmulq_n_f32(vpaddq_f32(vpaddq_f32(acc[0], acc[1]), vpaddq_f32(acc[2], acc[3])), volume);
+		float32x4x2_t pairs = vzipq_f32(s, s);
+		
+		vst1q_f32(out + i*2 + 0, vaddq_f32(vld1q_f32(out + i*2 + 0), pairs.val[0]));
+		vst1q_f32(out + i*2 + 4, vaddq_f32(vld1q_f32(out + i*2 + 4), pairs.val[1]));
+	}
+#endif
+	
+	for (; i < count; ++i, phase += step)
+	{
+		float32 s = UMix_SincDot_(src + (intsize)(phase >> 32), 1, UMix_SincRow_(table, taps, phase), taps) * volume;
+		
+		out[i*2 + 0] += s;
+		out[i*2 + 1] += s;
+	}
+}
+
+static void
+UMix_SincStereoToStereo_(float32* restrict out, const UMix_Voice* voice)
+{
+	const float32* table = UMix_SincTable_(voice->quality);
+	const int32 taps = UMix_TapCount(voice->quality);
+	const float32* src = voice->samples - UMix_HistoryFrames(voice->quality) * 2;
+	const float32 volume = voice->volume;
+	const uint64 step = voice->step;
+	uint64 phase = voice->phase;
+	const intsize count = voice->frame_count;
+	intsize i = 0;
+	
+	// NOTE(ljre): 2 output frames at a time. The samples stay interleaved and the coefficients get duplicated
+	//             instead, so each partial sum ends up as L R L R.
+#if defined(CONFIG_ARCH_X86FAMILY)
+	__m128 vol = _mm_set1_ps(volume);
+#	if defined(__AVX2__)
+	__m256i dup_lo = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+	__m256i dup_hi = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+#	endif
+	
+	for (; i < (count & ~(intsize)1); i += 2)
+	{
+		__m128 acc[2];
+		
+		for (int32 j = 0; j < 2; ++j, phase += step)
+		{
+			const float32* s = src + (intsize)(phase >> 32) * 2;
+			const float32* row = UMix_SincRow_(table, taps, phase);
+#	if defined(__AVX2__)
+			__m256 sum0 = _mm256_setzero_ps();
+			__m256 sum1 = _mm256_setzero_ps();
+			
+			for (int32 k = 0; k < taps; k += 8)
+			{
+				__m256 c = _mm256_load_ps(row + k);
+				
+				sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(_mm256_loadu_ps(s + k*2 + 0), _mm256_permutevar8x32_ps(c, dup_lo)));
+				sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(_mm256_loadu_ps(s + k*2 + 8), _mm256_permutevar8x32_ps(c, dup_hi)));
+			}
+			
+			__m256 sum = _mm256_add_ps(sum0, sum1);
+			acc[j] = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+#	else
+			__m128 sum0 = _mm_setzero_ps();
+			__m128 sum1 = _mm_setzero_ps();
+			
+			for (int32 k = 0; k < taps; k += 4)
+			{
+				__m128 c = _mm_load_ps(row + k);
+				
+				sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(s + k*2 + 0), _mm_unpacklo_ps(c, c)));
+				sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(s + k*2 + 4), _mm_unpackhi_ps(c, c)));
+			}
+			
+			acc[j] = _mm_add_ps(sum0, sum1);
+#	endif
+		}
+		
+		__m128 s = _mm_mul_ps(_mm_add_ps(_mm_movelh_ps(acc[0], acc[1]), _mm_movehl_ps(acc[1], acc[0])), vol);
+		
+		_mm_storeu_ps(out + i*2, _mm_add_ps(_mm_loadu_ps(out + i*2), s));
+	}
+#elif defined(CONFIG_ARCH_AARCH64)
+	for (; i < (count & ~(intsize)1); i += 2)
+	{
+		float32x4_t acc[2];
+		
+		for (int32 j = 0; j < 2; ++j, phase += step)
+		{
+			const float32* s = src + (intsize)(phase >> 32) * 2;
+			const float32* row = UMix_SincRow_(table, taps, phase);
+			float32x4_t sum_l = vdupq_n_f32(0.0f);
+			float32x4_t sum_r = vdupq_n_f32(0.0f);
+			
+			// NOTE(ljre): Here the loads can split the channels for free.
+			for (int32 k = 0; k < taps; k += 4)
+			{
+				float32x4x2_t lr = vld2q_f32(s + k*2);
+				float32x4_t c = vld1q_f32(row + k);
+				
+				sum_l = vmlaq_f32(sum_l, lr.val[0], c);
+				sum_r = vmlaq_f32(sum_r, lr.val[1], c);
+			}
+			
+			acc[j] = vpaddq_f32(sum_l, sum_r);
+		}
+		
+		float32x4_t s = vmulq_n_f32(vpaddq_f32(acc[0], acc[1]), volume);
+		
+		vst1q_f32(out + i*2, vaddq_f32(vld1q_f32(out + i*2), s));
+	}
+#endif
+	
+	for (; i < count; ++i, phase += step)
+	{
+		const float32* s = src + (intsize)(phase >> 32) * 2;
+		const float32* row = UMix_SincRow_(table, taps, phase);
+		
+		out[i*2 + 0] += UMix_SincDot_(s + 0, 2, row, taps) * volume;
+		out[i*2 + 1] += UMix_SincDot_(s + 1, 2, row, taps) * volume;
+	}
+}
+
+//~ NOTE(ljre): API
+// NOTE(ljre): Builds the sinc tables. Call it once before mixing any voice that isn't UMix_Quality_Linear.
+static void
+UMix_InitTables(void)
+{
+	if (global_umix_tables.ready)
+		return;
+	
+	UMix_BuildSincTable_(global_umix_tables.sinc8, 8, 0.38, 5.0);
+	UMix_BuildSincTable_(global_umix_tables.sinc32, 32, 0.45, 8.0);
+	global_umix_tables.ready = true;
+}
+
+// NOTE(ljre): Picks the right kernel. Any other layout than mono or stereo into stereo goes through the generic one.
+//             At the same rate, every quality comes down to copying the samples.
+static void
+UMix_MixVoice(float32* restrict out, int32 out_channels, const UMix_Voice* voice)
+{
+	bool same_rate = UMix_IsSameRate(voice->phase, voice->step);
+	bool sinc = (voice->quality != UMix_Quality_Linear);
+	
+	// NOTE(ljre): Fades only last a few milliseconds, so the SIMD kernels don't bother with them.
+	if (voice->volume_step != 0.0f)
+		UMix_Generic_(out, out_channels, voice);
+	else if (out_channels == 2 && voice->channels == 1)
+	{
+		if (same_rate)
+			UMix_MonoToStereoSameRate_(out, voice);
+		else if (sinc)
+			UMix_SincMonoToStereo_(out, voice);
+		else
+			UMix_MonoToStereo_(out, voice);
+	}
+	else if (out_channels == 2 && voice->channels == 2)
+	{
+		if (same_rate)
+			UMix_StereoToStereoSameRate_(out, voice);
+		else if (sinc)
+			UMix_SincStereoToStereo_(out, voice);
+		else
+			UMix_StereoToStereo_(out, voice);
+	}
+	else
+		UMix_Generic_(out, out_channels, voice);
+}
+
+// NOTE(ljre): Same as UMix_MixVoice, but always through the scalar kernel. Meant for tests and benchmarks.
+static void
+UMix_MixVoiceGeneric(float32* restrict out, int32 out_channels, const UMix_Voice* voice)
+{ UMix_Generic_(out, out_channels, voice); }
+
+#endif //UTIL_AUDIOMIX_H
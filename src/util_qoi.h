@@ -13,39 +13,35 @@ UQoi_HashOfPixel_(uint32 color)
 }
 
 //~ Internal API
-static uint32*
-UQoi_Parse(const uint8* data, uintsize size, Arena* arena, int32* out_width, int32* out_height)
+struct UQoi_Header_
 {
-	Trace();
-	
-	//- NOTE(ljre): Some types.
-	struct QoiHeader
-	{
-		uint8 magic[4];
-		uint32 width;
-		uint32 height;
-		uint8 channels;
-		uint8 colorspace;
-	};
-	
-	union QoiColor
+	uint8 magic[4];
+	uint32 width;
+	uint32 height;
+	uint8 channels;
+	uint8 colorspace;
+};
+
+union UQoi_Color_
+{
+	struct
 	{
-		struct
-		{
-			uint8 r, g, b, a;
-		};
-		
-		uint8 array[4];
-		uint32 value;
+		uint8 r, g, b, a;
 	};
 	
-	static_assert(sizeof(union QoiColor) == sizeof(uint32), "union didn't work?");
-	
-	//- NOTE(ljre): Validate header.
+	uint8 array[4];
+	uint32 value;
+};
+
+static_assert(sizeof(union UQoi_Color_) == sizeof(uint32), "union didn't work?");
+
+static bool
+UQoi_ParseHeader(const uint8* data, uintsize size, int32* out_width, int32* out_height)
+{
 	if (size < 14 + 8)
-		return NULL;
+		return false;
 	
-	struct QoiHeader header = *(const struct QoiHeader*)data;
+	struct UQoi_Header_ header = *(const struct UQoi_Header_*)data;
 	header.width = ByteSwap32(header.width);
 	header.height = ByteSwap32(header.height);
 	
@@ -53,168 +49,388 @@ UQoi_Parse(const uint8* data, uintsize size, Arena* arena, int32* out_width, int
 		header.channels < 3 || header.channels > 4 || header.colorspace > 1 || // NOTE(ljre): Format limitations.
 		header.colorspace != 1 || header.width > INT32_MAX || header.height > INT32_MAX) // NOTE(ljre): Our limitations.
 	{
-		return NULL;
+		return false;
 	}
 	
-	//- NOTE(ljre): Init.
-	const uint8* head = data + 14;
-	const uint8* end = data + size;
-	
-	union QoiColor* colors = ArenaPushAligned(arena, header.width * header.height * 4, 4);
-	uint32 color_index = 0;
-	bool err = false;
+	*out_width = (int32)header.width;
+	*out_height = (int32)header.height;
 	
-	union QoiColor previous_pixel = { 0, 0, 0, 255 };
-	union QoiColor pixels[64] = { 0 };
+	return true;
+}
+
+// NOTE(ljre): Decodes exactly 'count' pixels starting at 'head'. Every op is at most 5 bytes, and a valid stream
+//             always has at least the 8 bytes of the end marker after its last op, so a single bounds check per op
+//             is enough. Returns where the next op starts, or NULL on error.
+static const uint8*
+UQoi_DecodeOps_(const uint8* head, const uint8* end, union UQoi_Color_* out, uint32 count)
+{
+	union UQoi_Color_* out_end = out + count;
+	union UQoi_Color_ previous_pixel = { { 0, 0, 0, 255 } };
+	union UQoi_Color_ pixels[64] = { 0 };
 	
-	//- NOTE(ljre): Decode.
-	while (!err && color_index < header.width*header.height)
+	while (out < out_end)
 	{
-		if (head >= end)
-		{
-			err = true;
-			break;
-		}
+		if (Unlikely(end - head < 5))
+			return NULL;
 		
-		uint8 top = head[0] >> 6;
+		uint8 op = head[0];
+		union UQoi_Color_ cur = previous_pixel;
 		
-		if (top == 0b00) // NOTE(ljre): QOI_OP_INDEX
+		if (op < 0x40) // NOTE(ljre): QOI_OP_INDEX
 		{
-			uint8 index = *head++ & 0b00111111;
-			previous_pixel = colors[color_index++] = pixels[index];
+			cur = pixels[op];
+			head += 1;
 		}
-		else if (top == 0b01) // NOTE(ljre): QOI_OP_DIFF
+		else if (op < 0x80) // NOTE(ljre): QOI_OP_DIFF
 		{
-			uint8 diff[4] = {
-				((head[0] >> 4) & 0b11) - 2,
-				((head[0] >> 2) & 0b11) - 2,
-				((head[0] >> 0) & 0b11) - 2,
-				0,
-			};
-			
-			union QoiColor cur = previous_pixel;
-			
-			cur.array[0] += diff[0];
-			cur.array[1] += diff[1];
-			cur.array[2] += diff[2];
-			cur.array[3] += diff[3];
-			
-			previous_pixel = colors[color_index++] = cur;
-			++head;
+			cur.r += ((op >> 4) & 3) - 2;
+			cur.g += ((op >> 2) & 3) - 2;
+			cur.b += ((op >> 0) & 3) - 2;
+			head += 1;
 		}
-		else if (top == 0b10) // NOTE(ljre): QOI_OP_LUMA
+		else if (op < 0xc0) // NOTE(ljre): QOI_OP_LUMA
 		{
-			if (head + 1 >= end)
-			{
-				err = true;
-				break;
-			}
-			
-			uint8 diff[4] = {
-				head[1] >> 4,
-				((head[0]) & 0b00111111) - 32,
-				head[1] & 0b1111,
-				0,
-			};
-			
-			diff[0] += diff[1];
-			diff[2] += diff[1];
-			
-			union QoiColor cur = previous_pixel;
-			
-			cur.array[0] += diff[0];
-			cur.array[1] += diff[1];
-			cur.array[2] += diff[2];
-			cur.array[3] += diff[3];
+			uint8 diff_g = (op & 0x3f) - 32;
 			
-			previous_pixel = colors[color_index++] = cur;
+			cur.r += diff_g - 8 + (head[1] >> 4);
+			cur.g += diff_g;
+			cur.b += diff_g - 8 + (head[1] & 0xf);
 			head += 2;
 		}
-		else if (head[0] == 0b11111110) // NOTE(ljre): QOI_OP_RGB
+		else if (op < 0xfe) // NOTE(ljre): QOI_OP_RUN
 		{
-			if (head + 3 >= end)
-			{
-				err = true;
-				break;
-			}
+			uint32 run = (op & 0x3f) + 1;
 			
-			union QoiColor cur;
-			++head;
+			if (Unlikely(run > (uint32)(out_end - out)))
+				return NULL;
 			
-			cur.array[0] = head[0];
-			cur.array[1] = head[1];
-			cur.array[2] = head[2];
-			cur.array[3] = previous_pixel.array[3];
+			// NOTE(ljre): Runs are filled in bulk and don't touch the index, except for the very first pixel of the
+			//             stream, which never went through it.
+			pixels[UQoi_HashOfPixel_(cur.value)] = cur;
 			
-			previous_pixel = colors[color_index++] = cur;
-			head += 3;
-		}
-		else if (head[0] == 0b11111111) // NOTE(ljre): QOI_OP_RGBA
-		{
-			if (head + 4 >= end)
-			{
-				err = true;
-				break;
-			}
-			
-			union QoiColor cur;
-			++head;
+#ifdef CONFIG_ARCH_X86FAMILY
+			__m128i fill = _mm_set1_epi32((int32)cur.value);
 			
-			cur.array[0] = head[0];
-			cur.array[1] = head[1];
-			cur.array[2] = head[2];
-			cur.array[3] = head[3];
+			for (; run >= 4; run -= 4, out += 4)
+				_mm_storeu_si128((__m128i*)out, fill);
+#endif //CONFIG_ARCH_X86FAMILY
+			for (; run > 0; --run)
+				*out++ = cur;
 			
-			previous_pixel = colors[color_index++] = cur;
+			head += 1;
+			continue;
+		}
+		else if (op == 0xfe) // NOTE(ljre): QOI_OP_RGB
+		{
+			cur.r = head[1];
+			cur.g = head[2];
+			cur.b = head[3];
 			head += 4;
 		}
-		else if (top == 0b11) // NOTE(ljre): QOI_OP_RUN
+		else // NOTE(ljre): QOI_OP_RGBA
+		{
+			cur.r = head[1];
+			cur.g = head[2];
+			cur.b = head[3];
+			cur.a = head[4];
+			head += 5;
+		}
+		
+		pixels[UQoi_HashOfPixel_(cur.value)] = cur;
+		previous_pixel = *out++ = cur;
+	}
+	
+	return head;
+}
+
+static bool
+UQoi_CheckEndMarker_(const uint8* head, const uint8* end)
+{
+	const uint8 end_marker[8] = { 0,0,0,0, 0,0,0,1 };
+	
+	return head && end - head >= 8 && MemoryCompare(head, end_marker, 8) == 0;
+}
+
+// NOTE(ljre): Decodes into a caller-provided buffer of 'width*height' RGBA pixels. The header should already have
+//             been validated by UQoi_ParseHeader.
+static bool
+UQoi_DecodeToBuffer(const uint8* data, uintsize size, uint32* out_pixels, int32 width, int32 height)
+{
+	Trace();
+	
+	const uint8* end = data + size;
+	const uint8* head = UQoi_DecodeOps_(data + 14, end, (union UQoi_Color_*)out_pixels, (uint32)width * (uint32)height);
+	
+	return UQoi_CheckEndMarker_(head, end);
+}
+
+//~ NOTE(ljre): Bands
+// NOTE(ljre): Images encoded by UQoi_EncodeToBuffer with 'rows_per_band' set are split in bands of rows. Each band
+//             starts with an explicit RGBA op, never continues a run from the previous one, and only indexes colors
+//             seen inside of it, so it can be decoded on its own. A table is appended after the end marker:
+//
+//             [uint32 offset * band_count] [uint32 rows_per_band] [uint32 band_count] ["qbnd"]
+//
+//             Offsets are little-endian and relative to the start of the file. Regular QOI decoders stop at the end
+//             marker and never see the table.
+enum
+{
+	UQoi_MaxBands = 256,
+	UQoi_BandPixels = 64 << 10, // NOTE(ljre): What UQoi_CalcBandRows aims for.
+};
+
+struct UQoi_Bands
+{
+	int32 rows_per_band;
+	int32 band_count;
+	const uint8* offsets; // NOTE(ljre): Also where the ops end.
+}
+typedef UQoi_Bands;
+
+static int32
+UQoi_CalcBandRows(int32 width, int32 height)
+{
+	int32 rows = Max(UQoi_BandPixels / Max(width, 1), 1);
+	int32 min_rows = (height + UQoi_MaxBands-1) / UQoi_MaxBands;
+	
+	return Max(rows, min_rows);
+}
+
+static inline uint32
+UQoi_ReadU32_(const uint8* data)
+{ return data[0] | (uint32)data[1] << 8 | (uint32)data[2] << 16 | (uint32)data[3] << 24; }
+
+static inline void
+UQoi_WriteU32_(uint8* data, uint32 value)
+{
+	data[0] = (uint8)(value >> 0);
+	data[1] = (uint8)(value >> 8);
+	data[2] = (uint8)(value >> 16);
+	data[3] = (uint8)(value >> 24);
+}
+
+// NOTE(ljre): Returns false if the image has no band table. 'width' and 'height' come from UQoi_ParseHeader.
+static bool
+UQoi_ParseBands(const uint8* data, uintsize size, int32 width, int32 height, UQoi_Bands* out_bands)
+{
+	if (size < 14 + 8 + 12 || MemoryCompare(data + size - 4, "qbnd", 4) != 0)
+		return false;
+	
+	uint32 rows_per_band = UQoi_ReadU32_(data + size - 12);
+	uint32 band_count = UQoi_ReadU32_(data + size - 8);
+	
+	if (!rows_per_band || !band_count || band_count > UQoi_MaxBands)
+		return false;
+	if (band_count != ((uint32)height + rows_per_band-1) / rows_per_band)
+		return false;
+	if (size - 14 - 8 - 12 < band_count * 4)
+		return false;
+	
+	const uint8* offsets = data + size - 12 - band_count * 4;
+	uint32 previous_offset = 0;
+	
+	for (uint32 i = 0; i < band_count; ++i)
+	{
+		uint32 offset = UQoi_ReadU32_(offsets + i*4);
+		
+		if (i == 0 ? offset != 14 : offset <= previous_offset)
+			return false;
+		if (offset >= (uintsize)(offsets - data))
+			return false;
+		
+		previous_offset = offset;
+	}
+	
+	*out_bands = (UQoi_Bands) {
+		.rows_per_band = (int32)rows_per_band,
+		.band_count = (int32)band_count,
+		.offsets = offsets,
+	};
+	
+	return true;
+}
+
+// NOTE(ljre): Decodes the rows of 'band' into their place in 'out_pixels', a buffer for the whole image. Bands can be
+//             decoded in any order, from any thread.
+static bool
+UQoi_DecodeBand(const uint8* data, uintsize size, const UQoi_Bands* bands, int32 band, uint32* out_pixels, int32 width, int32 height)
+{
+	Trace();
+	SafeAssert(band >= 0 && band < bands->band_count);
+	
+	int32 first_row = band * bands->rows_per_band;
+	int32 row_count = Min(bands->rows_per_band, height - first_row);
+	const uint8* begin = data + UQoi_ReadU32_(bands->offsets + band*4);
+	const uint8* end = bands->offsets;
+	union UQoi_Color_* out = (union UQoi_Color_*)out_pixels + (uintsize)first_row * width;
+	
+	const uint8* head = UQoi_DecodeOps_(begin, end, out, (uint32)row_count * (uint32)width);
+	
+	if (band+1 < bands->band_count)
+		return head == data + UQoi_ReadU32_(bands->offsets + (band+1)*4);
+	return UQoi_CheckEndMarker_(head, end);
+}
+
+//~ NOTE(ljre): Encoding
+static uintsize
+UQoi_CalcMaxEncodedSize(int32 width, int32 height, int32 rows_per_band)
+{
+	uintsize size = 14 + (uintsize)width * height * 5 + 8;
+	
+	if (rows_per_band > 0)
+		size += ((uintsize)height + rows_per_band-1) / rows_per_band * 4 + 12;
+	
+	return size;
+}
+
+// NOTE(ljre): Encodes 'width*height' RGBA pixels as a 4-channel, linear QOI image. 'rows_per_band' of 0 means a
+//             plain QOI file, otherwise see UQoi_ParseBands. 'out_data' should be at least UQoi_CalcMaxEncodedSize
+//             bytes. Returns the actual size.
+static uintsize
+UQoi_EncodeToBuffer(const uint32* pixels, int32 width, int32 height, int32 rows_per_band, uint8* out_data, uintsize out_size)
+{
+	Trace();
+	
+	SafeAssert(width > 0 && height > 0 && rows_per_band >= 0);
+	SafeAssert(out_size >= UQoi_CalcMaxEncodedSize(width, height, rows_per_band));
+	
+	int32 band_rows = rows_per_band ? rows_per_band : height;
+	int32 band_count = (height + band_rows-1) / band_rows;
+	
+	SafeAssert(!rows_per_band || band_count <= UQoi_MaxBands);
+	
+	//- NOTE(ljre): Header.
+	uint8* head = out_data;
+	
+	MemoryCopy(head, "qoif", 4);
+	UQoi_WriteU32_(head + 4, ByteSwap32((uint32)width));
+	UQoi_WriteU32_(head + 8, ByteSwap32((uint32)height));
+	head[12] = 4; // NOTE(ljre): Channels.
+	head[13] = 1; // NOTE(ljre): Colorspace, all linear.
+	head += 14;
+	
+	//- NOTE(ljre): Ops, band by band.
+	uint32 band_offsets[UQoi_MaxBands];
+	const union UQoi_Color_* colors = (const union UQoi_Color_*)pixels;
+	
+	for (int32 band = 0; band < band_count; ++band)
+	{
+		uintsize first = (uintsize)band * band_rows * width;
+		uintsize last = Min(first + (uintsize)band_rows * width, (uintsize)width * height);
+		
+		union UQoi_Color_ index[64];
+		uint64 index_valid = 0; // NOTE(ljre): Only colors seen in this band can be indexed.
+		union UQoi_Color_ previous_pixel = colors[first];
+		uint32 run = 0;
+		
+		band_offsets[band] = (uint32)(head - out_data);
+		
+		for (uintsize i = first; i < last; ++i)
 		{
-			uint32 count = *head++ & 0b00111111;
-			count += 1;
+			union UQoi_Color_ cur = colors[i];
 			
-			Assert(count < 0b111111); // unreachable
+			if (i != first && cur.value == previous_pixel.value)
+			{
+				if (++run == 62)
+				{
+					*head++ = 0xc0 | (uint8)(run - 1);
+					run = 0;
+				}
+				
+				continue;
+			}
 			
-			if (color_index + count > header.width*header.height)
+			if (run > 0)
 			{
-				err = true;
-				break;
+				*head++ = 0xc0 | (uint8)(run - 1);
+				run = 0;
 			}
 			
-			while (count --> 0)
-				colors[color_index++] = previous_pixel;
-		}
-		else
-		{
-			err = true;
-			break;
-		}
+			int32 hash = UQoi_HashOfPixel_(cur.value);
+			
+			if (i != first && (index_valid >> hash & 1) && index[hash].value == cur.value)
+				*head++ = (uint8)hash;
+			else if (i != first && cur.a == previous_pixel.a)
+			{
+				int8 dr = (int8)(cur.r - previous_pixel.r);
+				int8 dg = (int8)(cur.g - previous_pixel.g);
+				int8 db = (int8)(cur.b - previous_pixel.b);
+				int8 dr_dg = dr - dg;
+				int8 db_dg = db - dg;
+				
+				if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1)
+					*head++ = 0x40 | (uint8)((dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+				else if (dg >= -32 && dg <= 31 && dr_dg >= -8 && dr_dg <= 7 && db_dg >= -8 && db_dg <= 7)
+				{
+					*head++ = 0x80 | (uint8)(dg + 32);
+					*head++ = (uint8)((dr_dg + 8) << 4 | (db_dg + 8));
+				}
+				else
+				{
+					*head++ = 0xfe;
+					*head++ = cur.r;
+					*head++ = cur.g;
+					*head++ = cur.b;
+				}
+			}
+			else
+			{
+				*head++ = 0xff;
+				*head++ = cur.r;
+				*head++ = cur.g;
+				*head++ = cur.b;
+				*head++ = cur.a;
+			}
 		
-		pixels[UQoi_HashOfPixel_(previous_pixel.value)] = previous_pixel;
+			index[hash] = cur;
+			index_valid |= 1ull << hash;
+			previous_pixel = cur;
+		}
+	
+		if (run > 0)
+			*head++ = 0xc0 | (uint8)(run - 1);
 	}
 	
-	//- NOTE(ljre): Check for end marker.
-	if (head + 8 > end)
-		err = true;
-	else
+	//- NOTE(ljre): End marker and band table.
+	const uint8 end_marker[8] = { 0,0,0,0, 0,0,0,1 };
+	MemoryCopy(head, end_marker, 8);
+	head += 8;
+	
+	if (rows_per_band > 0)
 	{
-		const uint8 end_marker[8] = { 0,0,0,0, 0,0,0,1 };
+		for (int32 band = 0; band < band_count; ++band, head += 4)
+			UQoi_WriteU32_(head, band_offsets[band]);
 		
-		if (MemoryCompare(head, end_marker, 8) != 0)
-			err = true;
+		UQoi_WriteU32_(head + 0, (uint32)rows_per_band);
+		UQoi_WriteU32_(head + 4, (uint32)band_count);
+		MemoryCopy(head + 8, "qbnd", 4);
+		head += 12;
 	}
 	
-	//- NOTE(ljre): Check for errors and return.
-	if (err)
+	return (uintsize)(head - out_data);
+}
+
+static uint32*
+UQoi_Parse(const uint8* data, uintsize size, Arena* arena, int32* out_width, int32* out_height)
+{
+	Trace();
+	
+	int32 width, height;
+	if (!UQoi_ParseHeader(data, size, &width, &height))
+		return NULL;
+	
+	uint32* colors = ArenaPushAligned(arena, (uintsize)width * height * 4, 4);
+	
+	if (!UQoi_DecodeToBuffer(data, size, colors, width, height))
 	{
 		ArenaPop(arena, colors);
 		return NULL;
 	}
 	
-	*out_width = (int32)header.width;
-	*out_height = (int32)header.height;
+	*out_width = width;
+	*out_height = height;
 	
-	return (uint32*)colors;
+	return colors;
 }
 
 #endif //UTIL_QOI_H
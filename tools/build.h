@@ -3,10 +3,20 @@
 
 #ifdef _WIN32
 #   define _CRT_SECURE_NO_WARNINGS
+#else
+#   define _DEFAULT_SOURCE
 #endif
 #include <sys/types.h>
 #include <sys/stat.h>
-#include <direct.h>
+#ifdef _WIN32
+#   include <direct.h>
+#else
+// NOTE(ljre): POSIX hosts spell the stat and mkdir functions without the MSVC prefixes.
+#   define __stat64 stat
+#   define _stat64 stat
+#   define _mkdir(dir) mkdir(dir, 0755)
+#   define _S_IFDIR S_IFDIR
+#endif
 #include <stdbool.h>
 #include <string.h>
 #include <stdlib.h>
@@ -68,6 +78,8 @@ static struct Build_Tu tu_gamepad_db_gen = { "gamepad_db_gen", "gamepad_db_gen/m
 static struct Build_Tu tu_renderbackend = { "renderbackend", "renderbackend.c" };
 static struct Build_Tu tu_game_test = { "game_test", "game_test/game.c" };
 static struct Build_Tu tu_game_nonejam1 = { "game_nonejam1", "game_nonejam1/game.c" };
+static struct Build_Tu tu_bench = { "bench", "bench/bench.c" };
+static struct Build_Tu tu_asset_packer = { "asset_packer", "asset_packer/main.c" };
 
 static struct Build_Executable g_executables[] = {
 	{
@@ -96,11 +108,27 @@ static struct Build_Executable g_executables[] = {
 			{ NULL },
 		},
 	},
+	{
+		.name = "bench",
+		.outname = "bench",
+		.is_graphic_program = true,
+		.tus = (struct Build_Tu*[]) { &tu_bench, &tu_engine, &tu_os, &tu_steam, &tu_debugtools, &tu_renderbackend, NULL },
+		.shaders = (struct Build_Shader[]) {
+			{ "engine_shader_quad.hlsl", "d3d11_shader_quad", "Vertex", "Pixel", "4_0", "g_render_" },
+			{ "engine_shader_quad_91.hlsl", "d3d11_shader_quad_91", "Vertex", "Pixel", "4_0_level_9_1", "g_render_" },
+			{ NULL },
+		},
+	},
 	{
 		.name = "gamepad_db_gen",
 		.outname = "gamepad_db_gen",
 		.tus = (struct Build_Tu*[]) { &tu_gamepad_db_gen, NULL },
-	}
+	},
+	{
+		.name = "asset_packer",
+		.outname = "asset_packer",
+		.tus = (struct Build_Tu*[]) { &tu_asset_packer, NULL },
+	},
 };
 
 static void
@@ -117,7 +117,11 @@ static Cstr f_rc = "rc tools\\windows-resource-file.rc /FO build\\windows-resour
 static Cstr f_cc = "gcc -std=c11";
 static Cstr f_cxx = "g++ -std=c++11 -fno-exceptions -fno-rtti";
 static Cstr f_cflags = "-Isrc -Iinclude";
+#   ifdef _WIN32
 static Cstr f_ldflags = "-lntdll";
+#   else
+static Cstr f_ldflags = "-lm -lpthread -ldl";
+#   endif
 static Cstr f_optimize[3] = { "-O0", "-O1", "-O2 -fno-strict-aliasing" };
 static Cstr f_warnings = "-Wall";
 static Cstr f_debuginfo = "-g";
@@ -186,6 +190,11 @@ GenTargetArg(void)
 static bool
 CompileShader(struct Build_Shader* shader)
 {
+#ifndef _WIN32
+	// NOTE(ljre): fxc only ships with the Windows SDK, so other hosts use the headers checked into include/.
+	return true;
+#endif
+	
 	// NOTE(ljre): Rebuild only if needed
 	if (!g_opts.force_rebuild)
 	{